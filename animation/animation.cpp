@@ -0,0 +1,206 @@
+#include "animation.hpp"
+
+#include "../simd/simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+using math::simd::f32x8;
+
+// Slerp approximated by nlerp with a cubic correction of t (zeux.io, "Approximating slerp").
+// Consecutive keys are stored in the same hemisphere, so d >= 0 here. Angular error against
+// exact slerp is below 1e-4 rad for keys up to 2 rad apart and below 8e-4 rad at 180 degrees.
+inline float corrected_t(float d, float t) {
+    float a = 1.0904f + d * (-3.2452f + d * (3.55645f - d * 1.43519f));
+    float b = 0.848013f + d * (-1.06021f + d * 0.215638f);
+    float k = a * (t - 0.5f) * (t - 0.5f) + b;
+    return t + t * (t - 0.5f) * (t - 1.0f) * k;
+}
+
+} // namespace
+
+namespace math {
+
+animation_clip::animation_clip(const std::vector<std::vector<transform_key>> &tracks)
+    : m_duration(0.0f) {
+    std::size_t total = 0;
+    for (const std::vector<transform_key> &keys : tracks) {
+        if (keys.empty()) {
+            throw std::invalid_argument("Animation track has no keys");
+        }
+        total += keys.size() + 1;
+    }
+    m_first_key.reserve(tracks.size());
+    m_last_key.reserve(tracks.size());
+    for (std::vector<float> *channel : {&m_time, &m_tx, &m_ty, &m_tz, &m_rx, &m_ry, &m_rz, &m_rw,
+                                        &m_sx, &m_sy, &m_sz}) {
+        channel->reserve(total);
+    }
+
+    for (const std::vector<transform_key> &keys : tracks) {
+        m_first_key.push_back(static_cast<std::uint32_t>(m_time.size()));
+        float prev[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+        // The last key is stored twice so key + 1 is always readable.
+        for (std::size_t k = 0; k <= keys.size(); ++k) {
+            const transform_key &key = keys[std::min(k, keys.size() - 1)];
+            float q[4] = {key.rotation[0], key.rotation[1], key.rotation[2], key.rotation[3]};
+            if (k > 0 && prev[0] * q[0] + prev[1] * q[1] + prev[2] * q[2] + prev[3] * q[3] < 0.0f) {
+                q[0] = -q[0];
+                q[1] = -q[1];
+                q[2] = -q[2];
+                q[3] = -q[3];
+            }
+            std::copy(q, q + 4, prev);
+
+            m_time.push_back(key.time);
+            m_tx.push_back(key.translation.x());
+            m_ty.push_back(key.translation.y());
+            m_tz.push_back(key.translation.z());
+            m_rx.push_back(q[0]);
+            m_ry.push_back(q[1]);
+            m_rz.push_back(q[2]);
+            m_rw.push_back(q[3]);
+            m_sx.push_back(key.scale.x());
+            m_sy.push_back(key.scale.y());
+            m_sz.push_back(key.scale.z());
+        }
+        m_last_key.push_back(static_cast<std::uint32_t>(m_time.size() - 2));
+        m_duration = std::max(m_duration, keys.back().time);
+    }
+}
+
+std::size_t animation_clip::track_count() const { return m_first_key.size(); }
+
+float animation_clip::duration() const { return m_duration; }
+
+animation_sampler::animation_sampler(const animation_clip &clip)
+    : m_clip(&clip), m_cursor(clip.m_first_key), m_key(clip.track_count()),
+      m_alpha(clip.track_count()) {}
+
+void animation_sampler::reset() { m_cursor = m_clip->m_first_key; }
+
+void animation_sampler::sample(float time, std::span<local_transform> out) {
+    const animation_clip &clip = *m_clip;
+    const std::size_t count = clip.track_count();
+    const float *times = clip.m_time.data();
+
+    // Pass 1: advance cursors and compute the blend factor of every track.
+    for (std::size_t t = 0; t < count; ++t) {
+        std::uint32_t c = m_cursor[t];
+        const std::uint32_t last = clip.m_last_key[t];
+        if (time < times[c]) [[unlikely]] {
+            const float *first = times + clip.m_first_key[t];
+            const float *it = std::upper_bound(first, times + last + 1, time);
+            c = static_cast<std::uint32_t>(std::max(it - 1, first) - times);
+        } else {
+            while (c < last && times[c + 1] <= time) {
+                ++c;
+            }
+        }
+        m_cursor[t] = c;
+        m_key[t] = static_cast<std::int32_t>(c);
+
+        float span = times[c + 1] - times[c];
+        float alpha = (span > 0.0f) ? (time - times[c]) / span : 0.0f;
+        m_alpha[t] = std::clamp(alpha, 0.0f, 1.0f);
+    }
+
+    // Pass 2: interpolate all tracks, eight at a time.
+    const float *channels[10] = {clip.m_tx.data(), clip.m_ty.data(), clip.m_tz.data(),
+                                 clip.m_rx.data(), clip.m_ry.data(), clip.m_rz.data(),
+                                 clip.m_rw.data(), clip.m_sx.data(), clip.m_sy.data(),
+                                 clip.m_sz.data()};
+    auto write = [&](std::size_t t, const float *v, std::size_t stride) {
+        local_transform &dst = out[t];
+        dst.translation.x(v[0]);
+        dst.translation.y(v[stride]);
+        dst.translation.z(v[2 * stride]);
+        dst.rotation[0] = v[3 * stride];
+        dst.rotation[1] = v[4 * stride];
+        dst.rotation[2] = v[5 * stride];
+        dst.rotation[3] = v[6 * stride];
+        dst.scale.x(v[7 * stride]);
+        dst.scale.y(v[8 * stride]);
+        dst.scale.z(v[9 * stride]);
+    };
+
+    std::size_t t = 0;
+    // The scalar backend uses the per-track loop below instead.
+#if MATH_SIMD_LEVEL >= 1
+    alignas(32) float lanes[10][8];
+    for (; t + 8 <= count; t += 8) {
+        const std::int32_t *key = &m_key[t];
+        const f32x8 alpha = f32x8::loadu(&m_alpha[t]);
+
+        f32x8 a[10], b[10];
+        for (int ch = 0; ch < 10; ++ch) {
+            a[ch] = f32x8::gather(channels[ch], key);
+            b[ch] = f32x8::gather(channels[ch] + 1, key);
+        }
+
+        for (int ch : {0, 1, 2, 7, 8, 9}) {
+            fmadd(b[ch] - a[ch], alpha, a[ch]).store(lanes[ch]);
+        }
+
+        f32x8 d = a[3] * b[3];
+        d = fmadd(a[4], b[4], d);
+        d = fmadd(a[5], b[5], d);
+        d = fmadd(a[6], b[6], d);
+        f32x8 ka = fmadd(d, f32x8(-1.43519f), f32x8(3.55645f));
+        ka = fmadd(d, ka, f32x8(-3.2452f));
+        ka = fmadd(d, ka, f32x8(1.0904f));
+        f32x8 kb = fmadd(d, f32x8(0.215638f), f32x8(-1.06021f));
+        kb = fmadd(d, kb, f32x8(0.848013f));
+        const f32x8 centered = alpha - f32x8(0.5f);
+        const f32x8 k = fmadd(ka * centered, centered, kb);
+        const f32x8 cubic = alpha * centered * (alpha - f32x8(1.0f));
+        const f32x8 ot = fmadd(cubic, k, alpha);
+
+        f32x8 q[4];
+        f32x8 len_sq(0.0f);
+        for (int c = 0; c < 4; ++c) {
+            q[c] = fmadd(b[3 + c] - a[3 + c], ot, a[3 + c]);
+            len_sq = fmadd(q[c], q[c], len_sq);
+        }
+        const f32x8 inv_len = f32x8(1.0f) / sqrt(len_sq);
+        for (int c = 0; c < 4; ++c) {
+            (q[c] * inv_len).store(lanes[3 + c]);
+        }
+
+        for (int l = 0; l < 8; ++l) {
+            write(t + l, &lanes[0][l], 8);
+        }
+    }
+#endif
+    for (; t < count; ++t) {
+        const std::int32_t k0 = m_key[t];
+        const float alpha = m_alpha[t];
+        float v[10];
+        for (int ch = 0; ch < 10; ++ch) {
+            const float a = channels[ch][k0];
+            v[ch] = a + (channels[ch][k0 + 1] - a) * alpha;
+        }
+
+        float d = 0.0f;
+        for (int c = 3; c < 7; ++c) {
+            d += channels[c][k0] * channels[c][k0 + 1];
+        }
+        const float ot = corrected_t(d, alpha);
+        float len_sq = 0.0f;
+        for (int c = 3; c < 7; ++c) {
+            const float a = channels[c][k0];
+            v[c] = a + (channels[c][k0 + 1] - a) * ot;
+            len_sq += v[c] * v[c];
+        }
+        const float inv_len = 1.0f / std::sqrt(len_sq);
+        for (int c = 3; c < 7; ++c) {
+            v[c] *= inv_len;
+        }
+        write(t, v, 1);
+    }
+}
+
+} // namespace math
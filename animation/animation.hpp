@@ -0,0 +1,70 @@
+#ifndef ANIMATION_HPP
+#define ANIMATION_HPP
+
+#include "../vec3/vec3.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace math {
+
+// Joint transform relative to its parent. Rotation is a unit quaternion (x, y, z, w).
+struct local_transform {
+    vec3 translation;
+    float rotation[4];
+    vec3 scale;
+};
+
+struct transform_key {
+    float time;
+    vec3 translation;
+    float rotation[4];
+    vec3 scale;
+};
+
+// Immutable keyframe data for a set of joint tracks. Keys of all tracks are stored
+// channel-by-channel (structure of arrays) so a sampler can gather the same channel of
+// many tracks at once.
+class animation_clip {
+  public:
+    // Every track needs at least one key; keys must be sorted by time.
+    explicit animation_clip(const std::vector<std::vector<transform_key>> &tracks);
+
+    std::size_t track_count() const;
+    float duration() const;
+
+  private:
+    friend class animation_sampler;
+
+    std::vector<std::uint32_t> m_first_key;
+    std::vector<std::uint32_t> m_last_key;
+    std::vector<float> m_time;
+    std::vector<float> m_tx, m_ty, m_tz;
+    std::vector<float> m_rx, m_ry, m_rz, m_rw;
+    std::vector<float> m_sx, m_sy, m_sz;
+    float m_duration;
+};
+
+// Per-instance playback state. Each track keeps a cursor to its current key, so moving
+// forward in time costs O(1) per track; jumping backwards falls back to a binary search.
+// Times outside a track's key range clamp to its first/last key.
+class animation_sampler {
+  public:
+    explicit animation_sampler(const animation_clip &clip);
+
+    // Writes one transform per track into out (out.size() >= clip.track_count()).
+    void sample(float time, std::span<local_transform> out);
+    void reset();
+
+  private:
+    const animation_clip *m_clip;
+    std::vector<std::uint32_t> m_cursor;
+    std::vector<std::int32_t> m_key;
+    std::vector<float> m_alpha;
+};
+
+} // namespace math
+
+#endif // ANIMATION_HPP
@@ -0,0 +1,332 @@
+#include "aos_soa.hpp"
+
+#include "../simd/vec3_block.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+static_assert(sizeof(math::vec3) == 3 * sizeof(float), "vec3 arrays are read as packed floats");
+static_assert(sizeof(math::vec4) == 4 * sizeof(float), "vec4 arrays are read as packed floats");
+
+namespace {
+
+using math::simd::f32x4;
+using math::simd::f32x8;
+
+constexpr std::size_t block = 8;
+
+inline void load_block(const float *p, f32x8 (&v)[3]) { math::simd::load_vec3x8(p, v); }
+
+inline void store_block(float *p, const f32x8 (&v)[3]) { math::simd::store_vec3x8(p, v); }
+
+// 8 packed vec4: vectors k and k + 4 share a register, so one 4x4 transpose per half gives
+// x, y, z, w in natural lane order.
+inline void load_block(const float *p, f32x8 (&v)[4]) {
+    for (int k = 0; k < 4; ++k) {
+        v[k] = f32x8(f32x4::loadu(p + 4 * k), f32x4::loadu(p + 16 + 4 * k));
+    }
+    math::simd::transpose4(v[0], v[1], v[2], v[3]);
+}
+
+inline void store_block(float *p, const f32x8 (&v)[4]) {
+    f32x8 r[4] = {v[0], v[1], v[2], v[3]};
+    math::simd::transpose4(r[0], r[1], r[2], r[3]);
+    for (int k = 0; k < 4; ++k) {
+        r[k].low().storeu(p + 4 * k);
+        r[k].high().storeu(p + 16 + 4 * k);
+    }
+}
+
+// Block at vector i holding n <= 8 vectors; a partial block goes through zeroed scratch.
+template <int N> void load(const float *base, std::size_t i, std::size_t n, f32x8 (&v)[N]) {
+    if (n == block) [[likely]] {
+        load_block(base + N * i, v);
+        return;
+    }
+    float scratch[N * block] = {};
+    std::copy(base + N * i, base + N * (i + n), scratch);
+    load_block(scratch, v);
+}
+
+template <int N> void store(float *base, std::size_t i, std::size_t n, const f32x8 (&v)[N]) {
+    if (n == block) [[likely]] {
+        store_block(base + N * i, v);
+        return;
+    }
+    float scratch[N * block];
+    store_block(scratch, v);
+    std::copy(scratch, scratch + N * n, base + N * i);
+}
+
+inline f32x8 load_lanes(const float *p, std::size_t i, std::size_t n) {
+    if (n == block) [[likely]] {
+        return f32x8::loadu(p + i);
+    }
+    float scratch[block] = {};
+    std::copy(p + i, p + i + n, scratch);
+    return f32x8::loadu(scratch);
+}
+
+inline void store_lanes(float *p, std::size_t i, std::size_t n, f32x8 v) {
+    if (n == block) [[likely]] {
+        v.storeu(p + i);
+        return;
+    }
+    float scratch[block];
+    v.storeu(scratch);
+    std::copy(scratch, scratch + n, p + i);
+}
+
+template <int N>
+void store_soa(float *const (&components)[N], std::size_t i, std::size_t n, const f32x8 (&v)[N]) {
+    for (int c = 0; c < N; ++c) {
+        store_lanes(components[c], i, n, v[c]);
+    }
+}
+
+template <typename Fn> void for_each_block(std::size_t count, Fn &&fn) {
+    for (std::size_t i = 0; i < count; i += block) {
+        fn(i, std::min(block, count - i));
+    }
+}
+
+template <typename V> const float *floats(std::span<const V> v) {
+    return reinterpret_cast<const float *>(v.data());
+}
+
+template <typename V> float *floats(std::span<V> v) { return reinterpret_cast<float *>(v.data()); }
+
+// ---- kernels on transposed blocks ----
+
+template <int N> f32x8 dot(const f32x8 (&a)[N], const f32x8 (&b)[N]) {
+    f32x8 sum = a[0] * b[0];
+    for (int c = 1; c < N; ++c) {
+        sum = fmadd(a[c], b[c], sum);
+    }
+    return sum;
+}
+
+inline void cross(const f32x8 (&a)[3], const f32x8 (&b)[3], f32x8 (&r)[3]) {
+    r[0] = fnmadd(a[2], b[1], a[1] * b[2]);
+    r[1] = fnmadd(a[0], b[2], a[2] * b[0]);
+    r[2] = fnmadd(a[1], b[0], a[0] * b[1]);
+}
+
+// Vectors with len_sq below min_len_sq become zero; 0 matches vec4::normalized(), 1e-8
+// vec3::normalized().
+template <int N> void normalize(const f32x8 (&v)[N], f32x8 (&r)[N], float min_len_sq) {
+    const f32x8 len_sq = dot(v, v);
+    const f32x8 inv_len = f32x8(1.0f) / sqrt(len_sq);
+    const auto degenerate = (min_len_sq > 0.0f) ? len_sq < min_len_sq : len_sq == 0.0f;
+    for (int c = 0; c < N; ++c) {
+        r[c] = select(degenerate, 0.0f, v[c] * inv_len);
+    }
+}
+
+template <int N> f32x8 distance(const f32x8 (&a)[N], const f32x8 (&b)[N]) {
+    f32x8 d[N];
+    for (int c = 0; c < N; ++c) {
+        d[c] = a[c] - b[c];
+    }
+    return sqrt(dot(d, d));
+}
+
+// Rows of m applied to N input components, plus the translation column for vec3 points.
+template <int N> void transform(const math::mat4x4 &m, const f32x8 (&v)[N], f32x8 (&r)[N]) {
+    const float *e = m.data();
+    for (int row = 0; row < N; ++row) {
+        f32x8 sum = (N == 3) ? f32x8(e[4 * row + 3]) : f32x8(0.0f);
+        for (int c = 0; c < N; ++c) {
+            sum = fmadd(f32x8(e[4 * row + c]), v[c], sum);
+        }
+        r[row] = sum;
+    }
+}
+
+template <int N, typename V>
+void normalize_aos(std::span<const V> in, std::span<V> out, float min_len_sq) {
+    const float *src = floats(in);
+    float *dst = floats(out);
+    for_each_block(in.size(), [&](std::size_t i, std::size_t n) {
+        f32x8 v[N], r[N];
+        load(src, i, n, v);
+        normalize(v, r, min_len_sq);
+        store(dst, i, n, r);
+    });
+}
+
+template <int N, typename V>
+void normalize_soa(std::span<const V> in, float *const (&dst)[N], float min_len_sq) {
+    const float *src = floats(in);
+    for_each_block(in.size(), [&](std::size_t i, std::size_t n) {
+        f32x8 v[N], r[N];
+        load(src, i, n, v);
+        normalize(v, r, min_len_sq);
+        store_soa(dst, i, n, r);
+    });
+}
+
+template <int N, typename V>
+void dot_aos(std::span<const V> a, std::span<const V> b, std::span<float> out) {
+    const float *pa = floats(a), *pb = floats(b);
+    for_each_block(a.size(), [&](std::size_t i, std::size_t n) {
+        f32x8 va[N], vb[N];
+        load(pa, i, n, va);
+        load(pb, i, n, vb);
+        store_lanes(out.data(), i, n, dot(va, vb));
+    });
+}
+
+template <int N, typename V>
+void distance_aos(std::span<const V> a, std::span<const V> b, std::span<float> out) {
+    const float *pa = floats(a), *pb = floats(b);
+    for_each_block(a.size(), [&](std::size_t i, std::size_t n) {
+        f32x8 va[N], vb[N];
+        load(pa, i, n, va);
+        load(pb, i, n, vb);
+        store_lanes(out.data(), i, n, distance(va, vb));
+    });
+}
+
+template <int N, typename V>
+void transform_aos(const math::mat4x4 &m, std::span<const V> in, std::span<V> out) {
+    const float *src = floats(in);
+    float *dst = floats(out);
+    for_each_block(in.size(), [&](std::size_t i, std::size_t n) {
+        f32x8 v[N], r[N];
+        load(src, i, n, v);
+        transform(m, v, r);
+        store(dst, i, n, r);
+    });
+}
+
+template <int N, typename V>
+void transform_soa(const math::mat4x4 &m, std::span<const V> in, float *const (&dst)[N]) {
+    const float *src = floats(in);
+    for_each_block(in.size(), [&](std::size_t i, std::size_t n) {
+        f32x8 v[N], r[N];
+        load(src, i, n, v);
+        transform(m, v, r);
+        store_soa(dst, i, n, r);
+    });
+}
+
+template <int N, typename V> void to_soa_impl(std::span<const V> in, float *const (&dst)[N]) {
+    const float *src = floats(in);
+    for_each_block(in.size(), [&](std::size_t i, std::size_t n) {
+        f32x8 v[N];
+        load(src, i, n, v);
+        store_soa(dst, i, n, v);
+    });
+}
+
+template <int N, typename V> void from_soa_impl(const float *const (&src)[N], std::span<V> out) {
+    float *dst = floats(out);
+    for_each_block(out.size(), [&](std::size_t i, std::size_t n) {
+        f32x8 v[N];
+        for (int c = 0; c < N; ++c) {
+            v[c] = load_lanes(src[c], i, n);
+        }
+        store(dst, i, n, v);
+    });
+}
+
+} // namespace
+
+namespace math {
+
+void to_soa(std::span<const vec3> in, const vec3_soa &out) {
+    float *const dst[3] = {out.x.data(), out.y.data(), out.z.data()};
+    to_soa_impl(in, dst);
+}
+
+void to_soa(std::span<const vec4> in, const vec4_soa &out) {
+    float *const dst[4] = {out.x.data(), out.y.data(), out.z.data(), out.w.data()};
+    to_soa_impl(in, dst);
+}
+
+void from_soa(std::span<const float> x, std::span<const float> y, std::span<const float> z,
+              std::span<vec3> out) {
+    const float *const src[3] = {x.data(), y.data(), z.data()};
+    from_soa_impl(src, out);
+}
+
+void from_soa(std::span<const float> x, std::span<const float> y, std::span<const float> z,
+              std::span<const float> w, std::span<vec4> out) {
+    const float *const src[4] = {x.data(), y.data(), z.data(), w.data()};
+    from_soa_impl(src, out);
+}
+
+void dot_production(std::span<const vec3> a, std::span<const vec3> b, std::span<float> out) {
+    dot_aos<3>(a, b, out);
+}
+
+void dot_production(std::span<const vec4> a, std::span<const vec4> b, std::span<float> out) {
+    dot_aos<4>(a, b, out);
+}
+
+void cross_production(std::span<const vec3> a, std::span<const vec3> b, std::span<vec3> out) {
+    const float *pa = floats(a), *pb = floats(b);
+    float *dst = floats(out);
+    for_each_block(a.size(), [&](std::size_t i, std::size_t n) {
+        f32x8 va[3], vb[3], r[3];
+        load(pa, i, n, va);
+        load(pb, i, n, vb);
+        cross(va, vb, r);
+        store(dst, i, n, r);
+    });
+}
+
+void cross_production(std::span<const vec3> a, std::span<const vec3> b, const vec3_soa &out) {
+    const float *pa = floats(a), *pb = floats(b);
+    float *const dst[3] = {out.x.data(), out.y.data(), out.z.data()};
+    for_each_block(a.size(), [&](std::size_t i, std::size_t n) {
+        f32x8 va[3], vb[3], r[3];
+        load(pa, i, n, va);
+        load(pb, i, n, vb);
+        cross(va, vb, r);
+        store_soa(dst, i, n, r);
+    });
+}
+
+void normalize(std::span<const vec3> in, std::span<vec3> out) { normalize_aos<3>(in, out, 1e-8f); }
+
+void normalize(std::span<const vec3> in, const vec3_soa &out) {
+    float *const dst[3] = {out.x.data(), out.y.data(), out.z.data()};
+    normalize_soa(in, dst, 1e-8f);
+}
+
+void normalize(std::span<const vec4> in, std::span<vec4> out) { normalize_aos<4>(in, out, 0.0f); }
+
+void normalize(std::span<const vec4> in, const vec4_soa &out) {
+    float *const dst[4] = {out.x.data(), out.y.data(), out.z.data(), out.w.data()};
+    normalize_soa(in, dst, 0.0f);
+}
+
+void distance(std::span<const vec3> a, std::span<const vec3> b, std::span<float> out) {
+    distance_aos<3>(a, b, out);
+}
+
+void distance(std::span<const vec4> a, std::span<const vec4> b, std::span<float> out) {
+    distance_aos<4>(a, b, out);
+}
+
+void transform_points(const mat4x4 &m, std::span<const vec3> in, std::span<vec3> out) {
+    transform_aos<3>(m, in, out);
+}
+
+void transform_points(const mat4x4 &m, std::span<const vec3> in, const vec3_soa &out) {
+    float *const dst[3] = {out.x.data(), out.y.data(), out.z.data()};
+    transform_soa(m, in, dst);
+}
+
+void transform_points(const mat4x4 &m, std::span<const vec4> in, std::span<vec4> out) {
+    transform_aos<4>(m, in, out);
+}
+
+void transform_points(const mat4x4 &m, std::span<const vec4> in, const vec4_soa &out) {
+    float *const dst[4] = {out.x.data(), out.y.data(), out.z.data(), out.w.data()};
+    transform_soa(m, in, dst);
+}
+
+} // namespace math
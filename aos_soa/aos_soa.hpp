@@ -0,0 +1,56 @@
+#ifndef AOS_SOA_HPP
+#define AOS_SOA_HPP
+
+#include "../mat4x4/mat4x4.hpp"
+
+#include <span>
+
+namespace math {
+
+// Batch kernels over existing vec3 / vec4 arrays (array of structures). Blocks of eight
+// vectors are loaded, transposed to x, y, z(, w) registers, computed on, and transposed
+// back, so there is no separate conversion pass over memory. Overloads taking a *_soa output
+// store the result as structure of arrays instead. Outputs have room for in.size() entries
+// and may alias the inputs.
+
+// Component arrays of equal length.
+struct vec3_soa {
+    std::span<float> x, y, z;
+};
+
+struct vec4_soa {
+    std::span<float> x, y, z, w;
+};
+
+void to_soa(std::span<const vec3> in, const vec3_soa &out);
+void to_soa(std::span<const vec4> in, const vec4_soa &out);
+void from_soa(std::span<const float> x, std::span<const float> y, std::span<const float> z,
+              std::span<vec3> out);
+void from_soa(std::span<const float> x, std::span<const float> y, std::span<const float> z,
+              std::span<const float> w, std::span<vec4> out);
+
+void dot_production(std::span<const vec3> a, std::span<const vec3> b, std::span<float> out);
+void dot_production(std::span<const vec4> a, std::span<const vec4> b, std::span<float> out);
+
+void cross_production(std::span<const vec3> a, std::span<const vec3> b, std::span<vec3> out);
+void cross_production(std::span<const vec3> a, std::span<const vec3> b, const vec3_soa &out);
+
+// Same results as vec3::normalized() / vec4::normalized(): degenerate vectors become zero.
+void normalize(std::span<const vec3> in, std::span<vec3> out);
+void normalize(std::span<const vec3> in, const vec3_soa &out);
+void normalize(std::span<const vec4> in, std::span<vec4> out);
+void normalize(std::span<const vec4> in, const vec4_soa &out);
+
+void distance(std::span<const vec3> a, std::span<const vec3> b, std::span<float> out);
+void distance(std::span<const vec4> a, std::span<const vec4> b, std::span<float> out);
+
+// vec3: points with w = 1 through the affine part of m (the last row is ignored).
+// vec4: the full product m * v.
+void transform_points(const mat4x4 &m, std::span<const vec3> in, std::span<vec3> out);
+void transform_points(const mat4x4 &m, std::span<const vec3> in, const vec3_soa &out);
+void transform_points(const mat4x4 &m, std::span<const vec4> in, std::span<vec4> out);
+void transform_points(const mat4x4 &m, std::span<const vec4> in, const vec4_soa &out);
+
+} // namespace math
+
+#endif // AOS_SOA_HPP
@@ -0,0 +1,467 @@
+#include "bounding_volumes.hpp"
+
+#include "../parallel/parallel_for.hpp"
+#include "../simd/vec3_block.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+static_assert(sizeof(math::vec3) == 3 * sizeof(float), "vec3 arrays are read as packed floats");
+static_assert(sizeof(math::aabb) == 6 * sizeof(float), "aabb arrays are read as packed floats");
+
+namespace {
+
+using math::simd::f32x4;
+using math::simd::f32x8;
+
+constexpr std::size_t block = 8;
+constexpr std::size_t cluster_chunk = 256;
+// Batches with fewer clusters than this are fitted on the calling thread.
+constexpr std::size_t parallel_threshold = 4096;
+constexpr float infinity = std::numeric_limits<float>::infinity();
+
+// Points [i, i + n) of p, n <= 8. A partial block repeats point 0, which leaves bounds,
+// extremes and farthest points unchanged.
+inline void load_points(const float *p, std::size_t i, std::size_t n, f32x8 (&v)[3]) {
+    if (n == block) [[likely]] {
+        math::simd::load_vec3x8(p + 3 * i, v);
+        return;
+    }
+    float scratch[3 * block];
+    for (std::size_t k = 0; k < block; ++k) {
+        const float *src = k < n ? p + 3 * (i + k) : p;
+        std::copy(src, src + 3, scratch + 3 * k);
+    }
+    math::simd::load_vec3x8(scratch, v);
+}
+
+inline math::vec3 point(const float *p, std::size_t i) {
+    return math::vec3(p[3 * i], p[3 * i + 1], p[3 * i + 2]);
+}
+
+math::aabb fit(const float *p, std::size_t n) {
+    f32x8 lo[3] = {f32x8(p[0]), f32x8(p[1]), f32x8(p[2])};
+    f32x8 hi[3] = {lo[0], lo[1], lo[2]};
+    for (std::size_t i = 0; i < n; i += block) {
+        f32x8 v[3];
+        load_points(p, i, std::min(block, n - i), v);
+        for (int c = 0; c < 3; ++c) {
+            lo[c] = min(lo[c], v[c]);
+            hi[c] = max(hi[c], v[c]);
+        }
+    }
+    return {math::vec3(reduce_min(lo[0]), reduce_min(lo[1]), reduce_min(lo[2])),
+            math::vec3(reduce_max(hi[0]), reduce_max(hi[1]), reduce_max(hi[2]))};
+}
+
+// Extreme points are found in two passes: the extreme value, then the first point that
+// reaches it. Tracking indices in lanes doubles the register state of the first pass, and the
+// second pass usually stops early while the points are still in L1.
+inline f32x8 distance_sq(const f32x8 (&v)[3], const f32x8 (&q)[3]) {
+    const f32x8 d[3] = {v[0] - q[0], v[1] - q[1], v[2] - q[2]};
+    return fmadd(d[0], d[0], fmadd(d[1], d[1], d[2] * d[2]));
+}
+
+// Index of the first point reaching `value` under the per-block `measure`; 0 if none does
+// (NaN input). Padded lanes repeat point 0, which an earlier lane has already matched.
+template <typename Measure>
+std::size_t first_reaching(const float *p, std::size_t n, float value, Measure measure) {
+    for (std::size_t i = 0; i < n; i += block) {
+        f32x8 v[3];
+        load_points(p, i, std::min(block, n - i), v);
+        if (const unsigned hits = bits(measure(v) == f32x8(value))) {
+            return i + std::countr_zero(hits);
+        }
+    }
+    return 0;
+}
+
+std::size_t farthest_from(const float *p, std::size_t n, const math::vec3 &q) {
+    const f32x8 k[3] = {f32x8(q.x()), f32x8(q.y()), f32x8(q.z())};
+    f32x8 farthest(0.0f);
+    for (std::size_t i = 0; i < n; i += block) {
+        f32x8 v[3];
+        load_points(p, i, std::min(block, n - i), v);
+        farthest = max(farthest, distance_sq(v, k));
+    }
+    return first_reaching(p, n, reduce_max(farthest),
+                          [&](const f32x8 (&v)[3]) { return distance_sq(v, k); });
+}
+
+struct sphere {
+    float c[3];
+    float r;
+
+    math::bounding_sphere to_bounding_sphere() const {
+        return {math::vec3(c[0], c[1], c[2]), r};
+    }
+};
+
+// Ritter's growth pass: every point outside moves the sphere towards it just enough to cover
+// it. Blocks with no point outside are skipped with one compare.
+void grow(const float *p, std::size_t n, sphere &s) {
+    for (std::size_t i = 0; i < n; i += block) {
+        const std::size_t count = std::min(block, n - i);
+        f32x8 v[3];
+        load_points(p, i, count, v);
+        const f32x8 d[3] = {v[0] - f32x8(s.c[0]), v[1] - f32x8(s.c[1]), v[2] - f32x8(s.c[2])};
+        const f32x8 dist_sq = fmadd(d[0], d[0], fmadd(d[1], d[1], d[2] * d[2]));
+        if (none(dist_sq > f32x8(s.r * s.r))) [[likely]] {
+            continue;
+        }
+        for (std::size_t k = 0; k < count; ++k) {
+            const float *q = p + 3 * (i + k);
+            const float dx = q[0] - s.c[0], dy = q[1] - s.c[1], dz = q[2] - s.c[2];
+            const float dist_sq_k = dx * dx + dy * dy + dz * dz;
+            if (dist_sq_k > s.r * s.r) {
+                const float dist = std::sqrt(dist_sq_k);
+                const float r = 0.5f * (s.r + dist);
+                const float shift = (r - s.r) / dist;
+                s.c[0] += dx * shift;
+                s.c[1] += dy * shift;
+                s.c[2] += dz * shift;
+                s.r = r;
+            }
+        }
+    }
+}
+
+sphere ritter(const float *p, std::size_t n) {
+    const math::vec3 a = point(p, farthest_from(p, n, point(p, 0)));
+    const math::vec3 b = point(p, farthest_from(p, n, a));
+    const math::vec3 center = (a + b) * 0.5f;
+    sphere s{{center.x(), center.y(), center.z()}, 0.5f * a.distance_to(b)};
+    grow(p, n, s);
+    return s;
+}
+
+// ---- exact minimal ball of a few points (Welzl), in double ----
+
+struct dpoint {
+    double v[3];
+};
+
+struct ball {
+    double c[3];
+    double r_sq;
+};
+
+inline double dot(const double *a, const double *b) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+inline void cross(const double *a, const double *b, double *out) {
+    out[0] = a[1] * b[2] - a[2] * b[1];
+    out[1] = a[2] * b[0] - a[0] * b[2];
+    out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+inline double distance_sq(const double *a, const double *b) {
+    const double d[3] = {a[0] - b[0], a[1] - b[1], a[2] - b[2]};
+    return dot(d, d);
+}
+
+inline bool contains(const ball &b, const dpoint &p) {
+    return distance_sq(b.c, p.v) <= b.r_sq * (1.0 + 1e-10);
+}
+
+ball ball_of_two(const dpoint &a, const dpoint &b) {
+    ball result;
+    for (int c = 0; c < 3; ++c) {
+        result.c[c] = 0.5 * (a.v[c] + b.v[c]);
+    }
+    result.r_sq = distance_sq(result.c, a.v);
+    return result;
+}
+
+// Circumcircle; a degenerate (collinear) triangle gets the ball of its widest pair.
+ball ball_of_three(const dpoint &p0, const dpoint &p1, const dpoint &p2) {
+    const double a[3] = {p1.v[0] - p0.v[0], p1.v[1] - p0.v[1], p1.v[2] - p0.v[2]};
+    const double b[3] = {p2.v[0] - p0.v[0], p2.v[1] - p0.v[1], p2.v[2] - p0.v[2]};
+    double n[3];
+    cross(a, b, n);
+    const double n_sq = dot(n, n);
+    if (n_sq <= 1e-24 * dot(a, a) * dot(b, b)) [[unlikely]] {
+        ball best = ball_of_two(p0, p1);
+        for (const ball &candidate : {ball_of_two(p0, p2), ball_of_two(p1, p2)}) {
+            if (candidate.r_sq > best.r_sq) {
+                best = candidate;
+            }
+        }
+        return best;
+    }
+    double bn[3], na[3];
+    cross(b, n, bn);
+    cross(n, a, na);
+    const double a_sq = dot(a, a), b_sq = dot(b, b), scale = 0.5 / n_sq;
+    ball result;
+    for (int c = 0; c < 3; ++c) {
+        result.c[c] = p0.v[c] + (a_sq * bn[c] + b_sq * na[c]) * scale;
+    }
+    result.r_sq = distance_sq(result.c, p0.v);
+    return result;
+}
+
+// Circumsphere; a degenerate (coplanar) tetrahedron falls back to its first three points.
+ball ball_of_four(const dpoint &p0, const dpoint &p1, const dpoint &p2, const dpoint &p3) {
+    double e[3][3];
+    for (int c = 0; c < 3; ++c) {
+        e[0][c] = p1.v[c] - p0.v[c];
+        e[1][c] = p2.v[c] - p0.v[c];
+        e[2][c] = p3.v[c] - p0.v[c];
+    }
+    double bc[3], ca[3], ab[3];
+    cross(e[1], e[2], bc);
+    cross(e[2], e[0], ca);
+    cross(e[0], e[1], ab);
+    const double det = dot(e[0], bc);
+    const double scale = std::sqrt(dot(e[0], e[0]) * dot(e[1], e[1]) * dot(e[2], e[2]));
+    if (std::abs(det) <= 1e-12 * scale) [[unlikely]] {
+        return ball_of_three(p0, p1, p2);
+    }
+    const double h0 = 0.5 * dot(e[0], e[0]), h1 = 0.5 * dot(e[1], e[1]),
+                 h2 = 0.5 * dot(e[2], e[2]);
+    ball result;
+    for (int c = 0; c < 3; ++c) {
+        result.c[c] = p0.v[c] + (h0 * bc[c] + h1 * ca[c] + h2 * ab[c]) / det;
+    }
+    result.r_sq = distance_sq(result.c, p0.v);
+    return result;
+}
+
+ball ball_of(const dpoint *support, int count) {
+    switch (count) {
+    case 0:
+        return {{0.0, 0.0, 0.0}, -1.0};
+    case 1:
+        return {{support[0].v[0], support[0].v[1], support[0].v[2]}, 0.0};
+    case 2:
+        return ball_of_two(support[0], support[1]);
+    case 3:
+        return ball_of_three(support[0], support[1], support[2]);
+    default:
+        return ball_of_four(support[0], support[1], support[2], support[3]);
+    }
+}
+
+// Smallest ball containing points[0, n) with support[0, k) on its boundary.
+ball welzl(const dpoint *points, int n, dpoint *support, int k) {
+    ball b = ball_of(support, k);
+    if (k == 4) {
+        return b;
+    }
+    for (int i = 0; i < n; ++i) {
+        if (!contains(b, points[i])) {
+            support[k] = points[i];
+            b = welzl(points, i, support, k + 1);
+        }
+    }
+    return b;
+}
+
+// EPOS-14 directions: the axes and the four cube diagonals, unnormalized (only the order of
+// the projections matters).
+constexpr int direction_count = 7;
+constexpr float direction_length_sq[direction_count] = {1, 1, 1, 3, 3, 3, 3};
+
+inline void project(const f32x8 (&v)[3], f32x8 (&out)[direction_count]) {
+    const f32x8 xy = v[0] + v[1], x_y = v[0] - v[1];
+    out[0] = v[0];
+    out[1] = v[1];
+    out[2] = v[2];
+    out[3] = xy + v[2];
+    out[4] = xy - v[2];
+    out[5] = x_y + v[2];
+    out[6] = x_y - v[2];
+}
+
+sphere epos(const float *p, std::size_t n) {
+    f32x8 lane_lo[direction_count], lane_hi[direction_count];
+    for (int d = 0; d < direction_count; ++d) {
+        lane_lo[d] = f32x8(infinity);
+        lane_hi[d] = f32x8(-infinity);
+    }
+    for (std::size_t i = 0; i < n; i += block) {
+        f32x8 v[3], projection[direction_count];
+        load_points(p, i, std::min(block, n - i), v);
+        project(v, projection);
+        for (int d = 0; d < direction_count; ++d) {
+            lane_lo[d] = min(lane_lo[d], projection[d]);
+            lane_hi[d] = max(lane_hi[d], projection[d]);
+        }
+    }
+    float lo[direction_count], hi[direction_count];
+    for (int d = 0; d < direction_count; ++d) {
+        lo[d] = reduce_min(lane_lo[d]);
+        hi[d] = reduce_max(lane_hi[d]);
+    }
+
+    // Extreme point 2d is the first at lo[d], 2d + 1 the first at hi[d].
+    std::size_t extreme_index[2 * direction_count] = {};
+    unsigned missing = (1u << (2 * direction_count)) - 1;
+    for (std::size_t i = 0; i < n && missing != 0; i += block) {
+        f32x8 v[3], projection[direction_count];
+        load_points(p, i, std::min(block, n - i), v);
+        project(v, projection);
+        unsigned found = 0;
+        for (int d = 0; d < direction_count; ++d) {
+            found |= (any(projection[d] == f32x8(lo[d])) ? 1u : 0u) << (2 * d);
+            found |= (any(projection[d] == f32x8(hi[d])) ? 1u : 0u) << (2 * d + 1);
+        }
+        for (found &= missing; found != 0; found &= found - 1) {
+            const int k = std::countr_zero(found);
+            const f32x8 target(k % 2 ? hi[k / 2] : lo[k / 2]);
+            extreme_index[k] = i + std::countr_zero(bits(projection[k / 2] == target));
+            missing &= ~(1u << k);
+        }
+    }
+
+    // Points are often extreme along several directions; each enters the exact ball once.
+    // The widest pair goes first: it is usually on the boundary, so the balls built for the
+    // first few points already hold the rest and Welzl rarely restarts.
+    int widest = 0;
+    for (int d = 1; d < direction_count; ++d) {
+        const float spread = hi[d] - lo[d], widest_spread = hi[widest] - lo[widest];
+        if (spread * spread * direction_length_sq[widest] >
+            widest_spread * widest_spread * direction_length_sq[d]) {
+            widest = d;
+        }
+    }
+    std::size_t index[2 * direction_count] = {extreme_index[2 * widest], extreme_index[2 * widest + 1]};
+    int count = index[0] == index[1] ? 1 : 2;
+    for (const std::size_t i : extreme_index) {
+        if (std::find(index, index + count, i) == index + count) {
+            index[count++] = i;
+        }
+    }
+    dpoint extremes[2 * direction_count];
+    for (int k = 0; k < count; ++k) {
+        const float *q = p + 3 * index[k];
+        extremes[k] = {{q[0], q[1], q[2]}};
+    }
+    dpoint support[4];
+    const ball b = welzl(extremes, count, support, 0);
+    sphere s{{static_cast<float>(b.c[0]), static_cast<float>(b.c[1]), static_cast<float>(b.c[2])},
+             static_cast<float>(std::sqrt(b.r_sq))};
+    grow(p, n, s);
+    return s;
+}
+
+const float *checked_points(std::span<const math::vec3> points) {
+    if (points.empty()) [[unlikely]] {
+        throw std::invalid_argument("Point set is empty");
+    }
+    return reinterpret_cast<const float *>(points.data());
+}
+
+template <typename Result, typename Fit>
+void fit_clusters(std::span<const math::vec3> points, std::span<const std::uint32_t> offsets,
+                  std::span<Result> out, unsigned thread_count, Fit fit_one) {
+    if (offsets.empty() || out.size() != offsets.size() - 1) [[unlikely]] {
+        throw std::invalid_argument("Expected one more cluster offset than outputs");
+    }
+    for (std::size_t c = 0; c < out.size(); ++c) {
+        if (offsets[c + 1] <= offsets[c] || offsets[c + 1] > points.size()) [[unlikely]] {
+            throw std::invalid_argument("Cluster offsets are out of range");
+        }
+    }
+    const float *p = reinterpret_cast<const float *>(points.data());
+    if (out.size() < parallel_threshold) {
+        thread_count = 1;
+    }
+    math::parallel::for_each_chunk(
+        out.size(), cluster_chunk,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t c = begin; c < end; ++c) {
+                out[c] = fit_one(p + 3 * std::size_t(offsets[c]), offsets[c + 1] - offsets[c]);
+            }
+        },
+        thread_count);
+}
+
+// Columns of the affine part, and their absolute values.
+struct arvo_matrix {
+    f32x4 column[4];
+    f32x4 abs_column[3];
+
+    explicit arvo_matrix(const math::mat4x4 &m) {
+        for (int r = 0; r < 4; ++r) {
+            column[r] = f32x4::load(m.data() + 4 * r);
+        }
+        math::simd::transpose4(column[0], column[1], column[2], column[3]);
+        for (int c = 0; c < 3; ++c) {
+            abs_column[c] = abs(column[c]);
+        }
+    }
+
+    math::aabb apply(const math::aabb &box) const {
+        const float *b = reinterpret_cast<const float *>(&box);
+        const f32x4 lo = f32x4::loadu(b);                                // min.xyz, max.x
+        const f32x4 hi = shuffle<1, 2, 3, 3>(f32x4::loadu(b + 2));      // max.xyz
+        const f32x4 center = (lo + hi) * 0.5f, extent = (hi - lo) * 0.5f;
+        f32x4 c = column[3], e = abs_column[0] * math::simd::broadcast_lane<0>(extent);
+        c = fmadd(column[0], math::simd::broadcast_lane<0>(center), c);
+        c = fmadd(column[1], math::simd::broadcast_lane<1>(center), c);
+        c = fmadd(column[2], math::simd::broadcast_lane<2>(center), c);
+        e = fmadd(abs_column[1], math::simd::broadcast_lane<1>(extent), e);
+        e = fmadd(abs_column[2], math::simd::broadcast_lane<2>(extent), e);
+        float out[8];
+        (c - e).storeu(out);
+        (c + e).storeu(out + 4);
+        return {math::vec3(out[0], out[1], out[2]), math::vec3(out[4], out[5], out[6])};
+    }
+};
+
+} // namespace
+
+namespace math {
+
+aabb fit_aabb(std::span<const vec3> points) { return fit(checked_points(points), points.size()); }
+
+bounding_sphere ritter_sphere(std::span<const vec3> points) {
+    return ritter(checked_points(points), points.size()).to_bounding_sphere();
+}
+
+bounding_sphere epos_sphere(std::span<const vec3> points) {
+    return epos(checked_points(points), points.size()).to_bounding_sphere();
+}
+
+aabb transform_aabb(const mat4x4 &m, const aabb &box) { return arvo_matrix(m).apply(box); }
+
+void fit_aabbs(std::span<const vec3> points, std::span<const std::uint32_t> offsets,
+               std::span<aabb> out, unsigned thread_count) {
+    fit_clusters(points, offsets, out, thread_count, fit);
+}
+
+void ritter_spheres(std::span<const vec3> points, std::span<const std::uint32_t> offsets,
+                    std::span<bounding_sphere> out, unsigned thread_count) {
+    fit_clusters(points, offsets, out, thread_count, [](const float *p, std::size_t n) {
+        return ritter(p, n).to_bounding_sphere();
+    });
+}
+
+void epos_spheres(std::span<const vec3> points, std::span<const std::uint32_t> offsets,
+                  std::span<bounding_sphere> out, unsigned thread_count) {
+    fit_clusters(points, offsets, out, thread_count, [](const float *p, std::size_t n) {
+        return epos(p, n).to_bounding_sphere();
+    });
+}
+
+void transform_aabbs(const mat4x4 &m, std::span<const aabb> boxes, std::span<aabb> out) {
+    const arvo_matrix arvo(m);
+    for (std::size_t i = 0; i < boxes.size(); ++i) {
+        out[i] = arvo.apply(boxes[i]);
+    }
+}
+
+void transform_aabbs(std::span<const mat4x4> matrices, std::span<const aabb> boxes,
+                     std::span<aabb> out) {
+    for (std::size_t i = 0; i < boxes.size(); ++i) {
+        out[i] = arvo_matrix(matrices[i]).apply(boxes[i]);
+    }
+}
+
+} // namespace math
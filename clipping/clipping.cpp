@@ -0,0 +1,224 @@
+#include "clipping.hpp"
+
+#include "../simd/simd.hpp"
+
+#include <algorithm>
+
+static_assert(sizeof(math::vec4) == 4 * sizeof(float), "vec4 arrays are read as packed floats");
+
+namespace {
+
+using math::simd::f32x4;
+using math::simd::f32x8;
+
+// Outcode bits, one per plane: 0..2 for x, y, z below their lower bound and 3..5 for x, y, z
+// above their upper bound. The low byte tests the view volume, the high byte the clip volume
+// (x and y widened by the guard band).
+constexpr std::uint16_t frustum_mask = 0x003F;
+constexpr int clip_shift = 8;
+constexpr int plane_count = 6;
+// Each clip plane adds at most one vertex to the polygon.
+constexpr int max_polygon = 3 + plane_count;
+constexpr std::uint32_t new_vertex = 0xFFFFFFFFu;
+
+struct polygon_vertex {
+    float p[4];
+    std::uint32_t index;
+};
+
+inline std::uint16_t compute_outcode(const float *v, float guard_band) {
+    const float w = v[3];
+    int code = 0;
+    for (int c = 0; c < 3; ++c) {
+        const float gw = (c < 2) ? guard_band * w : w;
+        code |= (v[c] < -w) << c;
+        code |= (v[c] > w) << (c + 3);
+        code |= (v[c] < -gw) << (c + clip_shift);
+        code |= (v[c] > gw) << (c + 3 + clip_shift);
+    }
+    return static_cast<std::uint16_t>(code);
+}
+
+void compute_outcodes(const float *positions, std::size_t count, float guard_band,
+                      std::uint16_t *out) {
+    std::size_t i = 0;
+#if MATH_SIMD_LEVEL >= 1
+    // Eight vertices per step, transposed so each comparison tests one plane of all eight. The
+    // codes are summed as floats (every bit is distinct and below 2^16, so exactly) and
+    // narrowed lane by lane. The scalar backend uses the per-vertex loop below instead.
+    const f32x8 zero(0.0f);
+    for (; i + 8 <= count; i += 8) {
+        const float *p = positions + 4 * i;
+        f32x8 x(f32x4::loadu(p), f32x4::loadu(p + 16));
+        f32x8 y(f32x4::loadu(p + 4), f32x4::loadu(p + 20));
+        f32x8 z(f32x4::loadu(p + 8), f32x4::loadu(p + 24));
+        f32x8 w(f32x4::loadu(p + 12), f32x4::loadu(p + 28));
+        math::simd::transpose4(x, y, z, w);
+        const f32x8 neg_w = -w;
+        const f32x8 gw = w * guard_band;
+        const f32x8 neg_gw = -gw;
+
+        const f32x8::mask planes[12] = {x < neg_w,  y < neg_w,  z < neg_w, x > w,  y > w,  z > w,
+                                        x < neg_gw, y < neg_gw, z < neg_w, x > gw, y > gw, z > w};
+        f32x8 code = zero;
+        for (int k = 0; k < 12; ++k) {
+            const int bit = (k < 6) ? k : k - 6 + clip_shift;
+            code += select(planes[k], f32x8(static_cast<float>(1 << bit)), zero);
+        }
+        alignas(32) float codes[8];
+        code.store(codes);
+        for (int l = 0; l < 8; ++l) {
+            out[i + l] = static_cast<std::uint16_t>(codes[l]);
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = compute_outcode(positions + 4 * i, guard_band);
+    }
+}
+
+// Signed distance to clip plane `plane`, >= 0 inside.
+inline float plane_distance(const float *v, int plane, float guard_band) {
+    switch (plane) {
+    case 0:
+        return v[0] + guard_band * v[3];
+    case 1:
+        return v[1] + guard_band * v[3];
+    case 2:
+        return v[2] + v[3];
+    case 3:
+        return guard_band * v[3] - v[0];
+    case 4:
+        return guard_band * v[3] - v[1];
+    default:
+        return v[3] - v[2];
+    }
+}
+
+// One Sutherland-Hodgman pass. Intersections are always interpolated from the inside vertex
+// towards the outside one, so two triangles sharing an edge produce the same new vertex.
+int clip_polygon(const polygon_vertex *in, int count, int plane, float guard_band,
+                 polygon_vertex *out) {
+    int out_count = 0;
+    for (int i = 0; i < count; ++i) {
+        const polygon_vertex &a = in[i];
+        const polygon_vertex &b = in[(i + 1) % count];
+        const float da = plane_distance(a.p, plane, guard_band);
+        const float db = plane_distance(b.p, plane, guard_band);
+        if (da >= 0.0f) {
+            out[out_count++] = a;
+        }
+        if ((da >= 0.0f) != (db >= 0.0f)) {
+            const polygon_vertex &inside = (da >= 0.0f) ? a : b;
+            const polygon_vertex &outside = (da >= 0.0f) ? b : a;
+            const float d_in = (da >= 0.0f) ? da : db;
+            const float d_out = (da >= 0.0f) ? db : da;
+            const float t = d_in / (d_in - d_out);
+            polygon_vertex &v = out[out_count++];
+            for (int c = 0; c < 4; ++c) {
+                v.p[c] = inside.p[c] + (outside.p[c] - inside.p[c]) * t;
+            }
+            v.index = new_vertex;
+        }
+    }
+    return out_count;
+}
+
+} // namespace
+
+namespace math {
+
+triangle_clipper::triangle_clipper(float guard_band) : m_guard_band(guard_band) {}
+
+void triangle_clipper::clip(std::span<const vec4> clip_positions,
+                            std::span<const std::uint32_t> indices) {
+    const float guard_band = m_guard_band;
+    const std::size_t triangle_count = indices.size() / 3;
+
+    m_outcodes.resize(clip_positions.size());
+    const float *positions = reinterpret_cast<const float *>(clip_positions.data());
+    compute_outcodes(positions, clip_positions.size(), guard_band, m_outcodes.data());
+
+    const std::size_t first_added = clip_positions.size();
+    m_vertices.clear();
+    m_indices.resize(indices.size());
+    m_triangle_ids.resize(triangle_count);
+
+    std::size_t written = 0;
+    for (std::size_t t = 0; t < triangle_count; ++t) {
+        const std::uint32_t i0 = indices[3 * t];
+        const std::uint32_t i1 = indices[3 * t + 1];
+        const std::uint32_t i2 = indices[3 * t + 2];
+        const std::uint16_t c0 = m_outcodes[i0];
+        const std::uint16_t c1 = m_outcodes[i1];
+        const std::uint16_t c2 = m_outcodes[i2];
+
+        if ((c0 & c1 & c2 & frustum_mask) != 0) {
+            continue;
+        }
+        const int planes = (c0 | c1 | c2) >> clip_shift;
+        if (planes == 0) [[likely]] {
+            if (m_indices.size() < 3 * written + 3) [[unlikely]] {
+                m_indices.resize(3 * written + 3);
+                m_triangle_ids.resize(written + 1);
+            }
+            m_indices[3 * written] = i0;
+            m_indices[3 * written + 1] = i1;
+            m_indices[3 * written + 2] = i2;
+            m_triangle_ids[written] = static_cast<std::uint32_t>(t);
+            ++written;
+            continue;
+        }
+
+        polygon_vertex buffers[2][max_polygon];
+        const std::uint32_t corners[3] = {i0, i1, i2};
+        for (int k = 0; k < 3; ++k) {
+            std::copy(positions + 4 * corners[k], positions + 4 * corners[k] + 4, buffers[0][k].p);
+            buffers[0][k].index = corners[k];
+        }
+        int count = 3;
+        int current = 0;
+        for (int plane = 0; plane < plane_count && count >= 3; ++plane) {
+            if (planes & (1 << plane)) {
+                count = clip_polygon(buffers[current], count, plane, guard_band, buffers[current ^ 1]);
+                current ^= 1;
+            }
+        }
+        if (count < 3) {
+            continue;
+        }
+
+        polygon_vertex *polygon = buffers[current];
+        for (int k = 0; k < count; ++k) {
+            if (polygon[k].index == new_vertex) {
+                polygon[k].index = static_cast<std::uint32_t>(first_added + m_vertices.size());
+                m_vertices.emplace_back(polygon[k].p[0], polygon[k].p[1], polygon[k].p[2], polygon[k].p[3]);
+            }
+        }
+        // Fan triangulation keeps the winding of the input triangle.
+        const std::size_t needed = written + count - 2;
+        if (m_triangle_ids.size() < needed) {
+            m_indices.resize(3 * needed);
+            m_triangle_ids.resize(needed);
+        }
+        for (int k = 1; k + 1 < count; ++k) {
+            m_indices[3 * written] = polygon[0].index;
+            m_indices[3 * written + 1] = polygon[k].index;
+            m_indices[3 * written + 2] = polygon[k + 1].index;
+            m_triangle_ids[written] = static_cast<std::uint32_t>(t);
+            ++written;
+        }
+    }
+    m_indices.resize(3 * written);
+    m_triangle_ids.resize(written);
+}
+
+std::span<const vec4> triangle_clipper::added_vertices() const { return m_vertices; }
+
+std::span<const std::uint32_t> triangle_clipper::indices() const { return m_indices; }
+
+std::span<const std::uint32_t> triangle_clipper::triangle_ids() const { return m_triangle_ids; }
+
+std::size_t triangle_clipper::triangle_count() const { return m_triangle_ids.size(); }
+
+} // namespace math
@@ -0,0 +1,45 @@
+#ifndef CLIPPING_HPP
+#define CLIPPING_HPP
+
+#include "../vec4/vec4.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace math {
+
+// Clips indexed triangles against the view volume -w <= x, y, z <= w in homogeneous clip
+// space, before the perspective divide. Per-vertex outcodes decide the common cases: a
+// triangle with all vertices inside is copied as is, one with all vertices outside the same
+// plane is dropped, and only the rest go through Sutherland-Hodgman. The result is a compact
+// index buffer: indices below clip_positions.size() refer to the input vertices, larger ones
+// to added_vertices()[index - clip_positions.size()], so input vertices are never copied.
+class triangle_clipper {
+  public:
+    // x and y are clipped against +-guard_band * w instead of +-w. A rasterizer with a guard
+    // band can pass its size in NDC units so that triangles merely crossing the screen edges
+    // are kept whole; they are still dropped when entirely off screen.
+    explicit triangle_clipper(float guard_band = 1.0f);
+
+    void clip(std::span<const vec4> clip_positions, std::span<const std::uint32_t> indices);
+
+    // Vertices created by clipping.
+    std::span<const vec4> added_vertices() const;
+    std::span<const std::uint32_t> indices() const;
+    // Input triangle each output triangle came from.
+    std::span<const std::uint32_t> triangle_ids() const;
+    std::size_t triangle_count() const;
+
+  private:
+    float m_guard_band;
+    std::vector<std::uint16_t> m_outcodes;
+    std::vector<vec4> m_vertices;
+    std::vector<std::uint32_t> m_indices;
+    std::vector<std::uint32_t> m_triangle_ids;
+};
+
+} // namespace math
+
+#endif // CLIPPING_HPP
@@ -0,0 +1,676 @@
+#include "convex_hull.hpp"
+
+#include "../parallel/parallel_for.hpp"
+#include "../predicates/predicates.hpp"
+#include "../simd/simd.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+static_assert(sizeof(math::vec3) == 3 * sizeof(float), "vec3 arrays are read as packed floats");
+
+namespace {
+
+using math::simd::f32x8;
+using math::simd::i32x8;
+
+constexpr std::size_t chunk_size = 16384;
+// Point sets smaller than this are processed on the calling thread.
+constexpr std::size_t parallel_threshold = 65536;
+constexpr std::uint32_t no_face = 0xFFFFFFFFu;
+constexpr float lowest = -std::numeric_limits<float>::infinity();
+constexpr std::int32_t lane_offsets[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+
+// Triangle of the hull under construction. Edge k runs from vertex[k] to vertex[(k + 1) % 3];
+// its opposite half-edge is edge twin[k] % 3 of face twin[k] / 3.
+struct face {
+    float normal[3];
+    float offset;
+    std::uint32_t vertex[3];
+    std::uint32_t twin[3];
+    std::uint32_t farthest;
+    float farthest_distance;
+    std::uint32_t visit;
+    bool visible;
+    bool alive;
+};
+
+struct search_step {
+    std::uint32_t face;
+    int entry; // edge the face was entered through
+    int step;  // edges of the face visited so far
+};
+
+struct candidate {
+    float value;
+    std::uint32_t index;
+};
+
+// Ties go to the lower index so results do not depend on the thread count.
+inline bool better(const candidate &a, const candidate &b) {
+    return a.value > b.value || (a.value == b.value && a.index < b.index);
+}
+
+class hull_builder {
+  public:
+    hull_builder(std::span<const math::vec3> points, unsigned thread_count);
+
+    void build(std::vector<std::uint32_t> &indices);
+
+  private:
+    float distance(const face &f, std::uint32_t point) const;
+    // Exact: true when the point lies strictly above the plane through the face's vertices.
+    bool sees(const face &f, std::uint32_t point) const;
+    unsigned threads_for(std::size_t count) const;
+
+    // Index and value of the largest metric over all points, for N metrics in one pass.
+    // simd(x, y, z, out) fills N registers, scalar(x, y, z, out) N floats.
+    template <std::size_t N, typename Simd, typename Scalar>
+    std::array<candidate, N> argmax(Simd &&simd, Scalar &&scalar) const;
+
+    std::uint32_t add_face(std::uint32_t a, std::uint32_t b, std::uint32_t c);
+    void release_face(std::uint32_t f);
+    void create_simplex();
+    // Moves every point in ids (all points when ids is null) to the conflict list of the first
+    // target face it lies above; points above none are inside and dropped.
+    void assign(const std::uint32_t *ids, std::size_t count, std::span<const std::uint32_t> targets);
+    void classify(const std::uint32_t *ids, std::size_t begin, std::size_t end);
+    bool find_horizon(std::uint32_t start, std::uint32_t eye);
+    void add_point(std::uint32_t f);
+    void drop_point(std::uint32_t f, std::uint32_t point);
+    void push_work(std::uint32_t f);
+
+    std::size_t m_count;
+    unsigned m_threads;
+    float m_epsilon;
+    std::vector<float> m_x, m_y, m_z;
+
+    // Face pool: released slots are reused, and so is the capacity of their conflict lists.
+    std::vector<face> m_faces;
+    std::vector<std::vector<std::uint32_t>> m_conflicts;
+    std::vector<std::uint32_t> m_free;
+    // Faces with conflicts as (conflict count, face), a max-heap; entries of faces released
+    // since are skipped when they come up.
+    std::vector<std::pair<std::size_t, std::uint32_t>> m_work;
+    std::uint32_t m_stamp;
+
+    std::vector<std::uint32_t> m_slot;
+    std::vector<float> m_dist;
+    std::vector<float> m_planes;
+    std::vector<std::size_t> m_counts;
+    std::vector<candidate> m_best;
+    std::vector<std::uint32_t> m_pending;
+    std::vector<std::uint32_t> m_visible;
+    std::vector<std::uint32_t> m_horizon;
+    std::vector<search_step> m_stack;
+    std::vector<std::uint32_t> m_loop_check;
+    std::vector<std::uint32_t> m_new_faces;
+};
+
+hull_builder::hull_builder(std::span<const math::vec3> points, unsigned thread_count)
+    : m_count(points.size()),
+      m_threads(thread_count ? thread_count : math::parallel::default_thread_count()),
+      m_epsilon(0.0f), m_x(points.size()), m_y(points.size()), m_z(points.size()), m_stamp(0) {
+    const float *src = reinterpret_cast<const float *>(points.data());
+    math::parallel::for_each_chunk(
+        m_count, chunk_size,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                m_x[i] = src[3 * i];
+                m_y[i] = src[3 * i + 1];
+                m_z[i] = src[3 * i + 2];
+            }
+        },
+        threads_for(m_count));
+}
+
+float hull_builder::distance(const face &f, std::uint32_t point) const {
+    return f.normal[0] * m_x[point] + f.normal[1] * m_y[point] + f.normal[2] * m_z[point] - f.offset;
+}
+
+bool hull_builder::sees(const face &f, std::uint32_t point) const {
+    auto at = [&](std::uint32_t i) { return math::vec3(m_x[i], m_y[i], m_z[i]); };
+    return math::orient3d(at(f.vertex[0]), at(f.vertex[1]), at(f.vertex[2]), at(point)) < 0;
+}
+
+unsigned hull_builder::threads_for(std::size_t count) const {
+    return count >= parallel_threshold ? m_threads : 1u;
+}
+
+template <std::size_t N, typename Simd, typename Scalar>
+std::array<candidate, N> hull_builder::argmax([[maybe_unused]] Simd &&simd, Scalar &&scalar) const {
+    const std::size_t chunk_count = (m_count + chunk_size - 1) / chunk_size;
+    std::vector<std::array<candidate, N>> partial(chunk_count);
+    math::parallel::for_each_chunk(
+        m_count, chunk_size,
+        [&](std::size_t begin, std::size_t end) {
+            std::array<candidate, N> best;
+            best.fill({lowest, 0});
+            std::size_t i = begin;
+#if MATH_SIMD_LEVEL >= 1
+            f32x8 best_value[N];
+            i32x8 best_index[N];
+            for (std::size_t n = 0; n < N; ++n) {
+                best_value[n] = f32x8(lowest);
+                best_index[n] = i32x8(0);
+            }
+            i32x8 index = i32x8(static_cast<std::int32_t>(begin)) + i32x8::loadu(lane_offsets);
+            for (; i + 8 <= end; i += 8) {
+                f32x8 value[N];
+                simd(f32x8::loadu(&m_x[i]), f32x8::loadu(&m_y[i]), f32x8::loadu(&m_z[i]), value);
+                for (std::size_t n = 0; n < N; ++n) {
+                    const f32x8::mask greater = value[n] > best_value[n];
+                    best_value[n] = select(greater, value[n], best_value[n]);
+                    best_index[n] = select(greater, index, best_index[n]);
+                }
+                index += i32x8(8);
+            }
+            for (std::size_t n = 0; n < N; ++n) {
+                alignas(32) float values[8];
+                std::int32_t indices[8];
+                best_value[n].store(values);
+                best_index[n].storeu(indices);
+                for (int lane = 0; lane < 8; ++lane) {
+                    const candidate lane_best = {values[lane], static_cast<std::uint32_t>(indices[lane])};
+                    if (i > begin && better(lane_best, best[n])) {
+                        best[n] = lane_best;
+                    }
+                }
+            }
+#endif
+            for (; i < end; ++i) {
+                float value[N];
+                scalar(m_x[i], m_y[i], m_z[i], value);
+                for (std::size_t n = 0; n < N; ++n) {
+                    if (value[n] > best[n].value) {
+                        best[n] = {value[n], static_cast<std::uint32_t>(i)};
+                    }
+                }
+            }
+            partial[begin / chunk_size] = best;
+        },
+        threads_for(m_count));
+
+    std::array<candidate, N> result = partial[0];
+    for (std::size_t c = 1; c < chunk_count; ++c) {
+        for (std::size_t n = 0; n < N; ++n) {
+            if (better(partial[c][n], result[n])) {
+                result[n] = partial[c][n];
+            }
+        }
+    }
+    return result;
+}
+
+std::uint32_t hull_builder::add_face(std::uint32_t a, std::uint32_t b, std::uint32_t c) {
+    std::uint32_t f;
+    if (!m_free.empty()) {
+        f = m_free.back();
+        m_free.pop_back();
+    } else {
+        f = static_cast<std::uint32_t>(m_faces.size());
+        m_faces.emplace_back();
+        m_conflicts.emplace_back();
+    }
+    // The plane is computed in double so long thin faces keep an accurate normal.
+    const double ux = double(m_x[b]) - m_x[a], uy = double(m_y[b]) - m_y[a], uz = double(m_z[b]) - m_z[a];
+    const double vx = double(m_x[c]) - m_x[a], vy = double(m_y[c]) - m_y[a], vz = double(m_z[c]) - m_z[a];
+    double nx = uy * vz - uz * vy, ny = uz * vx - ux * vz, nz = ux * vy - uy * vx;
+    const double length = std::sqrt(nx * nx + ny * ny + nz * nz);
+    const double inv = length > 0.0 ? 1.0 / length : 0.0;
+    nx *= inv;
+    ny *= inv;
+    nz *= inv;
+
+    face &result = m_faces[f];
+    result.normal[0] = static_cast<float>(nx);
+    result.normal[1] = static_cast<float>(ny);
+    result.normal[2] = static_cast<float>(nz);
+    result.offset = static_cast<float>(nx * m_x[a] + ny * m_y[a] + nz * m_z[a]);
+    result.vertex[0] = a;
+    result.vertex[1] = b;
+    result.vertex[2] = c;
+    result.twin[0] = result.twin[1] = result.twin[2] = no_face;
+    result.farthest = 0;
+    result.farthest_distance = lowest;
+    result.visit = 0;
+    result.visible = false;
+    result.alive = true;
+    return f;
+}
+
+void hull_builder::release_face(std::uint32_t f) {
+    m_faces[f].alive = false;
+    m_conflicts[f].clear();
+    m_free.push_back(f);
+}
+
+void hull_builder::create_simplex() {
+    if (m_count < 4) {
+        throw std::invalid_argument("Convex hull needs at least four points");
+    }
+
+    // Extreme points along the axes: max of x, -x, y, -y, z, -z.
+    const std::array<candidate, 6> extremes = argmax<6>(
+        [](f32x8 x, f32x8 y, f32x8 z, f32x8 *out) {
+            out[0] = x;
+            out[1] = -x;
+            out[2] = y;
+            out[3] = -y;
+            out[4] = z;
+            out[5] = -z;
+        },
+        [](float x, float y, float z, float *out) {
+            out[0] = x;
+            out[1] = -x;
+            out[2] = y;
+            out[3] = -y;
+            out[4] = z;
+            out[5] = -z;
+        });
+
+    // Work relative to the centre of the bounding box, so that the float plane distances of
+    // the batched classification, and the tolerance for "above a face", follow the spread of
+    // the points rather than their distance from the origin.
+    const float centre[3] = {0.5f * (extremes[0].value - extremes[1].value), 0.5f * (extremes[2].value - extremes[3].value),
+                             0.5f * (extremes[4].value - extremes[5].value)};
+    math::parallel::for_each_chunk(
+        m_count, chunk_size,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                m_x[i] -= centre[0];
+                m_y[i] -= centre[1];
+                m_z[i] -= centre[2];
+            }
+        },
+        threads_for(m_count));
+    const float extent = (extremes[0].value + extremes[1].value) + (extremes[2].value + extremes[3].value) +
+                         (extremes[4].value + extremes[5].value);
+    m_epsilon = 3.0f * FLT_EPSILON * extent;
+
+    auto distance_sq = [&](std::uint32_t a, std::uint32_t b) {
+        const double dx = double(m_x[a]) - m_x[b], dy = double(m_y[a]) - m_y[b], dz = double(m_z[a]) - m_z[b];
+        return dx * dx + dy * dy + dz * dz;
+    };
+    std::uint32_t p0 = extremes[0].index, p1 = extremes[1].index;
+    double widest = -1.0;
+    for (int i = 0; i < 6; ++i) {
+        for (int j = i + 1; j < 6; ++j) {
+            const double d = distance_sq(extremes[i].index, extremes[j].index);
+            if (d > widest) {
+                widest = d;
+                p0 = extremes[i].index;
+                p1 = extremes[j].index;
+            }
+        }
+    }
+    if (std::sqrt(widest) <= m_epsilon) {
+        throw std::invalid_argument("Convex hull input is degenerate");
+    }
+
+    // Farthest point from the line p0 p1.
+    const float ox = m_x[p0], oy = m_y[p0], oz = m_z[p0];
+    const double inv_length = 1.0 / std::sqrt(widest);
+    const float dx = static_cast<float>((double(m_x[p1]) - ox) * inv_length);
+    const float dy = static_cast<float>((double(m_y[p1]) - oy) * inv_length);
+    const float dz = static_cast<float>((double(m_z[p1]) - oz) * inv_length);
+    const std::uint32_t p2 = argmax<1>(
+        [&](f32x8 x, f32x8 y, f32x8 z, f32x8 *out) {
+            x -= f32x8(ox);
+            y -= f32x8(oy);
+            z -= f32x8(oz);
+            const f32x8 cx = fmadd(y, f32x8(dz), -(z * f32x8(dy)));
+            const f32x8 cy = fmadd(z, f32x8(dx), -(x * f32x8(dz)));
+            const f32x8 cz = fmadd(x, f32x8(dy), -(y * f32x8(dx)));
+            out[0] = fmadd(cx, cx, fmadd(cy, cy, cz * cz));
+        },
+        [&](float x, float y, float z, float *out) {
+            x -= ox;
+            y -= oy;
+            z -= oz;
+            const float cx = y * dz - z * dy, cy = z * dx - x * dz, cz = x * dy - y * dx;
+            out[0] = cx * cx + cy * cy + cz * cz;
+        })[0].index;
+    const std::uint32_t base_face = add_face(p0, p1, p2);
+    const face base = m_faces[base_face];
+    release_face(base_face);
+    if (base.normal[0] == 0.0f && base.normal[1] == 0.0f && base.normal[2] == 0.0f) {
+        throw std::invalid_argument("Convex hull input is degenerate");
+    }
+
+    // Farthest point from the plane p0 p1 p2, on either side.
+    const candidate apex = argmax<1>(
+        [&](f32x8 x, f32x8 y, f32x8 z, f32x8 *out) {
+            const f32x8 d = fmadd(x, f32x8(base.normal[0]),
+                                  fmadd(y, f32x8(base.normal[1]), fmadd(z, f32x8(base.normal[2]), f32x8(-base.offset))));
+            out[0] = abs(d);
+        },
+        [&](float x, float y, float z, float *out) {
+            out[0] = std::abs(base.normal[0] * x + base.normal[1] * y + base.normal[2] * z - base.offset);
+        })[0];
+    if (apex.value <= m_epsilon) {
+        throw std::invalid_argument("Convex hull input is degenerate");
+    }
+    const std::uint32_t p3 = apex.index;
+
+    // Four outward faces, then their twins by matching reversed edges.
+    const std::uint32_t corners[4] = {p0, p1, p2, p3};
+    std::uint32_t faces[4];
+    for (int f = 0; f < 4; ++f) {
+        std::uint32_t a = corners[(f + 1) % 4], b = corners[(f + 2) % 4], c = corners[(f + 3) % 4];
+        faces[f] = add_face(a, b, c);
+        if (sees(m_faces[faces[f]], corners[f])) {
+            release_face(faces[f]);
+            faces[f] = add_face(a, c, b);
+        }
+    }
+    for (std::uint32_t f : faces) {
+        for (int k = 0; k < 3; ++k) {
+            const std::uint32_t a = m_faces[f].vertex[k], b = m_faces[f].vertex[(k + 1) % 3];
+            for (std::uint32_t g : faces) {
+                for (int m = 0; m < 3; ++m) {
+                    if (m_faces[g].vertex[m] == b && m_faces[g].vertex[(m + 1) % 3] == a) {
+                        m_faces[f].twin[k] = 3 * g + m;
+                    }
+                }
+            }
+        }
+    }
+
+    assign(nullptr, m_count, faces);
+    for (std::uint32_t f : faces) {
+        push_work(f);
+    }
+}
+
+void hull_builder::classify(const std::uint32_t *ids, std::size_t begin, std::size_t end) {
+    const std::size_t target_count = m_planes.size() / 4;
+    const float *planes = m_planes.data();
+    std::size_t i = begin;
+#if MATH_SIMD_LEVEL >= 1
+    const f32x8 epsilon(m_epsilon);
+    const i32x8 unassigned(static_cast<std::int32_t>(no_face));
+    for (; i + 8 <= end; i += 8) {
+        f32x8 x, y, z;
+        if (ids != nullptr) {
+            const std::int32_t *index = reinterpret_cast<const std::int32_t *>(ids + i);
+            x = f32x8::gather(m_x.data(), index);
+            y = f32x8::gather(m_y.data(), index);
+            z = f32x8::gather(m_z.data(), index);
+        } else {
+            x = f32x8::loadu(&m_x[i]);
+            y = f32x8::loadu(&m_y[i]);
+            z = f32x8::loadu(&m_z[i]);
+        }
+        // no_face is -1 as int32, so the unassigned lanes are the negative ones.
+        i32x8 slot = unassigned;
+        f32x8 dist(0.0f);
+        for (std::size_t t = 0; t < target_count; ++t) {
+            const float *p = planes + 4 * t;
+            const f32x8 d = fmadd(x, f32x8(p[0]), fmadd(y, f32x8(p[1]), fmadd(z, f32x8(p[2]), f32x8(-p[3]))));
+            const f32x8::mask above = (d > epsilon) & (slot < i32x8(0));
+            slot = select(above, i32x8(static_cast<std::int32_t>(t)), slot);
+            dist = select(above, d, dist);
+            if (none(slot < i32x8(0))) {
+                break;
+            }
+        }
+        slot.storeu(reinterpret_cast<std::int32_t *>(&m_slot[i]));
+        dist.storeu(&m_dist[i]);
+    }
+#endif
+    for (; i < end; ++i) {
+        const std::uint32_t point = ids != nullptr ? ids[i] : static_cast<std::uint32_t>(i);
+        m_slot[i] = no_face;
+        for (std::size_t t = 0; t < target_count; ++t) {
+            const float *p = planes + 4 * t;
+            const float d = p[0] * m_x[point] + p[1] * m_y[point] + p[2] * m_z[point] - p[3];
+            if (d > m_epsilon) {
+                m_slot[i] = static_cast<std::uint32_t>(t);
+                m_dist[i] = d;
+                break;
+            }
+        }
+    }
+}
+
+void hull_builder::assign(const std::uint32_t *ids, std::size_t count, std::span<const std::uint32_t> targets) {
+    const std::size_t target_count = targets.size();
+    const std::size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+    const unsigned threads = threads_for(count);
+    m_slot.resize(count);
+    m_dist.resize(count);
+    m_planes.resize(4 * target_count);
+    for (std::size_t t = 0; t < target_count; ++t) {
+        const face &f = m_faces[targets[t]];
+        std::copy(f.normal, f.normal + 3, &m_planes[4 * t]);
+        m_planes[4 * t + 3] = f.offset;
+    }
+    m_counts.assign(chunk_count * target_count, 0);
+    m_best.assign(chunk_count * target_count, {lowest, 0});
+
+    // Pass 1: classify, count per (chunk, face) and track each face's farthest point.
+    math::parallel::for_each_chunk(
+        count, chunk_size,
+        [&](std::size_t begin, std::size_t end) {
+            classify(ids, begin, end);
+            std::size_t *counts = &m_counts[(begin / chunk_size) * target_count];
+            candidate *best = &m_best[(begin / chunk_size) * target_count];
+            for (std::size_t i = begin; i < end; ++i) {
+                const std::uint32_t slot = m_slot[i];
+                if (slot == no_face) {
+                    continue;
+                }
+                ++counts[slot];
+                if (m_dist[i] > best[slot].value) {
+                    best[slot] = {m_dist[i], ids != nullptr ? ids[i] : static_cast<std::uint32_t>(i)};
+                }
+            }
+        },
+        threads);
+
+    // Turn counts into write offsets inside each face's conflict list.
+    for (std::size_t t = 0; t < target_count; ++t) {
+        face &f = m_faces[targets[t]];
+        std::vector<std::uint32_t> &list = m_conflicts[targets[t]];
+        std::size_t offset = list.size();
+        for (std::size_t c = 0; c < chunk_count; ++c) {
+            const std::size_t n = m_counts[c * target_count + t];
+            m_counts[c * target_count + t] = offset;
+            offset += n;
+            const candidate &best = m_best[c * target_count + t];
+            if (best.value > f.farthest_distance) {
+                f.farthest_distance = best.value;
+                f.farthest = best.index;
+            }
+        }
+        list.resize(offset);
+    }
+
+    // Pass 2: scatter, every chunk into its own ranges.
+    math::parallel::for_each_chunk(
+        count, chunk_size,
+        [&](std::size_t begin, std::size_t end) {
+            std::size_t *offsets = &m_counts[(begin / chunk_size) * target_count];
+            for (std::size_t i = begin; i < end; ++i) {
+                const std::uint32_t slot = m_slot[i];
+                if (slot != no_face) {
+                    m_conflicts[targets[slot]][offsets[slot]++] = ids != nullptr ? ids[i] : static_cast<std::uint32_t>(i);
+                }
+            }
+        },
+        threads);
+}
+
+bool hull_builder::find_horizon(std::uint32_t start, std::uint32_t eye) {
+    // Faces the eye sees, found depth first from the start face. Each face's edges are walked
+    // counter-clockwise starting after the one it was entered through, so the edges to faces
+    // the eye does not see (the horizon) come out in loop order, stored as (from, to,
+    // opposite half-edge).
+    ++m_stamp;
+    m_visible.clear();
+    m_horizon.clear();
+    m_faces[start].visit = m_stamp;
+    m_faces[start].visible = true;
+    m_visible.push_back(start);
+    m_stack.clear();
+    m_stack.push_back({start, 0, 0});
+    while (!m_stack.empty()) {
+        search_step &top = m_stack.back();
+        if (top.step == 3) {
+            m_stack.pop_back();
+            continue;
+        }
+        const std::uint32_t f = top.face;
+        const int k = (top.entry + top.step++) % 3;
+        if (top.step == 1 && m_stack.size() > 1) {
+            continue; // the edge back to the parent
+        }
+        const std::uint32_t twin = m_faces[f].twin[k];
+        face &neighbour = m_faces[twin / 3];
+        if (neighbour.visit != m_stamp) {
+            neighbour.visit = m_stamp;
+            neighbour.visible = sees(neighbour, eye);
+            if (neighbour.visible) {
+                m_visible.push_back(twin / 3);
+                m_stack.push_back({twin / 3, static_cast<int>(twin % 3), 0});
+                continue;
+            }
+        }
+        if (!neighbour.visible) {
+            m_horizon.push_back(m_faces[f].vertex[k]);
+            m_horizon.push_back(m_faces[f].vertex[(k + 1) % 3]);
+            m_horizon.push_back(twin);
+        }
+    }
+
+    // A single loop: every edge ends where the next one starts, and no vertex repeats.
+    const std::size_t count = m_horizon.size() / 3;
+    for (std::size_t h = 0; h < count; ++h) {
+        if (m_horizon[3 * h + 1] != m_horizon[3 * ((h + 1) % count)]) {
+            return false;
+        }
+    }
+    m_loop_check.clear();
+    for (std::size_t h = 0; h < count; ++h) {
+        m_loop_check.push_back(m_horizon[3 * h]);
+    }
+    std::sort(m_loop_check.begin(), m_loop_check.end());
+    return std::adjacent_find(m_loop_check.begin(), m_loop_check.end()) == m_loop_check.end();
+}
+
+void hull_builder::add_point(std::uint32_t start) {
+    const std::uint32_t eye = m_faces[start].farthest;
+
+    // The conflict lists come from float distances; only exact tests decide what the eye
+    // sees, so the hull stays convex and the faces it sees form a disk.
+    if (!sees(m_faces[start], eye)) [[unlikely]] {
+        drop_point(start, eye);
+        return;
+    }
+    if (!find_horizon(start, eye)) [[unlikely]] {
+        throw std::runtime_error("Convex hull horizon is not a closed loop");
+    }
+
+    m_pending.clear();
+    for (std::uint32_t f : m_visible) {
+        m_pending.insert(m_pending.end(), m_conflicts[f].begin(), m_conflicts[f].end());
+        release_face(f);
+    }
+    const auto eye_slot = std::find(m_pending.begin(), m_pending.end(), eye);
+    if (eye_slot != m_pending.end()) {
+        *eye_slot = m_pending.back();
+        m_pending.pop_back();
+    }
+
+    // A cone of new faces from the eye to the horizon, linked to the rest of the hull and to
+    // each other: the edge (b, eye) of one face pairs with (eye, b) of the next.
+    m_new_faces.clear();
+    for (std::size_t h = 0; h < m_horizon.size(); h += 3) {
+        const std::uint32_t f = add_face(m_horizon[h], m_horizon[h + 1], eye);
+        const std::uint32_t outer = m_horizon[h + 2];
+        m_faces[f].twin[0] = outer;
+        m_faces[outer / 3].twin[outer % 3] = 3 * f;
+        m_new_faces.push_back(f);
+    }
+    for (std::size_t i = 0; i < m_new_faces.size(); ++i) {
+        const std::uint32_t f = m_new_faces[i];
+        const std::uint32_t next = m_new_faces[(i + 1) % m_new_faces.size()];
+        m_faces[f].twin[1] = 3 * next + 2;
+        m_faces[next].twin[2] = 3 * f + 1;
+    }
+
+    assign(m_pending.data(), m_pending.size(), m_new_faces);
+    for (std::uint32_t f : m_new_faces) {
+        push_work(f);
+    }
+}
+
+// Removes a point that rounding placed above face f although it is not, and picks the next
+// farthest of the remaining ones.
+void hull_builder::drop_point(std::uint32_t f, std::uint32_t point) {
+    std::vector<std::uint32_t> &list = m_conflicts[f];
+    list.erase(std::find(list.begin(), list.end(), point));
+    face &target = m_faces[f];
+    target.farthest_distance = lowest;
+    for (std::uint32_t p : list) {
+        const float d = distance(target, p);
+        if (d > target.farthest_distance) {
+            target.farthest_distance = d;
+            target.farthest = p;
+        }
+    }
+    push_work(f);
+}
+
+// Faces with the most conflicts go first. Taking the newest face instead lets eyes barely
+// above a large face hand its whole conflict list on, again and again, before its own
+// farthest point is added.
+void hull_builder::push_work(std::uint32_t f) {
+    if (!m_conflicts[f].empty()) {
+        m_work.emplace_back(m_conflicts[f].size(), f);
+        std::push_heap(m_work.begin(), m_work.end());
+    }
+}
+
+void hull_builder::build(std::vector<std::uint32_t> &indices) {
+    create_simplex();
+    while (!m_work.empty()) {
+        std::pop_heap(m_work.begin(), m_work.end());
+        const std::uint32_t f = m_work.back().second;
+        m_work.pop_back();
+        if (m_faces[f].alive && !m_conflicts[f].empty()) {
+            add_point(f);
+        }
+    }
+    indices.clear();
+    for (const face &f : m_faces) {
+        if (f.alive) {
+            indices.insert(indices.end(), f.vertex, f.vertex + 3);
+        }
+    }
+}
+
+} // namespace
+
+namespace math {
+
+convex_hull::convex_hull(std::span<const vec3> points, unsigned thread_count) {
+    hull_builder(points, thread_count).build(m_indices);
+    m_vertices = m_indices;
+    std::sort(m_vertices.begin(), m_vertices.end());
+    m_vertices.erase(std::unique(m_vertices.begin(), m_vertices.end()), m_vertices.end());
+}
+
+std::span<const std::uint32_t> convex_hull::indices() const { return m_indices; }
+
+std::span<const std::uint32_t> convex_hull::vertices() const { return m_vertices; }
+
+std::size_t convex_hull::face_count() const { return m_indices.size() / 3; }
+
+} // namespace math
@@ -0,0 +1,38 @@
+#ifndef CONVEX_HULL_HPP
+#define CONVEX_HULL_HPP
+
+#include "../vec3/vec3.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace math {
+
+// 3D convex hull of a point set (quickhull). Faces are triangles wound counter-clockwise
+// seen from outside; coplanar neighbours are not merged. Points closer to a face than a
+// tolerance scaled to the spread of the input count as inside, so near-duplicate and nearly
+// coplanar points do not produce slivers; in exchange such points may lie outside the hull
+// by up to a small multiple of that tolerance. Which faces a new vertex sees is decided
+// exactly (orient3d), so the hull itself is convex.
+class convex_hull {
+  public:
+    // Throws std::invalid_argument when all points are (nearly) coplanar.
+    // thread_count 0 = hardware concurrency.
+    explicit convex_hull(std::span<const vec3> points, unsigned thread_count = 0);
+
+    // Three input indices per face.
+    std::span<const std::uint32_t> indices() const;
+    // Input indices of the hull vertices, ascending.
+    std::span<const std::uint32_t> vertices() const;
+    std::size_t face_count() const;
+
+  private:
+    std::vector<std::uint32_t> m_indices;
+    std::vector<std::uint32_t> m_vertices;
+};
+
+} // namespace math
+
+#endif // CONVEX_HULL_HPP
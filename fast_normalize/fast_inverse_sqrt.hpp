@@ -0,0 +1,40 @@
+#ifndef FAST_INVERSE_SQRT_HPP
+#define FAST_INVERSE_SQRT_HPP
+
+#include "../simd/simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace math {
+
+// Approximate 1 / sqrt(x): the hardware reciprocal square root estimate refined by one
+// Newton-Raphson step. Relative error is below 5e-7 (a few ulp) for normal positive x.
+inline float fast_inverse_sqrt(float x) {
+#if MATH_SIMD_LEVEL >= 1
+    const float y = rsqrt(simd::f32x4(x))[0];
+    return y * (1.5f - 0.5f * x * y * y);
+#else
+    return 1.0f / std::sqrt(x);
+#endif
+}
+
+// fast_inverse_sqrt(len_sq) for len_sq >= 1e-8 and 0 below, the scale factor that
+// normalizes one vector of squared length len_sq. The estimate is taken of
+// max(len_sq, 1e-8) and cleared with a compare mask, so there is no branch.
+inline float fast_inverse_length(float len_sq) {
+    constexpr float degenerate = 1e-8f;
+#if MATH_SIMD_LEVEL >= 1
+    const simd::f32x4 x(len_sq);
+    const simd::f32x4 clamped = max(x, simd::f32x4(degenerate));
+    const simd::f32x4 y = rsqrt(clamped);
+    const simd::f32x4 refined = y * (simd::f32x4(1.5f) - simd::f32x4(0.5f) * clamped * (y * y));
+    return select(x >= degenerate, refined, simd::f32x4(0.0f))[0];
+#else
+    return static_cast<float>(len_sq >= degenerate) / std::sqrt(std::max(len_sq, degenerate));
+#endif
+}
+
+} // namespace math
+
+#endif // FAST_INVERSE_SQRT_HPP
@@ -0,0 +1,131 @@
+#include "fast_normalize.hpp"
+
+#include "../simd/vec3_block.hpp"
+
+static_assert(sizeof(math::vec2) == 2 * sizeof(float), "vec2 arrays are read as packed floats");
+static_assert(sizeof(math::vec3) == 3 * sizeof(float), "vec3 arrays are read as packed floats");
+static_assert(sizeof(math::vec4) == 4 * sizeof(float), "vec4 arrays are read as packed floats");
+
+namespace {
+
+using math::simd::f32x8;
+using math::simd::f32x16;
+
+constexpr float degenerate_length_sq = 1e-8f;
+
+// Normalizes `count` vectors of N packed floats, one at a time.
+template <int N> void normalize_scalar(const float *in, float *out, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i, in += N, out += N) {
+        float len_sq = 0.0f;
+        for (int c = 0; c < N; ++c) {
+            len_sq += in[c] * in[c];
+        }
+        const float inv_len = math::fast_inverse_length(len_sq);
+        for (int c = 0; c < N; ++c) {
+            out[c] = in[c] * inv_len;
+        }
+    }
+}
+
+// The scalar backend has no estimate to gain from (its rsqrt is a division), so it only runs
+// the per-vector loop above.
+#if MATH_SIMD_LEVEL >= 1
+// Sixteen vectors per iteration: one register on AVX-512, two or four on narrower backends.
+constexpr std::size_t batch = 16;
+
+// rsqrt refined by one Newton-Raphson step, zero where len_sq is degenerate.
+template <typename V> V masked_inverse_sqrt(V len_sq) {
+    const V y = rsqrt(len_sq);
+    const V refined = y * fnmadd(len_sq * 0.5f * y, y, 1.5f);
+    return select(len_sq >= degenerate_length_sq, refined, V(0.0f));
+}
+
+// Every lane gets the squared length of the vec2 (pairs) or vec4 (quads) it belongs to.
+inline f32x16 pair_length_sq(f32x16 v) {
+    const f32x16 sq = v * v;
+    return sq + shuffle<1, 0, 3, 2>(sq);
+}
+
+inline f32x16 quad_length_sq(f32x16 v) {
+    const f32x16 pairs = pair_length_sq(v);
+    return pairs + shuffle<2, 3, 0, 1>(pairs);
+}
+
+std::size_t normalize_vec2_simd(const float *in, float *out, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + batch <= count; i += batch) {
+        for (int r = 0; r < 2; ++r) {
+            const f32x16 v = f32x16::loadu(in + 2 * i + 16 * r);
+            (v * masked_inverse_sqrt(pair_length_sq(v))).storeu(out + 2 * i + 16 * r);
+        }
+    }
+    return i;
+}
+
+std::size_t normalize_vec4_simd(const float *in, float *out, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + batch <= count; i += batch) {
+        for (int r = 0; r < 4; ++r) {
+            const f32x16 v = f32x16::loadu(in + 4 * i + 16 * r);
+            (v * masked_inverse_sqrt(quad_length_sq(v))).storeu(out + 4 * i + 16 * r);
+        }
+    }
+    return i;
+}
+
+// Packed vec3 are transposed to x, y, z registers eight at a time.
+std::size_t normalize_vec3_simd(const float *in, float *out, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + batch <= count; i += batch) {
+        for (std::size_t h = 0; h < batch; h += 8) {
+            f32x8 v[3];
+            math::simd::load_vec3x8(in + 3 * (i + h), v);
+            const f32x8 inv_len = masked_inverse_sqrt(fmadd(v[2], v[2], fmadd(v[1], v[1], v[0] * v[0])));
+            for (f32x8 &component : v) {
+                component *= inv_len;
+            }
+            math::simd::store_vec3x8(out + 3 * (i + h), v);
+        }
+    }
+    return i;
+}
+#endif
+
+template <int N>
+void normalize_array(const float *in, float *out, std::size_t count) {
+    std::size_t done = 0;
+#if MATH_SIMD_LEVEL >= 1
+    if constexpr (N == 2) {
+        done = normalize_vec2_simd(in, out, count);
+    } else if constexpr (N == 3) {
+        done = normalize_vec3_simd(in, out, count);
+    } else {
+        done = normalize_vec4_simd(in, out, count);
+    }
+#endif
+    normalize_scalar<N>(in + N * done, out + N * done, count - done);
+}
+
+} // namespace
+
+namespace math {
+
+void normalize_fast(std::span<const vec2> in, std::span<vec2> out) {
+    normalize_array<2>(reinterpret_cast<const float *>(in.data()), reinterpret_cast<float *>(out.data()), in.size());
+}
+
+void normalize_fast(std::span<const vec3> in, std::span<vec3> out) {
+    normalize_array<3>(reinterpret_cast<const float *>(in.data()), reinterpret_cast<float *>(out.data()), in.size());
+}
+
+void normalize_fast(std::span<const vec4> in, std::span<vec4> out) {
+    normalize_array<4>(reinterpret_cast<const float *>(in.data()), reinterpret_cast<float *>(out.data()), in.size());
+}
+
+void normalize_fast(std::span<vec2> vectors) { normalize_fast(vectors, vectors); }
+
+void normalize_fast(std::span<vec3> vectors) { normalize_fast(vectors, vectors); }
+
+void normalize_fast(std::span<vec4> vectors) { normalize_fast(vectors, vectors); }
+
+} // namespace math
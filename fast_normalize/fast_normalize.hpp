@@ -0,0 +1,27 @@
+#ifndef FAST_NORMALIZE_HPP
+#define FAST_NORMALIZE_HPP
+
+#include "../vec4/vec4.hpp"
+#include "fast_inverse_sqrt.hpp"
+
+#include <span>
+
+namespace math {
+
+// Fast normalization of arrays: rsqrt refined by one Newton-Raphson step, so components are
+// within 5e-7 relative error of the exact result. Vectors with squared length below 1e-8
+// become zero through a compare mask, without a branch. Processes 16 vectors per iteration
+// on the SIMD layer's SSE, AVX2 and AVX-512 backends; out may be the same array as in. There
+// is no single-vector form: one scalar rsqrt plus its refinement is no faster than
+// vec*::normalized().
+void normalize_fast(std::span<const vec2> in, std::span<vec2> out);
+void normalize_fast(std::span<const vec3> in, std::span<vec3> out);
+void normalize_fast(std::span<const vec4> in, std::span<vec4> out);
+
+void normalize_fast(std::span<vec2> vectors);
+void normalize_fast(std::span<vec3> vectors);
+void normalize_fast(std::span<vec4> vectors);
+
+} // namespace math
+
+#endif // FAST_NORMALIZE_HPP
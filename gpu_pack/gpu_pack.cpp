@@ -0,0 +1,129 @@
+#include "gpu_pack.hpp"
+
+#include "../simd/simd.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+using math::simd::f32x4;
+using math::simd::f32x8;
+
+struct in_order {
+    std::size_t operator()(std::size_t i) const { return i; }
+};
+
+struct remapped {
+    const std::uint32_t *remap;
+    std::size_t operator()(std::size_t i) const { return remap[i]; }
+};
+
+// Row r of a in the low half, of b in the high half.
+inline f32x8 rows(const math::mat4x4 &a, const math::mat4x4 &b, int r) {
+    return f32x8(f32x4::load(a.data() + 4 * r), f32x4::load(b.data() + 4 * r));
+}
+
+template <bool Stream> inline void put(float *p, f32x4 v) {
+    if constexpr (Stream) {
+        v.stream(p);
+    } else {
+        v.storeu(p);
+    }
+}
+
+// a at p and b at p + 16, column by column; b is skipped when `second` is false.
+template <bool Stream>
+void pack_4x4(const math::mat4x4 &a, const math::mat4x4 &b, bool second, float *p) {
+    f32x8 c0 = rows(a, b, 0), c1 = rows(a, b, 1), c2 = rows(a, b, 2), c3 = rows(a, b, 3);
+    math::simd::transpose4(c0, c1, c2, c3);
+    put<Stream>(p, c0.low());
+    put<Stream>(p + 4, c1.low());
+    put<Stream>(p + 8, c2.low());
+    put<Stream>(p + 12, c3.low());
+    if (second) {
+        put<Stream>(p + 16, c0.high());
+        put<Stream>(p + 20, c1.high());
+        put<Stream>(p + 24, c2.high());
+        put<Stream>(p + 28, c3.high());
+    }
+}
+
+// a at p and b at p + 12. Interleaving rows 0..2 column by column is the x, y, z -> xyz
+// interleave of simd::store_vec3x8, with the four columns as four vectors.
+template <bool Stream>
+void pack_4x3(const math::mat4x4 &a, const math::mat4x4 &b, bool second, float *p) {
+    const f32x8 x = rows(a, b, 0), y = rows(a, b, 1), z = rows(a, b, 2);
+    const f32x8 xy = shuffle<0, 2, 0, 2>(x, y);
+    const f32x8 yz = shuffle<1, 3, 1, 3>(y, z);
+    const f32x8 zx = shuffle<0, 2, 1, 3>(z, x);
+    const f32x8 m03 = shuffle<0, 2, 0, 2>(xy, zx);
+    const f32x8 m14 = shuffle<0, 2, 1, 3>(yz, xy);
+    const f32x8 m25 = shuffle<1, 3, 1, 3>(zx, yz);
+    put<Stream>(p, m03.low());
+    put<Stream>(p + 4, m14.low());
+    put<Stream>(p + 8, m25.low());
+    if (second) {
+        put<Stream>(p + 12, m03.high());
+        put<Stream>(p + 16, m14.high());
+        put<Stream>(p + 20, m25.high());
+    }
+}
+
+// Two matrices per kernel call; an odd last matrix is paired with itself and written once.
+template <std::size_t Floats, typename Kernel, typename Order>
+void pack_pairs(const math::mat4x4 *matrices, std::size_t count, Order order, float *dst,
+                Kernel kernel) {
+    std::size_t i = 0;
+    for (; i + 1 < count; i += 2) {
+        kernel(matrices[order(i)], matrices[order(i + 1)], true, dst + Floats * i);
+    }
+    if (i < count) {
+        const math::mat4x4 &last = matrices[order(i)];
+        kernel(last, last, false, dst + Floats * i);
+    }
+}
+
+template <typename Order>
+void pack(const math::mat4x4 *matrices, std::size_t count, Order order,
+          math::gpu_matrix_layout layout, std::span<std::byte> dst) {
+    if (dst.size() < count * math::packed_matrix_size(layout)) [[unlikely]] {
+        throw std::invalid_argument("Destination buffer is too small");
+    }
+    float *out = reinterpret_cast<float *>(dst.data());
+    const bool aligned = reinterpret_cast<std::uintptr_t>(out) % 16 == 0;
+    if (layout == math::gpu_matrix_layout::column_major_4x4) {
+        aligned ? pack_pairs<16>(matrices, count, order, out, pack_4x4<true>)
+                : pack_pairs<16>(matrices, count, order, out, pack_4x4<false>);
+    } else {
+        aligned ? pack_pairs<12>(matrices, count, order, out, pack_4x3<true>)
+                : pack_pairs<12>(matrices, count, order, out, pack_4x3<false>);
+    }
+    if (aligned) {
+        math::simd::stream_fence();
+    }
+}
+
+} // namespace
+
+namespace math {
+
+std::size_t packed_matrix_size(gpu_matrix_layout layout) {
+    return layout == gpu_matrix_layout::column_major_4x4 ? 16 * sizeof(float) : 12 * sizeof(float);
+}
+
+void pack_matrices(std::span<const mat4x4> matrices, gpu_matrix_layout layout,
+                   std::span<std::byte> dst) {
+    pack(matrices.data(), matrices.size(), in_order{}, layout, dst);
+}
+
+void pack_matrices(std::span<const mat4x4> matrices, std::span<const std::uint32_t> remap,
+                   gpu_matrix_layout layout, std::span<std::byte> dst) {
+    if (!remap.empty() && *std::max_element(remap.begin(), remap.end()) >= matrices.size())
+        [[unlikely]] {
+        throw std::invalid_argument("Instance index out of range");
+    }
+    pack(matrices.data(), remap.size(), remapped{remap.data()}, layout, dst);
+}
+
+} // namespace math
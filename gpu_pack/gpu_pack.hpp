@@ -0,0 +1,38 @@
+#ifndef GPU_PACK_HPP
+#define GPU_PACK_HPP
+
+#include "../mat4x4/mat4x4.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace math {
+
+// Instance-buffer layouts for mat4x4 (which is row-major in memory).
+enum class gpu_matrix_layout {
+    // 16 floats, column by column (64 bytes).
+    column_major_4x4,
+    // 12 floats: the four columns without the last row, tightly packed (48 bytes). Only for
+    // affine matrices; the last row is dropped.
+    column_major_4x3,
+};
+
+// Bytes one matrix occupies in `layout`.
+std::size_t packed_matrix_size(gpu_matrix_layout layout);
+
+// Writes matrices[i] at dst + i * packed_matrix_size(layout). When dst is 16-byte aligned (as
+// mapped GPU buffers are) the output is written with non-temporal stores, which bypass the
+// cache and do not read the destination; otherwise plain stores are used. Throws
+// std::invalid_argument when dst is too small.
+void pack_matrices(std::span<const mat4x4> matrices, gpu_matrix_layout layout,
+                   std::span<std::byte> dst);
+
+// Same, writing matrices[remap[i]] to slot i (e.g. instances sorted by material). Throws
+// std::invalid_argument when an index is out of range or dst is too small.
+void pack_matrices(std::span<const mat4x4> matrices, std::span<const std::uint32_t> remap,
+                   gpu_matrix_layout layout, std::span<std::byte> dst);
+
+} // namespace math
+
+#endif // GPU_PACK_HPP
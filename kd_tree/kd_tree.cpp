@@ -0,0 +1,351 @@
+#include "kd_tree.hpp"
+
+#include "../parallel/parallel_for.hpp"
+#include "../simd/simd.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <stdexcept>
+
+static_assert(sizeof(math::vec3) == 3 * sizeof(float), "vec3 arrays are read as packed floats");
+
+namespace {
+
+using math::simd::f32x8;
+
+constexpr std::uint32_t max_leaf_size = 32;
+constexpr std::uint32_t sample_size = 63;
+// The top levels are split on the calling thread; the subtrees below them are built in
+// parallel. Fixed so the tree does not depend on the thread count.
+constexpr int serial_levels = 6;
+// Splits leaving less than a quarter of the points on one side fall back to the exact median,
+// which bounds the depth by about 2.5 * log2(size) and keeps the query stack small.
+constexpr std::uint32_t min_split_fraction = 4;
+constexpr int max_stack = 128;
+// Positions are padded so eight-wide loads at the end of the last leaf stay in bounds.
+constexpr std::size_t padding = 8;
+constexpr std::size_t query_chunk = 1024;
+
+struct build_point {
+    float p[3];
+    std::uint32_t index;
+};
+
+struct pending_subtree {
+    std::uint32_t begin, end;
+    std::uint32_t slot;
+};
+
+// Chooses the widest axis of a sample of [begin, end) and splits at the sample median.
+// Returns the first point of the right half; points left of it are <= split, the rest >= split.
+std::uint32_t split_range(build_point *points, std::uint32_t begin, std::uint32_t end,
+                          std::uint32_t &axis, float &split) {
+    const std::uint32_t count = end - begin;
+    const std::uint32_t samples = std::min(count, sample_size);
+    float sample[3][sample_size];
+    float low[3] = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                    std::numeric_limits<float>::max()};
+    float high[3] = {std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(),
+                     std::numeric_limits<float>::lowest()};
+    for (std::uint32_t s = 0; s < samples; ++s) {
+        const build_point &p = points[begin + std::uint64_t(s) * count / samples];
+        for (int c = 0; c < 3; ++c) {
+            sample[c][s] = p.p[c];
+            low[c] = std::min(low[c], p.p[c]);
+            high[c] = std::max(high[c], p.p[c]);
+        }
+    }
+    axis = 0;
+    for (std::uint32_t c = 1; c < 3; ++c) {
+        if (high[c] - low[c] > high[axis] - low[axis]) {
+            axis = c;
+        }
+    }
+    float *values = sample[axis];
+    std::nth_element(values, values + samples / 2, values + samples);
+    split = values[samples / 2];
+
+    const std::uint32_t a = axis;
+    const float s = split;
+    build_point *mid = std::partition(points + begin, points + end,
+                                      [a, s](const build_point &p) { return p.p[a] < s; });
+    std::uint32_t middle = static_cast<std::uint32_t>(mid - points);
+    const std::uint32_t min_side = count / min_split_fraction;
+    if (middle - begin < min_side || end - middle < min_side) [[unlikely]] {
+        middle = begin + count / 2;
+        std::nth_element(points + begin, points + middle, points + end,
+                         [a](const build_point &l, const build_point &r) { return l.p[a] < r.p[a]; });
+        split = points[middle].p[a];
+    }
+    return middle;
+}
+
+template <typename Node>
+std::uint32_t build_subtree(std::vector<Node> &nodes, build_point *points, std::uint32_t begin,
+                            std::uint32_t end, int levels, std::vector<pending_subtree> *pending) {
+    const std::uint32_t self = static_cast<std::uint32_t>(nodes.size());
+    nodes.push_back({0.0f, 3, begin, end});
+    if (end - begin <= max_leaf_size) {
+        return self;
+    }
+    if (levels == 0 && pending != nullptr) {
+        pending->push_back({begin, end, self});
+        return self;
+    }
+    std::uint32_t axis;
+    float split;
+    const std::uint32_t middle = split_range(points, begin, end, axis, split);
+    build_subtree(nodes, points, begin, middle, levels - 1, pending);
+    const std::uint32_t right = build_subtree(nodes, points, middle, end, levels - 1, pending);
+    nodes[self] = {split, axis, self + 1, right};
+    return self;
+}
+
+// Sorted insertion into the k best candidates so far. Returns the new count.
+inline std::size_t insert_candidate(std::uint32_t *indices, float *distances, std::size_t count,
+                                    std::size_t k, std::uint32_t index, float d2) {
+    std::size_t pos = (count < k) ? count : k - 1;
+    while (pos > 0 && distances[pos - 1] > d2) {
+        if (pos < k) {
+            distances[pos] = distances[pos - 1];
+            indices[pos] = indices[pos - 1];
+        }
+        --pos;
+    }
+    distances[pos] = d2;
+    indices[pos] = index;
+    return (count < k) ? count + 1 : count;
+}
+
+} // namespace
+
+namespace math {
+
+kd_tree::kd_tree(std::span<const vec3> points, unsigned thread_count) {
+    const std::size_t count = points.size();
+    const float *p = reinterpret_cast<const float *>(points.data());
+    std::vector<build_point> work(count);
+    parallel::for_each_chunk(
+        count, 1 << 16,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                work[i] = {{p[3 * i], p[3 * i + 1], p[3 * i + 2]}, static_cast<std::uint32_t>(i)};
+            }
+        },
+        thread_count);
+
+    std::vector<pending_subtree> pending;
+    build_subtree(m_nodes, work.data(), 0, static_cast<std::uint32_t>(count), serial_levels, &pending);
+
+    std::vector<std::vector<node>> subtrees(pending.size());
+    parallel::for_each_chunk(
+        pending.size(), 1,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t s = begin; s < end; ++s) {
+                build_subtree(subtrees[s], work.data(), pending[s].begin, pending[s].end, -1, nullptr);
+            }
+        },
+        thread_count);
+
+    // Splice the subtrees in: each root replaces its placeholder, the other nodes are appended.
+    for (std::size_t s = 0; s < pending.size(); ++s) {
+        const std::vector<node> &local = subtrees[s];
+        const std::uint32_t offset = static_cast<std::uint32_t>(m_nodes.size()) - 1;
+        for (std::size_t i = 0; i < local.size(); ++i) {
+            node n = local[i];
+            if (n.axis != leaf_axis) {
+                n.first += offset;
+                n.second += offset;
+            }
+            if (i == 0) {
+                m_nodes[pending[s].slot] = n;
+            } else {
+                m_nodes.push_back(n);
+            }
+        }
+    }
+
+    m_index.resize(count);
+    m_x.resize(count + padding);
+    m_y.resize(count + padding);
+    m_z.resize(count + padding);
+    parallel::for_each_chunk(
+        count, 1 << 16,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                m_index[i] = work[i].index;
+                m_x[i] = work[i].p[0];
+                m_y[i] = work[i].p[1];
+                m_z[i] = work[i].p[2];
+            }
+        },
+        thread_count);
+}
+
+std::size_t kd_tree::nearest(const vec3 &query, std::size_t k, std::span<std::uint32_t> indices,
+                             std::span<float> distances_sq) const {
+    k = std::min(k, m_index.size());
+    if (k == 0) [[unlikely]] {
+        return 0;
+    }
+    const float q[3] = {query.x(), query.y(), query.z()};
+    std::uint32_t *best = indices.data();
+    float *best_d2 = distances_sq.data();
+    std::size_t count = 0;
+    float worst = std::numeric_limits<float>::infinity();
+
+    // bound is the squared distance from the query to the node's cell, built incrementally
+    // from the per-axis offsets (Arya and Mount), which prunes far better than the distance
+    // to the last splitting plane alone.
+    struct entry {
+        std::uint32_t node;
+        float bound;
+        float offset[3];
+    };
+    entry stack[max_stack];
+    int top = 0;
+    stack[top++] = {0, 0.0f, {0.0f, 0.0f, 0.0f}};
+    const f32x8 qx(q[0]), qy(q[1]), qz(q[2]);
+
+    while (top > 0) {
+        entry e = stack[--top];
+        if (e.bound >= worst) {
+            continue;
+        }
+        std::uint32_t n = e.node;
+        while (m_nodes[n].axis != leaf_axis) {
+            const node &inner = m_nodes[n];
+            const std::uint32_t axis = inner.axis;
+            const float diff = q[axis] - inner.split;
+            const std::uint32_t near = (diff < 0.0f) ? inner.first : inner.second;
+            const std::uint32_t far = (diff < 0.0f) ? inner.second : inner.first;
+            const float bound = e.bound - e.offset[axis] * e.offset[axis] + diff * diff;
+            if (bound < worst) {
+                entry &f = stack[top++];
+                f = e;
+                f.node = far;
+                f.bound = bound;
+                f.offset[axis] = diff;
+            }
+            n = near;
+        }
+
+        const std::uint32_t begin = m_nodes[n].first;
+        const std::uint32_t end = m_nodes[n].second;
+        for (std::uint32_t j = begin; j < end; j += 8) {
+            const f32x8 dx = f32x8::loadu(&m_x[j]) - qx;
+            const f32x8 dy = f32x8::loadu(&m_y[j]) - qy;
+            const f32x8 dz = f32x8::loadu(&m_z[j]) - qz;
+            const f32x8 d2 = fmadd(dz, dz, fmadd(dy, dy, dx * dx));
+            unsigned mask = bits(d2 < worst);
+            if (end - j < 8) {
+                mask &= (1u << (end - j)) - 1u;
+            }
+            if (mask == 0) {
+                continue;
+            }
+            alignas(32) float lanes[8];
+            d2.store(lanes);
+            for (; mask != 0; mask &= mask - 1) {
+                const int l = std::countr_zero(mask);
+                if (lanes[l] < worst) {
+                    count = insert_candidate(best, best_d2, count, k, m_index[j + l], lanes[l]);
+                    if (count == k) {
+                        worst = best_d2[k - 1];
+                    }
+                }
+            }
+        }
+    }
+    return count;
+}
+
+void kd_tree::nearest(std::span<const vec3> queries, std::size_t k,
+                      std::span<std::uint32_t> indices, std::span<float> distances_sq,
+                      unsigned thread_count) const {
+    if (indices.size() / std::max<std::size_t>(k, 1) < queries.size() ||
+        distances_sq.size() / std::max<std::size_t>(k, 1) < queries.size()) [[unlikely]] {
+        throw std::invalid_argument("Outputs need k entries per query");
+    }
+    parallel::for_each_chunk(
+        queries.size(), query_chunk,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t q = begin; q < end; ++q) {
+                nearest(queries[q], k, indices.subspan(q * k, k), distances_sq.subspan(q * k, k));
+            }
+        },
+        thread_count);
+}
+
+std::size_t kd_tree::query_radius(const vec3 &center, float radius,
+                                  std::span<std::uint32_t> out) const {
+    if (m_index.empty()) [[unlikely]] {
+        return 0;
+    }
+    const float q[3] = {center.x(), center.y(), center.z()};
+    const float r2 = radius * radius;
+    std::size_t written = 0;
+    const std::size_t capacity = out.size();
+
+    std::uint32_t stack[max_stack];
+    int top = 0;
+    stack[top++] = 0;
+    const f32x8 qx(q[0]), qy(q[1]), qz(q[2]);
+
+    while (top > 0) {
+        std::uint32_t n = stack[--top];
+        while (m_nodes[n].axis != leaf_axis) {
+            const node &inner = m_nodes[n];
+            const float diff = q[inner.axis] - inner.split;
+            const std::uint32_t near = (diff < 0.0f) ? inner.first : inner.second;
+            const std::uint32_t far = (diff < 0.0f) ? inner.second : inner.first;
+            if (diff * diff <= r2) {
+                stack[top++] = far;
+            }
+            n = near;
+        }
+
+        const std::uint32_t begin = m_nodes[n].first;
+        const std::uint32_t end = m_nodes[n].second;
+        for (std::uint32_t j = begin; j < end; j += 8) {
+            const f32x8 dx = f32x8::loadu(&m_x[j]) - qx;
+            const f32x8 dy = f32x8::loadu(&m_y[j]) - qy;
+            const f32x8 dz = f32x8::loadu(&m_z[j]) - qz;
+            const f32x8 d2 = fmadd(dz, dz, fmadd(dy, dy, dx * dx));
+            unsigned mask = bits(d2 <= r2);
+            if (end - j < 8) {
+                mask &= (1u << (end - j)) - 1u;
+            }
+            for (; mask != 0; mask &= mask - 1) {
+                if (written == capacity) [[unlikely]] {
+                    return written;
+                }
+                out[written++] = m_index[j + std::countr_zero(mask)];
+            }
+        }
+    }
+    return written;
+}
+
+void kd_tree::query_radius(std::span<const vec3> queries, float radius, std::size_t max_results,
+                           std::span<std::uint32_t> indices, std::span<std::uint32_t> counts,
+                           unsigned thread_count) const {
+    if (indices.size() / std::max<std::size_t>(max_results, 1) < queries.size() ||
+        counts.size() < queries.size()) [[unlikely]] {
+        throw std::invalid_argument("Outputs need max_results indices and one count per query");
+    }
+    parallel::for_each_chunk(
+        queries.size(), query_chunk,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t q = begin; q < end; ++q) {
+                counts[q] = static_cast<std::uint32_t>(
+                    query_radius(queries[q], radius, indices.subspan(q * max_results, max_results)));
+            }
+        },
+        thread_count);
+}
+
+std::size_t kd_tree::size() const { return m_index.size(); }
+
+} // namespace math
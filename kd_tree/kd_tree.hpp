@@ -0,0 +1,62 @@
+#ifndef KD_TREE_HPP
+#define KD_TREE_HPP
+
+#include "../vec3/vec3.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace math {
+
+// Static k-d tree over a point cloud for exact nearest-neighbour and radius queries. Inner
+// nodes split the widest axis of their bounds at the median of a sample of their points;
+// leaves hold at most 32 points, stored contiguously as structure of arrays so a leaf is
+// tested eight points at a time.
+class kd_tree {
+  public:
+    // thread_count 0 = hardware concurrency.
+    explicit kd_tree(std::span<const vec3> points, unsigned thread_count = 0);
+
+    // The min(k, size()) points closest to query, nearest first. indices and distances_sq
+    // (squared distances) need room for that many entries. Returns the number written.
+    std::size_t nearest(const vec3 &query, std::size_t k, std::span<std::uint32_t> indices,
+                        std::span<float> distances_sq) const;
+
+    // Batched nearest(): results of query q start at q * k, so indices and distances_sq need
+    // queries.size() * k entries; throws std::invalid_argument when either is shorter. With
+    // k > size() the entries past size() of every query are left untouched.
+    void nearest(std::span<const vec3> queries, std::size_t k, std::span<std::uint32_t> indices,
+                 std::span<float> distances_sq, unsigned thread_count = 0) const;
+
+    // Writes the indices of points with distance <= radius from center into out and returns
+    // how many were written; stops when out is full.
+    std::size_t query_radius(const vec3 &center, float radius, std::span<std::uint32_t> out) const;
+
+    // Batched query_radius(): query q writes up to max_results indices starting at
+    // q * max_results and stores how many in counts[q]. indices needs queries.size() *
+    // max_results entries and counts queries.size(); throws std::invalid_argument otherwise.
+    void query_radius(std::span<const vec3> queries, float radius, std::size_t max_results,
+                      std::span<std::uint32_t> indices, std::span<std::uint32_t> counts,
+                      unsigned thread_count = 0) const;
+
+    std::size_t size() const;
+
+  private:
+    struct node {
+        float split;
+        std::uint32_t axis; // leaf_axis for leaves
+        std::uint32_t first; // inner: left child; leaf: first point
+        std::uint32_t second; // inner: right child; leaf: one past the last point
+    };
+    static constexpr std::uint32_t leaf_axis = 3;
+
+    std::vector<node> m_nodes;
+    std::vector<std::uint32_t> m_index; // tree order -> input index
+    std::vector<float> m_x, m_y, m_z;   // positions in tree order
+};
+
+} // namespace math
+
+#endif // KD_TREE_HPP
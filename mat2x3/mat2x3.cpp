@@ -0,0 +1,225 @@
+#include "mat2x3.hpp"
+
+#include "../simd/simd.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+static_assert(sizeof(math::vec2) == 2 * sizeof(float), "vec2 arrays are read as packed floats");
+static_assert(sizeof(math::sprite) == 6 * sizeof(float), "sprites are read as packed floats");
+
+namespace {
+
+using math::simd::f32x8;
+
+// Transposes an 8x8 block of floats held in eight registers: each 4x4 quarter is transposed
+// in place, then the off-diagonal quarters swap halves.
+inline void transpose8(f32x8 (&r)[8]) {
+    math::simd::transpose4(r[0], r[1], r[2], r[3]);
+    math::simd::transpose4(r[4], r[5], r[6], r[7]);
+    for (int i = 0; i < 4; ++i) {
+        const f32x8 top = r[i], bottom = r[i + 4];
+        r[i] = f32x8(top.low(), bottom.low());
+        r[i + 4] = f32x8(top.high(), bottom.high());
+    }
+}
+
+} // namespace
+
+namespace math {
+
+mat2x3::mat2x3() { std::memset(m_matrix, 0, sizeof(m_matrix)); }
+
+mat2x3::mat2x3(const float (&elements)[2][3]) { std::memcpy(m_matrix, elements, sizeof(m_matrix)); }
+
+mat2x3::mat2x3(const mat2x3 &other) { std::memcpy(m_matrix, other.m_matrix, sizeof(m_matrix)); }
+
+mat2x3 &mat2x3::operator=(const mat2x3 &other) {
+    if (this != &other) {
+        std::memcpy(m_matrix, other.m_matrix, sizeof(m_matrix));
+    }
+    return *this;
+}
+
+mat2x3 mat2x3::operator*(const mat2x3 &other) const {
+    const float(&a)[2][3] = m_matrix;
+    const float(&b)[2][3] = other.m_matrix;
+    return {{{a[0][0] * b[0][0] + a[0][1] * b[1][0], a[0][0] * b[0][1] + a[0][1] * b[1][1],
+              a[0][0] * b[0][2] + a[0][1] * b[1][2] + a[0][2]},
+             {a[1][0] * b[0][0] + a[1][1] * b[1][0], a[1][0] * b[0][1] + a[1][1] * b[1][1],
+              a[1][0] * b[0][2] + a[1][1] * b[1][2] + a[1][2]}}};
+}
+
+mat2x3 &mat2x3::operator*=(const mat2x3 &other) {
+    *this = *this * other;
+    return *this;
+}
+
+vec2 mat2x3::operator*(const vec2 &point) const {
+    return vec2(m_matrix[0][0] * point.x() + m_matrix[0][1] * point.y() + m_matrix[0][2],
+                m_matrix[1][0] * point.x() + m_matrix[1][1] * point.y() + m_matrix[1][2]);
+}
+
+vec2 mat2x3::transform_vector(const vec2 &vector) const {
+    return vec2(m_matrix[0][0] * vector.x() + m_matrix[0][1] * vector.y(),
+                m_matrix[1][0] * vector.x() + m_matrix[1][1] * vector.y());
+}
+
+float &mat2x3::at(int row, int col) { return m_matrix[row][col]; }
+
+const float &mat2x3::at(int row, int col) const {
+    if (row < 0 || row >= 2 || col < 0 || col >= 3) [[unlikely]] {
+        throw std::out_of_range("Matrix index out of range");
+    }
+    return m_matrix[row][col];
+}
+
+mat2x3 mat2x3::inverse() const {
+    const float det = determinant();
+    if (std::abs(det) < 1e-8f) {
+        throw std::runtime_error("Matrix is not invertible");
+    }
+    const float inv_det = 1.0f / det;
+    // Inverse of the linear part, then the translation mapped back through it.
+    const float a = m_matrix[1][1] * inv_det;
+    const float b = -m_matrix[0][1] * inv_det;
+    const float c = -m_matrix[1][0] * inv_det;
+    const float d = m_matrix[0][0] * inv_det;
+    const float tx = m_matrix[0][2], ty = m_matrix[1][2];
+    return {{{a, b, -(a * tx + b * ty)}, {c, d, -(c * tx + d * ty)}}};
+}
+
+float mat2x3::determinant() const { return m_matrix[0][0] * m_matrix[1][1] - m_matrix[0][1] * m_matrix[1][0]; }
+
+mat2x3 mat2x3::identity() { return {{{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}}}; }
+
+mat2x3 mat2x3::translation(float tx, float ty) { return {{{1.0f, 0.0f, tx}, {0.0f, 1.0f, ty}}}; }
+
+mat2x3 mat2x3::rotation(float angle_rad) {
+    const float c = std::cos(angle_rad);
+    const float s = std::sin(angle_rad);
+    return {{{c, -s, 0.0f}, {s, c, 0.0f}}};
+}
+
+mat2x3 mat2x3::scaling(float sx, float sy) { return {{{sx, 0.0f, 0.0f}, {0.0f, sy, 0.0f}}}; }
+
+mat2x3 mat2x3::make_transform(const vec2 &translation, float angle_rad, const vec2 &scale) {
+    const float c = std::cos(angle_rad);
+    const float s = std::sin(angle_rad);
+    return {{{c * scale.x(), -s * scale.y(), translation.x()}, {s * scale.x(), c * scale.y(), translation.y()}}};
+}
+
+std::ostream &operator<<(std::ostream &os, const math::mat2x3 &matrix) {
+    os << "[" << matrix.at(0, 0) << ", " << matrix.at(0, 1) << ", " << matrix.at(0, 2) << "]\n"
+       << "[" << matrix.at(1, 0) << ", " << matrix.at(1, 1) << ", " << matrix.at(1, 2) << "]\n";
+    return os;
+}
+
+void transform_points(const mat2x3 &matrix, std::span<const vec2> points, std::span<vec2> out) {
+    if (out.size() < points.size()) [[unlikely]] {
+        throw std::invalid_argument("Output is smaller than the input");
+    }
+    const float *src = reinterpret_cast<const float *>(points.data());
+    float *dst = reinterpret_cast<float *>(out.data());
+    const std::size_t count = points.size();
+    const float a = matrix.at(0, 0), b = matrix.at(0, 1), tx = matrix.at(0, 2);
+    const float c = matrix.at(1, 0), d = matrix.at(1, 1), ty = matrix.at(1, 2);
+
+    std::size_t i = 0;
+#if MATH_SIMD_LEVEL >= 1
+    // Points stay interleaved: (x, y) * (a, d) + (y, x) * (b, c) + (tx, ty).
+    alignas(32) const float pattern[3][8] = {{a, d, a, d, a, d, a, d},
+                                             {b, c, b, c, b, c, b, c},
+                                             {tx, ty, tx, ty, tx, ty, tx, ty}};
+    const f32x8 diagonal = f32x8::load(pattern[0]);
+    const f32x8 cross = f32x8::load(pattern[1]);
+    const f32x8 offset = f32x8::load(pattern[2]);
+    for (; i + 8 <= count; i += 8) {
+        for (int half = 0; half < 2; ++half) {
+            const f32x8 v = f32x8::loadu(src + 2 * i + 8 * half);
+            fmadd(v, diagonal, fmadd(shuffle<1, 0, 3, 2>(v), cross, offset)).storeu(dst + 2 * i + 8 * half);
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        const float x = src[2 * i], y = src[2 * i + 1];
+        dst[2 * i] = a * x + b * y + tx;
+        dst[2 * i + 1] = c * x + d * y + ty;
+    }
+}
+
+void build_sprite_quads(const mat2x3 &view, std::span<const sprite> sprites, std::span<vec2> corners) {
+    if (corners.size() / 4 < sprites.size()) [[unlikely]] {
+        throw std::invalid_argument("Corner output needs four entries per sprite");
+    }
+    const float *src = reinterpret_cast<const float *>(sprites.data());
+    float *dst = reinterpret_cast<float *>(corners.data());
+    const std::size_t count = sprites.size();
+    const float a = view.at(0, 0), b = view.at(0, 1), tx = view.at(0, 2);
+    const float c = view.at(1, 0), d = view.at(1, 1), ty = view.at(1, 2);
+
+    // Corner = view * (position + k0 * axis_x + k1 * axis_y) with axis_x = rotation * half.x,
+    // axis_y = perp(rotation) * half.y and (k0, k1) running (-1,-1), (1,-1), (1,1), (-1,1).
+    std::size_t i = 0;
+#if MATH_SIMD_LEVEL >= 1
+    const f32x8 va(a), vb(b), vtx(tx);
+    const f32x8 vc(c), vd(d), vty(ty);
+    // Each sprite is read as eight floats, two past its end, so the last sprite is left to
+    // the scalar loop.
+    for (; i + 9 <= count; i += 8) {
+        f32x8 r[8];
+        for (int s = 0; s < 8; ++s) {
+            r[s] = f32x8::loadu(src + 6 * (i + s));
+        }
+        transpose8(r); // px, py, hx, hy, cos, sin, -, -
+
+        const f32x8 px = fmadd(va, r[0], fmadd(vb, r[1], vtx));
+        const f32x8 py = fmadd(vc, r[0], fmadd(vd, r[1], vty));
+        // Sprite axes in sprite space, then through the linear part of view.
+        const f32x8 ax = r[4] * r[2];
+        const f32x8 ay = r[5] * r[2];
+        const f32x8 bx = -r[5] * r[3];
+        const f32x8 by = r[4] * r[3];
+        const f32x8 ux = fmadd(va, ax, vb * ay);
+        const f32x8 uy = fmadd(vc, ax, vd * ay);
+        const f32x8 wx = fmadd(va, bx, vb * by);
+        const f32x8 wy = fmadd(vc, bx, vd * by);
+
+        const f32x8 sum_x = ux + wx, sum_y = uy + wy;
+        const f32x8 diff_x = ux - wx, diff_y = uy - wy;
+        r[0] = px - sum_x;
+        r[1] = py - sum_y;
+        r[2] = px + diff_x;
+        r[3] = py + diff_y;
+        r[4] = px + sum_x;
+        r[5] = py + sum_y;
+        r[6] = px - diff_x;
+        r[7] = py - diff_y;
+        transpose8(r); // one register of four corners per sprite
+        for (int s = 0; s < 8; ++s) {
+            r[s].storeu(dst + 8 * (i + s));
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        const float *p = src + 6 * i;
+        const float px = a * p[0] + b * p[1] + tx;
+        const float py = c * p[0] + d * p[1] + ty;
+        const float ax = p[4] * p[2], ay = p[5] * p[2];
+        const float bx = -p[5] * p[3], by = p[4] * p[3];
+        const float ux = a * ax + b * ay, uy = c * ax + d * ay;
+        const float wx = a * bx + b * by, wy = c * bx + d * by;
+        float *q = dst + 8 * i;
+        q[0] = px - ux - wx;
+        q[1] = py - uy - wy;
+        q[2] = px + ux - wx;
+        q[3] = py + uy - wy;
+        q[4] = px + ux + wx;
+        q[5] = py + uy + wy;
+        q[6] = px - ux + wx;
+        q[7] = py - uy + wy;
+    }
+}
+
+} // namespace math
@@ -0,0 +1,69 @@
+#ifndef MAT2X3_HPP
+#define MAT2X3_HPP
+
+#include "../vec2/vec2.hpp"
+
+#include <cstddef>
+#include <iostream>
+#include <span>
+
+namespace math {
+
+// 2D affine transform: the top two rows of a 3x3 homogeneous matrix whose last row is
+// (0, 0, 1). Like mat4x4 it transforms column vectors, with the translation in column 2,
+// so a * b applies b first.
+class mat2x3 {
+  public:
+    mat2x3();
+    mat2x3(const float (&elements)[2][3]);
+    mat2x3(const mat2x3 &other);
+
+    mat2x3 &operator=(const mat2x3 &other);
+
+    mat2x3 operator*(const mat2x3 &other) const;
+    mat2x3 &operator*=(const mat2x3 &other);
+
+    // Transforms a point (translation applied).
+    vec2 operator*(const vec2 &point) const;
+    // Transforms a direction (translation ignored).
+    vec2 transform_vector(const vec2 &vector) const;
+
+    float &at(int row, int col);
+    const float &at(int row, int col) const;
+
+    mat2x3 inverse() const;
+    float determinant() const;
+
+    static mat2x3 identity();
+    static mat2x3 translation(float tx, float ty);
+    static mat2x3 rotation(float angle_rad);
+    static mat2x3 scaling(float sx, float sy);
+    // translation * rotation * scaling, built directly.
+    static mat2x3 make_transform(const vec2 &translation, float angle_rad, const vec2 &scale);
+
+  private:
+    float m_matrix[2][3];
+};
+
+std::ostream &operator<<(std::ostream &os, const math::mat2x3 &matrix);
+
+// One textured quad. The rotation is stored as (cos, sin) of the angle so placing sprites
+// needs no trigonometry; vec2(1, 0) is unrotated.
+struct sprite {
+    vec2 position;
+    vec2 half_size;
+    vec2 rotation;
+};
+
+// Transforms every point in `points` by `matrix` into `out` (which may alias `points`).
+// Throws std::invalid_argument when out is shorter than points.
+void transform_points(const mat2x3 &matrix, std::span<const vec2> points, std::span<vec2> out);
+
+// Writes the four corners of every sprite, transformed by view, into corners (4 per sprite,
+// counter-clockwise from (-half_size.x, -half_size.y) in sprite space). Throws
+// std::invalid_argument when corners has fewer than 4 * sprites.size() entries.
+void build_sprite_quads(const mat2x3 &view, std::span<const sprite> sprites, std::span<vec2> corners);
+
+} // namespace math
+
+#endif // MAT2X3_HPP
@@ -0,0 +1,234 @@
+#include "mat3x3.hpp"
+
+#include "../simd/vec3_block.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+static_assert(sizeof(math::vec3) == 3 * sizeof(float), "vec3 arrays are read as packed floats");
+
+namespace {
+
+using math::simd::f32x4;
+using math::simd::f32x8;
+
+// (a.y, a.z, a.x) * (b.z, b.x, b.y) - (a.z, a.x, a.y) * (b.y, b.z, b.x); the padding lane stays 0.
+inline f32x4 cross3(f32x4 a, f32x4 b) {
+    const f32x4 c = a * shuffle<1, 2, 0, 3>(b) - shuffle<1, 2, 0, 3>(a) * b;
+    return shuffle<1, 2, 0, 3>(c);
+}
+
+inline float dot3(f32x4 a, f32x4 b) {
+    const f32x4 p = a * b;
+    return p[0] + p[1] + p[2];
+}
+
+} // namespace
+
+namespace math {
+
+mat3x3::mat3x3() { std::memset(m_matrix, 0, sizeof(m_matrix)); }
+
+mat3x3::mat3x3(const float (&elements)[3][3]) {
+    for (int r = 0; r < 3; ++r) {
+        m_matrix[r][0] = elements[r][0];
+        m_matrix[r][1] = elements[r][1];
+        m_matrix[r][2] = elements[r][2];
+        m_matrix[r][3] = 0.0f;
+    }
+}
+
+mat3x3::mat3x3(const vec3 &row0, const vec3 &row1, const vec3 &row2)
+    : m_matrix{{row0.x(), row0.y(), row0.z(), 0.0f},
+               {row1.x(), row1.y(), row1.z(), 0.0f},
+               {row2.x(), row2.y(), row2.z(), 0.0f}} {}
+
+mat3x3::mat3x3(const mat3x3 &other) { std::memcpy(m_matrix, other.m_matrix, sizeof(m_matrix)); }
+
+mat3x3 &mat3x3::operator=(const mat3x3 &other) {
+    if (this != &other) {
+        std::memcpy(m_matrix, other.m_matrix, sizeof(m_matrix));
+    }
+    return *this;
+}
+
+mat3x3 mat3x3::operator+(const mat3x3 &other) const {
+    mat3x3 result;
+    for (int r = 0; r < 3; ++r) {
+        (f32x4::load(m_matrix[r]) + f32x4::load(other.m_matrix[r])).store(result.m_matrix[r]);
+    }
+    return result;
+}
+
+mat3x3 mat3x3::operator-(const mat3x3 &other) const {
+    mat3x3 result;
+    for (int r = 0; r < 3; ++r) {
+        (f32x4::load(m_matrix[r]) - f32x4::load(other.m_matrix[r])).store(result.m_matrix[r]);
+    }
+    return result;
+}
+
+mat3x3 mat3x3::operator*(const mat3x3 &other) const {
+    mat3x3 result;
+    const f32x4 o0 = f32x4::load(other.m_matrix[0]);
+    const f32x4 o1 = f32x4::load(other.m_matrix[1]);
+    const f32x4 o2 = f32x4::load(other.m_matrix[2]);
+    for (int r = 0; r < 3; ++r) {
+        const f32x4 m = f32x4::load(m_matrix[r]);
+        f32x4 acc = math::simd::broadcast_lane<0>(m) * o0;
+        acc = fmadd(math::simd::broadcast_lane<1>(m), o1, acc);
+        acc = fmadd(math::simd::broadcast_lane<2>(m), o2, acc);
+        acc.store(result.m_matrix[r]);
+    }
+    return result;
+}
+
+mat3x3 &mat3x3::operator*=(const mat3x3 &other) {
+    *this = *this * other;
+    return *this;
+}
+
+mat3x3 mat3x3::operator*(const float scalar) const {
+    mat3x3 result;
+    for (int r = 0; r < 3; ++r) {
+        (f32x4::load(m_matrix[r]) * scalar).store(result.m_matrix[r]);
+    }
+    return result;
+}
+
+mat3x3 &mat3x3::operator*=(const float scalar) {
+    *this = *this * scalar;
+    return *this;
+}
+
+vec3 mat3x3::operator*(const vec3 &vector) const {
+    return vec3(
+        m_matrix[0][0] * vector.x() + m_matrix[0][1] * vector.y() + m_matrix[0][2] * vector.z(),
+        m_matrix[1][0] * vector.x() + m_matrix[1][1] * vector.y() + m_matrix[1][2] * vector.z(),
+        m_matrix[2][0] * vector.x() + m_matrix[2][1] * vector.y() + m_matrix[2][2] * vector.z());
+}
+
+float &mat3x3::at(int row, int col) { return m_matrix[row][col]; }
+
+const float &mat3x3::at(int row, int col) const {
+    if (row < 0 || row >= 3) {
+        throw std::out_of_range("Row index out of range");
+    }
+    if (col < 0 || col >= 3) {
+        throw std::out_of_range("Column index out of range");
+    }
+    return m_matrix[row][col];
+}
+
+vec3 mat3x3::row(int index) const {
+    return vec3(m_matrix[index][0], m_matrix[index][1], m_matrix[index][2]);
+}
+
+mat3x3 mat3x3::transpose() const {
+    mat3x3 result;
+    f32x4 row0 = f32x4::load(m_matrix[0]);
+    f32x4 row1 = f32x4::load(m_matrix[1]);
+    f32x4 row2 = f32x4::load(m_matrix[2]);
+    f32x4 row3(0.0f);
+    math::simd::transpose4(row0, row1, row2, row3);
+    row0.store(result.m_matrix[0]);
+    row1.store(result.m_matrix[1]);
+    row2.store(result.m_matrix[2]);
+    return result;
+}
+
+mat3x3 mat3x3::inverse() const {
+    // The rows of the cofactor matrix are the cross products of the other two rows,
+    // so inverse = transpose(cofactor) / det.
+    const f32x4 r0 = f32x4::load(m_matrix[0]);
+    const f32x4 r1 = f32x4::load(m_matrix[1]);
+    const f32x4 r2 = f32x4::load(m_matrix[2]);
+    f32x4 c0 = cross3(r1, r2);
+    f32x4 c1 = cross3(r2, r0);
+    f32x4 c2 = cross3(r0, r1);
+    float det = dot3(r0, c0);
+
+    if (std::abs(det) < 1e-8f) {
+        throw std::runtime_error("Matrix is not invertible");
+    }
+
+    const float inv_det = 1.0f / det;
+    c0 *= inv_det;
+    c1 *= inv_det;
+    c2 *= inv_det;
+    f32x4 c3(0.0f);
+    math::simd::transpose4(c0, c1, c2, c3);
+    mat3x3 result;
+    c0.store(result.m_matrix[0]);
+    c1.store(result.m_matrix[1]);
+    c2.store(result.m_matrix[2]);
+    return result;
+}
+
+double mat3x3::determinant() const {
+    return m_matrix[0][0] * (m_matrix[1][1] * m_matrix[2][2] - m_matrix[1][2] * m_matrix[2][1]) -
+           m_matrix[0][1] * (m_matrix[1][0] * m_matrix[2][2] - m_matrix[1][2] * m_matrix[2][0]) +
+           m_matrix[0][2] * (m_matrix[1][0] * m_matrix[2][1] - m_matrix[1][1] * m_matrix[2][0]);
+}
+
+mat3x3 mat3x3::identity() {
+    return {{{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}}};
+}
+
+mat3x3 mat3x3::zero() { return mat3x3(); }
+
+std::ostream &operator<<(std::ostream &os, const math::mat3x3 &matrix) {
+    os << "[" << matrix.at(0, 0) << ", " << matrix.at(0, 1) << ", " << matrix.at(0, 2) << "]\n"
+       << "[" << matrix.at(1, 0) << ", " << matrix.at(1, 1) << ", " << matrix.at(1, 2) << "]\n"
+       << "[" << matrix.at(2, 0) << ", " << matrix.at(2, 1) << ", " << matrix.at(2, 2) << "]\n";
+    return os;
+}
+
+void transform_normals(const mat3x3 &matrix, std::span<const vec3> normals, std::span<vec3> out) {
+    if (out.size() < normals.size()) [[unlikely]] {
+        throw std::invalid_argument("Output is smaller than the input");
+    }
+    const float *src = reinterpret_cast<const float *>(normals.data());
+    float *dst = reinterpret_cast<float *>(out.data());
+    const std::size_t count = normals.size();
+
+    const float m00 = matrix.at(0, 0), m01 = matrix.at(0, 1), m02 = matrix.at(0, 2);
+    const float m10 = matrix.at(1, 0), m11 = matrix.at(1, 1), m12 = matrix.at(1, 2);
+    const float m20 = matrix.at(2, 0), m21 = matrix.at(2, 1), m22 = matrix.at(2, 2);
+
+    std::size_t i = 0;
+#if MATH_SIMD_LEVEL >= 1
+    // Eight normals per step; the scalar backend uses the per-normal loop below instead.
+    const f32x8 a00(m00), a01(m01), a02(m02);
+    const f32x8 a10(m10), a11(m11), a12(m12);
+    const f32x8 a20(m20), a21(m21), a22(m22);
+
+    for (; i + 8 <= count; i += 8) {
+        f32x8 v[3];
+        math::simd::load_vec3x8(src + 3 * i, v);
+        f32x8 n[3] = {fmadd(a02, v[2], fmadd(a01, v[1], a00 * v[0])),
+                      fmadd(a12, v[2], fmadd(a11, v[1], a10 * v[0])),
+                      fmadd(a22, v[2], fmadd(a21, v[1], a20 * v[0]))};
+        const f32x8 len_sq = fmadd(n[2], n[2], fmadd(n[1], n[1], n[0] * n[0]));
+        const f32x8 inv_len = select(len_sq >= 1e-8f, f32x8(1.0f) / sqrt(len_sq), f32x8(0.0f));
+        for (f32x8 &component : n) {
+            component *= inv_len;
+        }
+        math::simd::store_vec3x8(dst + 3 * i, n);
+    }
+#endif
+    for (; i < count; ++i) {
+        const float x = src[3 * i], y = src[3 * i + 1], z = src[3 * i + 2];
+        float nx = m00 * x + m01 * y + m02 * z;
+        float ny = m10 * x + m11 * y + m12 * z;
+        float nz = m20 * x + m21 * y + m22 * z;
+        float len_sq = nx * nx + ny * ny + nz * nz;
+        float inv_len = (len_sq < 1e-8f) ? 0.0f : 1.0f / std::sqrt(len_sq);
+        dst[3 * i] = nx * inv_len;
+        dst[3 * i + 1] = ny * inv_len;
+        dst[3 * i + 2] = nz * inv_len;
+    }
+}
+
+} // namespace math
@@ -0,0 +1,58 @@
+#ifndef MAT3X3_HPP
+#define MAT3X3_HPP
+
+#include "../vec3/vec3.hpp"
+
+#include <cstddef>
+#include <iostream>
+#include <span>
+
+namespace math {
+class mat3x3 {
+  public:
+    mat3x3();
+    mat3x3(const float (&elements)[3][3]);
+    mat3x3(const vec3 &row0, const vec3 &row1, const vec3 &row2);
+    mat3x3(const mat3x3 &other);
+
+    mat3x3 &operator=(const mat3x3 &other);
+
+    mat3x3 operator+(const mat3x3 &other) const;
+    mat3x3 operator-(const mat3x3 &other) const;
+    mat3x3 operator*(const mat3x3 &other) const;
+    mat3x3 &operator*=(const mat3x3 &other);
+
+    mat3x3 operator*(const float scalar) const;
+    mat3x3 &operator*=(const float scalar);
+
+    vec3 operator*(const vec3 &vector) const;
+
+    float &at(int row, int col);
+    const float &at(int row, int col) const;
+
+    vec3 row(int index) const;
+
+    mat3x3 transpose() const;
+    mat3x3 inverse() const;
+    double determinant() const;
+
+    static mat3x3 identity();
+    static mat3x3 zero();
+
+  private:
+    // Each row is padded to four floats so it can be moved with one 16-byte load/store.
+    // The padding lane is kept at zero.
+    alignas(16) float m_matrix[3][4];
+};
+
+std::ostream &operator<<(std::ostream &os, const math::mat3x3 &matrix);
+
+// Transforms every normal in `normals` by `matrix` and renormalizes the result into `out`
+// (which may alias `normals`). Degenerate results (squared length below 1e-8) become zero,
+// matching vec3::normalized. Pair with mat4x4::normal_matrix(), whose scale does not matter here.
+// Throws std::invalid_argument when out is shorter than normals.
+void transform_normals(const mat3x3 &matrix, std::span<const vec3> normals, std::span<vec3> out);
+
+} // namespace math
+
+#endif // MAT3X3_HPP
@@ -1,11 +1,32 @@
 #include "mat4x4.hpp"
 
-#include <cmath>
-#include <immintrin.h>
+#include "../simd/simd.hpp"
 
+#include <cmath>
 #include <cstring>
 
-#define NO_SIMD
+namespace {
+
+using math::simd::f32x4;
+using math::simd::f32x8;
+
+// out = op(a, b) over the matrix as two registers of eight floats (rows 0-1 and 2-3).
+template <typename Op>
+void for_each_half(const math::mat4x4 &a, const math::mat4x4 &b, math::mat4x4 &out, Op op) {
+    for (int i = 0; i < 16; i += 8) {
+        op(f32x8::load(a.data() + i), f32x8::load(b.data() + i)).store(out.data() + i);
+    }
+}
+
+template <typename Op>
+void for_each_half(const math::mat4x4 &a, float scalar, math::mat4x4 &out, Op op) {
+    const f32x8 b(scalar);
+    for (int i = 0; i < 16; i += 8) {
+        op(f32x8::load(a.data() + i), b).store(out.data() + i);
+    }
+}
+
+} // namespace
 
 math::mat4x4::mat4x4() { std::memset(m_matrix, 0, sizeof(m_matrix)); }
 
@@ -26,456 +47,66 @@ math::mat4x4 &math::mat4x4::operator=(const mat4x4 &other) {
 
 math::mat4x4 math::mat4x4::operator+(const mat4x4 &other) const {
     mat4x4 result;
-#ifndef NO_SIMD
-    __m256 vec_a1 = _mm256_load_ps(&m_matrix[0][0]);
-    __m256 vec_b1 = _mm256_load_ps(&other.m_matrix[0][0]);
-    __m256 vec_result1 = _mm256_add_ps(vec_a1, vec_b1);
-    _mm256_store_ps(&result.m_matrix[0][0], vec_result1);
-
-    __m256 vec_a2 = _mm256_load_ps(&m_matrix[2][0]);
-    __m256 vec_b2 = _mm256_load_ps(&other.m_matrix[2][0]);
-    __m256 vec_result2 = _mm256_add_ps(vec_a2, vec_b2);
-    _mm256_store_ps(&result.m_matrix[2][0], vec_result2);
-#else
-    result.m_matrix[0][0] = m_matrix[0][0] + other.m_matrix[0][0];
-    result.m_matrix[0][1] = m_matrix[0][1] + other.m_matrix[0][1];
-    result.m_matrix[0][2] = m_matrix[0][2] + other.m_matrix[0][2];
-    result.m_matrix[0][3] = m_matrix[0][3] + other.m_matrix[0][3];
-
-    result.m_matrix[1][0] = m_matrix[1][0] + other.m_matrix[1][0];
-    result.m_matrix[1][1] = m_matrix[1][1] + other.m_matrix[1][1];
-    result.m_matrix[1][2] = m_matrix[1][2] + other.m_matrix[1][2];
-    result.m_matrix[1][3] = m_matrix[1][3] + other.m_matrix[1][3];
-
-    result.m_matrix[2][0] = m_matrix[2][0] + other.m_matrix[2][0];
-    result.m_matrix[2][1] = m_matrix[2][1] + other.m_matrix[2][1];
-    result.m_matrix[2][2] = m_matrix[2][2] + other.m_matrix[2][2];
-    result.m_matrix[2][3] = m_matrix[2][3] + other.m_matrix[2][3];
-
-    result.m_matrix[3][0] = m_matrix[3][0] + other.m_matrix[3][0];
-    result.m_matrix[3][1] = m_matrix[3][1] + other.m_matrix[3][1];
-    result.m_matrix[3][2] = m_matrix[3][2] + other.m_matrix[3][2];
-    result.m_matrix[3][3] = m_matrix[3][3] + other.m_matrix[3][3];
-#endif
+    for_each_half(*this, other, result, [](f32x8 a, f32x8 b) { return a + b; });
     return result;
 }
 
 math::mat4x4 math::mat4x4::operator-(const mat4x4 &other) const {
     mat4x4 result;
-#ifndef NO_SIMD
-    __m256 vec_a1 = _mm256_load_ps(&m_matrix[0][0]);
-    __m256 vec_b1 = _mm256_load_ps(&other.m_matrix[0][0]);
-    __m256 vec_result1 = _mm256_sub_ps(vec_a1, vec_b1);
-    _mm256_store_ps(&result.m_matrix[0][0], vec_result1);
-
-    __m256 vec_a2 = _mm256_load_ps(&m_matrix[2][0]);
-    __m256 vec_b2 = _mm256_load_ps(&other.m_matrix[2][0]);
-    __m256 vec_result2 = _mm256_sub_ps(vec_a2, vec_b2);
-    _mm256_store_ps(&result.m_matrix[2][0], vec_result2);
-#else
-    result.m_matrix[0][0] = m_matrix[0][0] - other.m_matrix[0][0];
-    result.m_matrix[0][1] = m_matrix[0][1] - other.m_matrix[0][1];
-    result.m_matrix[0][2] = m_matrix[0][2] - other.m_matrix[0][2];
-    result.m_matrix[0][3] = m_matrix[0][3] - other.m_matrix[0][3];
-
-    result.m_matrix[1][0] = m_matrix[1][0] - other.m_matrix[1][0];
-    result.m_matrix[1][1] = m_matrix[1][1] - other.m_matrix[1][1];
-    result.m_matrix[1][2] = m_matrix[1][2] - other.m_matrix[1][2];
-    result.m_matrix[1][3] = m_matrix[1][3] - other.m_matrix[1][3];
-
-    result.m_matrix[2][0] = m_matrix[2][0] - other.m_matrix[2][0];
-    result.m_matrix[2][1] = m_matrix[2][1] - other.m_matrix[2][1];
-    result.m_matrix[2][2] = m_matrix[2][2] - other.m_matrix[2][2];
-    result.m_matrix[2][3] = m_matrix[2][3] - other.m_matrix[2][3];
-
-    result.m_matrix[3][0] = m_matrix[3][0] - other.m_matrix[3][0];
-    result.m_matrix[3][1] = m_matrix[3][1] - other.m_matrix[3][1];
-    result.m_matrix[3][2] = m_matrix[3][2] - other.m_matrix[3][2];
-    result.m_matrix[3][3] = m_matrix[3][3] - other.m_matrix[3][3];
-#endif
+    for_each_half(*this, other, result, [](f32x8 a, f32x8 b) { return a - b; });
     return result;
 }
 
+// Row r of the product is sum_k m[r][k] * other.row(k); two rows are computed per register.
 math::mat4x4 math::mat4x4::operator*(const mat4x4 &other) const {
+    const f32x4 o0 = f32x4::load(&other.m_matrix[0][0]);
+    const f32x4 o1 = f32x4::load(&other.m_matrix[1][0]);
+    const f32x4 o2 = f32x4::load(&other.m_matrix[2][0]);
+    const f32x4 o3 = f32x4::load(&other.m_matrix[3][0]);
+    const f32x8 b0(o0, o0), b1(o1, o1), b2(o2, o2), b3(o3, o3);
+
     mat4x4 result;
-#ifndef NO_SIMD
-
-    const __m128 o0 = _mm_load_ps(&other.m_matrix[0][0]);
-    const __m128 o1 = _mm_load_ps(&other.m_matrix[1][0]);
-    const __m128 o2 = _mm_load_ps(&other.m_matrix[2][0]);
-    const __m128 o3 = _mm_load_ps(&other.m_matrix[3][0]);
-
-    const __m128 m0 = _mm_load_ps(&m_matrix[0][0]);
-    const __m128 m1 = _mm_load_ps(&m_matrix[1][0]);
-    const __m128 m2 = _mm_load_ps(&m_matrix[2][0]);
-    const __m128 m3 = _mm_load_ps(&m_matrix[3][0]);
-
-    __m128 m0_x = _mm_shuffle_ps(m0, m0, 0x00);
-    __m128 m0_y = _mm_shuffle_ps(m0, m0, 0x55);
-    __m128 m0_z = _mm_shuffle_ps(m0, m0, 0xAA);
-    __m128 m0_w = _mm_shuffle_ps(m0, m0, 0xFF);
-
-    __m128 m1_x = _mm_shuffle_ps(m1, m1, 0x00);
-    __m128 m1_y = _mm_shuffle_ps(m1, m1, 0x55);
-    __m128 m1_z = _mm_shuffle_ps(m1, m1, 0xAA);
-    __m128 m1_w = _mm_shuffle_ps(m1, m1, 0xFF);
-
-    __m128 m2_x = _mm_shuffle_ps(m2, m2, 0x00);
-    __m128 m2_y = _mm_shuffle_ps(m2, m2, 0x55);
-    __m128 m2_z = _mm_shuffle_ps(m2, m2, 0xAA);
-    __m128 m2_w = _mm_shuffle_ps(m2, m2, 0xFF);
-
-    __m128 m3_x = _mm_shuffle_ps(m3, m3, 0x00);
-    __m128 m3_y = _mm_shuffle_ps(m3, m3, 0x55);
-    __m128 m3_z = _mm_shuffle_ps(m3, m3, 0xAA);
-    __m128 m3_w = _mm_shuffle_ps(m3, m3, 0xFF);
-
-    __m128 r0 = _mm_mul_ps(m0_x, o0);
-    __m128 r1 = _mm_mul_ps(m1_x, o0);
-    __m128 r2 = _mm_mul_ps(m2_x, o0);
-    __m128 r3 = _mm_mul_ps(m3_x, o0);
-
-    r0 = _mm_fmadd_ps(m0_y, o1, r0);
-    r1 = _mm_fmadd_ps(m1_y, o1, r1);
-    r2 = _mm_fmadd_ps(m2_y, o1, r2);
-    r3 = _mm_fmadd_ps(m3_y, o1, r3);
-
-    r0 = _mm_fmadd_ps(m0_z, o2, r0);
-    r1 = _mm_fmadd_ps(m1_z, o2, r1);
-    r2 = _mm_fmadd_ps(m2_z, o2, r2);
-    r3 = _mm_fmadd_ps(m3_z, o2, r3);
-
-    r0 = _mm_fmadd_ps(m0_w, o3, r0);
-    r1 = _mm_fmadd_ps(m1_w, o3, r1);
-    r2 = _mm_fmadd_ps(m2_w, o3, r2);
-    r3 = _mm_fmadd_ps(m3_w, o3, r3);
-
-    _mm_store_ps(&result.m_matrix[0][0], r0);
-    _mm_store_ps(&result.m_matrix[1][0], r1);
-    _mm_store_ps(&result.m_matrix[2][0], r2);
-    _mm_store_ps(&result.m_matrix[3][0], r3);
-
-#else
-    result.m_matrix[0][0] =
-        m_matrix[0][0] * other.m_matrix[0][0] + m_matrix[0][1] * other.m_matrix[1][0] +
-        m_matrix[0][2] * other.m_matrix[2][0] + m_matrix[0][3] * other.m_matrix[3][0];
-    result.m_matrix[0][1] =
-        m_matrix[0][0] * other.m_matrix[0][1] + m_matrix[0][1] * other.m_matrix[1][1] +
-        m_matrix[0][2] * other.m_matrix[2][1] + m_matrix[0][3] * other.m_matrix[3][1];
-    result.m_matrix[0][2] =
-        m_matrix[0][0] * other.m_matrix[0][2] + m_matrix[0][1] * other.m_matrix[1][2] +
-        m_matrix[0][2] * other.m_matrix[2][2] + m_matrix[0][3] * other.m_matrix[3][2];
-    result.m_matrix[0][3] =
-        m_matrix[0][0] * other.m_matrix[0][3] + m_matrix[0][1] * other.m_matrix[1][3] +
-        m_matrix[0][2] * other.m_matrix[2][3] + m_matrix[0][3] * other.m_matrix[3][3];
-    result.m_matrix[1][0] =
-        m_matrix[1][0] * other.m_matrix[0][0] + m_matrix[1][1] * other.m_matrix[1][0] +
-        m_matrix[1][2] * other.m_matrix[2][0] + m_matrix[1][3] * other.m_matrix[3][0];
-    result.m_matrix[1][1] =
-        m_matrix[1][0] * other.m_matrix[0][1] + m_matrix[1][1] * other.m_matrix[1][1] +
-        m_matrix[1][2] * other.m_matrix[2][1] + m_matrix[1][3] * other.m_matrix[3][1];
-    result.m_matrix[1][2] =
-        m_matrix[1][0] * other.m_matrix[0][2] + m_matrix[1][1] * other.m_matrix[1][2] +
-        m_matrix[1][2] * other.m_matrix[2][2] + m_matrix[1][3] * other.m_matrix[3][2];
-    result.m_matrix[1][3] =
-        m_matrix[1][0] * other.m_matrix[0][3] + m_matrix[1][1] * other.m_matrix[1][3] +
-        m_matrix[1][2] * other.m_matrix[2][3] + m_matrix[1][3] * other.m_matrix[3][3];
-    result.m_matrix[2][0] =
-        m_matrix[2][0] * other.m_matrix[0][0] + m_matrix[2][1] * other.m_matrix[1][0] +
-        m_matrix[2][2] * other.m_matrix[2][0] + m_matrix[2][3] * other.m_matrix[3][0];
-    result.m_matrix[2][1] =
-        m_matrix[2][0] * other.m_matrix[0][1] + m_matrix[2][1] * other.m_matrix[1][1] +
-        m_matrix[2][2] * other.m_matrix[2][1] + m_matrix[2][3] * other.m_matrix[3][1];
-    result.m_matrix[2][2] =
-        m_matrix[2][0] * other.m_matrix[0][2] + m_matrix[2][1] * other.m_matrix[1][2] +
-        m_matrix[2][2] * other.m_matrix[2][2] + m_matrix[2][3] * other.m_matrix[3][2];
-    result.m_matrix[2][3] =
-        m_matrix[2][0] * other.m_matrix[0][3] + m_matrix[2][1] * other.m_matrix[1][3] +
-        m_matrix[2][2] * other.m_matrix[2][3] + m_matrix[2][3] * other.m_matrix[3][3];
-    result.m_matrix[3][0] =
-        m_matrix[3][0] * other.m_matrix[0][0] + m_matrix[3][1] * other.m_matrix[1][0] +
-        m_matrix[3][2] * other.m_matrix[2][0] + m_matrix[3][3] * other.m_matrix[3][0];
-    result.m_matrix[3][1] =
-        m_matrix[3][0] * other.m_matrix[0][1] + m_matrix[3][1] * other.m_matrix[1][1] +
-        m_matrix[3][2] * other.m_matrix[2][1] + m_matrix[3][3] * other.m_matrix[3][1];
-    result.m_matrix[3][2] =
-        m_matrix[3][0] * other.m_matrix[0][2] + m_matrix[3][1] * other.m_matrix[1][2] +
-        m_matrix[3][2] * other.m_matrix[2][2] + m_matrix[3][3] * other.m_matrix[3][2];
-    result.m_matrix[3][3] =
-        m_matrix[3][0] * other.m_matrix[0][3] + m_matrix[3][1] * other.m_matrix[1][3] +
-        m_matrix[3][2] * other.m_matrix[2][3] + m_matrix[3][3] * other.m_matrix[3][3];
-#endif
+    for (int r = 0; r < 4; r += 2) {
+        const f32x8 a = f32x8::load(&m_matrix[r][0]);
+        f32x8 row = simd::broadcast_lane<0>(a) * b0;
+        row = fmadd(simd::broadcast_lane<1>(a), b1, row);
+        row = fmadd(simd::broadcast_lane<2>(a), b2, row);
+        row = fmadd(simd::broadcast_lane<3>(a), b3, row);
+        row.store(&result.m_matrix[r][0]);
+    }
     return result;
 }
 
 math::mat4x4 &math::mat4x4::operator+=(const mat4x4 &other) {
-#ifndef NO_SIMD
-    __m256 vec_a1 = _mm256_load_ps(&m_matrix[0][0]);
-    __m256 vec_b1 = _mm256_load_ps(&other.m_matrix[0][0]);
-    __m256 vec_result1 = _mm256_add_ps(vec_a1, vec_b1);
-    _mm256_store_ps(&m_matrix[0][0], vec_result1);
-
-    __m256 vec_a2 = _mm256_load_ps(&m_matrix[2][0]);
-    __m256 vec_b2 = _mm256_load_ps(&other.m_matrix[2][0]);
-    __m256 vec_result2 = _mm256_add_ps(vec_a2, vec_b2);
-    _mm256_store_ps(&m_matrix[2][0], vec_result2);
-#else
-    m_matrix[0][0] += other.m_matrix[0][0];
-    m_matrix[0][1] += other.m_matrix[0][1];
-    m_matrix[0][2] += other.m_matrix[0][2];
-    m_matrix[0][3] += other.m_matrix[0][3];
-    m_matrix[1][0] += other.m_matrix[1][0];
-    m_matrix[1][1] += other.m_matrix[1][1];
-    m_matrix[1][2] += other.m_matrix[1][2];
-    m_matrix[1][3] += other.m_matrix[1][3];
-    m_matrix[2][0] += other.m_matrix[2][0];
-    m_matrix[2][1] += other.m_matrix[2][1];
-    m_matrix[2][2] += other.m_matrix[2][2];
-    m_matrix[2][3] += other.m_matrix[2][3];
-    m_matrix[3][0] += other.m_matrix[3][0];
-    m_matrix[3][1] += other.m_matrix[3][1];
-    m_matrix[3][2] += other.m_matrix[3][2];
-    m_matrix[3][3] += other.m_matrix[3][3];
-#endif
+    for_each_half(*this, other, *this, [](f32x8 a, f32x8 b) { return a + b; });
     return *this;
 }
 
 math::mat4x4 &math::mat4x4::operator-=(const mat4x4 &other) {
-#ifndef NO_SIMD
-    __m256 vec_a1 = _mm256_load_ps(&m_matrix[0][0]);
-    __m256 vec_b1 = _mm256_load_ps(&other.m_matrix[0][0]);
-    __m256 vec_result1 = _mm256_sub_ps(vec_a1, vec_b1);
-    _mm256_store_ps(&m_matrix[0][0], vec_result1);
-
-    __m256 vec_a2 = _mm256_load_ps(&m_matrix[2][0]);
-    __m256 vec_b2 = _mm256_load_ps(&other.m_matrix[2][0]);
-    __m256 vec_result2 = _mm256_sub_ps(vec_a2, vec_b2);
-    _mm256_store_ps(&m_matrix[2][0], vec_result2);
-#else
-    m_matrix[0][0] -= other.m_matrix[0][0];
-    m_matrix[0][1] -= other.m_matrix[0][1];
-    m_matrix[0][2] -= other.m_matrix[0][2];
-    m_matrix[0][3] -= other.m_matrix[0][3];
-    m_matrix[1][0] -= other.m_matrix[1][0];
-    m_matrix[1][1] -= other.m_matrix[1][1];
-    m_matrix[1][2] -= other.m_matrix[1][2];
-    m_matrix[1][3] -= other.m_matrix[1][3];
-    m_matrix[2][0] -= other.m_matrix[2][0];
-    m_matrix[2][1] -= other.m_matrix[2][1];
-    m_matrix[2][2] -= other.m_matrix[2][2];
-    m_matrix[2][3] -= other.m_matrix[2][3];
-    m_matrix[3][0] -= other.m_matrix[3][0];
-    m_matrix[3][1] -= other.m_matrix[3][1];
-    m_matrix[3][2] -= other.m_matrix[3][2];
-    m_matrix[3][3] -= other.m_matrix[3][3];
-#endif
+    for_each_half(*this, other, *this, [](f32x8 a, f32x8 b) { return a - b; });
     return *this;
 }
 
 math::mat4x4 &math::mat4x4::operator*=(const mat4x4 &other) {
-#ifndef NO_SIMD
-    const __m128 b0 = _mm_load_ps(&other.m_matrix[0][0]);
-    const __m128 b1 = _mm_load_ps(&other.m_matrix[1][0]);
-    const __m128 b2 = _mm_load_ps(&other.m_matrix[2][0]);
-    const __m128 b3 = _mm_load_ps(&other.m_matrix[3][0]);
-
-    const __m128 a0 = _mm_load_ps(&m_matrix[0][0]);
-    const __m128 a1 = _mm_load_ps(&m_matrix[1][0]);
-    const __m128 a2 = _mm_load_ps(&m_matrix[2][0]);
-    const __m128 a3 = _mm_load_ps(&m_matrix[3][0]);
-
-    __m128 a0_x = _mm_shuffle_ps(a0, a0, 0x00);
-    __m128 a0_y = _mm_shuffle_ps(a0, a0, 0x55);
-    __m128 a0_z = _mm_shuffle_ps(a0, a0, 0xAA);
-    __m128 a0_w = _mm_shuffle_ps(a0, a0, 0xFF);
-
-    __m128 a1_x = _mm_shuffle_ps(a1, a1, 0x00);
-    __m128 a1_y = _mm_shuffle_ps(a1, a1, 0x55);
-    __m128 a1_z = _mm_shuffle_ps(a1, a1, 0xAA);
-    __m128 a1_w = _mm_shuffle_ps(a1, a1, 0xFF);
-
-    __m128 a2_x = _mm_shuffle_ps(a2, a2, 0x00);
-    __m128 a2_y = _mm_shuffle_ps(a2, a2, 0x55);
-    __m128 a2_z = _mm_shuffle_ps(a2, a2, 0xAA);
-    __m128 a2_w = _mm_shuffle_ps(a2, a2, 0xFF);
-
-    __m128 a3_x = _mm_shuffle_ps(a3, a3, 0x00);
-    __m128 a3_y = _mm_shuffle_ps(a3, a3, 0x55);
-    __m128 a3_z = _mm_shuffle_ps(a3, a3, 0xAA);
-    __m128 a3_w = _mm_shuffle_ps(a3, a3, 0xFF);
-
-    __m128 r0 = _mm_mul_ps(a0_x, b0);
-    __m128 r1 = _mm_mul_ps(a1_x, b0);
-    __m128 r2 = _mm_mul_ps(a2_x, b0);
-    __m128 r3 = _mm_mul_ps(a3_x, b0);
-
-    r0 = _mm_fmadd_ps(a0_y, b1, r0);
-    r1 = _mm_fmadd_ps(a1_y, b1, r1);
-    r2 = _mm_fmadd_ps(a2_y, b1, r2);
-    r3 = _mm_fmadd_ps(a3_y, b1, r3);
-
-    r0 = _mm_fmadd_ps(a0_z, b2, r0);
-    r1 = _mm_fmadd_ps(a1_z, b2, r1);
-    r2 = _mm_fmadd_ps(a2_z, b2, r2);
-    r3 = _mm_fmadd_ps(a3_z, b2, r3);
-
-    r0 = _mm_fmadd_ps(a0_w, b3, r0);
-    r1 = _mm_fmadd_ps(a1_w, b3, r1);
-    r2 = _mm_fmadd_ps(a2_w, b3, r2);
-    r3 = _mm_fmadd_ps(a3_w, b3, r3);
-
-    _mm_store_ps(&m_matrix[0][0], r0);
-    _mm_store_ps(&m_matrix[1][0], r1);
-    _mm_store_ps(&m_matrix[2][0], r2);
-    _mm_store_ps(&m_matrix[3][0], r3);
-#else
-    mat4x4 temp = *this;
-
-    m_matrix[0][0] =
-        temp.m_matrix[0][0] * other.m_matrix[0][0] + temp.m_matrix[0][1] * other.m_matrix[1][0] +
-        temp.m_matrix[0][2] * other.m_matrix[2][0] + temp.m_matrix[0][3] * other.m_matrix[3][0];
-    m_matrix[0][1] =
-        temp.m_matrix[0][0] * other.m_matrix[0][1] + temp.m_matrix[0][1] * other.m_matrix[1][1] +
-        temp.m_matrix[0][2] * other.m_matrix[2][1] + temp.m_matrix[0][3] * other.m_matrix[3][1];
-    m_matrix[0][2] =
-        temp.m_matrix[0][0] * other.m_matrix[0][2] + temp.m_matrix[0][1] * other.m_matrix[1][2] +
-        temp.m_matrix[0][2] * other.m_matrix[2][2] + temp.m_matrix[0][3] * other.m_matrix[3][2];
-    m_matrix[0][3] =
-        temp.m_matrix[0][0] * other.m_matrix[0][3] + temp.m_matrix[0][1] * other.m_matrix[1][3] +
-        temp.m_matrix[0][2] * other.m_matrix[2][3] + temp.m_matrix[0][3] * other.m_matrix[3][3];
-
-    m_matrix[1][0] =
-        temp.m_matrix[1][0] * other.m_matrix[0][0] + temp.m_matrix[1][1] * other.m_matrix[1][0] +
-        temp.m_matrix[1][2] * other.m_matrix[2][0] + temp.m_matrix[1][3] * other.m_matrix[3][0];
-    m_matrix[1][1] =
-        temp.m_matrix[1][0] * other.m_matrix[0][1] + temp.m_matrix[1][1] * other.m_matrix[1][1] +
-        temp.m_matrix[1][2] * other.m_matrix[2][1] + temp.m_matrix[1][3] * other.m_matrix[3][1];
-    m_matrix[1][2] =
-        temp.m_matrix[1][0] * other.m_matrix[0][2] + temp.m_matrix[1][1] * other.m_matrix[1][2] +
-        temp.m_matrix[1][2] * other.m_matrix[2][2] + temp.m_matrix[1][3] * other.m_matrix[3][2];
-    m_matrix[1][3] =
-        temp.m_matrix[1][0] * other.m_matrix[0][3] + temp.m_matrix[1][1] * other.m_matrix[1][3] +
-        temp.m_matrix[1][2] * other.m_matrix[2][3] + temp.m_matrix[1][3] * other.m_matrix[3][3];
-
-    m_matrix[2][0] =
-        temp.m_matrix[2][0] * other.m_matrix[0][0] + temp.m_matrix[2][1] * other.m_matrix[1][0] +
-        temp.m_matrix[2][2] * other.m_matrix[2][0] + temp.m_matrix[2][3] * other.m_matrix[3][0];
-    m_matrix[2][1] =
-        temp.m_matrix[2][0] * other.m_matrix[0][1] + temp.m_matrix[2][1] * other.m_matrix[1][1] +
-        temp.m_matrix[2][2] * other.m_matrix[2][1] + temp.m_matrix[2][3] * other.m_matrix[3][1];
-    m_matrix[2][2] =
-        temp.m_matrix[2][0] * other.m_matrix[0][2] + temp.m_matrix[2][1] * other.m_matrix[1][2] +
-        temp.m_matrix[2][2] * other.m_matrix[2][2] + temp.m_matrix[2][3] * other.m_matrix[3][2];
-    m_matrix[2][3] =
-        temp.m_matrix[2][0] * other.m_matrix[0][3] + temp.m_matrix[2][1] * other.m_matrix[1][3] +
-        temp.m_matrix[2][2] * other.m_matrix[2][3] + temp.m_matrix[2][3] * other.m_matrix[3][3];
-
-    m_matrix[3][0] =
-        temp.m_matrix[3][0] * other.m_matrix[0][0] + temp.m_matrix[3][1] * other.m_matrix[1][0] +
-        temp.m_matrix[3][2] * other.m_matrix[2][0] + temp.m_matrix[3][3] * other.m_matrix[3][0];
-    m_matrix[3][1] =
-        temp.m_matrix[3][0] * other.m_matrix[0][1] + temp.m_matrix[3][1] * other.m_matrix[1][1] +
-        temp.m_matrix[3][2] * other.m_matrix[2][1] + temp.m_matrix[3][3] * other.m_matrix[3][1];
-    m_matrix[3][2] =
-        temp.m_matrix[3][0] * other.m_matrix[0][2] + temp.m_matrix[3][1] * other.m_matrix[1][2] +
-        temp.m_matrix[3][2] * other.m_matrix[2][2] + temp.m_matrix[3][3] * other.m_matrix[3][2];
-    m_matrix[3][3] =
-        temp.m_matrix[3][0] * other.m_matrix[0][3] + temp.m_matrix[3][1] * other.m_matrix[1][3] +
-        temp.m_matrix[3][2] * other.m_matrix[2][3] + temp.m_matrix[3][3] * other.m_matrix[3][3];
-#endif
+    *this = *this * other;
     return *this;
 }
 
 math::mat4x4 math::mat4x4::operator+(const float scalar) const {
     mat4x4 result;
-#ifndef NO_SIMD
-    __m256 vec_scalar = _mm256_set1_ps(scalar);
-    __m256 vec_a1 = _mm256_load_ps(&m_matrix[0][0]);
-    __m256 vec_result1 = _mm256_add_ps(vec_a1, vec_scalar);
-    _mm256_store_ps(&result.m_matrix[0][0], vec_result1);
-    __m256 vec_a2 = _mm256_load_ps(&m_matrix[2][0]);
-    __m256 vec_result2 = _mm256_add_ps(vec_a2, vec_scalar);
-    _mm256_store_ps(&result.m_matrix[2][0], vec_result2);
-#else
-    result.m_matrix[0][0] = m_matrix[0][0] + scalar;
-    result.m_matrix[0][1] = m_matrix[0][1] + scalar;
-    result.m_matrix[0][2] = m_matrix[0][2] + scalar;
-    result.m_matrix[0][3] = m_matrix[0][3] + scalar;
-    result.m_matrix[1][0] = m_matrix[1][0] + scalar;
-    result.m_matrix[1][1] = m_matrix[1][1] + scalar;
-    result.m_matrix[1][2] = m_matrix[1][2] + scalar;
-    result.m_matrix[1][3] = m_matrix[1][3] + scalar;
-    result.m_matrix[2][0] = m_matrix[2][0] + scalar;
-    result.m_matrix[2][1] = m_matrix[2][1] + scalar;
-    result.m_matrix[2][2] = m_matrix[2][2] + scalar;
-    result.m_matrix[2][3] = m_matrix[2][3] + scalar;
-    result.m_matrix[3][0] = m_matrix[3][0] + scalar;
-    result.m_matrix[3][1] = m_matrix[3][1] + scalar;
-    result.m_matrix[3][2] = m_matrix[3][2] + scalar;
-    result.m_matrix[3][3] = m_matrix[3][3] + scalar;
-#endif
+    for_each_half(*this, scalar, result, [](f32x8 a, f32x8 b) { return a + b; });
     return result;
 }
 
 math::mat4x4 math::mat4x4::operator-(const float scalar) const {
     mat4x4 result;
-#ifndef NO_SIMD
-    __m256 vec_scalar = _mm256_set1_ps(scalar);
-    __m256 vec_a1 = _mm256_load_ps(&m_matrix[0][0]);
-    __m256 vec_result1 = _mm256_sub_ps(vec_a1, vec_scalar);
-    _mm256_store_ps(&result.m_matrix[0][0], vec_result1);
-    __m256 vec_a2 = _mm256_load_ps(&m_matrix[2][0]);
-    __m256 vec_result2 = _mm256_sub_ps(vec_a2, vec_scalar);
-    _mm256_store_ps(&result.m_matrix[2][0], vec_result2);
-#else
-    result.m_matrix[0][0] = m_matrix[0][0] - scalar;
-    result.m_matrix[0][1] = m_matrix[0][1] - scalar;
-    result.m_matrix[0][2] = m_matrix[0][2] - scalar;
-    result.m_matrix[0][3] = m_matrix[0][3] - scalar;
-    result.m_matrix[1][0] = m_matrix[1][0] - scalar;
-    result.m_matrix[1][1] = m_matrix[1][1] - scalar;
-    result.m_matrix[1][2] = m_matrix[1][2] - scalar;
-    result.m_matrix[1][3] = m_matrix[1][3] - scalar;
-    result.m_matrix[2][0] = m_matrix[2][0] - scalar;
-    result.m_matrix[2][1] = m_matrix[2][1] - scalar;
-    result.m_matrix[2][2] = m_matrix[2][2] - scalar;
-    result.m_matrix[2][3] = m_matrix[2][3] - scalar;
-    result.m_matrix[3][0] = m_matrix[3][0] - scalar;
-    result.m_matrix[3][1] = m_matrix[3][1] - scalar;
-    result.m_matrix[3][2] = m_matrix[3][2] - scalar;
-    result.m_matrix[3][3] = m_matrix[3][3] - scalar;
-#endif
+    for_each_half(*this, scalar, result, [](f32x8 a, f32x8 b) { return a - b; });
     return result;
 }
 
 math::mat4x4 math::mat4x4::operator*(const float scalar) const {
     mat4x4 result;
-#ifndef NO_SIMD
-    __m256 vec_scalar = _mm256_set1_ps(scalar);
-    __m256 vec_a1 = _mm256_load_ps(&m_matrix[0][0]);
-    __m256 vec_result1 = _mm256_mul_ps(vec_a1, vec_scalar);
-    _mm256_store_ps(&result.m_matrix[0][0], vec_result1);
-    __m256 vec_a2 = _mm256_load_ps(&m_matrix[2][0]);
-    __m256 vec_result2 = _mm256_mul_ps(vec_a2, vec_scalar);
-    _mm256_store_ps(&result.m_matrix[2][0], vec_result2);
-#else
-    result.m_matrix[0][0] = m_matrix[0][0] * scalar;
-    result.m_matrix[0][1] = m_matrix[0][1] * scalar;
-    result.m_matrix[0][2] = m_matrix[0][2] * scalar;
-    result.m_matrix[0][3] = m_matrix[0][3] * scalar;
-    result.m_matrix[1][0] = m_matrix[1][0] * scalar;
-    result.m_matrix[1][1] = m_matrix[1][1] * scalar;
-    result.m_matrix[1][2] = m_matrix[1][2] * scalar;
-    result.m_matrix[1][3] = m_matrix[1][3] * scalar;
-    result.m_matrix[2][0] = m_matrix[2][0] * scalar;
-    result.m_matrix[2][1] = m_matrix[2][1] * scalar;
-    result.m_matrix[2][2] = m_matrix[2][2] * scalar;
-    result.m_matrix[2][3] = m_matrix[2][3] * scalar;
-    result.m_matrix[3][0] = m_matrix[3][0] * scalar;
-    result.m_matrix[3][1] = m_matrix[3][1] * scalar;
-    result.m_matrix[3][2] = m_matrix[3][2] * scalar;
-    result.m_matrix[3][3] = m_matrix[3][3] * scalar;
-#endif
+    for_each_half(*this, scalar, result, [](f32x8 a, f32x8 b) { return a * b; });
     return result;
 }
 
@@ -519,37 +150,17 @@ const float &math::mat4x4::at(int row, int col) const {
 }
 
 math::mat4x4 math::mat4x4::transpose() const {
+    f32x4 row0 = f32x4::load(&m_matrix[0][0]);
+    f32x4 row1 = f32x4::load(&m_matrix[1][0]);
+    f32x4 row2 = f32x4::load(&m_matrix[2][0]);
+    f32x4 row3 = f32x4::load(&m_matrix[3][0]);
+    simd::transpose4(row0, row1, row2, row3);
+
     mat4x4 result;
-#ifndef NO_SIMD
-    __m128 row0 = _mm_load_ps(&m_matrix[0][0]);
-    __m128 row1 = _mm_load_ps(&m_matrix[1][0]);
-    __m128 row2 = _mm_load_ps(&m_matrix[2][0]);
-    __m128 row3 = _mm_load_ps(&m_matrix[3][0]);
-
-    _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
-
-    _mm_store_ps(&result.m_matrix[0][0], row0);
-    _mm_store_ps(&result.m_matrix[1][0], row1);
-    _mm_store_ps(&result.m_matrix[2][0], row2);
-    _mm_store_ps(&result.m_matrix[3][0], row3);
-#else
-    result.m_matrix[0][0] = m_matrix[0][0];
-    result.m_matrix[0][1] = m_matrix[1][0];
-    result.m_matrix[0][2] = m_matrix[2][0];
-    result.m_matrix[0][3] = m_matrix[3][0];
-    result.m_matrix[1][0] = m_matrix[0][1];
-    result.m_matrix[1][1] = m_matrix[1][1];
-    result.m_matrix[1][2] = m_matrix[2][1];
-    result.m_matrix[1][3] = m_matrix[3][1];
-    result.m_matrix[2][0] = m_matrix[0][2];
-    result.m_matrix[2][1] = m_matrix[1][2];
-    result.m_matrix[2][2] = m_matrix[2][2];
-    result.m_matrix[2][3] = m_matrix[3][2];
-    result.m_matrix[3][0] = m_matrix[0][3];
-    result.m_matrix[3][1] = m_matrix[1][3];
-    result.m_matrix[3][2] = m_matrix[2][3];
-    result.m_matrix[3][3] = m_matrix[3][3];
-#endif
+    row0.store(&result.m_matrix[0][0]);
+    row1.store(&result.m_matrix[1][0]);
+    row2.store(&result.m_matrix[2][0]);
+    row3.store(&result.m_matrix[3][0]);
     return result;
 }
 
@@ -633,6 +244,26 @@ double math::mat4x4::determinant() const {
                    m[6] * (m[8] * m[13] - m[9] * m[12]));
 }
 
+math::mat3x3 math::mat4x4::normal_matrix() const {
+    const float(&m)[4][4] = m_matrix;
+    float c00 = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+    float c01 = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+    float c02 = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+    float c10 = m[2][1] * m[0][2] - m[2][2] * m[0][1];
+    float c11 = m[2][2] * m[0][0] - m[2][0] * m[0][2];
+    float c12 = m[2][0] * m[0][1] - m[2][1] * m[0][0];
+    float c20 = m[0][1] * m[1][2] - m[0][2] * m[1][1];
+    float c21 = m[0][2] * m[1][0] - m[0][0] * m[1][2];
+    float c22 = m[0][0] * m[1][1] - m[0][1] * m[1][0];
+
+    float det = m[0][0] * c00 + m[0][1] * c01 + m[0][2] * c02;
+    float sign = (det < 0.0f) ? -1.0f : 1.0f;
+
+    return {{{c00 * sign, c01 * sign, c02 * sign},
+             {c10 * sign, c11 * sign, c12 * sign},
+             {c20 * sign, c21 * sign, c22 * sign}}};
+}
+
 math::mat4x4 math::mat4x4::identity() {
     return {{{1.0f, 0.0f, 0.0f, 0.0f},
              {0.0f, 1.0f, 0.0f, 0.0f},
@@ -1,6 +1,7 @@
 #ifndef MAT4X4_HPP
 #define MAT4X4_HPP
 
+#include "../mat3x3/mat3x3.hpp"
 #include "../vec4/vec4.hpp"
 
 #include <iostream>
@@ -34,10 +35,19 @@ class mat4x4 {
     float &at(int row, int col);
     const float &at(int row, int col) const;
 
+    // The 16 elements, row-major and 32-byte aligned.
+    float *data();
+    const float *data() const;
+
     mat4x4 transpose() const;
     mat4x4 inverse() const;
     double determinant() const;
 
+    // Cofactor matrix of the upper 3x3, i.e. det * inverse-transpose, with the sign of det
+    // folded in so mirrored transforms keep outward normals. Normals transformed by it only
+    // differ in length from the exact result, so no division is needed when renormalizing.
+    mat3x3 normal_matrix() const;
+
     static mat4x4 identity();
     static mat4x4 zero();
 
@@ -70,6 +80,10 @@ private:
     alignas(32) float m_matrix[4][4];
 };
 
+inline float *mat4x4::data() { return &m_matrix[0][0]; }
+
+inline const float *mat4x4::data() const { return &m_matrix[0][0]; }
+
 std::ostream &operator<<(std::ostream &os, const math::mat4x4 &matrix);
 
 inline float from_degrees_to_radians(float degrees)
@@ -0,0 +1,219 @@
+#include "occlusion.hpp"
+
+#include "../parallel/parallel_for.hpp"
+#include "../simd/simd.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace {
+
+using math::simd::f32x4;
+using math::simd::f32x8;
+
+constexpr std::size_t box_chunk = 4096;
+
+// Lane k of a box's corners takes max.x when bit 0 of k is set, max.y for bit 1, max.z for bit 2.
+alignas(32) constexpr float corner_x[8] = {0, 1, 0, 1, 0, 1, 0, 1};
+alignas(32) constexpr float corner_y[8] = {0, 0, 1, 1, 0, 0, 1, 1};
+alignas(32) constexpr float corner_z[8] = {0, 0, 0, 0, 1, 1, 1, 1};
+
+// Level texel (x, y) = farthest of texels (2x .. 2x + 1, 2y .. 2y + 1) of the level above;
+// odd edges repeat the last row or column.
+void downsample(const float *src, int src_width, int src_height, float *dst, int dst_width,
+                int dst_height) {
+    for (int y = 0; y < dst_height; ++y) {
+        const float *r0 = src + std::size_t(2 * y) * src_width;
+        const float *r1 = src + std::size_t(std::min(2 * y + 1, src_height - 1)) * src_width;
+        float *out = dst + std::size_t(y) * dst_width;
+        int x = 0;
+        for (; 2 * x + 8 <= src_width && x + 4 <= dst_width; x += 4) {
+            const f32x4 a = max(f32x4::loadu(r0 + 2 * x), f32x4::loadu(r1 + 2 * x));
+            const f32x4 b = max(f32x4::loadu(r0 + 2 * x + 4), f32x4::loadu(r1 + 2 * x + 4));
+            max(shuffle<0, 2, 0, 2>(a, b), shuffle<1, 3, 1, 3>(a, b)).storeu(out + x);
+        }
+        for (; x < dst_width; ++x) {
+            const int x1 = std::min(2 * x + 1, src_width - 1);
+            out[x] = std::max(std::max(r0[2 * x], r0[x1]), std::max(r1[2 * x], r1[x1]));
+        }
+    }
+}
+
+int checked_size(int size) {
+    if (size <= 0) [[unlikely]] {
+        throw std::invalid_argument("Occlusion buffer size must be positive");
+    }
+    return size;
+}
+
+// One batch's view-projection (broadcast), corner masks and hi-Z levels. Chunks test from a
+// local copy so the byte stores of the results do not force reloads of the state.
+struct box_tester {
+    f32x8 m[16];
+    f32x8::mask pick[3];
+    f32x4 window_sign, window_scale, window_limit;
+    const float *levels;
+    const int *level_offset;
+    const int *level_width;
+    int width, height, last_level;
+
+    float texel(int level, int x, int y) const {
+        return levels[level_offset[level] + std::size_t(y) * level_width[level] + x];
+    }
+
+    bool visible(const math::aabb &box) const {
+        const f32x8 x = select(pick[0], f32x8(box.max.x()), f32x8(box.min.x()));
+        const f32x8 y = select(pick[1], f32x8(box.max.y()), f32x8(box.min.y()));
+        const f32x8 z = select(pick[2], f32x8(box.max.z()), f32x8(box.min.z()));
+        f32x8 clip[4];
+        for (int r = 0; r < 4; ++r) {
+            const f32x8 *row = m + 4 * r;
+            clip[r] = fmadd(row[0], x, fmadd(row[1], y, fmadd(row[2], z, row[3])));
+        }
+        const f32x8 w = clip[3], neg_w = -w;
+        // All eight corners beyond one plane of the view volume.
+        if (all(clip[0] < neg_w) || all(clip[0] > w) || all(clip[1] < neg_w) ||
+            all(clip[1] > w) || all(clip[2] < neg_w) || all(clip[2] > w)) {
+            return false;
+        }
+        // A box crossing the near plane has no bounded screen rectangle.
+        if (any(clip[2] < neg_w) || any(w <= f32x8(0.0f))) {
+            return true;
+        }
+        const f32x8 inv_w = f32x8(1.0f) / w;
+        const f32x8 nx = clip[0] * inv_w, ny = clip[1] * inv_w, nz = clip[2] * inv_w;
+        const float nearest = reduce_min(nz) * 0.5f + 0.5f;
+
+        // min x, min y, -max x, -max y in NDC, reduced together, then through the
+        // rasterizer's window transform (y down): x0, y1, x1, y0 in pixels.
+        f32x4 lo_x = min(nx.low(), nx.high()), lo_y = min(ny.low(), ny.high());
+        f32x4 hi_x = min((-nx).low(), (-nx).high()), hi_y = min((-ny).low(), (-ny).high());
+        math::simd::transpose4(lo_x, lo_y, hi_x, hi_y);
+        const f32x4 ndc = min(min(lo_x, lo_y), min(hi_x, hi_y));
+        // Clamped to [-1, size] first: corners close to the eye project arbitrarily far, and
+        // int(v + 1) - 1 is floor(v) for v >= -1.
+        float window[4];
+        min(max(fmadd(ndc, window_sign, f32x4(1.0f)) * window_scale, f32x4(-1.0f)), window_limit)
+            .storeu(window);
+        const int x0 = std::max(static_cast<int>(window[0] + 1.0f) - 1, 0);
+        const int y1 = std::min(static_cast<int>(window[1] + 1.0f) - 1, height - 1);
+        const int x1 = std::min(static_cast<int>(window[2] + 1.0f) - 1, width - 1);
+        const int y0 = std::max(static_cast<int>(window[3] + 1.0f) - 1, 0);
+        if (x0 > x1 || y0 > y1) {
+            return false;
+        }
+        // The finest level where the rectangle spans at most 2x2 texels.
+        const int level = std::min(
+            static_cast<int>(std::bit_width(static_cast<unsigned>(std::max(x1 - x0, y1 - y0)))),
+            last_level);
+        // Always four reads, repeated when the rectangle spans one texel: a data-dependent
+        // loop here costs more in mispredictions than the extra loads.
+        const int tx0 = x0 >> level, tx1 = x1 >> level, ty0 = y0 >> level, ty1 = y1 >> level;
+        const float farthest = std::max(std::max(texel(level, tx0, ty0), texel(level, tx1, ty0)),
+                                        std::max(texel(level, tx0, ty1), texel(level, tx1, ty1)));
+        return nearest <= farthest;
+    }
+};
+
+} // namespace
+
+namespace math {
+
+occlusion_buffer::occlusion_buffer(int width, int height)
+    : m_target(checked_size(width), checked_size(height)) {
+    int offset = 0;
+    for (int w = width, h = height;; w = (w + 1) / 2, h = (h + 1) / 2) {
+        m_level_offset.push_back(offset);
+        m_level_width.push_back(w);
+        m_level_height.push_back(h);
+        offset += w * h;
+        if (w == 1 && h == 1) {
+            break;
+        }
+    }
+    m_levels.assign(offset, 1.0f);
+}
+
+void occlusion_buffer::render_occluders(const mat4x4 &view_projection,
+                                        std::span<const vec3> positions,
+                                        std::span<const std::uint32_t> indices,
+                                        unsigned thread_count) {
+    raster_options options;
+    options.thread_count = thread_count;
+    m_target.clear();
+    rasterize(view_projection, positions, indices, m_target, options);
+    build_mips();
+}
+
+void occlusion_buffer::build_mips() {
+    const std::span<const float> depth = m_target.depth_buffer();
+    const int width = m_target.width(), height = m_target.height(), stride = m_target.stride();
+    for (int y = 0; y < height; ++y) {
+        std::copy_n(depth.begin() + std::size_t(y) * stride, width,
+                    m_levels.begin() + std::size_t(y) * width);
+    }
+    for (int level = 1; level < level_count(); ++level) {
+        downsample(m_levels.data() + m_level_offset[level - 1], m_level_width[level - 1],
+                   m_level_height[level - 1], m_levels.data() + m_level_offset[level],
+                   m_level_width[level], m_level_height[level]);
+    }
+}
+
+int occlusion_buffer::width() const { return m_level_width[0]; }
+
+int occlusion_buffer::height() const { return m_level_height[0]; }
+
+int occlusion_buffer::level_count() const { return static_cast<int>(m_level_offset.size()); }
+
+int occlusion_buffer::level_width(int level) const { return m_level_width[level]; }
+
+int occlusion_buffer::level_height(int level) const { return m_level_height[level]; }
+
+float occlusion_buffer::depth(int level, int x, int y) const {
+    return m_levels[m_level_offset[level] + std::size_t(y) * m_level_width[level] + x];
+}
+
+bool occlusion_buffer::is_visible(const mat4x4 &view_projection, const aabb &box) const {
+    std::uint8_t visible;
+    test_aabbs(view_projection, {&box, 1}, {&visible, 1}, 1);
+    return visible != 0;
+}
+
+void occlusion_buffer::test_aabbs(const mat4x4 &view_projection, std::span<const aabb> boxes,
+                                  std::span<std::uint8_t> visible, unsigned thread_count) const {
+    if (visible.size() < boxes.size()) [[unlikely]] {
+        throw std::invalid_argument("Visibility output is smaller than the box count");
+    }
+    box_tester tester;
+    for (int i = 0; i < 16; ++i) {
+        tester.m[i] = f32x8(view_projection.data()[i]);
+    }
+    tester.pick[0] = f32x8::load(corner_x) > f32x8(0.5f);
+    tester.pick[1] = f32x8::load(corner_y) > f32x8(0.5f);
+    tester.pick[2] = f32x8::load(corner_z) > f32x8(0.5f);
+    alignas(16) const float sign[4] = {1.0f, -1.0f, -1.0f, 1.0f};
+    alignas(16) const float scale[4] = {0.5f * width(), 0.5f * height(), 0.5f * width(),
+                                        0.5f * height()};
+    tester.window_sign = f32x4::load(sign);
+    tester.window_scale = f32x4::load(scale);
+    tester.window_limit = f32x4(static_cast<float>(std::max(width(), height())));
+    tester.levels = m_levels.data();
+    tester.level_offset = m_level_offset.data();
+    tester.level_width = m_level_width.data();
+    tester.width = width();
+    tester.height = height();
+    tester.last_level = level_count() - 1;
+
+    parallel::for_each_chunk(
+        boxes.size(), box_chunk,
+        [&](std::size_t begin, std::size_t end) {
+            const box_tester local = tester;
+            for (std::size_t i = begin; i < end; ++i) {
+                visible[i] = local.visible(boxes[i]) ? 1 : 0;
+            }
+        },
+        thread_count);
+}
+
+} // namespace math
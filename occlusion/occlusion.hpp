@@ -0,0 +1,57 @@
+#ifndef OCCLUSION_HPP
+#define OCCLUSION_HPP
+
+#include "../rasterizer/rasterizer.hpp"
+#include "../reductions/reductions.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace math {
+
+// Hierarchical-Z occlusion culling on the CPU. Occluder triangles are rendered into a small
+// depth buffer with rasterize(), and a mip chain keeps the farthest depth of every 2x2 texel
+// block, so one to four texel reads bound the occluder depth behind any screen rectangle.
+// A box is occluded when its nearest window-space depth is behind that bound.
+//
+// Depths are sampled at pixel centers like the rasterizer's, so an occluder edge counts for
+// the whole pixel; boxes peeking through by less than a pixel may be culled.
+class occlusion_buffer {
+  public:
+    explicit occlusion_buffer(int width = 256, int height = 128);
+
+    // Clears the depth, renders the occluders (three indices per triangle, see rasterize())
+    // and rebuilds the mip chain. view_projection must match the one passed to the tests.
+    void render_occluders(const mat4x4 &view_projection, std::span<const vec3> positions,
+                          std::span<const std::uint32_t> indices, unsigned thread_count = 0);
+
+    int width() const;
+    int height() const;
+    int level_count() const;
+    int level_width(int level) const;
+    int level_height(int level) const;
+    // Farthest occluder depth in texel (x, y) of level; level 0 is the rendered depth.
+    float depth(int level, int x, int y) const;
+
+    // False when the world-space box is hidden behind the occluders or entirely outside the
+    // view volume. Boxes crossing the near plane are always visible.
+    bool is_visible(const mat4x4 &view_projection, const aabb &box) const;
+    // visible[i] = is_visible(view_projection, boxes[i]) ? 1 : 0, spread over thread_count
+    // threads (0 = hardware concurrency).
+    void test_aabbs(const mat4x4 &view_projection, std::span<const aabb> boxes,
+                    std::span<std::uint8_t> visible, unsigned thread_count = 0) const;
+
+  private:
+    void build_mips();
+
+    raster_target m_target;
+    std::vector<int> m_level_offset;
+    std::vector<int> m_level_width;
+    std::vector<int> m_level_height;
+    std::vector<float> m_levels;
+};
+
+} // namespace math
+
+#endif // OCCLUSION_HPP
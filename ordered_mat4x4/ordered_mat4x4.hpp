@@ -0,0 +1,294 @@
+#ifndef ORDERED_MAT4X4_HPP
+#define ORDERED_MAT4X4_HPP
+
+#include "../mat4x4/mat4x4.hpp"
+#include "../simd/simd.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace math {
+
+enum class storage_order { row_major, column_major };
+
+// mat4x4 with the storage order fixed at compile time, for consumers that want column-major
+// data without a transpose() at every boundary. Elements are addressed as (row, col) in
+// either order; data() exposes the storage order. The matrix is kept as four lines of four
+// floats (rows or columns), and every kernel is chosen by `if constexpr`, so there is no
+// runtime branch on the order. Converting between orders, or from mat4x4 to column-major,
+// is explicit and is the only place a transpose happens.
+template <storage_order Order> class basic_mat4x4 {
+  public:
+    static constexpr storage_order order = Order;
+
+    // Zero matrix, like mat4x4().
+    basic_mat4x4();
+    // elements[row][col], whatever the storage order.
+    explicit basic_mat4x4(const float (&elements)[4][4]);
+    explicit basic_mat4x4(const mat4x4 &m);
+    template <storage_order Other>
+        requires(Other != Order)
+    explicit basic_mat4x4(const basic_mat4x4<Other> &other);
+
+    mat4x4 to_mat4x4() const;
+
+    basic_mat4x4 operator+(const basic_mat4x4 &other) const;
+    basic_mat4x4 operator-(const basic_mat4x4 &other) const;
+    basic_mat4x4 operator*(const basic_mat4x4 &other) const;
+    basic_mat4x4 &operator*=(const basic_mat4x4 &other);
+    basic_mat4x4 operator*(float scalar) const;
+
+    vec4 operator*(const vec4 &vector) const;
+
+    float &at(int row, int col);
+    const float &at(int row, int col) const;
+
+    // The 16 elements in storage order, 32-byte aligned.
+    float *data();
+    const float *data() const;
+
+    // Same storage order, transposed contents.
+    basic_mat4x4 transpose() const;
+
+    static basic_mat4x4 identity();
+    static basic_mat4x4 zero();
+    static basic_mat4x4 translation(float tx, float ty, float tz);
+    static basic_mat4x4 scaling(float sx, float sy, float sz);
+    static basic_mat4x4 rotation_x(float angle_rad);
+    static basic_mat4x4 rotation_y(float angle_rad);
+    static basic_mat4x4 rotation_z(float angle_rad);
+
+  private:
+    template <storage_order> friend class basic_mat4x4;
+
+    simd::f32x4 line(int i) const { return simd::f32x4::load(m_lines[i]); }
+    void set_line(int i, simd::f32x4 v) { v.store(m_lines[i]); }
+
+    template <int Axis> static basic_mat4x4 axis_rotation(float angle_rad);
+
+    // Rows for row_major, columns for column_major.
+    alignas(32) float m_lines[4][4];
+};
+
+using row_major_mat4x4 = basic_mat4x4<storage_order::row_major>;
+using column_major_mat4x4 = basic_mat4x4<storage_order::column_major>;
+
+static_assert(sizeof(column_major_mat4x4) == 16 * sizeof(float), "matrices are 16 packed floats");
+
+template <storage_order Order> basic_mat4x4<Order>::basic_mat4x4() : m_lines{} {}
+
+template <storage_order Order> basic_mat4x4<Order>::basic_mat4x4(const float (&elements)[4][4]) {
+    for (int r = 0; r < 4; ++r) {
+        for (int c = 0; c < 4; ++c) {
+            at(r, c) = elements[r][c];
+        }
+    }
+}
+
+template <storage_order Order> basic_mat4x4<Order>::basic_mat4x4(const mat4x4 &m) {
+    simd::f32x4 l[4];
+    for (int i = 0; i < 4; ++i) {
+        l[i] = simd::f32x4::load(m.data() + 4 * i);
+    }
+    if constexpr (Order == storage_order::column_major) {
+        simd::transpose4(l[0], l[1], l[2], l[3]);
+    }
+    for (int i = 0; i < 4; ++i) {
+        set_line(i, l[i]);
+    }
+}
+
+template <storage_order Order>
+template <storage_order Other>
+    requires(Other != Order)
+basic_mat4x4<Order>::basic_mat4x4(const basic_mat4x4<Other> &other) {
+    simd::f32x4 l[4] = {other.line(0), other.line(1), other.line(2), other.line(3)};
+    simd::transpose4(l[0], l[1], l[2], l[3]);
+    for (int i = 0; i < 4; ++i) {
+        set_line(i, l[i]);
+    }
+}
+
+template <storage_order Order> mat4x4 basic_mat4x4<Order>::to_mat4x4() const {
+    simd::f32x4 l[4] = {line(0), line(1), line(2), line(3)};
+    if constexpr (Order == storage_order::column_major) {
+        simd::transpose4(l[0], l[1], l[2], l[3]);
+    }
+    mat4x4 result;
+    for (int i = 0; i < 4; ++i) {
+        l[i].store(result.data() + 4 * i);
+    }
+    return result;
+}
+
+template <storage_order Order>
+basic_mat4x4<Order> basic_mat4x4<Order>::operator+(const basic_mat4x4 &other) const {
+    basic_mat4x4 result;
+    for (int i = 0; i < 4; ++i) {
+        result.set_line(i, line(i) + other.line(i));
+    }
+    return result;
+}
+
+template <storage_order Order>
+basic_mat4x4<Order> basic_mat4x4<Order>::operator-(const basic_mat4x4 &other) const {
+    basic_mat4x4 result;
+    for (int i = 0; i < 4; ++i) {
+        result.set_line(i, line(i) - other.line(i));
+    }
+    return result;
+}
+
+// Row-major: row i of A * B is sum_k A(i, k) * row k of B. Column-major: column j is
+// sum_k B(k, j) * column k of A. Both are "line i of one operand weights the lines of the
+// other", with the operands swapped.
+template <storage_order Order>
+basic_mat4x4<Order> basic_mat4x4<Order>::operator*(const basic_mat4x4 &other) const {
+    const basic_mat4x4 &weights = Order == storage_order::row_major ? *this : other;
+    const basic_mat4x4 &lines = Order == storage_order::row_major ? other : *this;
+    const simd::f32x4 l0 = lines.line(0), l1 = lines.line(1), l2 = lines.line(2),
+                      l3 = lines.line(3);
+    basic_mat4x4 result;
+    for (int i = 0; i < 4; ++i) {
+        const simd::f32x4 w = weights.line(i);
+        simd::f32x4 sum = simd::broadcast_lane<0>(w) * l0;
+        sum = fmadd(simd::broadcast_lane<1>(w), l1, sum);
+        sum = fmadd(simd::broadcast_lane<2>(w), l2, sum);
+        sum = fmadd(simd::broadcast_lane<3>(w), l3, sum);
+        result.set_line(i, sum);
+    }
+    return result;
+}
+
+template <storage_order Order>
+basic_mat4x4<Order> &basic_mat4x4<Order>::operator*=(const basic_mat4x4 &other) {
+    return *this = *this * other;
+}
+
+template <storage_order Order>
+basic_mat4x4<Order> basic_mat4x4<Order>::operator*(float scalar) const {
+    basic_mat4x4 result;
+    for (int i = 0; i < 4; ++i) {
+        result.set_line(i, line(i) * scalar);
+    }
+    return result;
+}
+
+// Column-major: sum_k v_k * column k. Row-major: the four row products, transposed so the
+// horizontal sums become one vertical add.
+template <storage_order Order> vec4 basic_mat4x4<Order>::operator*(const vec4 &vector) const {
+    const simd::f32x4 v = vector.to_simd();
+    if constexpr (Order == storage_order::column_major) {
+        simd::f32x4 sum = simd::broadcast_lane<0>(v) * line(0);
+        sum = fmadd(simd::broadcast_lane<1>(v), line(1), sum);
+        sum = fmadd(simd::broadcast_lane<2>(v), line(2), sum);
+        sum = fmadd(simd::broadcast_lane<3>(v), line(3), sum);
+        return vec4(sum);
+    } else {
+        simd::f32x4 p0 = line(0) * v, p1 = line(1) * v, p2 = line(2) * v, p3 = line(3) * v;
+        simd::transpose4(p0, p1, p2, p3);
+        return vec4((p0 + p1) + (p2 + p3));
+    }
+}
+
+template <storage_order Order> float &basic_mat4x4<Order>::at(int row, int col) {
+    if constexpr (Order == storage_order::row_major) {
+        return m_lines[row][col];
+    } else {
+        return m_lines[col][row];
+    }
+}
+
+template <storage_order Order> const float &basic_mat4x4<Order>::at(int row, int col) const {
+    if (row < 0 || row >= 4) {
+        throw std::out_of_range("Row index out of range");
+    }
+    if (col < 0 || col >= 4) {
+        throw std::out_of_range("Column index out of range");
+    }
+    if constexpr (Order == storage_order::row_major) {
+        return m_lines[row][col];
+    } else {
+        return m_lines[col][row];
+    }
+}
+
+template <storage_order Order> float *basic_mat4x4<Order>::data() { return &m_lines[0][0]; }
+
+template <storage_order Order> const float *basic_mat4x4<Order>::data() const {
+    return &m_lines[0][0];
+}
+
+template <storage_order Order> basic_mat4x4<Order> basic_mat4x4<Order>::transpose() const {
+    simd::f32x4 l[4] = {line(0), line(1), line(2), line(3)};
+    simd::transpose4(l[0], l[1], l[2], l[3]);
+    basic_mat4x4 result;
+    for (int i = 0; i < 4; ++i) {
+        result.set_line(i, l[i]);
+    }
+    return result;
+}
+
+template <storage_order Order> basic_mat4x4<Order> basic_mat4x4<Order>::identity() {
+    basic_mat4x4 result;
+    for (int i = 0; i < 4; ++i) {
+        result.m_lines[i][i] = 1.0f;
+    }
+    return result;
+}
+
+template <storage_order Order> basic_mat4x4<Order> basic_mat4x4<Order>::zero() {
+    return basic_mat4x4();
+}
+
+template <storage_order Order>
+basic_mat4x4<Order> basic_mat4x4<Order>::translation(float tx, float ty, float tz) {
+    basic_mat4x4 result = identity();
+    result.at(0, 3) = tx;
+    result.at(1, 3) = ty;
+    result.at(2, 3) = tz;
+    return result;
+}
+
+template <storage_order Order>
+basic_mat4x4<Order> basic_mat4x4<Order>::scaling(float sx, float sy, float sz) {
+    basic_mat4x4 result;
+    result.m_lines[0][0] = sx;
+    result.m_lines[1][1] = sy;
+    result.m_lines[2][2] = sz;
+    result.m_lines[3][3] = 1.0f;
+    return result;
+}
+
+// Same element placement as mat4x4::rotation_x/y/z.
+template <storage_order Order>
+template <int Axis>
+basic_mat4x4<Order> basic_mat4x4<Order>::axis_rotation(float angle_rad) {
+    constexpr int i = (Axis + 1) % 3, j = (Axis + 2) % 3;
+    const float c = std::cos(angle_rad), s = std::sin(angle_rad);
+    basic_mat4x4 result = identity();
+    result.at(i, i) = c;
+    result.at(i, j) = -s;
+    result.at(j, i) = s;
+    result.at(j, j) = c;
+    return result;
+}
+
+template <storage_order Order>
+basic_mat4x4<Order> basic_mat4x4<Order>::rotation_x(float angle_rad) {
+    return axis_rotation<0>(angle_rad);
+}
+
+template <storage_order Order>
+basic_mat4x4<Order> basic_mat4x4<Order>::rotation_y(float angle_rad) {
+    return axis_rotation<1>(angle_rad);
+}
+
+template <storage_order Order>
+basic_mat4x4<Order> basic_mat4x4<Order>::rotation_z(float angle_rad) {
+    return axis_rotation<2>(angle_rad);
+}
+
+} // namespace math
+
+#endif // ORDERED_MAT4X4_HPP
@@ -0,0 +1,324 @@
+#include "orthonormalize.hpp"
+
+#include "../simd/simd.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+using math::simd::f32x8;
+
+constexpr int max_newton_steps = 16;
+// Squared Frobenius change per Newton step below which the iteration stops.
+constexpr float newton_tolerance_sq = 1e-12f;
+// |det X| at or below this times |X|^3 (Frobenius) counts as singular. Relative, so a uniform
+// scale of the input never changes the answer.
+constexpr float singular_tolerance = 1e-6f;
+
+// The kernels below are written once over a lane type T: float for single matrices, f32x8
+// for eight matrices at a time. m holds the linear part row-major: m[3 * row + col].
+
+inline float sqrt_lanes(float v) { return std::sqrt(v); }
+inline float abs_lanes(float v) { return std::abs(v); }
+inline float max_lanes(float a, float b) { return std::max(a, b); }
+inline bool all_below(float v, float limit) { return v < limit; }
+inline bool any_at_most(float v, float limit) { return v <= limit; }
+
+inline f32x8 sqrt_lanes(f32x8 v) { return sqrt(v); }
+inline f32x8 abs_lanes(f32x8 v) { return abs(v); }
+inline f32x8 max_lanes(f32x8 a, f32x8 b) { return max(a, b); }
+inline bool all_below(f32x8 v, float limit) { return all(v < limit); }
+inline bool any_at_most(f32x8 v, f32x8 limit) { return any(v <= limit); }
+
+template <typename T> T column_dot(const T (&m)[9], int a, int b) {
+    return m[a] * m[b] + m[3 + a] * m[3 + b] + m[6 + a] * m[6 + b];
+}
+
+template <typename T> T basis_error(const T (&m)[9]) {
+    const T one(1.0f);
+    T error = abs_lanes(column_dot(m, 0, 0) - one);
+    error = max_lanes(error, abs_lanes(column_dot(m, 1, 1) - one));
+    error = max_lanes(error, abs_lanes(column_dot(m, 2, 2) - one));
+    error = max_lanes(error, abs_lanes(column_dot(m, 0, 1)));
+    error = max_lanes(error, abs_lanes(column_dot(m, 0, 2)));
+    return max_lanes(error, abs_lanes(column_dot(m, 1, 2)));
+}
+
+template <typename T> void gram_schmidt(T (&m)[9]) {
+    const T one(1.0f);
+    const T inv_x = one / sqrt_lanes(column_dot(m, 0, 0));
+    for (int r = 0; r < 3; ++r) {
+        m[3 * r] = m[3 * r] * inv_x;
+    }
+    const T projection = column_dot(m, 0, 1);
+    for (int r = 0; r < 3; ++r) {
+        m[3 * r + 1] = m[3 * r + 1] - projection * m[3 * r];
+    }
+    const T inv_y = one / sqrt_lanes(column_dot(m, 1, 1));
+    for (int r = 0; r < 3; ++r) {
+        m[3 * r + 1] = m[3 * r + 1] * inv_y;
+    }
+    m[2] = m[3] * m[7] - m[6] * m[4];
+    m[5] = m[6] * m[1] - m[0] * m[7];
+    m[8] = m[0] * m[4] - m[3] * m[1];
+}
+
+// Cofactor matrix of m (det(m) * m^-T); returns det(m).
+template <typename T> T cofactors(const T (&m)[9], T (&c)[9]) {
+    c[0] = m[4] * m[8] - m[5] * m[7];
+    c[1] = m[5] * m[6] - m[3] * m[8];
+    c[2] = m[3] * m[7] - m[4] * m[6];
+    c[3] = m[2] * m[7] - m[1] * m[8];
+    c[4] = m[0] * m[8] - m[2] * m[6];
+    c[5] = m[1] * m[6] - m[0] * m[7];
+    c[6] = m[1] * m[5] - m[2] * m[4];
+    c[7] = m[2] * m[3] - m[0] * m[5];
+    c[8] = m[0] * m[4] - m[1] * m[3];
+    return m[0] * c[0] + m[1] * c[1] + m[2] * c[2];
+}
+
+// One scaled Newton step X <- (g X + X^-T / g) / 2 with g = sqrt(|X^-1| / |X|) (Frobenius);
+// returns the squared Frobenius change.
+template <typename T> T newton_step(T (&x)[9]) {
+    T c[9];
+    const T det = cofactors(x, c);
+    T norm_x(0.0f), norm_c(0.0f);
+    for (int k = 0; k < 9; ++k) {
+        norm_x = norm_x + x[k] * x[k];
+        norm_c = norm_c + c[k] * c[k];
+    }
+    // |X^-1| = |C| / |det|, so g^2 = |C| / (|det| |X|).
+    const T gamma = sqrt_lanes(sqrt_lanes(norm_c / norm_x) / abs_lanes(det));
+    const T a = T(0.5f) * gamma;
+    const T b = T(0.5f) / (gamma * det);
+    T change(0.0f);
+    for (int k = 0; k < 9; ++k) {
+        const T next = a * x[k] + b * c[k];
+        const T d = next - x[k];
+        change = change + d * d;
+        x[k] = next;
+    }
+    return change;
+}
+
+template <typename T> T determinant(const T (&m)[9]) {
+    T c[9];
+    return cofactors(m, c);
+}
+
+// R^T * A, symmetrized.
+template <typename T> void stretch(const T (&r)[9], const T (&a)[9], T (&s)[9]) {
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            s[3 * i + j] = r[i] * a[j] + r[3 + i] * a[3 + j] + r[6 + i] * a[6 + j];
+        }
+    }
+    for (int i = 0; i < 3; ++i) {
+        for (int j = i + 1; j < 3; ++j) {
+            const T mean = T(0.5f) * (s[3 * i + j] + s[3 * j + i]);
+            s[3 * i + j] = mean;
+            s[3 * j + i] = mean;
+        }
+    }
+}
+
+template <typename T> void polar(T (&x)[9]) {
+    T norm_sq(0.0f);
+    for (int k = 0; k < 9; ++k) {
+        norm_sq = norm_sq + x[k] * x[k];
+    }
+    if (any_at_most(abs_lanes(determinant(x)), T(singular_tolerance) * norm_sq * sqrt_lanes(norm_sq))) {
+        throw std::runtime_error("Matrix is not invertible");
+    }
+    for (int step = 0; step < max_newton_steps; ++step) {
+        if (all_below(newton_step(x), newton_tolerance_sq)) {
+            break;
+        }
+    }
+}
+
+inline void load_linear(const math::mat4x4 &matrix, float (&m)[9]) {
+    const float *src = matrix.data();
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 3; ++c) {
+            m[3 * r + c] = src[4 * r + c];
+        }
+    }
+}
+
+inline void store_linear(const float (&m)[9], math::mat4x4 &matrix) {
+    float *dst = matrix.data();
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 3; ++c) {
+            dst[4 * r + c] = m[3 * r + c];
+        }
+    }
+}
+
+inline math::mat3x3 to_mat3x3(const float (&m)[9]) {
+    return math::mat3x3({{m[0], m[1], m[2]}, {m[3], m[4], m[5]}, {m[6], m[7], m[8]}});
+}
+
+// The scalar backend runs the single-matrix loops only.
+#if MATH_SIMD_LEVEL >= 1
+constexpr std::size_t batch = 8;
+
+// Element k of the linear part of eight consecutive matrices.
+inline void load_linear8(const math::mat4x4 *matrices, f32x8 (&m)[9]) {
+    alignas(32) float lanes[9][8];
+    for (int i = 0; i < 8; ++i) {
+        const float *src = matrices[i].data();
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) {
+                lanes[3 * r + c][i] = src[4 * r + c];
+            }
+        }
+    }
+    for (int k = 0; k < 9; ++k) {
+        m[k] = f32x8::load(lanes[k]);
+    }
+}
+
+inline void spill8(const f32x8 (&m)[9], float (&lanes)[9][8]) {
+    for (int k = 0; k < 9; ++k) {
+        m[k].store(lanes[k]);
+    }
+}
+
+inline void lane_of(const float (&lanes)[9][8], int i, float (&m)[9]) {
+    for (int k = 0; k < 9; ++k) {
+        m[k] = lanes[k][i];
+    }
+}
+#endif
+
+} // namespace
+
+namespace math {
+
+void orthonormality_error(std::span<const mat4x4> matrices, std::span<float> errors) {
+    const std::size_t count = matrices.size();
+    std::size_t i = 0;
+#if MATH_SIMD_LEVEL >= 1
+    for (; i + batch <= count; i += batch) {
+        f32x8 m[9];
+        load_linear8(&matrices[i], m);
+        basis_error(m).storeu(&errors[i]);
+    }
+#endif
+    for (; i < count; ++i) {
+        float m[9];
+        load_linear(matrices[i], m);
+        errors[i] = basis_error(m);
+    }
+}
+
+void orthonormalize(std::span<mat4x4> matrices) {
+    const std::size_t count = matrices.size();
+    std::size_t i = 0;
+#if MATH_SIMD_LEVEL >= 1
+    for (; i + batch <= count; i += batch) {
+        f32x8 m[9];
+        load_linear8(&matrices[i], m);
+        gram_schmidt(m);
+        alignas(32) float lanes[9][8];
+        spill8(m, lanes);
+        for (int l = 0; l < 8; ++l) {
+            float single[9];
+            lane_of(lanes, l, single);
+            store_linear(single, matrices[i + l]);
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        float m[9];
+        load_linear(matrices[i], m);
+        gram_schmidt(m);
+        store_linear(m, matrices[i]);
+    }
+}
+
+std::size_t orthonormalize_drifted(std::span<mat4x4> matrices, float threshold) {
+    const std::size_t count = matrices.size();
+    std::size_t changed = 0;
+    std::size_t i = 0;
+#if MATH_SIMD_LEVEL >= 1
+    for (; i + batch <= count; i += batch) {
+        f32x8 m[9];
+        load_linear8(&matrices[i], m);
+        unsigned drifted = bits(basis_error(m) > threshold);
+        if (drifted == 0) [[likely]] {
+            continue;
+        }
+        gram_schmidt(m);
+        alignas(32) float lanes[9][8];
+        spill8(m, lanes);
+        for (; drifted != 0; drifted &= drifted - 1) {
+            const int l = std::countr_zero(drifted);
+            float single[9];
+            lane_of(lanes, l, single);
+            store_linear(single, matrices[i + l]);
+            ++changed;
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        float m[9];
+        load_linear(matrices[i], m);
+        if (basis_error(m) > threshold) {
+            gram_schmidt(m);
+            store_linear(m, matrices[i]);
+            ++changed;
+        }
+    }
+    return changed;
+}
+
+void polar_decompose(std::span<const mat4x4> matrices, std::span<mat3x3> rotations,
+                     std::span<mat3x3> stretches) {
+    const std::size_t count = matrices.size();
+    const bool want_stretch = !stretches.empty();
+    std::size_t i = 0;
+#if MATH_SIMD_LEVEL >= 1
+    for (; i + batch <= count; i += batch) {
+        f32x8 a[9], x[9];
+        load_linear8(&matrices[i], a);
+        std::copy(a, a + 9, x);
+        polar(x);
+        alignas(32) float lanes[9][8];
+        spill8(x, lanes);
+        for (int l = 0; l < 8; ++l) {
+            float single[9];
+            lane_of(lanes, l, single);
+            rotations[i + l] = to_mat3x3(single);
+        }
+        if (want_stretch) {
+            f32x8 s[9];
+            stretch(x, a, s);
+            spill8(s, lanes);
+            for (int l = 0; l < 8; ++l) {
+                float single[9];
+                lane_of(lanes, l, single);
+                stretches[i + l] = to_mat3x3(single);
+            }
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        float a[9], x[9];
+        load_linear(matrices[i], a);
+        std::copy(a, a + 9, x);
+        polar(x);
+        rotations[i] = to_mat3x3(x);
+        if (want_stretch) {
+            float s[9];
+            stretch(x, a, s);
+            stretches[i] = to_mat3x3(s);
+        }
+    }
+}
+
+} // namespace math
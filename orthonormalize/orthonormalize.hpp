@@ -0,0 +1,38 @@
+#ifndef ORTHONORMALIZE_HPP
+#define ORTHONORMALIZE_HPP
+
+#include "../mat4x4/mat4x4.hpp"
+
+#include <cstddef>
+#include <span>
+
+namespace math {
+
+// Batch repair of the upper 3x3 (linear part) of mat4x4 arrays. Translation and the last row
+// are never touched. Matrices are processed eight at a time with AVX2.
+
+// Largest deviation of the linear part from orthonormal: max over |c_i . c_j - delta_ij| for
+// its columns c_0..c_2. Zero for a rotation; roughly the relative scale or skew error.
+void orthonormality_error(std::span<const mat4x4> matrices, std::span<float> errors);
+
+// Gram-Schmidt on the columns: x is normalized, y is made orthogonal to x and normalized, and
+// z is rebuilt as x cross y. Cheap and stable for the small drift of accumulated rotations;
+// the result is always a rotation, and any scale is removed.
+void orthonormalize(std::span<mat4x4> matrices);
+
+// orthonormalize() applied only to matrices whose orthonormality_error exceeds threshold.
+// Returns the number of matrices changed.
+std::size_t orthonormalize_drifted(std::span<mat4x4> matrices, float threshold);
+
+// Polar decomposition of the linear part, A = R * S, with R orthogonal and S symmetric positive
+// semi-definite: R is the rotation closest to A and S holds its scale and shear. Computed by
+// scaled Newton iteration (Higham), converging in under ten steps. For mirrored inputs
+// (negative determinant) R is a reflection. `stretches` may be empty. Throws
+// std::runtime_error when a linear part is singular relative to its size (|det| at or below
+// 1e-6 |A|^3), so a uniform scale of the input does not change which matrices throw.
+void polar_decompose(std::span<const mat4x4> matrices, std::span<mat3x3> rotations,
+                     std::span<mat3x3> stretches);
+
+} // namespace math
+
+#endif // ORTHONORMALIZE_HPP
@@ -0,0 +1,78 @@
+#ifndef PARALLEL_FOR_HPP
+#define PARALLEL_FOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace math::parallel {
+
+inline unsigned default_thread_count() {
+    unsigned count = std::thread::hardware_concurrency();
+    return count ? count : 1;
+}
+
+// Calls fn(begin, end) for consecutive chunks of [0, count). Chunks are handed out dynamically
+// to `thread_count` workers (0 = hardware concurrency); the calling thread is one of them.
+// Chunk boundaries depend only on count and chunk_size, never on the thread count.
+// fn must not throw.
+template <typename Fn>
+void for_each_chunk(std::size_t count, std::size_t chunk_size, Fn &&fn, unsigned thread_count = 0) {
+    if (count == 0) [[unlikely]] {
+        return;
+    }
+    chunk_size = std::max<std::size_t>(chunk_size, 1);
+    const std::size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+    if (thread_count == 0) {
+        thread_count = default_thread_count();
+    }
+    thread_count = static_cast<unsigned>(std::min<std::size_t>(thread_count, chunk_count));
+
+    if (thread_count <= 1) {
+        for (std::size_t begin = 0; begin < count; begin += chunk_size) {
+            fn(begin, std::min(begin + chunk_size, count));
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> next_chunk{0};
+    auto worker = [&]() {
+        for (std::size_t chunk = next_chunk.fetch_add(1, std::memory_order_relaxed);
+             chunk < chunk_count; chunk = next_chunk.fetch_add(1, std::memory_order_relaxed)) {
+            const std::size_t begin = chunk * chunk_size;
+            fn(begin, std::min(begin + chunk_size, count));
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count - 1);
+    for (unsigned t = 1; t < thread_count; ++t) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+}
+
+// Runs fn(index) once for every index in [0, count), each on its own worker.
+template <typename Fn> void for_each_worker(unsigned count, Fn &&fn) {
+    if (count == 0) [[unlikely]] {
+        return;
+    }
+    std::vector<std::thread> threads;
+    threads.reserve(count - 1);
+    for (unsigned t = 1; t < count; ++t) {
+        threads.emplace_back([&fn, t]() { fn(t); });
+    }
+    fn(0u);
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+}
+
+} // namespace math::parallel
+
+#endif // PARALLEL_FOR_HPP
@@ -0,0 +1,565 @@
+#include "predicates.hpp"
+
+#include "../simd/vec3_block.hpp"
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+static_assert(sizeof(math::vec2) == 2 * sizeof(float), "vec2 arrays are read as packed floats");
+static_assert(sizeof(math::vec3) == 3 * sizeof(float), "vec3 arrays are read as packed floats");
+
+namespace {
+
+// Forward error bounds of the determinant evaluations below (Shewchuk's errboundA), as a
+// multiple of the permanent, for unit roundoff u.
+template <typename T> struct error_bound {
+    static constexpr T u = sizeof(T) == 4 ? T(1.0 / 16777216.0) : T(1.0 / 9007199254740992.0);
+    static constexpr T orient2d = (T(3) + T(16) * u) * u;
+    static constexpr T orient3d = (T(7) + T(56) * u) * u;
+    static constexpr T incircle = (T(10) + T(96) * u) * u;
+    static constexpr T insphere = (T(16) + T(224) * u) * u;
+};
+
+// Below this permanent float products may underflow and the relative bounds stop holding.
+constexpr float float_filter_floor = 1e-30f;
+
+constexpr int uncertain = 2;
+
+template <typename T> inline int sign_if_certain(T det, T permanent, T bound) {
+    if (std::abs(det) > bound * permanent) [[likely]] {
+        return det > T(0) ? 1 : -1;
+    }
+    return uncertain;
+}
+
+// Determinants with their permanents (the same expression over absolute values), evaluated
+// in the order the error bounds were derived for. Points are arrays of coordinates.
+
+template <typename T> inline T orient2d_det(const T *a, const T *b, const T *c, T &permanent) {
+    const T left = (a[0] - c[0]) * (b[1] - c[1]);
+    const T right = (a[1] - c[1]) * (b[0] - c[0]);
+    permanent = std::abs(left) + std::abs(right);
+    return left - right;
+}
+
+template <typename T>
+inline T orient3d_det(const T *a, const T *b, const T *c, const T *d, T &permanent) {
+    const T adx = a[0] - d[0], ady = a[1] - d[1], adz = a[2] - d[2];
+    const T bdx = b[0] - d[0], bdy = b[1] - d[1], bdz = b[2] - d[2];
+    const T cdx = c[0] - d[0], cdy = c[1] - d[1], cdz = c[2] - d[2];
+    const T bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    const T cdxady = cdx * ady, adxcdy = adx * cdy;
+    const T adxbdy = adx * bdy, bdxady = bdx * ady;
+    permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * std::abs(adz) +
+                (std::abs(cdxady) + std::abs(adxcdy)) * std::abs(bdz) +
+                (std::abs(adxbdy) + std::abs(bdxady)) * std::abs(cdz);
+    return adz * (bdxcdy - cdxbdy) + bdz * (cdxady - adxcdy) + cdz * (adxbdy - bdxady);
+}
+
+template <typename T>
+inline T incircle_det(const T *a, const T *b, const T *c, const T *d, T &permanent) {
+    const T adx = a[0] - d[0], ady = a[1] - d[1];
+    const T bdx = b[0] - d[0], bdy = b[1] - d[1];
+    const T cdx = c[0] - d[0], cdy = c[1] - d[1];
+    const T bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    const T cdxady = cdx * ady, adxcdy = adx * cdy;
+    const T adxbdy = adx * bdy, bdxady = bdx * ady;
+    const T alift = adx * adx + ady * ady;
+    const T blift = bdx * bdx + bdy * bdy;
+    const T clift = cdx * cdx + cdy * cdy;
+    permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * alift +
+                (std::abs(cdxady) + std::abs(adxcdy)) * blift +
+                (std::abs(adxbdy) + std::abs(bdxady)) * clift;
+    return alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+}
+
+template <typename T>
+inline T insphere_det(const T *a, const T *b, const T *c, const T *d, const T *e, T &permanent) {
+    const T aex = a[0] - e[0], aey = a[1] - e[1], aez = a[2] - e[2];
+    const T bex = b[0] - e[0], bey = b[1] - e[1], bez = b[2] - e[2];
+    const T cex = c[0] - e[0], cey = c[1] - e[1], cez = c[2] - e[2];
+    const T dex = d[0] - e[0], dey = d[1] - e[1], dez = d[2] - e[2];
+
+    const T aexbey = aex * bey, bexaey = bex * aey;
+    const T bexcey = bex * cey, cexbey = cex * bey;
+    const T cexdey = cex * dey, dexcey = dex * cey;
+    const T dexaey = dex * aey, aexdey = aex * dey;
+    const T aexcey = aex * cey, cexaey = cex * aey;
+    const T bexdey = bex * dey, dexbey = dex * bey;
+    const T ab = aexbey - bexaey, bc = bexcey - cexbey, cd = cexdey - dexcey;
+    const T da = dexaey - aexdey, ac = aexcey - cexaey, bd = bexdey - dexbey;
+
+    const T abc = aez * bc - bez * ac + cez * ab;
+    const T bcd = bez * cd - cez * bd + dez * bc;
+    const T cda = cez * da + dez * ac + aez * cd;
+    const T dab = dez * ab + aez * bd + bez * da;
+
+    const T alift = aex * aex + aey * aey + aez * aez;
+    const T blift = bex * bex + bey * bey + bez * bez;
+    const T clift = cex * cex + cey * cey + cez * cez;
+    const T dlift = dex * dex + dey * dey + dez * dez;
+
+    const T ab_p = std::abs(aexbey) + std::abs(bexaey), bc_p = std::abs(bexcey) + std::abs(cexbey);
+    const T cd_p = std::abs(cexdey) + std::abs(dexcey), da_p = std::abs(dexaey) + std::abs(aexdey);
+    const T ac_p = std::abs(aexcey) + std::abs(cexaey), bd_p = std::abs(bexdey) + std::abs(dexbey);
+    const T abc_p = std::abs(aez) * bc_p + std::abs(bez) * ac_p + std::abs(cez) * ab_p;
+    const T bcd_p = std::abs(bez) * cd_p + std::abs(cez) * bd_p + std::abs(dez) * bc_p;
+    const T cda_p = std::abs(cez) * da_p + std::abs(dez) * ac_p + std::abs(aez) * cd_p;
+    const T dab_p = std::abs(dez) * ab_p + std::abs(aez) * bd_p + std::abs(bez) * da_p;
+    permanent = dlift * abc_p + clift * dab_p + blift * cda_p + alift * bcd_p;
+
+    return (dlift * abc - clift * dab) + (blift * cda - alift * bcd);
+}
+
+// Exact arithmetic on expansions: sums of doubles with non-overlapping significands, in
+// increasing magnitude, whose sign is the sign of the last (largest) component. Products of
+// float inputs up to degree 5 neither overflow nor underflow double, so every step is exact.
+using expansion = std::vector<double>;
+
+inline void two_sum(double a, double b, double &sum, double &error) {
+    sum = a + b;
+    const double b_virtual = sum - a;
+    const double a_virtual = sum - b_virtual;
+    error = (a - a_virtual) + (b - b_virtual);
+}
+
+inline void fast_two_sum(double a, double b, double &sum, double &error) {
+    sum = a + b;
+    error = b - (sum - a);
+}
+
+inline void two_product(double a, double b, double &product, double &error) {
+    product = a * b;
+    error = std::fma(a, b, -product);
+}
+
+expansion grow(const expansion &e, double b) {
+    expansion h;
+    h.reserve(e.size() + 1);
+    double q = b;
+    for (double component : e) {
+        double sum, error;
+        two_sum(q, component, sum, error);
+        if (error != 0.0) {
+            h.push_back(error);
+        }
+        q = sum;
+    }
+    if (q != 0.0 || h.empty()) {
+        h.push_back(q);
+    }
+    return h;
+}
+
+expansion add(const expansion &e, const expansion &f) {
+    expansion h = e;
+    for (double component : f) {
+        h = grow(h, component);
+    }
+    return h;
+}
+
+expansion negate(expansion e) {
+    for (double &component : e) {
+        component = -component;
+    }
+    return e;
+}
+
+expansion scale(const expansion &e, double b) {
+    expansion h;
+    h.reserve(2 * e.size());
+    double q, error;
+    two_product(e[0], b, q, error);
+    if (error != 0.0) {
+        h.push_back(error);
+    }
+    for (std::size_t i = 1; i < e.size(); ++i) {
+        double product, product_error, sum;
+        two_product(e[i], b, product, product_error);
+        two_sum(q, product_error, sum, error);
+        if (error != 0.0) {
+            h.push_back(error);
+        }
+        fast_two_sum(product, sum, q, error);
+        if (error != 0.0) {
+            h.push_back(error);
+        }
+    }
+    if (q != 0.0 || h.empty()) {
+        h.push_back(q);
+    }
+    return h;
+}
+
+expansion multiply(const expansion &e, const expansion &f) {
+    expansion h = scale(e, f[0]);
+    for (std::size_t i = 1; i < f.size(); ++i) {
+        h = add(h, scale(e, f[i]));
+    }
+    return h;
+}
+
+expansion difference(double a, double b) {
+    double sum, error;
+    two_sum(a, -b, sum, error);
+    return error != 0.0 ? expansion{error, sum} : expansion{sum};
+}
+
+inline int sign(const expansion &e) { return e.back() > 0.0 ? 1 : (e.back() < 0.0 ? -1 : 0); }
+
+// e0 * f0 - e1 * f1
+expansion cross(const expansion &e0, const expansion &f0, const expansion &e1, const expansion &f1) {
+    return add(multiply(e0, f0), negate(multiply(e1, f1)));
+}
+
+int orient2d_exact(const double *a, const double *b, const double *c) {
+    const expansion acx = difference(a[0], c[0]), acy = difference(a[1], c[1]);
+    const expansion bcx = difference(b[0], c[0]), bcy = difference(b[1], c[1]);
+    return sign(cross(acx, bcy, acy, bcx));
+}
+
+int orient3d_exact(const double *a, const double *b, const double *c, const double *d) {
+    expansion ad[3], bd[3], cd[3];
+    for (int k = 0; k < 3; ++k) {
+        ad[k] = difference(a[k], d[k]);
+        bd[k] = difference(b[k], d[k]);
+        cd[k] = difference(c[k], d[k]);
+    }
+    const expansion bc = cross(bd[0], cd[1], cd[0], bd[1]);
+    const expansion ca = cross(cd[0], ad[1], ad[0], cd[1]);
+    const expansion ab = cross(ad[0], bd[1], bd[0], ad[1]);
+    return sign(add(add(multiply(ad[2], bc), multiply(bd[2], ca)), multiply(cd[2], ab)));
+}
+
+int incircle_exact(const double *a, const double *b, const double *c, const double *d) {
+    expansion ad[2], bd[2], cd[2];
+    for (int k = 0; k < 2; ++k) {
+        ad[k] = difference(a[k], d[k]);
+        bd[k] = difference(b[k], d[k]);
+        cd[k] = difference(c[k], d[k]);
+    }
+    auto lift = [](const expansion (&v)[2]) { return add(multiply(v[0], v[0]), multiply(v[1], v[1])); };
+    const expansion bc = cross(bd[0], cd[1], cd[0], bd[1]);
+    const expansion ca = cross(cd[0], ad[1], ad[0], cd[1]);
+    const expansion ab = cross(ad[0], bd[1], bd[0], ad[1]);
+    return sign(add(add(multiply(lift(ad), bc), multiply(lift(bd), ca)), multiply(lift(cd), ab)));
+}
+
+int insphere_exact(const double *a, const double *b, const double *c, const double *d, const double *e) {
+    expansion ae[3], be[3], ce[3], de[3];
+    for (int k = 0; k < 3; ++k) {
+        ae[k] = difference(a[k], e[k]);
+        be[k] = difference(b[k], e[k]);
+        ce[k] = difference(c[k], e[k]);
+        de[k] = difference(d[k], e[k]);
+    }
+    auto lift = [](const expansion (&v)[3]) {
+        return add(add(multiply(v[0], v[0]), multiply(v[1], v[1])), multiply(v[2], v[2]));
+    };
+    const expansion ab = cross(ae[0], be[1], be[0], ae[1]);
+    const expansion bc = cross(be[0], ce[1], ce[0], be[1]);
+    const expansion cd = cross(ce[0], de[1], de[0], ce[1]);
+    const expansion da = cross(de[0], ae[1], ae[0], de[1]);
+    const expansion ac = cross(ae[0], ce[1], ce[0], ae[1]);
+    const expansion bd = cross(be[0], de[1], de[0], be[1]);
+
+    const expansion abc = add(add(multiply(ae[2], bc), negate(multiply(be[2], ac))), multiply(ce[2], ab));
+    const expansion bcd = add(add(multiply(be[2], cd), negate(multiply(ce[2], bd))), multiply(de[2], bc));
+    const expansion cda = add(add(multiply(ce[2], da), multiply(de[2], ac)), multiply(ae[2], cd));
+    const expansion dab = add(add(multiply(de[2], ab), multiply(ae[2], bd)), multiply(be[2], da));
+
+    const expansion left = add(multiply(lift(de), abc), negate(multiply(lift(ce), dab)));
+    const expansion right = add(multiply(lift(be), cda), negate(multiply(lift(ae), bcd)));
+    return sign(add(left, right));
+}
+
+// The double and exact stages, for inputs the float filter could not decide.
+
+int orient2d_slow(const float *af, const float *bf, const float *cf) {
+    const double a[2] = {af[0], af[1]}, b[2] = {bf[0], bf[1]}, c[2] = {cf[0], cf[1]};
+    double permanent;
+    const double det = orient2d_det(a, b, c, permanent);
+    const int s = sign_if_certain(det, permanent, error_bound<double>::orient2d);
+    return s != uncertain ? s : orient2d_exact(a, b, c);
+}
+
+int orient3d_slow(const float *af, const float *bf, const float *cf, const float *df) {
+    const double a[3] = {af[0], af[1], af[2]}, b[3] = {bf[0], bf[1], bf[2]};
+    const double c[3] = {cf[0], cf[1], cf[2]}, d[3] = {df[0], df[1], df[2]};
+    double permanent;
+    const double det = orient3d_det(a, b, c, d, permanent);
+    const int s = sign_if_certain(det, permanent, error_bound<double>::orient3d);
+    return s != uncertain ? s : orient3d_exact(a, b, c, d);
+}
+
+int incircle_slow(const float *af, const float *bf, const float *cf, const float *df) {
+    const double a[2] = {af[0], af[1]}, b[2] = {bf[0], bf[1]};
+    const double c[2] = {cf[0], cf[1]}, d[2] = {df[0], df[1]};
+    double permanent;
+    const double det = incircle_det(a, b, c, d, permanent);
+    const int s = sign_if_certain(det, permanent, error_bound<double>::incircle);
+    return s != uncertain ? s : incircle_exact(a, b, c, d);
+}
+
+int insphere_slow(const float *af, const float *bf, const float *cf, const float *df, const float *ef) {
+    const double a[3] = {af[0], af[1], af[2]}, b[3] = {bf[0], bf[1], bf[2]};
+    const double c[3] = {cf[0], cf[1], cf[2]}, d[3] = {df[0], df[1], df[2]};
+    const double e[3] = {ef[0], ef[1], ef[2]};
+    double permanent;
+    const double det = insphere_det(a, b, c, d, e, permanent);
+    const int s = sign_if_certain(det, permanent, error_bound<double>::insphere);
+    return s != uncertain ? s : insphere_exact(a, b, c, d, e);
+}
+
+inline int float_filter(float det, float permanent, float bound) {
+    return permanent > float_filter_floor ? sign_if_certain(det, permanent, bound) : uncertain;
+}
+
+int orient2d_point(const float *a, const float *b, const float *c) {
+    float permanent;
+    const float det = orient2d_det(a, b, c, permanent);
+    const int s = float_filter(det, permanent, error_bound<float>::orient2d);
+    return s != uncertain ? s : orient2d_slow(a, b, c);
+}
+
+int orient3d_point(const float *a, const float *b, const float *c, const float *d) {
+    float permanent;
+    const float det = orient3d_det(a, b, c, d, permanent);
+    const int s = float_filter(det, permanent, error_bound<float>::orient3d);
+    return s != uncertain ? s : orient3d_slow(a, b, c, d);
+}
+
+int incircle_point(const float *a, const float *b, const float *c, const float *d) {
+    float permanent;
+    const float det = incircle_det(a, b, c, d, permanent);
+    const int s = float_filter(det, permanent, error_bound<float>::incircle);
+    return s != uncertain ? s : incircle_slow(a, b, c, d);
+}
+
+int insphere_point(const float *a, const float *b, const float *c, const float *d, const float *e) {
+    float permanent;
+    const float det = insphere_det(a, b, c, d, e, permanent);
+    const int s = float_filter(det, permanent, error_bound<float>::insphere);
+    return s != uncertain ? s : insphere_slow(a, b, c, d, e);
+}
+
+inline const float *coords(const math::vec2 &v) { return reinterpret_cast<const float *>(&v); }
+inline const float *coords(const math::vec3 &v) { return reinterpret_cast<const float *>(&v); }
+
+// The batch forms filter eight points at a time on the SIMD backends; the scalar backend
+// runs the per-point loops only.
+#if MATH_SIMD_LEVEL >= 1
+using math::simd::f32x4;
+using math::simd::f32x8;
+
+constexpr std::size_t batch = 8;
+
+// Deinterleaves 8 packed vec2 into x and y registers. Each half of the loads holds four
+// vectors, so the split is an in-group shuffle.
+inline void load_vec2x8(const float *p, f32x8 &x, f32x8 &y) {
+    const f32x8 m01(f32x4::loadu(p), f32x4::loadu(p + 8));      // x0 y0 x1 y1 | x4 y4 x5 y5
+    const f32x8 m23(f32x4::loadu(p + 4), f32x4::loadu(p + 12)); // x2 y2 x3 y3 | x6 y6 x7 y7
+    x = shuffle<0, 2, 0, 2>(m01, m23);
+    y = shuffle<1, 3, 1, 3>(m01, m23);
+}
+
+// Writes the signs of certain lanes and returns the bit mask of uncertain ones.
+inline unsigned store_signs(f32x8 det, f32x8 permanent, float bound, int *out) {
+    const unsigned certain = bits((abs(det) > permanent * bound) & (permanent > float_filter_floor));
+    const unsigned positive = bits(det > 0.0f), negative = bits(det < 0.0f);
+    for (int l = 0; l < 8; ++l) {
+        out[l] = static_cast<int>((positive >> l) & 1u) - static_cast<int>((negative >> l) & 1u);
+    }
+    return ~certain & 0xFFu;
+}
+#endif
+
+} // namespace
+
+namespace math {
+
+int orient2d(const vec2 &a, const vec2 &b, const vec2 &c) { return orient2d_point(coords(a), coords(b), coords(c)); }
+
+int orient3d(const vec3 &a, const vec3 &b, const vec3 &c, const vec3 &d) {
+    return orient3d_point(coords(a), coords(b), coords(c), coords(d));
+}
+
+int incircle(const vec2 &a, const vec2 &b, const vec2 &c, const vec2 &d) {
+    return incircle_point(coords(a), coords(b), coords(c), coords(d));
+}
+
+int insphere(const vec3 &a, const vec3 &b, const vec3 &c, const vec3 &d, const vec3 &e) {
+    return insphere_point(coords(a), coords(b), coords(c), coords(d), coords(e));
+}
+
+void orient2d(const vec2 &a, const vec2 &b, std::span<const vec2> points, std::span<int> out) {
+    const float *pa = coords(a), *pb = coords(b);
+    const float *p = reinterpret_cast<const float *>(points.data());
+    const std::size_t count = points.size();
+    std::size_t i = 0;
+#if MATH_SIMD_LEVEL >= 1
+    // With c varying: det = (ax - cx)(by - cy) - (ay - cy)(bx - cx).
+    const f32x8 ax(pa[0]), ay(pa[1]);
+    const f32x8 bx(pb[0]), by(pb[1]);
+    for (; i + batch <= count; i += batch) {
+        f32x8 cx, cy;
+        load_vec2x8(p + 2 * i, cx, cy);
+        const f32x8 left = (ax - cx) * (by - cy);
+        const f32x8 right = (ay - cy) * (bx - cx);
+        unsigned slow = store_signs(left - right, abs(left) + abs(right), error_bound<float>::orient2d, &out[i]);
+        for (; slow != 0; slow &= slow - 1) {
+            const std::size_t k = i + std::countr_zero(slow);
+            out[k] = orient2d_slow(pa, pb, p + 2 * k);
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = orient2d_point(pa, pb, p + 2 * i);
+    }
+}
+
+void orient3d(const vec3 &a, const vec3 &b, const vec3 &c, std::span<const vec3> points,
+              std::span<int> out) {
+    const float *pa = coords(a), *pb = coords(b), *pc = coords(c);
+    const float *p = reinterpret_cast<const float *>(points.data());
+    const std::size_t count = points.size();
+    std::size_t i = 0;
+#if MATH_SIMD_LEVEL >= 1
+    const f32x8 fa[3] = {pa[0], pa[1], pa[2]};
+    const f32x8 fb[3] = {pb[0], pb[1], pb[2]};
+    const f32x8 fc[3] = {pc[0], pc[1], pc[2]};
+    for (; i + batch <= count; i += batch) {
+        f32x8 d[3];
+        math::simd::load_vec3x8(p + 3 * i, d);
+        const f32x8 adx = fa[0] - d[0], ady = fa[1] - d[1], adz = fa[2] - d[2];
+        const f32x8 bdx = fb[0] - d[0], bdy = fb[1] - d[1], bdz = fb[2] - d[2];
+        const f32x8 cdx = fc[0] - d[0], cdy = fc[1] - d[1], cdz = fc[2] - d[2];
+        const f32x8 bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+        const f32x8 cdxady = cdx * ady, adxcdy = adx * cdy;
+        const f32x8 adxbdy = adx * bdy, bdxady = bdx * ady;
+        f32x8 det = adz * (bdxcdy - cdxbdy);
+        det = fmadd(bdz, cdxady - adxcdy, det);
+        det = fmadd(cdz, adxbdy - bdxady, det);
+        f32x8 permanent = (abs(bdxcdy) + abs(cdxbdy)) * abs(adz);
+        permanent = fmadd(abs(cdxady) + abs(adxcdy), abs(bdz), permanent);
+        permanent = fmadd(abs(adxbdy) + abs(bdxady), abs(cdz), permanent);
+        unsigned slow = store_signs(det, permanent, error_bound<float>::orient3d, &out[i]);
+        for (; slow != 0; slow &= slow - 1) {
+            const std::size_t k = i + std::countr_zero(slow);
+            out[k] = orient3d_slow(pa, pb, pc, p + 3 * k);
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = orient3d_point(pa, pb, pc, p + 3 * i);
+    }
+}
+
+void incircle(const vec2 &a, const vec2 &b, const vec2 &c, std::span<const vec2> points,
+              std::span<int> out) {
+    const float *pa = coords(a), *pb = coords(b), *pc = coords(c);
+    const float *p = reinterpret_cast<const float *>(points.data());
+    const std::size_t count = points.size();
+    std::size_t i = 0;
+#if MATH_SIMD_LEVEL >= 1
+    const f32x8 ax(pa[0]), ay(pa[1]);
+    const f32x8 bx(pb[0]), by(pb[1]);
+    const f32x8 cx(pc[0]), cy(pc[1]);
+    for (; i + batch <= count; i += batch) {
+        f32x8 dx, dy;
+        load_vec2x8(p + 2 * i, dx, dy);
+        const f32x8 adx = ax - dx, ady = ay - dy;
+        const f32x8 bdx = bx - dx, bdy = by - dy;
+        const f32x8 cdx = cx - dx, cdy = cy - dy;
+        const f32x8 bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+        const f32x8 cdxady = cdx * ady, adxcdy = adx * cdy;
+        const f32x8 adxbdy = adx * bdy, bdxady = bdx * ady;
+        const f32x8 alift = fmadd(adx, adx, ady * ady);
+        const f32x8 blift = fmadd(bdx, bdx, bdy * bdy);
+        const f32x8 clift = fmadd(cdx, cdx, cdy * cdy);
+        f32x8 det = alift * (bdxcdy - cdxbdy);
+        det = fmadd(blift, cdxady - adxcdy, det);
+        det = fmadd(clift, adxbdy - bdxady, det);
+        f32x8 permanent = (abs(bdxcdy) + abs(cdxbdy)) * alift;
+        permanent = fmadd(abs(cdxady) + abs(adxcdy), blift, permanent);
+        permanent = fmadd(abs(adxbdy) + abs(bdxady), clift, permanent);
+        unsigned slow = store_signs(det, permanent, error_bound<float>::incircle, &out[i]);
+        for (; slow != 0; slow &= slow - 1) {
+            const std::size_t k = i + std::countr_zero(slow);
+            out[k] = incircle_slow(pa, pb, pc, p + 2 * k);
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = incircle_point(pa, pb, pc, p + 2 * i);
+    }
+}
+
+void insphere(const vec3 &a, const vec3 &b, const vec3 &c, const vec3 &d,
+              std::span<const vec3> points, std::span<int> out) {
+    const float *pa = coords(a), *pb = coords(b), *pc = coords(c), *pd = coords(d);
+    const float *p = reinterpret_cast<const float *>(points.data());
+    const std::size_t count = points.size();
+    std::size_t i = 0;
+#if MATH_SIMD_LEVEL >= 1
+    const float *fixed[4] = {pa, pb, pc, pd};
+    f32x8 f[4][3];
+    for (int v = 0; v < 4; ++v) {
+        for (int k = 0; k < 3; ++k) {
+            f[v][k] = f32x8(fixed[v][k]);
+        }
+    }
+    for (; i + batch <= count; i += batch) {
+        f32x8 e[3];
+        math::simd::load_vec3x8(p + 3 * i, e);
+        f32x8 dx[4], dy[4], dz[4], lift[4];
+        for (int v = 0; v < 4; ++v) {
+            dx[v] = f[v][0] - e[0];
+            dy[v] = f[v][1] - e[1];
+            dz[v] = f[v][2] - e[2];
+            lift[v] = fmadd(dx[v], dx[v], fmadd(dy[v], dy[v], dz[v] * dz[v]));
+        }
+        // 2x2 minors of x, y for pairs (u, v) = ab, bc, cd, da, ac, bd.
+        const int pairs[6][2] = {{0, 1}, {1, 2}, {2, 3}, {3, 0}, {0, 2}, {1, 3}};
+        f32x8 minor[6], minor_p[6];
+        for (int m = 0; m < 6; ++m) {
+            const f32x8 l = dx[pairs[m][0]] * dy[pairs[m][1]];
+            const f32x8 r = dx[pairs[m][1]] * dy[pairs[m][0]];
+            minor[m] = l - r;
+            minor_p[m] = abs(l) + abs(r);
+        }
+        enum { ab, bc, cd, da, ac, bd };
+        auto triple = [&](int z0, int m0, int z1, int m1, bool minus1, int z2, int m2, f32x8 &perm) {
+            perm = fmadd(abs(dz[z0]), minor_p[m0], fmadd(abs(dz[z1]), minor_p[m1], abs(dz[z2]) * minor_p[m2]));
+            const f32x8 t1 = dz[z1] * minor[m1];
+            const f32x8 t0 = dz[z0] * minor[m0];
+            return fmadd(dz[z2], minor[m2], minus1 ? t0 - t1 : t0 + t1);
+        };
+        f32x8 abc_p, bcd_p, cda_p, dab_p;
+        const f32x8 abc = triple(0, bc, 1, ac, true, 2, ab, abc_p);
+        const f32x8 bcd = triple(1, cd, 2, bd, true, 3, bc, bcd_p);
+        const f32x8 cda = triple(2, da, 3, ac, false, 0, cd, cda_p);
+        const f32x8 dab = triple(3, ab, 0, bd, false, 1, da, dab_p);
+        // lift[3] * abc - lift[2] * dab + lift[1] * cda - lift[0] * bcd, the products of the
+        // positive terms fused.
+        const f32x8 det = -fnmadd(lift[3], abc, lift[2] * dab) - fnmadd(lift[1], cda, lift[0] * bcd);
+        f32x8 permanent = lift[3] * abc_p;
+        permanent = fmadd(lift[2], dab_p, permanent);
+        permanent = fmadd(lift[1], cda_p, permanent);
+        permanent = fmadd(lift[0], bcd_p, permanent);
+        unsigned slow = store_signs(det, permanent, error_bound<float>::insphere, &out[i]);
+        for (; slow != 0; slow &= slow - 1) {
+            const std::size_t k = i + std::countr_zero(slow);
+            out[k] = insphere_slow(pa, pb, pc, pd, p + 3 * k);
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = insphere_point(pa, pb, pc, pd, p + 3 * i);
+    }
+}
+
+} // namespace math
@@ -0,0 +1,40 @@
+#ifndef PREDICATES_HPP
+#define PREDICATES_HPP
+
+#include "../vec3/vec3.hpp"
+
+#include <span>
+
+namespace math {
+
+// Robust geometric predicates (after Shewchuk, "Adaptive Precision Floating-Point Arithmetic
+// and Fast Robust Geometric Predicates"). Each returns the sign (-1, 0 or 1) of the exact
+// determinant of its float inputs: the determinant is first evaluated in float with a forward
+// error bound, then in double, and only when both are inconclusive with exact expansion
+// arithmetic. Every result is exact for finite inputs.
+
+// > 0 when a, b, c are counter-clockwise, < 0 when clockwise, 0 when collinear.
+int orient2d(const vec2 &a, const vec2 &b, const vec2 &c);
+// > 0 when d lies below the plane through a, b, c (a, b, c counter-clockwise seen from
+// above), < 0 above, 0 when coplanar.
+int orient3d(const vec3 &a, const vec3 &b, const vec3 &c, const vec3 &d);
+// > 0 when d lies inside the circle through counter-clockwise a, b, c, < 0 outside, 0 on it.
+int incircle(const vec2 &a, const vec2 &b, const vec2 &c, const vec2 &d);
+// > 0 when e lies inside the sphere through a, b, c, d (with orient3d(a, b, c, d) > 0), < 0
+// outside, 0 on it.
+int insphere(const vec3 &a, const vec3 &b, const vec3 &c, const vec3 &d, const vec3 &e);
+
+// Batch forms: the leading points are fixed and the last one runs over `points`, e.g. every
+// point against one edge, plane, circle or sphere. out[i] receives the sign for points[i].
+// Eight points are filtered per AVX2 iteration; only the uncertain ones take the slow path.
+void orient2d(const vec2 &a, const vec2 &b, std::span<const vec2> points, std::span<int> out);
+void orient3d(const vec3 &a, const vec3 &b, const vec3 &c, std::span<const vec3> points,
+              std::span<int> out);
+void incircle(const vec2 &a, const vec2 &b, const vec2 &c, std::span<const vec2> points,
+              std::span<int> out);
+void insphere(const vec3 &a, const vec3 &b, const vec3 &c, const vec3 &d,
+              std::span<const vec3> points, std::span<int> out);
+
+} // namespace math
+
+#endif // PREDICATES_HPP
@@ -0,0 +1,348 @@
+#include "rasterizer.hpp"
+
+#include "../clipping/clipping.hpp"
+#include "../parallel/parallel_for.hpp"
+#include "../simd/simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+using math::simd::f32x8;
+using math::simd::i32x8;
+
+constexpr int subpixel_bits = 4;
+constexpr int subpixel_scale = 1 << subpixel_bits;
+constexpr int block_size = 8;
+constexpr int tile_size = 64;
+constexpr std::size_t vertex_chunk = 16384;
+constexpr std::size_t triangle_chunk = 16384;
+// Vertices further than this many pixels from the viewport origin are not representable in
+// the fixed-point edge setup. Triangles are clipped to half of it, so only degenerate input
+// (w == 0, NaN) can reach the limit; such triangles are dropped.
+constexpr float fixed_point_limit = 16384.0f;
+constexpr float guard_band_pixels = 8192.0f;
+
+struct screen_vertex {
+    float x, y, z;
+    bool valid;
+};
+
+// Edge functions E(x, y) = a * x + b * y + c in 28.4 fixed point, already biased by the
+// top-left fill rule so a sample is covered when all three are >= 0.
+struct triangle_setup {
+    std::int32_t a[3];
+    std::int32_t b[3];
+    std::int64_t c[3];
+    // Window-space depth as a plane over fixed-point coordinates: z = z0 + zx * x + zy * y.
+    double z0;
+    float zx, zy;
+    int min_x, min_y, max_x, max_y; // inclusive pixel bounds, clipped to the viewport
+    std::uint32_t id;
+};
+
+bool setup_triangle(const screen_vertex &v0, const screen_vertex &v1, const screen_vertex &v2,
+                    std::uint32_t id, int width, int height, bool cull_back_faces,
+                    triangle_setup &out) {
+    if (!v0.valid || !v1.valid || !v2.valid) {
+        return false;
+    }
+
+    std::int64_t x[3] = {std::llround(v0.x * subpixel_scale), std::llround(v1.x * subpixel_scale),
+                         std::llround(v2.x * subpixel_scale)};
+    std::int64_t y[3] = {std::llround(v0.y * subpixel_scale), std::llround(v1.y * subpixel_scale),
+                         std::llround(v2.y * subpixel_scale)};
+    float z[3] = {v0.z, v1.z, v2.z};
+
+    std::int64_t area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+    if (area == 0) {
+        return false;
+    }
+    // y points down on screen, so counter-clockwise NDC triangles have negative area here.
+    if (area > 0 && cull_back_faces) {
+        return false;
+    }
+    if (area < 0) {
+        std::swap(x[1], x[2]);
+        std::swap(y[1], y[2]);
+        std::swap(z[1], z[2]);
+        area = -area;
+    }
+
+    std::int64_t min_fx = std::min({x[0], x[1], x[2]});
+    std::int64_t max_fx = std::max({x[0], x[1], x[2]});
+    std::int64_t min_fy = std::min({y[0], y[1], y[2]});
+    std::int64_t max_fy = std::max({y[0], y[1], y[2]});
+    // Pixel p is sampled at p * 16 + 8.
+    out.min_x = static_cast<int>(std::max<std::int64_t>((min_fx - 8 + subpixel_scale - 1) >> subpixel_bits, 0));
+    out.min_y = static_cast<int>(std::max<std::int64_t>((min_fy - 8 + subpixel_scale - 1) >> subpixel_bits, 0));
+    out.max_x = static_cast<int>(std::min<std::int64_t>((max_fx - 8) >> subpixel_bits, width - 1));
+    out.max_y = static_cast<int>(std::min<std::int64_t>((max_fy - 8) >> subpixel_bits, height - 1));
+    if (out.min_x > out.max_x || out.min_y > out.max_y) {
+        return false;
+    }
+
+    // Edge k is opposite vertex k.
+    for (int k = 0; k < 3; ++k) {
+        const int i = (k + 1) % 3;
+        const int j = (k + 2) % 3;
+        std::int64_t a = y[i] - y[j];
+        std::int64_t b = x[j] - x[i];
+        std::int64_t c = -(a * x[i] + b * y[i]);
+        bool top_left = a > 0 || (a == 0 && b < 0);
+        out.a[k] = static_cast<std::int32_t>(a);
+        out.b[k] = static_cast<std::int32_t>(b);
+        out.c[k] = top_left ? c : c - 1;
+    }
+
+    // z = z0 + (z1 - z0) * E1 / area + (z2 - z0) * E2 / area
+    const double inv_area = 1.0 / static_cast<double>(area);
+    const double dz1 = (z[1] - z[0]) * inv_area;
+    const double dz2 = (z[2] - z[0]) * inv_area;
+    out.zx = static_cast<float>(dz1 * out.a[1] + dz2 * out.a[2]);
+    out.zy = static_cast<float>(dz1 * out.b[1] + dz2 * out.b[2]);
+    out.z0 = z[0] + dz1 * static_cast<double>(out.c[1]) + dz2 * static_cast<double>(out.c[2]);
+    out.id = id;
+    return true;
+}
+
+inline std::int32_t clamp_edge(std::int64_t e) {
+    // Values this large cannot change sign inside one block; clamping keeps the per-lane
+    // arithmetic in 32 bits.
+    constexpr std::int64_t limit = std::int64_t(1) << 30;
+    return static_cast<std::int32_t>(std::clamp(e, -limit, limit));
+}
+
+// Rasterizes tri inside the pixel rectangle [x0, x1) x [y0, y1), which is block aligned.
+void rasterize_in_rect(const triangle_setup &tri, int x0, int y0, int x1, int y1, float *depth,
+                       std::uint32_t *ids, int stride) {
+    const int bx0 = std::max(x0, tri.min_x & ~(block_size - 1));
+    const int by0 = std::max(y0, tri.min_y & ~(block_size - 1));
+    const int bx1 = std::min(x1, tri.max_x + 1);
+    const int by1 = std::min(y1, tri.max_y + 1);
+
+    const std::int32_t step_x[3] = {tri.a[0] * subpixel_scale, tri.a[1] * subpixel_scale,
+                                    tri.a[2] * subpixel_scale};
+    const std::int32_t step_y[3] = {tri.b[0] * subpixel_scale, tri.b[1] * subpixel_scale,
+                                    tri.b[2] * subpixel_scale};
+    const float zstep_x = tri.zx * subpixel_scale;
+    const float zstep_y = tri.zy * subpixel_scale;
+
+#if MATH_SIMD_LEVEL >= 1
+    constexpr float lane_index[block_size] = {0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f};
+    const f32x8 z_lane = f32x8::loadu(lane_index) * f32x8(zstep_x);
+    const f32x8 z_row(zstep_y);
+    i32x8 row_step[3], lane_offset[3];
+    for (int k = 0; k < 3; ++k) {
+        std::int32_t offsets[block_size];
+        for (int c = 0; c < block_size; ++c) {
+            offsets[c] = step_x[k] * c;
+        }
+        row_step[k] = i32x8(step_y[k]);
+        lane_offset[k] = i32x8::loadu(offsets);
+    }
+    const i32x8 id(static_cast<std::int32_t>(tri.id));
+#endif
+
+    for (int by = by0; by < by1; by += block_size) {
+        for (int bx = bx0; bx < bx1; bx += block_size) {
+            const std::int64_t sx = std::int64_t(bx) * subpixel_scale + subpixel_scale / 2;
+            const std::int64_t sy = std::int64_t(by) * subpixel_scale + subpixel_scale / 2;
+
+            // Reject the block when one edge is negative at its most inside corner.
+            std::int32_t e0[3];
+            bool outside = false;
+            for (int k = 0; k < 3; ++k) {
+                std::int64_t e = tri.a[k] * sx + tri.b[k] * sy + tri.c[k];
+                std::int64_t best = e + std::max<std::int64_t>(step_x[k], 0) * (block_size - 1) +
+                                    std::max<std::int64_t>(step_y[k], 0) * (block_size - 1);
+                outside = outside || best < 0;
+                e0[k] = clamp_edge(e);
+            }
+            if (outside) {
+                continue;
+            }
+            const float zb = static_cast<float>(tri.z0 + tri.zx * double(sx) + tri.zy * double(sy));
+
+#if MATH_SIMD_LEVEL >= 1
+            i32x8 e[3];
+            for (int k = 0; k < 3; ++k) {
+                e[k] = i32x8(e0[k]) + lane_offset[k];
+            }
+            f32x8 z = f32x8(zb) + z_lane;
+            for (int r = 0; r < block_size; ++r) {
+                const f32x8::mask covered = ~((e[0] | e[1] | e[2]) < i32x8(0));
+                if (any(covered)) {
+                    const std::size_t offset = std::size_t(by + r) * stride + bx;
+                    std::int32_t *id_row = reinterpret_cast<std::int32_t *>(ids + offset);
+                    const f32x8 current = f32x8::loadu(depth + offset);
+                    const f32x8::mask pass = covered & (z < current);
+                    select(pass, z, current).storeu(depth + offset);
+                    select(pass, id, i32x8::loadu(id_row)).storeu(id_row);
+                }
+                for (int k = 0; k < 3; ++k) {
+                    e[k] += row_step[k];
+                }
+                z += z_row;
+            }
+#else
+            for (int r = 0; r < block_size; ++r) {
+                for (int c = 0; c < block_size; ++c) {
+                    std::int32_t w0 = e0[0] + step_x[0] * c + step_y[0] * r;
+                    std::int32_t w1 = e0[1] + step_x[1] * c + step_y[1] * r;
+                    std::int32_t w2 = e0[2] + step_x[2] * c + step_y[2] * r;
+                    if ((w0 | w1 | w2) < 0) {
+                        continue;
+                    }
+                    float z = zb + zstep_x * c + zstep_y * r;
+                    const std::size_t offset = std::size_t(by + r) * stride + bx + c;
+                    if (z < depth[offset]) {
+                        depth[offset] = z;
+                        ids[offset] = tri.id;
+                    }
+                }
+            }
+#endif
+        }
+    }
+}
+
+} // namespace
+
+namespace math {
+
+raster_target::raster_target(int width, int height)
+    : m_width(width), m_height(height), m_stride((width + block_size - 1) & ~(block_size - 1)),
+      m_padded_height((height + tile_size - 1) & ~(tile_size - 1)),
+      m_depth(std::size_t(m_stride) * m_padded_height, 1.0f),
+      m_ids(std::size_t(m_stride) * m_padded_height, no_triangle) {}
+
+void raster_target::clear() {
+    std::fill(m_depth.begin(), m_depth.end(), 1.0f);
+    std::fill(m_ids.begin(), m_ids.end(), no_triangle);
+}
+
+int raster_target::width() const { return m_width; }
+
+int raster_target::height() const { return m_height; }
+
+int raster_target::stride() const { return m_stride; }
+
+float raster_target::depth(int x, int y) const { return m_depth[std::size_t(y) * m_stride + x]; }
+
+std::uint32_t raster_target::triangle_id(int x, int y) const {
+    return m_ids[std::size_t(y) * m_stride + x];
+}
+
+std::span<const float> raster_target::depth_buffer() const {
+    return {m_depth.data(), std::size_t(m_stride) * m_height};
+}
+
+std::span<const std::uint32_t> raster_target::id_buffer() const {
+    return {m_ids.data(), std::size_t(m_stride) * m_height};
+}
+
+void rasterize(const mat4x4 &view_projection, std::span<const vec3> positions,
+               std::span<const std::uint32_t> indices, raster_target &target,
+               const raster_options &options) {
+    const int width = target.m_width;
+    const int height = target.m_height;
+    const float half_w = 0.5f * width;
+    const float half_h = 0.5f * height;
+
+    // 1. Vertices to clip space and through the regular vec4 NDC path to window space. The
+    //    clipper only reads outcodes of input vertices, so both happen in one pass; vertices
+    //    the clipper adds are converted afterwards.
+    auto to_screen = [&](const vec4 &clip) -> screen_vertex {
+        if (clip.w() <= 0.0f) {
+            return {0.0f, 0.0f, 0.0f, false};
+        }
+        vec4 ndc = clip.to_normalized_device_coordinates();
+        float sx = (ndc.x() + 1.0f) * half_w;
+        float sy = (1.0f - ndc.y()) * half_h;
+        return {sx, sy, ndc.z() * 0.5f + 0.5f,
+                std::abs(sx) < fixed_point_limit && std::abs(sy) < fixed_point_limit};
+    };
+
+    std::vector<vec4> clip_positions(positions.size());
+    std::vector<screen_vertex> screen(positions.size());
+    parallel::for_each_chunk(
+        positions.size(), vertex_chunk,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                const vec4 clip = view_projection * vec4(positions[i], 1.0f);
+                vec4 &out = clip_positions[i];
+                out.x(clip.x());
+                out.y(clip.y());
+                out.z(clip.z());
+                out.w(clip.w());
+                screen[i] = to_screen(clip);
+            }
+        },
+        options.thread_count);
+
+    // Near/far planes and the guard band.
+    triangle_clipper clipper(std::max(guard_band_pixels / std::max(half_w, half_h), 1.0f));
+    clipper.clip(clip_positions, indices);
+    for (const vec4 &added : clipper.added_vertices()) {
+        screen.push_back(to_screen(added));
+    }
+    const std::span<const std::uint32_t> clipped_indices = clipper.indices();
+    const std::span<const std::uint32_t> triangle_ids = clipper.triangle_ids();
+
+    // 2. Triangle setup and binning. Every chunk of triangles owns its own bins so no locking
+    //    is needed, and tiles later walk the chunks in order to keep submission order.
+    const int tiles_x = (width + tile_size - 1) / tile_size;
+    const int tiles_y = (height + tile_size - 1) / tile_size;
+    const std::size_t tile_count = std::size_t(tiles_x) * tiles_y;
+    const std::size_t triangle_count = clipper.triangle_count();
+    const std::size_t chunk_count = (triangle_count + triangle_chunk - 1) / triangle_chunk;
+
+    std::vector<triangle_setup> setups(triangle_count);
+    std::vector<std::vector<std::uint32_t>> bins(chunk_count * tile_count);
+    parallel::for_each_chunk(
+        triangle_count, triangle_chunk,
+        [&](std::size_t begin, std::size_t end) {
+            std::vector<std::uint32_t> *chunk_bins = &bins[(begin / triangle_chunk) * tile_count];
+            for (std::size_t t = begin; t < end; ++t) {
+                triangle_setup &tri = setups[t];
+                if (!setup_triangle(screen[clipped_indices[3 * t]], screen[clipped_indices[3 * t + 1]],
+                                    screen[clipped_indices[3 * t + 2]], triangle_ids[t],
+                                    width, height, options.cull_back_faces, tri)) {
+                    continue;
+                }
+                for (int ty = tri.min_y / tile_size; ty <= tri.max_y / tile_size; ++ty) {
+                    for (int tx = tri.min_x / tile_size; tx <= tri.max_x / tile_size; ++tx) {
+                        chunk_bins[std::size_t(ty) * tiles_x + tx].push_back(
+                            static_cast<std::uint32_t>(t));
+                    }
+                }
+            }
+        },
+        options.thread_count);
+
+    // 3. One worker per tile; tiles touch disjoint pixels.
+    float *depth = target.m_depth.data();
+    std::uint32_t *ids = target.m_ids.data();
+    const int stride = target.m_stride;
+    parallel::for_each_chunk(
+        tile_count, 1,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t tile = begin; tile < end; ++tile) {
+                const int x0 = int(tile % tiles_x) * tile_size;
+                const int y0 = int(tile / tiles_x) * tile_size;
+                const int x1 = std::min(x0 + tile_size, stride);
+                const int y1 = y0 + tile_size;
+                for (std::size_t chunk = 0; chunk < chunk_count; ++chunk) {
+                    for (std::uint32_t t : bins[chunk * tile_count + tile]) {
+                        rasterize_in_rect(setups[t], x0, y0, x1, y1, depth, ids, stride);
+                    }
+                }
+            }
+        },
+        options.thread_count);
+}
+
+} // namespace math
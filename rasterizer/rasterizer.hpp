@@ -0,0 +1,63 @@
+#ifndef RASTERIZER_HPP
+#define RASTERIZER_HPP
+
+#include "../mat4x4/mat4x4.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace math {
+
+struct raster_options {
+    unsigned thread_count = 0; // 0 = hardware concurrency
+    bool cull_back_faces = false; // front faces are counter-clockwise in NDC
+};
+
+// Depth and triangle-ID buffers of a CPU render. Depth is window-space z in [0, 1]
+// (cleared to 1), IDs are triangle indices (cleared to no_triangle).
+class raster_target {
+  public:
+    static constexpr std::uint32_t no_triangle = 0xFFFFFFFFu;
+
+    raster_target(int width, int height);
+
+    void clear();
+
+    int width() const;
+    int height() const;
+    // Row pitch of the buffers in pixels; rows are padded to a multiple of 8.
+    int stride() const;
+
+    float depth(int x, int y) const;
+    std::uint32_t triangle_id(int x, int y) const;
+
+    std::span<const float> depth_buffer() const;
+    std::span<const std::uint32_t> id_buffer() const;
+
+  private:
+    friend void rasterize(const mat4x4 &, std::span<const vec3>, std::span<const std::uint32_t>,
+                          raster_target &, const raster_options &);
+
+    int m_width;
+    int m_height;
+    int m_stride;
+    int m_padded_height;
+    std::vector<float> m_depth;
+    std::vector<std::uint32_t> m_ids;
+};
+
+// Renders indexed triangles (three indices per triangle) transformed by view_projection
+// into target with a less-than depth test. The screen is split into 64x64 tiles; triangles
+// are binned per tile and every tile is rasterized by one worker, 8x8 pixels at a time.
+// Triangles are clipped in homogeneous space first (see triangle_clipper), so geometry that
+// crosses the near plane or reaches far outside the viewport is drawn correctly; IDs written
+// to the target always refer to the input triangles.
+void rasterize(const mat4x4 &view_projection, std::span<const vec3> positions,
+               std::span<const std::uint32_t> indices, raster_target &target,
+               const raster_options &options = {});
+
+} // namespace math
+
+#endif // RASTERIZER_HPP
@@ -0,0 +1,163 @@
+#include "ray_generation.hpp"
+
+#include "../parallel/parallel_for.hpp"
+#include "../simd/vec3_block.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+using math::simd::f32x8;
+
+constexpr std::size_t block = 8;
+constexpr std::size_t row_chunk = 8;
+
+// Pixel centers of the lanes of a block.
+alignas(32) constexpr float lane_centers[block] = {0.5f, 1.5f, 2.5f, 3.5f,
+                                                   4.5f, 5.5f, 6.5f, 7.5f};
+
+void check_size(int width, int height) {
+    if (width <= 0 || height <= 0) [[unlikely]] {
+        throw std::invalid_argument("Image size must be positive");
+    }
+}
+
+// The inverse view-projection, one broadcast register per element (row-major).
+struct inverse_matrix {
+    f32x8 m[16];
+
+    explicit inverse_matrix(const math::mat4x4 &view_projection) {
+        const math::mat4x4 inverse = view_projection.inverse();
+        for (int i = 0; i < 16; ++i) {
+            m[i] = f32x8(inverse.data()[i]);
+        }
+    }
+
+    // Row r of inverse * (x, y, z, 1) with the y, z and constant terms already summed.
+    f32x8 row(int r, f32x8 x, f32x8 partial) const { return fmadd(m[4 * r], x, partial); }
+    f32x8 partial(int r, f32x8 y, f32x8 z) const {
+        return fmadd(m[4 * r + 1], y, fmadd(m[4 * r + 2], z, m[4 * r + 3]));
+    }
+};
+
+// x, y, z in world space of eight NDC points, divided by w.
+inline void unproject_block(const inverse_matrix &inv, f32x8 x, f32x8 y, f32x8 z,
+                            f32x8 (&out)[3]) {
+    const f32x8 inv_w = f32x8(1.0f) / inv.row(3, x, inv.partial(3, y, z));
+    for (int r = 0; r < 3; ++r) {
+        out[r] = inv.row(r, x, inv.partial(r, y, z)) * inv_w;
+    }
+}
+
+// The pixel centers of one row from near to far plane. The y and z terms of the product are
+// fixed per row, so a block costs one fmadd per homogeneous component and end point.
+void generate_row(const inverse_matrix &inv, int width, float ndc_y, float scale_x,
+                  float *const (&origin)[3], float *const (&direction)[3]) {
+    const f32x8 y(ndc_y);
+    f32x8 near_partial[4], far_partial[4];
+    for (int r = 0; r < 4; ++r) {
+        near_partial[r] = inv.partial(r, y, f32x8(-1.0f));
+        far_partial[r] = inv.partial(r, y, f32x8(1.0f));
+    }
+    const f32x8 step(static_cast<float>(block));
+    f32x8 pixel = f32x8::load(lane_centers);
+    for (std::size_t i = 0; i < static_cast<std::size_t>(width); i += block) {
+        const f32x8 x = fmadd(pixel, f32x8(scale_x), f32x8(-1.0f));
+        pixel += step;
+        const f32x8 near_w = f32x8(1.0f) / inv.row(3, x, near_partial[3]);
+        const f32x8 far_w = f32x8(1.0f) / inv.row(3, x, far_partial[3]);
+        f32x8 o[3], d[3];
+        for (int r = 0; r < 3; ++r) {
+            o[r] = inv.row(r, x, near_partial[r]) * near_w;
+            d[r] = inv.row(r, x, far_partial[r]) * far_w - o[r];
+        }
+        const f32x8 inv_length =
+            f32x8(1.0f) / sqrt(fmadd(d[0], d[0], fmadd(d[1], d[1], d[2] * d[2])));
+        const std::size_t count = std::min(block, static_cast<std::size_t>(width) - i);
+        for (int r = 0; r < 3; ++r) {
+            d[r] *= inv_length;
+            if (count == block) [[likely]] {
+                o[r].storeu(origin[r] + i);
+                d[r].storeu(direction[r] + i);
+            } else {
+                float scratch[2 * block];
+                o[r].storeu(scratch);
+                d[r].storeu(scratch + block);
+                std::copy_n(scratch, count, origin[r] + i);
+                std::copy_n(scratch + block, count, direction[r] + i);
+            }
+        }
+    }
+}
+
+} // namespace
+
+namespace math {
+
+void unproject(const mat4x4 &view_projection, int width, int height,
+               std::span<const vec3> window_points, std::span<vec3> out) {
+    check_size(width, height);
+    if (out.size() < window_points.size()) [[unlikely]] {
+        throw std::invalid_argument("Output is smaller than the input");
+    }
+    const inverse_matrix inv(view_projection);
+    const f32x8 scale_x(2.0f / width), scale_y(-2.0f / height);
+    const std::size_t n = window_points.size();
+    const float *in = reinterpret_cast<const float *>(window_points.data());
+    float *dst = reinterpret_cast<float *>(out.data());
+    for (std::size_t i = 0; i < n; i += block) {
+        const std::size_t count = std::min(block, n - i);
+        // A partial block is padded with copies of its first point.
+        float scratch[3 * block];
+        const float *src = in + 3 * i;
+        if (count < block) [[unlikely]] {
+            for (std::size_t k = 0; k < block; ++k) {
+                std::copy_n(src + 3 * (k < count ? k : 0), 3, scratch + 3 * k);
+            }
+            src = scratch;
+        }
+        f32x8 v[3], world[3];
+        math::simd::load_vec3x8(src, v);
+        unproject_block(inv, fmadd(v[0], scale_x, f32x8(-1.0f)), fmadd(v[1], scale_y, f32x8(1.0f)),
+                        fmadd(v[2], f32x8(2.0f), f32x8(-1.0f)), world);
+        if (count == block) [[likely]] {
+            math::simd::store_vec3x8(dst + 3 * i, world);
+        } else {
+            math::simd::store_vec3x8(scratch, world);
+            std::copy_n(scratch, 3 * count, dst + 3 * i);
+        }
+    }
+}
+
+void generate_primary_rays(const mat4x4 &view_projection, int width, int height,
+                           const vec3_soa &origins, const vec3_soa &directions,
+                           unsigned thread_count) {
+    check_size(width, height);
+    const std::size_t pixels = std::size_t(width) * height;
+    for (const std::span<float> &component :
+         {origins.x, origins.y, origins.z, directions.x, directions.y, directions.z}) {
+        if (component.size() < pixels) [[unlikely]] {
+            throw std::invalid_argument("Ray output is smaller than the image");
+        }
+    }
+    const inverse_matrix inv(view_projection);
+    const float scale_x = 2.0f / width, scale_y = 2.0f / height;
+    parallel::for_each_chunk(
+        static_cast<std::size_t>(height), row_chunk,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t y = begin; y < end; ++y) {
+                const std::size_t offset = y * width;
+                float *const origin[3] = {origins.x.data() + offset, origins.y.data() + offset,
+                                          origins.z.data() + offset};
+                float *const direction[3] = {directions.x.data() + offset,
+                                             directions.y.data() + offset,
+                                             directions.z.data() + offset};
+                const float ndc_y = 1.0f - (static_cast<float>(y) + 0.5f) * scale_y;
+                generate_row(inv, width, ndc_y, scale_x, origin, direction);
+            }
+        },
+        thread_count);
+}
+
+} // namespace math
@@ -0,0 +1,31 @@
+#ifndef RAY_GENERATION_HPP
+#define RAY_GENERATION_HPP
+
+#include "../aos_soa/aos_soa.hpp"
+
+#include <span>
+
+namespace math {
+
+// Screen-to-world unprojection for a width x height image in the rasterizer's window
+// convention: pixel (x, y) covers [x, x + 1) x [y, y + 1) with y pointing down, and depth is
+// window-space z in [0, 1]. view_projection is inverted once per call, which throws
+// std::runtime_error when it is singular; a non-positive size throws std::invalid_argument.
+
+// out[i] = world position of window point (x, y, depth) = window_points[i]. out has room for
+// window_points.size() entries and may alias it.
+void unproject(const mat4x4 &view_projection, int width, int height,
+               std::span<const vec3> window_points, std::span<vec3> out);
+
+// One ray through the center of every pixel, row by row (index y * width + x): the origin is
+// the pixel on the near plane (depth 0) and the direction the unit vector towards the pixel
+// on the far plane (depth 1). The inverse is applied incrementally along each row, eight
+// pixels at a time, and rows are spread over thread_count threads (0 = hardware
+// concurrency). Every output array has room for width * height entries.
+void generate_primary_rays(const mat4x4 &view_projection, int width, int height,
+                           const vec3_soa &origins, const vec3_soa &directions,
+                           unsigned thread_count = 0);
+
+} // namespace math
+
+#endif // RAY_GENERATION_HPP
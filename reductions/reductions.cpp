@@ -0,0 +1,256 @@
+#include "reductions.hpp"
+
+#include "../parallel/parallel_for.hpp"
+#include "../simd/vec3_block.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+static_assert(sizeof(math::vec3) == 3 * sizeof(float), "vec3 arrays are read as packed floats");
+
+namespace {
+
+using math::simd::f32x8;
+
+constexpr std::size_t block = 8;
+// Points summed in float before the lanes are carried into double accumulators.
+constexpr std::size_t run_size = 256;
+// Partial results are kept per chunk; the boundaries must not depend on the thread count.
+constexpr std::size_t chunk_size = 16384;
+// Point sets smaller than this are processed on the calling thread.
+constexpr std::size_t parallel_threshold = 65536;
+
+static_assert(chunk_size % run_size == 0 && run_size % block == 0);
+
+// What a pass accumulates besides the bounds: nothing, first moments, or first and second.
+enum class moments { none, first, second };
+
+struct partial {
+    float min[3];
+    float max[3];
+    // Sums of d = p - shift, and of d_i * d_j in the order xx, yy, zz, xy, yz, zx.
+    double sum[3];
+    double product[6];
+};
+
+// Points [i, i + n) of the set, n <= 8. A partial block is padded with `pad`, which must be a
+// point of the set so bounds are unaffected.
+inline void load_points(const float *points, std::size_t i, std::size_t n, const float *pad,
+                        f32x8 (&v)[3]) {
+    if (n == block) [[likely]] {
+        math::simd::load_vec3x8(points + 3 * i, v);
+        return;
+    }
+    float scratch[3 * block];
+    for (std::size_t k = 0; k < block; ++k) {
+        const float *src = k < n ? points + 3 * (i + k) : pad;
+        std::copy(src, src + 3, scratch + 3 * k);
+    }
+    math::simd::load_vec3x8(scratch, v);
+}
+
+// Adds the lanes of a float run sum into per-lane double accumulators.
+inline void carry(f32x8 run, double (&lanes)[block]) {
+    float values[block];
+    run.storeu(values);
+    for (std::size_t l = 0; l < block; ++l) {
+        lanes[l] += values[l];
+    }
+}
+
+inline double lane_sum(const double (&lanes)[block]) {
+    return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) +
+           ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+}
+
+// Partial result for points [begin, end). `shift` is a point of the set; sums are taken
+// relative to it so the second moments do not cancel catastrophically.
+template <moments M>
+partial reduce_chunk(const float *points, std::size_t begin, std::size_t end, const float *shift) {
+    const f32x8 k[3] = {f32x8(shift[0]), f32x8(shift[1]), f32x8(shift[2])};
+    f32x8 lo[3] = {k[0], k[1], k[2]};
+    f32x8 hi[3] = {k[0], k[1], k[2]};
+    double sum[3][block] = {};
+    double product[6][block] = {};
+
+    for (std::size_t run = begin; run < end; run += run_size) {
+        const std::size_t run_end = std::min(run + run_size, end);
+        f32x8 s[3] = {f32x8(0.0f), f32x8(0.0f), f32x8(0.0f)};
+        f32x8 p[6] = {f32x8(0.0f), f32x8(0.0f), f32x8(0.0f),
+                      f32x8(0.0f), f32x8(0.0f), f32x8(0.0f)};
+        for (std::size_t i = run; i < run_end; i += block) {
+            f32x8 v[3];
+            load_points(points, i, std::min(block, run_end - i), shift, v);
+            for (int c = 0; c < 3; ++c) {
+                lo[c] = min(lo[c], v[c]);
+                hi[c] = max(hi[c], v[c]);
+            }
+            if constexpr (M != moments::none) {
+                const f32x8 d[3] = {v[0] - k[0], v[1] - k[1], v[2] - k[2]};
+                for (int c = 0; c < 3; ++c) {
+                    s[c] += d[c];
+                }
+                if constexpr (M == moments::second) {
+                    for (int c = 0; c < 3; ++c) {
+                        p[c] = fmadd(d[c], d[c], p[c]);
+                        p[3 + c] = fmadd(d[c], d[(c + 1) % 3], p[3 + c]);
+                    }
+                }
+            }
+        }
+        if constexpr (M != moments::none) {
+            for (int c = 0; c < 3; ++c) {
+                carry(s[c], sum[c]);
+            }
+        }
+        if constexpr (M == moments::second) {
+            for (int c = 0; c < 6; ++c) {
+                carry(p[c], product[c]);
+            }
+        }
+    }
+
+    partial result;
+    for (int c = 0; c < 3; ++c) {
+        result.min[c] = reduce_min(lo[c]);
+        result.max[c] = reduce_max(hi[c]);
+        result.sum[c] = lane_sum(sum[c]);
+    }
+    for (int c = 0; c < 6; ++c) {
+        result.product[c] = lane_sum(product[c]);
+    }
+    return result;
+}
+
+partial merge(const partial &a, const partial &b) {
+    partial result;
+    for (int c = 0; c < 3; ++c) {
+        result.min[c] = std::min(a.min[c], b.min[c]);
+        result.max[c] = std::max(a.max[c], b.max[c]);
+        result.sum[c] = a.sum[c] + b.sum[c];
+    }
+    for (int c = 0; c < 6; ++c) {
+        result.product[c] = a.product[c] + b.product[c];
+    }
+    return result;
+}
+
+// Fixed pairwise tree over the chunk partials, in chunk order.
+partial combine(std::span<const partial> parts) {
+    if (parts.size() == 1) {
+        return parts[0];
+    }
+    const std::size_t half = parts.size() / 2;
+    return merge(combine(parts.first(half)), combine(parts.subspan(half)));
+}
+
+// fn(begin, end) for every chunk, results in chunk order.
+template <typename Result, typename Fn>
+std::vector<Result> per_chunk(std::size_t count, unsigned thread_count, Fn &&fn) {
+    std::vector<Result> parts((count + chunk_size - 1) / chunk_size);
+    if (count < parallel_threshold) {
+        thread_count = 1;
+    }
+    math::parallel::for_each_chunk(
+        count, chunk_size,
+        [&](std::size_t begin, std::size_t end) { parts[begin / chunk_size] = fn(begin, end); },
+        thread_count);
+    return parts;
+}
+
+template <moments M> partial reduce(std::span<const math::vec3> points, unsigned thread_count) {
+    if (points.empty()) [[unlikely]] {
+        throw std::invalid_argument("Point set is empty");
+    }
+    const float *data = reinterpret_cast<const float *>(points.data());
+    const std::vector<partial> parts =
+        per_chunk<partial>(points.size(), thread_count, [&](std::size_t begin, std::size_t end) {
+            return reduce_chunk<M>(data, begin, end, data);
+        });
+    return combine(parts);
+}
+
+math::aabb bounds_of(const partial &r) {
+    return {math::vec3(r.min[0], r.min[1], r.min[2]), math::vec3(r.max[0], r.max[1], r.max[2])};
+}
+
+// Mean of d = p - shift, per axis.
+void mean_offset(const partial &r, std::size_t count, double (&mean)[3]) {
+    for (int c = 0; c < 3; ++c) {
+        mean[c] = r.sum[c] / static_cast<double>(count);
+    }
+}
+
+math::vec3 mean_of(const partial &r, std::size_t count, const math::vec3 &shift) {
+    double mean[3];
+    mean_offset(r, count, mean);
+    return math::vec3(static_cast<float>(shift.x() + mean[0]),
+                      static_cast<float>(shift.y() + mean[1]),
+                      static_cast<float>(shift.z() + mean[2]));
+}
+
+// E[d d^T] - E[d] E[d]^T; the shift cancels.
+math::mat3x3 covariance_of(const partial &r, std::size_t count) {
+    double mean[3];
+    mean_offset(r, count, mean);
+    const double n = static_cast<double>(count);
+    float elements[3][3];
+    for (int c = 0; c < 3; ++c) {
+        const int next = (c + 1) % 3;
+        elements[c][c] = static_cast<float>(r.product[c] / n - mean[c] * mean[c]);
+        const float off = static_cast<float>(r.product[3 + c] / n - mean[c] * mean[next]);
+        elements[c][next] = off;
+        elements[next][c] = off;
+    }
+    return math::mat3x3(elements);
+}
+
+float max_distance_sq_chunk(const float *points, std::size_t begin, std::size_t end,
+                            const math::vec3 &center) {
+    const f32x8 k[3] = {f32x8(center.x()), f32x8(center.y()), f32x8(center.z())};
+    f32x8 farthest(0.0f);
+    for (std::size_t i = begin; i < end; i += block) {
+        f32x8 v[3];
+        load_points(points, i, std::min(block, end - i), points, v);
+        const f32x8 d[3] = {v[0] - k[0], v[1] - k[1], v[2] - k[2]};
+        farthest = max(farthest, fmadd(d[0], d[0], fmadd(d[1], d[1], d[2] * d[2])));
+    }
+    return reduce_max(farthest);
+}
+
+} // namespace
+
+namespace math {
+
+aabb compute_bounds(std::span<const vec3> points, unsigned thread_count) {
+    return bounds_of(reduce<moments::none>(points, thread_count));
+}
+
+vec3 compute_centroid(std::span<const vec3> points, unsigned thread_count) {
+    const partial r = reduce<moments::first>(points, thread_count);
+    return mean_of(r, points.size(), points[0]);
+}
+
+mat3x3 compute_covariance(std::span<const vec3> points, unsigned thread_count) {
+    return covariance_of(reduce<moments::second>(points, thread_count), points.size());
+}
+
+point_statistics compute_statistics(std::span<const vec3> points, unsigned thread_count) {
+    const partial r = reduce<moments::second>(points, thread_count);
+    return {bounds_of(r), mean_of(r, points.size(), points[0]), covariance_of(r, points.size())};
+}
+
+bounding_sphere compute_bounding_sphere(std::span<const vec3> points, unsigned thread_count) {
+    const aabb box = compute_bounds(points, thread_count);
+    const vec3 center = (box.min + box.max) * 0.5f;
+    const float *data = reinterpret_cast<const float *>(points.data());
+    const std::vector<float> parts =
+        per_chunk<float>(points.size(), thread_count, [&](std::size_t begin, std::size_t end) {
+            return max_distance_sq_chunk(data, begin, end, center);
+        });
+    return {center, std::sqrt(*std::max_element(parts.begin(), parts.end()))};
+}
+
+} // namespace math
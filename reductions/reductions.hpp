@@ -0,0 +1,44 @@
+#ifndef REDUCTIONS_HPP
+#define REDUCTIONS_HPP
+
+#include "../mat3x3/mat3x3.hpp"
+
+#include <span>
+
+namespace math {
+
+// Parallel reductions over vec3 point sets. The input is split into fixed chunks whose
+// partial results are combined in a fixed pairwise tree, and sums are carried in double past
+// short float runs, so every result is bit-identical for any thread_count (0 = hardware
+// concurrency). All functions throw std::invalid_argument on an empty span.
+
+struct aabb {
+    vec3 min;
+    vec3 max;
+};
+
+struct bounding_sphere {
+    vec3 center;
+    float radius;
+};
+
+struct point_statistics {
+    aabb bounds;
+    vec3 mean;
+    // Population covariance (divided by the point count).
+    mat3x3 covariance;
+};
+
+aabb compute_bounds(std::span<const vec3> points, unsigned thread_count = 0);
+vec3 compute_centroid(std::span<const vec3> points, unsigned thread_count = 0);
+mat3x3 compute_covariance(std::span<const vec3> points, unsigned thread_count = 0);
+// Bounds, mean and covariance in a single pass over the points.
+point_statistics compute_statistics(std::span<const vec3> points, unsigned thread_count = 0);
+
+// Sphere around the box center reaching the farthest point. Not minimal, but never larger
+// than the box's circumscribed sphere. Two passes over the points.
+bounding_sphere compute_bounding_sphere(std::span<const vec3> points, unsigned thread_count = 0);
+
+} // namespace math
+
+#endif // REDUCTIONS_HPP
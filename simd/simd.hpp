@@ -0,0 +1,744 @@
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Thin portable SIMD layer: f32x4, f32x8 and f32x16 with the same interface on every backend,
+// so a kernel is written once and benchmarked per backend by rebuilding.
+//
+// The backend is chosen at build time. Define one of MATH_SIMD_SCALAR, MATH_SIMD_SSE
+// (SSE4.1), MATH_SIMD_AVX2 (AVX2 + FMA) or MATH_SIMD_AVX512 (AVX-512F) to force it; otherwise
+// the widest instruction set the compiler targets is used, and NO_SIMD selects scalar. Types
+// wider than the backend's registers are built from two halves, so f32x16 always works.
+
+#if !defined(MATH_SIMD_SCALAR) && !defined(MATH_SIMD_SSE) && !defined(MATH_SIMD_AVX2) &&          \
+    !defined(MATH_SIMD_AVX512)
+#if defined(NO_SIMD)
+#define MATH_SIMD_SCALAR
+#elif defined(__AVX512F__) && defined(__AVX2__) && defined(__FMA__)
+#define MATH_SIMD_AVX512
+#elif defined(__AVX2__) && defined(__FMA__)
+#define MATH_SIMD_AVX2
+#elif defined(__SSE4_1__)
+#define MATH_SIMD_SSE
+#else
+#define MATH_SIMD_SCALAR
+#endif
+#endif
+
+#if defined(MATH_SIMD_AVX512)
+#define MATH_SIMD_LEVEL 3
+#elif defined(MATH_SIMD_AVX2)
+#define MATH_SIMD_LEVEL 2
+#elif defined(MATH_SIMD_SSE)
+#define MATH_SIMD_LEVEL 1
+#else
+#define MATH_SIMD_LEVEL 0
+#endif
+
+#if MATH_SIMD_LEVEL >= 3 && !defined(__AVX512F__)
+#error "MATH_SIMD_AVX512 needs AVX-512F code generation"
+#endif
+#if MATH_SIMD_LEVEL >= 2 && (!defined(__AVX2__) || !defined(__FMA__))
+#error "MATH_SIMD_AVX2 needs AVX2 and FMA code generation"
+#endif
+#if MATH_SIMD_LEVEL >= 1 && !defined(__SSE4_1__)
+#error "MATH_SIMD_SSE needs SSE4.1 code generation"
+#endif
+
+#if MATH_SIMD_LEVEL >= 1
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC's AVX-512 intrinsics seed their results with a self-initialized _mm512_undefined_ps(),
+// which trips -Wuninitialized wherever they are inlined.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+#else
+#include <immintrin.h>
+#endif
+#endif
+
+namespace math::simd {
+
+#if MATH_SIMD_LEVEL == 3
+inline constexpr const char *backend_name = "avx512";
+#elif MATH_SIMD_LEVEL == 2
+inline constexpr const char *backend_name = "avx2";
+#elif MATH_SIMD_LEVEL == 1
+inline constexpr const char *backend_name = "sse4.1";
+#else
+inline constexpr const char *backend_name = "scalar";
+#endif
+
+// Interface shared by every vector type V (N lanes) and its mask type V::mask:
+//   V(float)                 broadcast            V::load / V::loadu   aligned / unaligned load
+//   v.store / v.storeu       store                v[i]                 lane read (slow path)
+//   V::gather(base, index)   lane i = base[index[i]] for N int32 indices (hardware gather on
+//                            AVX2 and AVX-512, scalar loads otherwise)
+//   v.stream                 aligned non-temporal store (plain store on the scalar backend);
+//                            follow a batch of them with stream_fence()
+//   + - * / unary -          lane-wise            += -= *= /=
+//   fmadd(a, b, c)           a * b + c, fused where the backend has FMA
+//   fnmadd(a, b, c)          c - a * b
+//   min, max, abs, sqrt      lane-wise            reduce_add / reduce_min / reduce_max
+//   floor                    lane-wise
+//   rsqrt(a)                 approximate 1 / sqrt(a): the hardware estimate (12 bits, 14 for
+//                            f32x16 on AVX-512), exact on the scalar backend
+//   == != < <= > >=          give V::mask         select(m, a, b)      m ? a : b per lane
+//   shuffle<i0, i1, i2, i3>(a)     permute within every group of four lanes
+//   shuffle<i0, i1, i2, i3>(a, b)  per group: lanes i0, i1 from a and i2, i3 from b
+//                                  (_mm_shuffle_ps semantics)
+// Masks support & | ^ ~ and any(m), all(m), none(m), bits(m) (lane i -> bit i).
+// The functions are hidden friends: call them unqualified so argument-dependent lookup finds
+// them.
+// Types with eight or more lanes also have V(half lo, half hi), v.low() and v.high().
+//
+// i32x4 and i32x8 hold int32 lanes for exact fixed-point work and only carry what it needs:
+// I(int32) broadcast, I::loadu, i.storeu, wrapping + and +=, |, < (signed, giving the mask of
+// the float type with the same width) and select.
+
+template <int i0, int i1, int i2, int i3> constexpr int make_shuffle_imm() {
+    static_assert(i0 >= 0 && i0 < 4 && i1 >= 0 && i1 < 4 && i2 >= 0 && i2 < 4 && i3 >= 0 &&
+                      i3 < 4,
+                  "shuffle lanes must be in [0, 4)");
+    return i0 | (i1 << 2) | (i2 << 4) | (i3 << 6);
+}
+
+// A variable rather than a call so the intrinsics see an immediate even at -O0.
+template <int i0, int i1, int i2, int i3>
+inline constexpr int shuffle_imm = make_shuffle_imm<i0, i1, i2, i3>();
+
+// Two halves acting as one vector; used for every width the backend has no register for.
+template <typename Half> struct wide_mask {
+    typename Half::mask lo, hi;
+
+    friend wide_mask operator&(wide_mask a, wide_mask b) { return {a.lo & b.lo, a.hi & b.hi}; }
+    friend wide_mask operator|(wide_mask a, wide_mask b) { return {a.lo | b.lo, a.hi | b.hi}; }
+    friend wide_mask operator^(wide_mask a, wide_mask b) { return {a.lo ^ b.lo, a.hi ^ b.hi}; }
+    friend wide_mask operator~(wide_mask a) { return {~a.lo, ~a.hi}; }
+    friend unsigned bits(wide_mask a) { return bits(a.lo) | (bits(a.hi) << Half::size); }
+    friend bool any(wide_mask a) { return any(a.lo) || any(a.hi); }
+    friend bool all(wide_mask a) { return all(a.lo) && all(a.hi); }
+    friend bool none(wide_mask a) { return !any(a); }
+};
+
+template <typename Half> struct wide {
+    using half_type = Half;
+    using mask = wide_mask<Half>;
+    static constexpr std::size_t size = 2 * Half::size;
+
+    Half lo, hi;
+
+    wide() = default;
+    wide(float value) : lo(value), hi(value) {}
+    wide(Half low_half, Half high_half) : lo(low_half), hi(high_half) {}
+
+    static wide load(const float *p) { return {Half::load(p), Half::load(p + Half::size)}; }
+    static wide loadu(const float *p) { return {Half::loadu(p), Half::loadu(p + Half::size)}; }
+    static wide gather(const float *base, const std::int32_t *index) {
+        return {Half::gather(base, index), Half::gather(base, index + Half::size)};
+    }
+    void store(float *p) const {
+        lo.store(p);
+        hi.store(p + Half::size);
+    }
+    void storeu(float *p) const {
+        lo.storeu(p);
+        hi.storeu(p + Half::size);
+    }
+    void stream(float *p) const {
+        lo.stream(p);
+        hi.stream(p + Half::size);
+    }
+    float operator[](std::size_t i) const { return i < Half::size ? lo[i] : hi[i - Half::size]; }
+    Half low() const { return lo; }
+    Half high() const { return hi; }
+
+    friend wide operator+(wide a, wide b) { return {a.lo + b.lo, a.hi + b.hi}; }
+    friend wide operator-(wide a, wide b) { return {a.lo - b.lo, a.hi - b.hi}; }
+    friend wide operator*(wide a, wide b) { return {a.lo * b.lo, a.hi * b.hi}; }
+    friend wide operator/(wide a, wide b) { return {a.lo / b.lo, a.hi / b.hi}; }
+    friend wide operator-(wide a) { return {-a.lo, -a.hi}; }
+    wide &operator+=(wide b) { return *this = *this + b; }
+    wide &operator-=(wide b) { return *this = *this - b; }
+    wide &operator*=(wide b) { return *this = *this * b; }
+    wide &operator/=(wide b) { return *this = *this / b; }
+
+    friend wide fmadd(wide a, wide b, wide c) { return {fmadd(a.lo, b.lo, c.lo), fmadd(a.hi, b.hi, c.hi)}; }
+    friend wide fnmadd(wide a, wide b, wide c) { return {fnmadd(a.lo, b.lo, c.lo), fnmadd(a.hi, b.hi, c.hi)}; }
+    friend wide min(wide a, wide b) { return {min(a.lo, b.lo), min(a.hi, b.hi)}; }
+    friend wide max(wide a, wide b) { return {max(a.lo, b.lo), max(a.hi, b.hi)}; }
+    friend wide abs(wide a) { return {abs(a.lo), abs(a.hi)}; }
+    friend wide sqrt(wide a) { return {sqrt(a.lo), sqrt(a.hi)}; }
+    friend wide rsqrt(wide a) { return {rsqrt(a.lo), rsqrt(a.hi)}; }
+    friend wide floor(wide a) { return {floor(a.lo), floor(a.hi)}; }
+    friend float reduce_add(wide a) { return reduce_add(a.lo + a.hi); }
+    friend float reduce_min(wide a) { return reduce_min(min(a.lo, a.hi)); }
+    friend float reduce_max(wide a) { return reduce_max(max(a.lo, a.hi)); }
+
+    friend mask operator==(wide a, wide b) { return {a.lo == b.lo, a.hi == b.hi}; }
+    friend mask operator!=(wide a, wide b) { return {a.lo != b.lo, a.hi != b.hi}; }
+    friend mask operator<(wide a, wide b) { return {a.lo < b.lo, a.hi < b.hi}; }
+    friend mask operator<=(wide a, wide b) { return {a.lo <= b.lo, a.hi <= b.hi}; }
+    friend mask operator>(wide a, wide b) { return {a.lo > b.lo, a.hi > b.hi}; }
+    friend mask operator>=(wide a, wide b) { return {a.lo >= b.lo, a.hi >= b.hi}; }
+    friend wide select(mask m, wide a, wide b) { return {select(m.lo, a.lo, b.lo), select(m.hi, a.hi, b.hi)}; }
+
+    template <int i0, int i1, int i2, int i3> friend wide shuffle(wide a) {
+        return {shuffle<i0, i1, i2, i3>(a.lo), shuffle<i0, i1, i2, i3>(a.hi)};
+    }
+    template <int i0, int i1, int i2, int i3> friend wide shuffle(wide a, wide b) {
+        return {shuffle<i0, i1, i2, i3>(a.lo, b.lo), shuffle<i0, i1, i2, i3>(a.hi, b.hi)};
+    }
+};
+
+// ---------------------------------------------------------------------------------------------
+// f32x4
+
+#if MATH_SIMD_LEVEL >= 1
+struct m32x4 {
+    __m128 v;
+
+    friend m32x4 operator&(m32x4 a, m32x4 b) { return {_mm_and_ps(a.v, b.v)}; }
+    friend m32x4 operator|(m32x4 a, m32x4 b) { return {_mm_or_ps(a.v, b.v)}; }
+    friend m32x4 operator^(m32x4 a, m32x4 b) { return {_mm_xor_ps(a.v, b.v)}; }
+    friend m32x4 operator~(m32x4 a) { return {_mm_xor_ps(a.v, _mm_castsi128_ps(_mm_set1_epi32(-1)))}; }
+    friend unsigned bits(m32x4 a) { return static_cast<unsigned>(_mm_movemask_ps(a.v)); }
+    friend bool any(m32x4 a) { return bits(a) != 0; }
+    friend bool all(m32x4 a) { return bits(a) == 0xF; }
+    friend bool none(m32x4 a) { return bits(a) == 0; }
+};
+
+struct f32x4 {
+    using mask = m32x4;
+    static constexpr std::size_t size = 4;
+
+    __m128 v;
+
+    f32x4() = default;
+    f32x4(__m128 value) : v(value) {}
+    f32x4(float value) : v(_mm_set1_ps(value)) {}
+
+    static f32x4 load(const float *p) { return _mm_load_ps(p); }
+    static f32x4 loadu(const float *p) { return _mm_loadu_ps(p); }
+    static f32x4 gather(const float *base, const std::int32_t *index) {
+        return _mm_setr_ps(base[index[0]], base[index[1]], base[index[2]], base[index[3]]);
+    }
+    void store(float *p) const { _mm_store_ps(p, v); }
+    void storeu(float *p) const { _mm_storeu_ps(p, v); }
+    void stream(float *p) const { _mm_stream_ps(p, v); }
+    float operator[](std::size_t i) const {
+        alignas(16) float lanes[4];
+        store(lanes);
+        return lanes[i];
+    }
+
+    friend f32x4 operator+(f32x4 a, f32x4 b) { return _mm_add_ps(a.v, b.v); }
+    friend f32x4 operator-(f32x4 a, f32x4 b) { return _mm_sub_ps(a.v, b.v); }
+    friend f32x4 operator*(f32x4 a, f32x4 b) { return _mm_mul_ps(a.v, b.v); }
+    friend f32x4 operator/(f32x4 a, f32x4 b) { return _mm_div_ps(a.v, b.v); }
+    friend f32x4 operator-(f32x4 a) { return _mm_xor_ps(a.v, _mm_set1_ps(-0.0f)); }
+    f32x4 &operator+=(f32x4 b) { return *this = *this + b; }
+    f32x4 &operator-=(f32x4 b) { return *this = *this - b; }
+    f32x4 &operator*=(f32x4 b) { return *this = *this * b; }
+    f32x4 &operator/=(f32x4 b) { return *this = *this / b; }
+
+#ifdef __FMA__
+    friend f32x4 fmadd(f32x4 a, f32x4 b, f32x4 c) { return _mm_fmadd_ps(a.v, b.v, c.v); }
+    friend f32x4 fnmadd(f32x4 a, f32x4 b, f32x4 c) { return _mm_fnmadd_ps(a.v, b.v, c.v); }
+#else
+    friend f32x4 fmadd(f32x4 a, f32x4 b, f32x4 c) { return a * b + c; }
+    friend f32x4 fnmadd(f32x4 a, f32x4 b, f32x4 c) { return c - a * b; }
+#endif
+    friend f32x4 min(f32x4 a, f32x4 b) { return _mm_min_ps(a.v, b.v); }
+    friend f32x4 max(f32x4 a, f32x4 b) { return _mm_max_ps(a.v, b.v); }
+    friend f32x4 abs(f32x4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v); }
+    friend f32x4 sqrt(f32x4 a) { return _mm_sqrt_ps(a.v); }
+    friend f32x4 rsqrt(f32x4 a) { return _mm_rsqrt_ps(a.v); }
+    friend f32x4 floor(f32x4 a) { return _mm_floor_ps(a.v); }
+    friend float reduce_add(f32x4 a) {
+        __m128 s = _mm_add_ps(a.v, _mm_movehl_ps(a.v, a.v));
+        return _mm_cvtss_f32(_mm_add_ss(s, _mm_shuffle_ps(s, s, 0x55)));
+    }
+    friend float reduce_min(f32x4 a) {
+        __m128 s = _mm_min_ps(a.v, _mm_movehl_ps(a.v, a.v));
+        return _mm_cvtss_f32(_mm_min_ss(s, _mm_shuffle_ps(s, s, 0x55)));
+    }
+    friend float reduce_max(f32x4 a) {
+        __m128 s = _mm_max_ps(a.v, _mm_movehl_ps(a.v, a.v));
+        return _mm_cvtss_f32(_mm_max_ss(s, _mm_shuffle_ps(s, s, 0x55)));
+    }
+
+    friend m32x4 operator==(f32x4 a, f32x4 b) { return {_mm_cmpeq_ps(a.v, b.v)}; }
+    friend m32x4 operator!=(f32x4 a, f32x4 b) { return {_mm_cmpneq_ps(a.v, b.v)}; }
+    friend m32x4 operator<(f32x4 a, f32x4 b) { return {_mm_cmplt_ps(a.v, b.v)}; }
+    friend m32x4 operator<=(f32x4 a, f32x4 b) { return {_mm_cmple_ps(a.v, b.v)}; }
+    friend m32x4 operator>(f32x4 a, f32x4 b) { return {_mm_cmpgt_ps(a.v, b.v)}; }
+    friend m32x4 operator>=(f32x4 a, f32x4 b) { return {_mm_cmpge_ps(a.v, b.v)}; }
+    friend f32x4 select(m32x4 m, f32x4 a, f32x4 b) { return _mm_blendv_ps(b.v, a.v, m.v); }
+
+    template <int i0, int i1, int i2, int i3> friend f32x4 shuffle(f32x4 a) {
+        return _mm_shuffle_ps(a.v, a.v, (shuffle_imm<i0, i1, i2, i3>));
+    }
+    template <int i0, int i1, int i2, int i3> friend f32x4 shuffle(f32x4 a, f32x4 b) {
+        return _mm_shuffle_ps(a.v, b.v, (shuffle_imm<i0, i1, i2, i3>));
+    }
+};
+#else
+struct m32x4 {
+    unsigned lanes; // bit i = lane i
+
+    friend m32x4 operator&(m32x4 a, m32x4 b) { return {a.lanes & b.lanes}; }
+    friend m32x4 operator|(m32x4 a, m32x4 b) { return {a.lanes | b.lanes}; }
+    friend m32x4 operator^(m32x4 a, m32x4 b) { return {a.lanes ^ b.lanes}; }
+    friend m32x4 operator~(m32x4 a) { return {~a.lanes & 0xFu}; }
+    friend unsigned bits(m32x4 a) { return a.lanes; }
+    friend bool any(m32x4 a) { return a.lanes != 0; }
+    friend bool all(m32x4 a) { return a.lanes == 0xFu; }
+    friend bool none(m32x4 a) { return a.lanes == 0; }
+};
+
+struct f32x4 {
+    using mask = m32x4;
+    static constexpr std::size_t size = 4;
+
+    float v[4];
+
+    f32x4() = default;
+    f32x4(float value) : v{value, value, value, value} {}
+
+    static f32x4 load(const float *p) { return loadu(p); }
+    static f32x4 loadu(const float *p) {
+        f32x4 r;
+        std::memcpy(r.v, p, sizeof(r.v));
+        return r;
+    }
+    static f32x4 gather(const float *base, const std::int32_t *index) {
+        f32x4 r;
+        for (int i = 0; i < 4; ++i) {
+            r.v[i] = base[index[i]];
+        }
+        return r;
+    }
+    void store(float *p) const { storeu(p); }
+    void storeu(float *p) const { std::memcpy(p, v, sizeof(v)); }
+    void stream(float *p) const { storeu(p); }
+    float operator[](std::size_t i) const { return v[i]; }
+
+    template <typename Fn> static f32x4 map(Fn fn) {
+        f32x4 r;
+        for (int i = 0; i < 4; ++i) {
+            r.v[i] = fn(i);
+        }
+        return r;
+    }
+    template <typename Fn> static m32x4 test(Fn fn) {
+        unsigned lanes = 0;
+        for (int i = 0; i < 4; ++i) {
+            lanes |= static_cast<unsigned>(fn(i)) << i;
+        }
+        return {lanes};
+    }
+
+    friend f32x4 operator+(f32x4 a, f32x4 b) { return map([&](int i) { return a.v[i] + b.v[i]; }); }
+    friend f32x4 operator-(f32x4 a, f32x4 b) { return map([&](int i) { return a.v[i] - b.v[i]; }); }
+    friend f32x4 operator*(f32x4 a, f32x4 b) { return map([&](int i) { return a.v[i] * b.v[i]; }); }
+    friend f32x4 operator/(f32x4 a, f32x4 b) { return map([&](int i) { return a.v[i] / b.v[i]; }); }
+    friend f32x4 operator-(f32x4 a) { return map([&](int i) { return -a.v[i]; }); }
+    f32x4 &operator+=(f32x4 b) { return *this = *this + b; }
+    f32x4 &operator-=(f32x4 b) { return *this = *this - b; }
+    f32x4 &operator*=(f32x4 b) { return *this = *this * b; }
+    f32x4 &operator/=(f32x4 b) { return *this = *this / b; }
+
+    friend f32x4 fmadd(f32x4 a, f32x4 b, f32x4 c) { return a * b + c; }
+    friend f32x4 fnmadd(f32x4 a, f32x4 b, f32x4 c) { return c - a * b; }
+    friend f32x4 min(f32x4 a, f32x4 b) { return map([&](int i) { return b.v[i] < a.v[i] ? b.v[i] : a.v[i]; }); }
+    friend f32x4 max(f32x4 a, f32x4 b) { return map([&](int i) { return b.v[i] > a.v[i] ? b.v[i] : a.v[i]; }); }
+    friend f32x4 abs(f32x4 a) { return map([&](int i) { return std::abs(a.v[i]); }); }
+    friend f32x4 sqrt(f32x4 a) { return map([&](int i) { return std::sqrt(a.v[i]); }); }
+    friend f32x4 rsqrt(f32x4 a) { return map([&](int i) { return 1.0f / std::sqrt(a.v[i]); }); }
+    friend f32x4 floor(f32x4 a) { return map([&](int i) { return std::floor(a.v[i]); }); }
+    friend float reduce_add(f32x4 a) { return (a.v[0] + a.v[2]) + (a.v[1] + a.v[3]); }
+    friend float reduce_min(f32x4 a) { return std::min(std::min(a.v[0], a.v[2]), std::min(a.v[1], a.v[3])); }
+    friend float reduce_max(f32x4 a) { return std::max(std::max(a.v[0], a.v[2]), std::max(a.v[1], a.v[3])); }
+
+    friend m32x4 operator==(f32x4 a, f32x4 b) { return test([&](int i) { return a.v[i] == b.v[i]; }); }
+    friend m32x4 operator!=(f32x4 a, f32x4 b) { return test([&](int i) { return a.v[i] != b.v[i]; }); }
+    friend m32x4 operator<(f32x4 a, f32x4 b) { return test([&](int i) { return a.v[i] < b.v[i]; }); }
+    friend m32x4 operator<=(f32x4 a, f32x4 b) { return test([&](int i) { return a.v[i] <= b.v[i]; }); }
+    friend m32x4 operator>(f32x4 a, f32x4 b) { return test([&](int i) { return a.v[i] > b.v[i]; }); }
+    friend m32x4 operator>=(f32x4 a, f32x4 b) { return test([&](int i) { return a.v[i] >= b.v[i]; }); }
+    friend f32x4 select(m32x4 m, f32x4 a, f32x4 b) {
+        return map([&](int i) { return (m.lanes >> i) & 1u ? a.v[i] : b.v[i]; });
+    }
+
+    template <int i0, int i1, int i2, int i3> friend f32x4 shuffle(f32x4 a) {
+        static_cast<void>(shuffle_imm<i0, i1, i2, i3>);
+        f32x4 r;
+        r.v[0] = a.v[i0];
+        r.v[1] = a.v[i1];
+        r.v[2] = a.v[i2];
+        r.v[3] = a.v[i3];
+        return r;
+    }
+    template <int i0, int i1, int i2, int i3> friend f32x4 shuffle(f32x4 a, f32x4 b) {
+        static_cast<void>(shuffle_imm<i0, i1, i2, i3>);
+        f32x4 r;
+        r.v[0] = a.v[i0];
+        r.v[1] = a.v[i1];
+        r.v[2] = b.v[i2];
+        r.v[3] = b.v[i3];
+        return r;
+    }
+};
+#endif
+
+// ---------------------------------------------------------------------------------------------
+// f32x8
+
+#if MATH_SIMD_LEVEL >= 2
+struct m32x8 {
+    __m256 v;
+
+    friend m32x8 operator&(m32x8 a, m32x8 b) { return {_mm256_and_ps(a.v, b.v)}; }
+    friend m32x8 operator|(m32x8 a, m32x8 b) { return {_mm256_or_ps(a.v, b.v)}; }
+    friend m32x8 operator^(m32x8 a, m32x8 b) { return {_mm256_xor_ps(a.v, b.v)}; }
+    friend m32x8 operator~(m32x8 a) { return {_mm256_xor_ps(a.v, _mm256_castsi256_ps(_mm256_set1_epi32(-1)))}; }
+    friend unsigned bits(m32x8 a) { return static_cast<unsigned>(_mm256_movemask_ps(a.v)); }
+    friend bool any(m32x8 a) { return bits(a) != 0; }
+    friend bool all(m32x8 a) { return bits(a) == 0xFF; }
+    friend bool none(m32x8 a) { return bits(a) == 0; }
+};
+
+struct f32x8 {
+    using half_type = f32x4;
+    using mask = m32x8;
+    static constexpr std::size_t size = 8;
+
+    __m256 v;
+
+    f32x8() = default;
+    f32x8(__m256 value) : v(value) {}
+    f32x8(float value) : v(_mm256_set1_ps(value)) {}
+    f32x8(f32x4 low_half, f32x4 high_half)
+        : v(_mm256_insertf128_ps(_mm256_castps128_ps256(low_half.v), high_half.v, 1)) {}
+
+    static f32x8 load(const float *p) { return _mm256_load_ps(p); }
+    static f32x8 loadu(const float *p) { return _mm256_loadu_ps(p); }
+    static f32x8 gather(const float *base, const std::int32_t *index) {
+        return _mm256_i32gather_ps(base, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(index)),
+                                   4);
+    }
+    void store(float *p) const { _mm256_store_ps(p, v); }
+    void storeu(float *p) const { _mm256_storeu_ps(p, v); }
+    void stream(float *p) const { _mm256_stream_ps(p, v); }
+    float operator[](std::size_t i) const {
+        alignas(32) float lanes[8];
+        store(lanes);
+        return lanes[i];
+    }
+    f32x4 low() const { return _mm256_castps256_ps128(v); }
+    f32x4 high() const { return _mm256_extractf128_ps(v, 1); }
+
+    friend f32x8 operator+(f32x8 a, f32x8 b) { return _mm256_add_ps(a.v, b.v); }
+    friend f32x8 operator-(f32x8 a, f32x8 b) { return _mm256_sub_ps(a.v, b.v); }
+    friend f32x8 operator*(f32x8 a, f32x8 b) { return _mm256_mul_ps(a.v, b.v); }
+    friend f32x8 operator/(f32x8 a, f32x8 b) { return _mm256_div_ps(a.v, b.v); }
+    friend f32x8 operator-(f32x8 a) { return _mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f)); }
+    f32x8 &operator+=(f32x8 b) { return *this = *this + b; }
+    f32x8 &operator-=(f32x8 b) { return *this = *this - b; }
+    f32x8 &operator*=(f32x8 b) { return *this = *this * b; }
+    f32x8 &operator/=(f32x8 b) { return *this = *this / b; }
+
+    friend f32x8 fmadd(f32x8 a, f32x8 b, f32x8 c) { return _mm256_fmadd_ps(a.v, b.v, c.v); }
+    friend f32x8 fnmadd(f32x8 a, f32x8 b, f32x8 c) { return _mm256_fnmadd_ps(a.v, b.v, c.v); }
+    friend f32x8 min(f32x8 a, f32x8 b) { return _mm256_min_ps(a.v, b.v); }
+    friend f32x8 max(f32x8 a, f32x8 b) { return _mm256_max_ps(a.v, b.v); }
+    friend f32x8 abs(f32x8 a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v); }
+    friend f32x8 sqrt(f32x8 a) { return _mm256_sqrt_ps(a.v); }
+    friend f32x8 rsqrt(f32x8 a) { return _mm256_rsqrt_ps(a.v); }
+    friend f32x8 floor(f32x8 a) { return _mm256_floor_ps(a.v); }
+    friend float reduce_add(f32x8 a) { return reduce_add(a.low() + a.high()); }
+    friend float reduce_min(f32x8 a) { return reduce_min(min(a.low(), a.high())); }
+    friend float reduce_max(f32x8 a) { return reduce_max(max(a.low(), a.high())); }
+
+    friend m32x8 operator==(f32x8 a, f32x8 b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ)}; }
+    friend m32x8 operator!=(f32x8 a, f32x8 b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_NEQ_UQ)}; }
+    friend m32x8 operator<(f32x8 a, f32x8 b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)}; }
+    friend m32x8 operator<=(f32x8 a, f32x8 b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ)}; }
+    friend m32x8 operator>(f32x8 a, f32x8 b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)}; }
+    friend m32x8 operator>=(f32x8 a, f32x8 b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ)}; }
+    friend f32x8 select(m32x8 m, f32x8 a, f32x8 b) { return _mm256_blendv_ps(b.v, a.v, m.v); }
+
+    template <int i0, int i1, int i2, int i3> friend f32x8 shuffle(f32x8 a) {
+        return _mm256_permute_ps(a.v, (shuffle_imm<i0, i1, i2, i3>));
+    }
+    template <int i0, int i1, int i2, int i3> friend f32x8 shuffle(f32x8 a, f32x8 b) {
+        return _mm256_shuffle_ps(a.v, b.v, (shuffle_imm<i0, i1, i2, i3>));
+    }
+};
+#else
+using m32x8 = wide_mask<f32x4>;
+using f32x8 = wide<f32x4>;
+#endif
+
+// ---------------------------------------------------------------------------------------------
+// f32x16
+
+#if MATH_SIMD_LEVEL >= 3
+struct m32x16 {
+    __mmask16 v;
+
+    friend m32x16 operator&(m32x16 a, m32x16 b) { return {static_cast<__mmask16>(a.v & b.v)}; }
+    friend m32x16 operator|(m32x16 a, m32x16 b) { return {static_cast<__mmask16>(a.v | b.v)}; }
+    friend m32x16 operator^(m32x16 a, m32x16 b) { return {static_cast<__mmask16>(a.v ^ b.v)}; }
+    friend m32x16 operator~(m32x16 a) { return {static_cast<__mmask16>(~a.v)}; }
+    friend unsigned bits(m32x16 a) { return a.v; }
+    friend bool any(m32x16 a) { return a.v != 0; }
+    friend bool all(m32x16 a) { return a.v == 0xFFFF; }
+    friend bool none(m32x16 a) { return a.v == 0; }
+};
+
+struct f32x16 {
+    using half_type = f32x8;
+    using mask = m32x16;
+    static constexpr std::size_t size = 16;
+
+    __m512 v;
+
+    f32x16() = default;
+    f32x16(__m512 value) : v(value) {}
+    f32x16(float value) : v(_mm512_set1_ps(value)) {}
+    f32x16(f32x8 low_half, f32x8 high_half)
+        : v(_mm512_castpd_ps(_mm512_insertf64x4(_mm512_castpd256_pd512(_mm256_castps_pd(low_half.v)),
+                                                _mm256_castps_pd(high_half.v), 1))) {}
+
+    static f32x16 load(const float *p) { return _mm512_load_ps(p); }
+    static f32x16 loadu(const float *p) { return _mm512_loadu_ps(p); }
+    static f32x16 gather(const float *base, const std::int32_t *index) {
+        return _mm512_i32gather_ps(_mm512_loadu_si512(index), base, 4);
+    }
+    void store(float *p) const { _mm512_store_ps(p, v); }
+    void storeu(float *p) const { _mm512_storeu_ps(p, v); }
+    void stream(float *p) const { _mm512_stream_ps(p, v); }
+    float operator[](std::size_t i) const {
+        alignas(64) float lanes[16];
+        store(lanes);
+        return lanes[i];
+    }
+    f32x8 low() const { return _mm512_castps512_ps256(v); }
+    f32x8 high() const { return _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(v), 1)); }
+
+    friend f32x16 operator+(f32x16 a, f32x16 b) { return _mm512_add_ps(a.v, b.v); }
+    friend f32x16 operator-(f32x16 a, f32x16 b) { return _mm512_sub_ps(a.v, b.v); }
+    friend f32x16 operator*(f32x16 a, f32x16 b) { return _mm512_mul_ps(a.v, b.v); }
+    friend f32x16 operator/(f32x16 a, f32x16 b) { return _mm512_div_ps(a.v, b.v); }
+    friend f32x16 operator-(f32x16 a) {
+        return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a.v), _mm512_set1_epi32(INT32_MIN)));
+    }
+    f32x16 &operator+=(f32x16 b) { return *this = *this + b; }
+    f32x16 &operator-=(f32x16 b) { return *this = *this - b; }
+    f32x16 &operator*=(f32x16 b) { return *this = *this * b; }
+    f32x16 &operator/=(f32x16 b) { return *this = *this / b; }
+
+    friend f32x16 fmadd(f32x16 a, f32x16 b, f32x16 c) { return _mm512_fmadd_ps(a.v, b.v, c.v); }
+    friend f32x16 fnmadd(f32x16 a, f32x16 b, f32x16 c) { return _mm512_fnmadd_ps(a.v, b.v, c.v); }
+    friend f32x16 min(f32x16 a, f32x16 b) { return _mm512_min_ps(a.v, b.v); }
+    friend f32x16 max(f32x16 a, f32x16 b) { return _mm512_max_ps(a.v, b.v); }
+    friend f32x16 abs(f32x16 a) { return _mm512_abs_ps(a.v); }
+    friend f32x16 sqrt(f32x16 a) { return _mm512_sqrt_ps(a.v); }
+    friend f32x16 rsqrt(f32x16 a) { return _mm512_rsqrt14_ps(a.v); }
+    friend f32x16 floor(f32x16 a) {
+        return _mm512_roundscale_ps(a.v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+    }
+    friend float reduce_add(f32x16 a) { return reduce_add(a.low() + a.high()); }
+    friend float reduce_min(f32x16 a) { return reduce_min(min(a.low(), a.high())); }
+    friend float reduce_max(f32x16 a) { return reduce_max(max(a.low(), a.high())); }
+
+    friend m32x16 operator==(f32x16 a, f32x16 b) { return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_EQ_OQ)}; }
+    friend m32x16 operator!=(f32x16 a, f32x16 b) { return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_NEQ_UQ)}; }
+    friend m32x16 operator<(f32x16 a, f32x16 b) { return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ)}; }
+    friend m32x16 operator<=(f32x16 a, f32x16 b) { return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_LE_OQ)}; }
+    friend m32x16 operator>(f32x16 a, f32x16 b) { return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_GT_OQ)}; }
+    friend m32x16 operator>=(f32x16 a, f32x16 b) { return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_GE_OQ)}; }
+    friend f32x16 select(m32x16 m, f32x16 a, f32x16 b) { return _mm512_mask_blend_ps(m.v, b.v, a.v); }
+
+    template <int i0, int i1, int i2, int i3> friend f32x16 shuffle(f32x16 a) {
+        return _mm512_permute_ps(a.v, (shuffle_imm<i0, i1, i2, i3>));
+    }
+    template <int i0, int i1, int i2, int i3> friend f32x16 shuffle(f32x16 a, f32x16 b) {
+        return _mm512_shuffle_ps(a.v, b.v, (shuffle_imm<i0, i1, i2, i3>));
+    }
+};
+#else
+using m32x16 = wide_mask<f32x8>;
+using f32x16 = wide<f32x8>;
+#endif
+
+// ---------------------------------------------------------------------------------------------
+// i32x4, i32x8
+
+#if MATH_SIMD_LEVEL >= 1
+struct i32x4 {
+    using mask = m32x4;
+    static constexpr std::size_t size = 4;
+
+    __m128i v;
+
+    i32x4() = default;
+    i32x4(__m128i value) : v(value) {}
+    i32x4(std::int32_t value) : v(_mm_set1_epi32(value)) {}
+
+    static i32x4 loadu(const std::int32_t *p) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    }
+    void storeu(std::int32_t *p) const { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v); }
+
+    friend i32x4 operator+(i32x4 a, i32x4 b) { return _mm_add_epi32(a.v, b.v); }
+    friend i32x4 operator|(i32x4 a, i32x4 b) { return _mm_or_si128(a.v, b.v); }
+    i32x4 &operator+=(i32x4 b) { return *this = *this + b; }
+
+    friend m32x4 operator<(i32x4 a, i32x4 b) { return {_mm_castsi128_ps(_mm_cmplt_epi32(a.v, b.v))}; }
+    friend i32x4 select(m32x4 m, i32x4 a, i32x4 b) {
+        return _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(b.v), _mm_castsi128_ps(a.v), m.v));
+    }
+};
+#else
+struct i32x4 {
+    using mask = m32x4;
+    static constexpr std::size_t size = 4;
+
+    std::int32_t v[4];
+
+    i32x4() = default;
+    i32x4(std::int32_t value) : v{value, value, value, value} {}
+
+    static i32x4 loadu(const std::int32_t *p) {
+        i32x4 r;
+        std::memcpy(r.v, p, sizeof(r.v));
+        return r;
+    }
+    void storeu(std::int32_t *p) const { std::memcpy(p, v, sizeof(v)); }
+
+    friend i32x4 operator+(i32x4 a, i32x4 b) {
+        i32x4 r;
+        for (int i = 0; i < 4; ++i) {
+            r.v[i] = static_cast<std::int32_t>(static_cast<std::uint32_t>(a.v[i]) +
+                                               static_cast<std::uint32_t>(b.v[i]));
+        }
+        return r;
+    }
+    friend i32x4 operator|(i32x4 a, i32x4 b) {
+        i32x4 r;
+        for (int i = 0; i < 4; ++i) {
+            r.v[i] = a.v[i] | b.v[i];
+        }
+        return r;
+    }
+    i32x4 &operator+=(i32x4 b) { return *this = *this + b; }
+
+    friend m32x4 operator<(i32x4 a, i32x4 b) {
+        m32x4 m{0};
+        for (int i = 0; i < 4; ++i) {
+            m.lanes |= static_cast<unsigned>(a.v[i] < b.v[i]) << i;
+        }
+        return m;
+    }
+    friend i32x4 select(m32x4 m, i32x4 a, i32x4 b) {
+        i32x4 r;
+        for (int i = 0; i < 4; ++i) {
+            r.v[i] = (m.lanes >> i) & 1u ? a.v[i] : b.v[i];
+        }
+        return r;
+    }
+};
+#endif
+
+#if MATH_SIMD_LEVEL >= 2
+struct i32x8 {
+    using half_type = i32x4;
+    using mask = m32x8;
+    static constexpr std::size_t size = 8;
+
+    __m256i v;
+
+    i32x8() = default;
+    i32x8(__m256i value) : v(value) {}
+    i32x8(std::int32_t value) : v(_mm256_set1_epi32(value)) {}
+
+    static i32x8 loadu(const std::int32_t *p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+    }
+    void storeu(std::int32_t *p) const { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); }
+
+    friend i32x8 operator+(i32x8 a, i32x8 b) { return _mm256_add_epi32(a.v, b.v); }
+    friend i32x8 operator|(i32x8 a, i32x8 b) { return _mm256_or_si256(a.v, b.v); }
+    i32x8 &operator+=(i32x8 b) { return *this = *this + b; }
+
+    friend m32x8 operator<(i32x8 a, i32x8 b) { return {_mm256_castsi256_ps(_mm256_cmpgt_epi32(b.v, a.v))}; }
+    friend i32x8 select(m32x8 m, i32x8 a, i32x8 b) {
+        return _mm256_castps_si256(
+            _mm256_blendv_ps(_mm256_castsi256_ps(b.v), _mm256_castsi256_ps(a.v), m.v));
+    }
+};
+#else
+struct i32x8 {
+    using half_type = i32x4;
+    using mask = m32x8;
+    static constexpr std::size_t size = 8;
+
+    i32x4 lo, hi;
+
+    i32x8() = default;
+    i32x8(std::int32_t value) : lo(value), hi(value) {}
+    i32x8(i32x4 low_half, i32x4 high_half) : lo(low_half), hi(high_half) {}
+
+    static i32x8 loadu(const std::int32_t *p) { return {i32x4::loadu(p), i32x4::loadu(p + 4)}; }
+    void storeu(std::int32_t *p) const {
+        lo.storeu(p);
+        hi.storeu(p + 4);
+    }
+
+    friend i32x8 operator+(i32x8 a, i32x8 b) { return {a.lo + b.lo, a.hi + b.hi}; }
+    friend i32x8 operator|(i32x8 a, i32x8 b) { return {a.lo | b.lo, a.hi | b.hi}; }
+    i32x8 &operator+=(i32x8 b) { return *this = *this + b; }
+
+    friend m32x8 operator<(i32x8 a, i32x8 b) { return {a.lo < b.lo, a.hi < b.hi}; }
+    friend i32x8 select(m32x8 m, i32x8 a, i32x8 b) {
+        return {select(m.lo, a.lo, b.lo), select(m.hi, a.hi, b.hi)};
+    }
+};
+#endif
+
+// Lane i of every group of four, broadcast across the group.
+template <int i, typename V> V broadcast_lane(V a) { return shuffle<i, i, i, i>(a); }
+
+// In-place 4x4 transpose of rows r0..r3; on wider types every group of four lanes is
+// transposed independently.
+template <typename V> void transpose4(V &r0, V &r1, V &r2, V &r3) {
+    const V t0 = shuffle<0, 1, 0, 1>(r0, r1);
+    const V t1 = shuffle<2, 3, 2, 3>(r0, r1);
+    const V t2 = shuffle<0, 1, 0, 1>(r2, r3);
+    const V t3 = shuffle<2, 3, 2, 3>(r2, r3);
+    r0 = shuffle<0, 2, 0, 2>(t0, t2);
+    r1 = shuffle<1, 3, 1, 3>(t0, t2);
+    r2 = shuffle<0, 2, 0, 2>(t1, t3);
+    r3 = shuffle<1, 3, 1, 3>(t1, t3);
+}
+
+// Makes earlier stream() stores globally visible before any later store.
+inline void stream_fence() {
+#if MATH_SIMD_LEVEL >= 1
+    _mm_sfence();
+#endif
+}
+
+} // namespace math::simd
+
+#endif // SIMD_HPP
@@ -0,0 +1,39 @@
+#ifndef SIMD_VEC3_BLOCK_HPP
+#define SIMD_VEC3_BLOCK_HPP
+
+#include "simd.hpp"
+
+namespace math::simd {
+
+// Eight packed vec3 (24 floats) to x, y, z registers and back. Each half of a register holds
+// four vectors, so both directions are in-group shuffles only:
+//   m03 = x0 y0 z0 x1   m14 = y1 z1 x2 y2   m25 = z2 x3 y3 z3   (per half)
+inline void load_vec3x8(const float *p, f32x8 (&v)[3]) {
+    const f32x8 m03(f32x4::loadu(p), f32x4::loadu(p + 12));
+    const f32x8 m14(f32x4::loadu(p + 4), f32x4::loadu(p + 16));
+    const f32x8 m25(f32x4::loadu(p + 8), f32x4::loadu(p + 20));
+    const f32x8 xy = shuffle<2, 3, 1, 2>(m14, m25); // x2 y2 x3 y3
+    const f32x8 yz = shuffle<1, 2, 0, 1>(m03, m14); // y0 z0 y1 z1
+    v[0] = shuffle<0, 3, 0, 2>(m03, xy);
+    v[1] = shuffle<0, 2, 1, 3>(yz, xy);
+    v[2] = shuffle<1, 3, 0, 3>(yz, m25);
+}
+
+inline void store_vec3x8(float *p, const f32x8 (&v)[3]) {
+    const f32x8 xy = shuffle<0, 2, 0, 2>(v[0], v[1]); // x0 x2 y0 y2
+    const f32x8 yz = shuffle<1, 3, 1, 3>(v[1], v[2]); // y1 y3 z1 z3
+    const f32x8 zx = shuffle<0, 2, 1, 3>(v[2], v[0]); // z0 z2 x1 x3
+    const f32x8 m03 = shuffle<0, 2, 0, 2>(xy, zx);
+    const f32x8 m14 = shuffle<0, 2, 1, 3>(yz, xy);
+    const f32x8 m25 = shuffle<1, 3, 1, 3>(zx, yz);
+    m03.low().storeu(p);
+    m14.low().storeu(p + 4);
+    m25.low().storeu(p + 8);
+    m03.high().storeu(p + 12);
+    m14.high().storeu(p + 16);
+    m25.high().storeu(p + 20);
+}
+
+} // namespace math::simd
+
+#endif // SIMD_VEC3_BLOCK_HPP
@@ -0,0 +1,332 @@
+#include "skinning.hpp"
+
+#include "../parallel/parallel_for.hpp"
+#include "../simd/simd.hpp"
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+static_assert(sizeof(math::vec3) == 3 * sizeof(float), "vec3 arrays are read as packed floats");
+static_assert(sizeof(math::dual_quat) == 8 * sizeof(float), "dual_quat is loaded as 8 floats");
+
+namespace {
+
+using math::simd::f32x4;
+using math::simd::f32x8;
+
+// Bone matrix stored as four padded columns (c0 c1 | c2 c3) so one influence is blended
+// with two eight-lane FMAs and a point is transformed as c0*x + c1*y + c2*z + c3.
+struct bone_columns {
+    alignas(32) float c[4][4];
+};
+
+// Palettes up to this many bones are converted on the stack (16 KB); larger ones use the heap.
+constexpr std::size_t stack_bones = 256;
+
+void to_columns(std::span<const math::mat4x4> palette, bone_columns *bones) {
+    for (std::size_t b = 0; b < palette.size(); ++b) {
+        for (int col = 0; col < 4; ++col) {
+            bones[b].c[col][0] = palette[b].at(0, col);
+            bones[b].c[col][1] = palette[b].at(1, col);
+            bones[b].c[col][2] = palette[b].at(2, col);
+            bones[b].c[col][3] = 0.0f;
+        }
+    }
+}
+
+template <int N>
+void check_sizes(std::span<const math::vec3> positions, std::span<const math::vec3> normals,
+                 std::span<const math::vertex_influence<N>> influences,
+                 std::span<math::vec3> out_positions, std::span<math::vec3> out_normals) {
+    const std::size_t count = positions.size();
+    if (influences.size() < count) [[unlikely]] {
+        throw std::invalid_argument("Fewer vertex influences than positions");
+    }
+    if (out_positions.size() < count) [[unlikely]] {
+        throw std::invalid_argument("Position output is smaller than the input");
+    }
+    if (!normals.empty() && !out_normals.empty() &&
+        (normals.size() < count || out_normals.size() < count)) [[unlikely]] {
+        throw std::invalid_argument("Normals do not cover every position");
+    }
+}
+
+inline void normalize3(float *v) {
+    float len_sq = v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
+    float inv_len = (len_sq < 1e-8f) ? 0.0f : 1.0f / std::sqrt(len_sq);
+    v[0] *= inv_len;
+    v[1] *= inv_len;
+    v[2] *= inv_len;
+}
+
+template <int N>
+void skin_linear_range(const bone_columns *bones, const float *positions, const float *normals,
+                       const math::vertex_influence<N> *influences, float *out_positions,
+                       float *out_normals, std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+        const math::vertex_influence<N> &inf = influences[i];
+        const float *p = positions + 3 * i;
+#if MATH_SIMD_LEVEL >= 1
+        f32x8 c01(0.0f);
+        f32x8 c23(0.0f);
+        for (int k = 0; k < N; ++k) {
+            const f32x8 w(inf.weights[k]);
+            const float *b = bones[inf.bones[k]].c[0];
+            c01 = fmadd(w, f32x8::load(b), c01);
+            c23 = fmadd(w, f32x8::load(b + 8), c23);
+        }
+
+        alignas(16) float result[4];
+        f32x8 acc = fmadd(c23, f32x8(f32x4(p[2]), f32x4(1.0f)), c01 * f32x8(f32x4(p[0]), f32x4(p[1])));
+        (acc.low() + acc.high()).store(result);
+        out_positions[3 * i] = result[0];
+        out_positions[3 * i + 1] = result[1];
+        out_positions[3 * i + 2] = result[2];
+
+        if (normals) {
+            const float *n = normals + 3 * i;
+            acc = fmadd(c23, f32x8(f32x4(n[2]), f32x4(0.0f)), c01 * f32x8(f32x4(n[0]), f32x4(n[1])));
+            const f32x4 v = acc.low() + acc.high();
+            // The fourth lane is zero, so the full sum is the squared length.
+            const f32x4 len_sq(reduce_add(v * v));
+            const f32x4 inv_len = select(len_sq >= 1e-8f, f32x4(1.0f) / sqrt(len_sq), f32x4(0.0f));
+            (v * inv_len).store(result);
+            out_normals[3 * i] = result[0];
+            out_normals[3 * i + 1] = result[1];
+            out_normals[3 * i + 2] = result[2];
+        }
+#else
+        float m[4][3] = {};
+        for (int k = 0; k < N; ++k) {
+            const float w = inf.weights[k];
+            const bone_columns &b = bones[inf.bones[k]];
+            for (int col = 0; col < 4; ++col) {
+                m[col][0] += w * b.c[col][0];
+                m[col][1] += w * b.c[col][1];
+                m[col][2] += w * b.c[col][2];
+            }
+        }
+        for (int r = 0; r < 3; ++r) {
+            out_positions[3 * i + r] = m[0][r] * p[0] + m[1][r] * p[1] + m[2][r] * p[2] + m[3][r];
+        }
+        if (normals) {
+            const float *n = normals + 3 * i;
+            float *o = out_normals + 3 * i;
+            for (int r = 0; r < 3; ++r) {
+                o[r] = m[0][r] * n[0] + m[1][r] * n[1] + m[2][r] * n[2];
+            }
+            normalize3(o);
+        }
+#endif
+    }
+}
+
+template <int N>
+void skin_dual_quaternion_range(const math::dual_quat *palette, const float *positions,
+                                const float *normals, const math::vertex_influence<N> *influences,
+                                float *out_positions, float *out_normals, std::size_t begin,
+                                std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+        const math::vertex_influence<N> &inf = influences[i];
+        const float *pivot = palette[inf.bones[0]].real;
+
+        // Blend in the hemisphere of the first bone so antipodal quaternions do not cancel.
+        alignas(32) float blended[8];
+#if MATH_SIMD_LEVEL >= 1
+        f32x8 acc(0.0f);
+        for (int k = 0; k < N; ++k) {
+            const float *q = palette[inf.bones[k]].real;
+            float d = pivot[0] * q[0] + pivot[1] * q[1] + pivot[2] * q[2] + pivot[3] * q[3];
+            float w = (d < 0.0f) ? -inf.weights[k] : inf.weights[k];
+            acc = fmadd(f32x8(w), f32x8::loadu(q), acc);
+        }
+        acc.store(blended);
+#else
+        for (int c = 0; c < 8; ++c) {
+            blended[c] = 0.0f;
+        }
+        for (int k = 0; k < N; ++k) {
+            const float *q = palette[inf.bones[k]].real;
+            float d = pivot[0] * q[0] + pivot[1] * q[1] + pivot[2] * q[2] + pivot[3] * q[3];
+            float w = (d < 0.0f) ? -inf.weights[k] : inf.weights[k];
+            for (int c = 0; c < 8; ++c) {
+                blended[c] += w * q[c];
+            }
+        }
+#endif
+
+        float len_sq = blended[0] * blended[0] + blended[1] * blended[1] +
+                       blended[2] * blended[2] + blended[3] * blended[3];
+        float inv_len = (len_sq < 1e-8f) ? 0.0f : 1.0f / std::sqrt(len_sq);
+        const float rx = blended[0] * inv_len, ry = blended[1] * inv_len;
+        const float rz = blended[2] * inv_len, rw = blended[3] * inv_len;
+        const float dx = blended[4] * inv_len, dy = blended[5] * inv_len;
+        const float dz = blended[6] * inv_len, dw = blended[7] * inv_len;
+
+        // t = 2 * (dual * conjugate(real)).xyz
+        const float tx = 2.0f * (rw * dx - dw * rx + ry * dz - rz * dy);
+        const float ty = 2.0f * (rw * dy - dw * ry + rz * dx - rx * dz);
+        const float tz = 2.0f * (rw * dz - dw * rz + rx * dy - ry * dx);
+
+        // v' = v + 2 * cross(r, cross(r, v) + w * v)
+        auto rotate = [&](const float *v, float *o) {
+            float cx = ry * v[2] - rz * v[1] + rw * v[0];
+            float cy = rz * v[0] - rx * v[2] + rw * v[1];
+            float cz = rx * v[1] - ry * v[0] + rw * v[2];
+            o[0] = v[0] + 2.0f * (ry * cz - rz * cy);
+            o[1] = v[1] + 2.0f * (rz * cx - rx * cz);
+            o[2] = v[2] + 2.0f * (rx * cy - ry * cx);
+        };
+
+        float *op = out_positions + 3 * i;
+        rotate(positions + 3 * i, op);
+        op[0] += tx;
+        op[1] += ty;
+        op[2] += tz;
+        if (normals) {
+            rotate(normals + 3 * i, out_normals + 3 * i);
+        }
+    }
+}
+
+template <int N>
+void run_linear(std::span<const math::mat4x4> palette, std::span<const math::vec3> positions,
+                std::span<const math::vec3> normals,
+                std::span<const math::vertex_influence<N>> influences,
+                std::span<math::vec3> out_positions, std::span<math::vec3> out_normals,
+                const math::skinning_options &options) {
+    check_sizes<N>(positions, normals, influences, out_positions, out_normals);
+    bone_columns local[stack_bones];
+    std::vector<bone_columns> heap;
+    bone_columns *bones = local;
+    if (palette.size() > stack_bones) [[unlikely]] {
+        heap.resize(palette.size());
+        bones = heap.data();
+    }
+    to_columns(palette, bones);
+    const float *src_p = reinterpret_cast<const float *>(positions.data());
+    const float *src_n = (normals.empty() || out_normals.empty())
+                             ? nullptr
+                             : reinterpret_cast<const float *>(normals.data());
+    float *dst_p = reinterpret_cast<float *>(out_positions.data());
+    float *dst_n = reinterpret_cast<float *>(out_normals.data());
+
+    math::parallel::for_each_chunk(
+        positions.size(), options.chunk_size,
+        [&](std::size_t begin, std::size_t end) {
+            skin_linear_range<N>(bones, src_p, src_n, influences.data(), dst_p, dst_n, begin,
+                                 end);
+        },
+        options.thread_count);
+}
+
+template <int N>
+void run_dual_quaternion(std::span<const math::dual_quat> palette,
+                         std::span<const math::vec3> positions, std::span<const math::vec3> normals,
+                         std::span<const math::vertex_influence<N>> influences,
+                         std::span<math::vec3> out_positions, std::span<math::vec3> out_normals,
+                         const math::skinning_options &options) {
+    check_sizes<N>(positions, normals, influences, out_positions, out_normals);
+    const float *src_p = reinterpret_cast<const float *>(positions.data());
+    const float *src_n = (normals.empty() || out_normals.empty())
+                             ? nullptr
+                             : reinterpret_cast<const float *>(normals.data());
+    float *dst_p = reinterpret_cast<float *>(out_positions.data());
+    float *dst_n = reinterpret_cast<float *>(out_normals.data());
+
+    math::parallel::for_each_chunk(
+        positions.size(), options.chunk_size,
+        [&](std::size_t begin, std::size_t end) {
+            skin_dual_quaternion_range<N>(palette.data(), src_p, src_n, influences.data(), dst_p,
+                                          dst_n, begin, end);
+        },
+        options.thread_count);
+}
+
+} // namespace
+
+namespace math {
+
+dual_quat dual_quat::from_matrix(const mat4x4 &matrix) {
+    const float m00 = matrix.at(0, 0), m01 = matrix.at(0, 1), m02 = matrix.at(0, 2);
+    const float m10 = matrix.at(1, 0), m11 = matrix.at(1, 1), m12 = matrix.at(1, 2);
+    const float m20 = matrix.at(2, 0), m21 = matrix.at(2, 1), m22 = matrix.at(2, 2);
+
+    float x, y, z, w;
+    float trace = m00 + m11 + m22;
+    if (trace > 0.0f) {
+        float s = 0.5f / std::sqrt(trace + 1.0f);
+        w = 0.25f / s;
+        x = (m21 - m12) * s;
+        y = (m02 - m20) * s;
+        z = (m10 - m01) * s;
+    } else if (m00 > m11 && m00 > m22) {
+        float s = 2.0f * std::sqrt(1.0f + m00 - m11 - m22);
+        w = (m21 - m12) / s;
+        x = 0.25f * s;
+        y = (m01 + m10) / s;
+        z = (m02 + m20) / s;
+    } else if (m11 > m22) {
+        float s = 2.0f * std::sqrt(1.0f + m11 - m00 - m22);
+        w = (m02 - m20) / s;
+        x = (m01 + m10) / s;
+        y = 0.25f * s;
+        z = (m12 + m21) / s;
+    } else {
+        float s = 2.0f * std::sqrt(1.0f + m22 - m00 - m11);
+        w = (m10 - m01) / s;
+        x = (m02 + m20) / s;
+        y = (m12 + m21) / s;
+        z = 0.25f * s;
+    }
+
+    // dual = 0.5 * (t, 0) * real
+    const float tx = matrix.at(0, 3), ty = matrix.at(1, 3), tz = matrix.at(2, 3);
+    dual_quat result;
+    result.real[0] = x;
+    result.real[1] = y;
+    result.real[2] = z;
+    result.real[3] = w;
+    result.dual[0] = 0.5f * (w * tx + ty * z - tz * y);
+    result.dual[1] = 0.5f * (w * ty + tz * x - tx * z);
+    result.dual[2] = 0.5f * (w * tz + tx * y - ty * x);
+    result.dual[3] = -0.5f * (tx * x + ty * y + tz * z);
+    return result;
+}
+
+dual_quat dual_quat::identity() { return {{0.0f, 0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 0.0f, 0.0f}}; }
+
+void skin_linear(std::span<const mat4x4> palette, std::span<const vec3> positions,
+                 std::span<const vec3> normals, std::span<const vertex_influence4> influences,
+                 std::span<vec3> out_positions, std::span<vec3> out_normals,
+                 const skinning_options &options) {
+    run_linear<4>(palette, positions, normals, influences, out_positions, out_normals, options);
+}
+
+void skin_linear(std::span<const mat4x4> palette, std::span<const vec3> positions,
+                 std::span<const vec3> normals, std::span<const vertex_influence8> influences,
+                 std::span<vec3> out_positions, std::span<vec3> out_normals,
+                 const skinning_options &options) {
+    run_linear<8>(palette, positions, normals, influences, out_positions, out_normals, options);
+}
+
+void skin_dual_quaternion(std::span<const dual_quat> palette, std::span<const vec3> positions,
+                          std::span<const vec3> normals,
+                          std::span<const vertex_influence4> influences,
+                          std::span<vec3> out_positions, std::span<vec3> out_normals,
+                          const skinning_options &options) {
+    run_dual_quaternion<4>(palette, positions, normals, influences, out_positions, out_normals,
+                           options);
+}
+
+void skin_dual_quaternion(std::span<const dual_quat> palette, std::span<const vec3> positions,
+                          std::span<const vec3> normals,
+                          std::span<const vertex_influence8> influences,
+                          std::span<vec3> out_positions, std::span<vec3> out_normals,
+                          const skinning_options &options) {
+    run_dual_quaternion<8>(palette, positions, normals, influences, out_positions, out_normals,
+                           options);
+}
+
+} // namespace math
@@ -0,0 +1,67 @@
+#ifndef SKINNING_HPP
+#define SKINNING_HPP
+
+#include "../mat4x4/mat4x4.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace math {
+
+// Bone indices and weights of one vertex. Weights are expected to sum to 1; unused slots must
+// hold a valid bone index (0 is fine) with weight 0.
+template <int N> struct vertex_influence {
+    std::uint16_t bones[N];
+    float weights[N];
+};
+
+using vertex_influence4 = vertex_influence<4>;
+using vertex_influence8 = vertex_influence<8>;
+
+// Unit dual quaternion (x, y, z, w order) describing a rigid bone transform.
+struct dual_quat {
+    float real[4];
+    float dual[4];
+
+    // Expects a rigid transform (rotation + translation); scale and shear are discarded.
+    static dual_quat from_matrix(const mat4x4 &matrix);
+    static dual_quat identity();
+};
+
+struct skinning_options {
+    unsigned thread_count = 0; // 0 = hardware concurrency
+    std::size_t chunk_size = 4096;
+};
+
+// Linear-blend skinning. Each output vertex is transformed by the weighted sum of its bone
+// matrices; normals use the upper 3x3 of the blended matrix and are renormalized (exact for
+// rotation + uniform scale palettes). `normals`/`out_normals` may be empty to skip normals.
+// `influences` and `out_positions`, and both normal spans when used, need at least
+// positions.size() entries; otherwise std::invalid_argument is thrown (also for the dual
+// quaternion overloads).
+void skin_linear(std::span<const mat4x4> palette, std::span<const vec3> positions,
+                 std::span<const vec3> normals, std::span<const vertex_influence4> influences,
+                 std::span<vec3> out_positions, std::span<vec3> out_normals,
+                 const skinning_options &options = {});
+void skin_linear(std::span<const mat4x4> palette, std::span<const vec3> positions,
+                 std::span<const vec3> normals, std::span<const vertex_influence8> influences,
+                 std::span<vec3> out_positions, std::span<vec3> out_normals,
+                 const skinning_options &options = {});
+
+// Dual-quaternion skinning: blends rigid transforms without the volume loss (candy-wrapper)
+// of linear blending at twisting joints. Output normals are unit length.
+void skin_dual_quaternion(std::span<const dual_quat> palette, std::span<const vec3> positions,
+                          std::span<const vec3> normals,
+                          std::span<const vertex_influence4> influences,
+                          std::span<vec3> out_positions, std::span<vec3> out_normals,
+                          const skinning_options &options = {});
+void skin_dual_quaternion(std::span<const dual_quat> palette, std::span<const vec3> positions,
+                          std::span<const vec3> normals,
+                          std::span<const vertex_influence8> influences,
+                          std::span<vec3> out_positions, std::span<vec3> out_normals,
+                          const skinning_options &options = {});
+
+} // namespace math
+
+#endif // SKINNING_HPP
@@ -0,0 +1,142 @@
+#ifndef SNAPSHOT_BUFFER_HPP
+#define SNAPSHOT_BUFFER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace math {
+
+// Lock-free publishing of fixed-size arrays (world matrices, positions, ...) from one writer
+// thread to up to max_readers reader threads. There are max_readers + 2 buffers, so with one
+// reader this is a triple buffer. The writer fills a buffer no reader can see and publishes it
+// by swapping an index; readers pin the latest published buffer and read it in place. Nothing
+// is copied, the writer never waits for readers, and a pinned snapshot never changes.
+//
+// Each reader thread holds at most one snapshot at a time; with more than max_readers
+// snapshots alive, write_buffer() spins until one is released.
+template <typename T> class snapshot_buffer {
+    struct alignas(64) slot {
+        std::vector<T> data;
+        std::uint64_t frame = 0;
+        std::atomic<std::uint32_t> pins{0};
+    };
+
+  public:
+    // Read-only view of one published frame. Releases its buffer when destroyed.
+    class snapshot {
+      public:
+        snapshot() = default;
+        snapshot(snapshot &&other) noexcept : m_slot(std::exchange(other.m_slot, nullptr)) {}
+        snapshot &operator=(snapshot &&other) noexcept;
+        ~snapshot() { release(); }
+
+        std::span<const T> data() const { return m_slot->data; }
+        // 0 for the initial, value-initialized contents; then 1, 2, ... per publish().
+        std::uint64_t frame() const { return m_slot->frame; }
+        explicit operator bool() const { return m_slot != nullptr; }
+
+        void release();
+
+      private:
+        friend class snapshot_buffer;
+        explicit snapshot(slot *pinned) : m_slot(pinned) {}
+
+        slot *m_slot = nullptr;
+    };
+
+    snapshot_buffer(std::size_t element_count, unsigned max_readers = 1);
+
+    snapshot_buffer(const snapshot_buffer &) = delete;
+    snapshot_buffer &operator=(const snapshot_buffer &) = delete;
+
+    std::size_t size() const { return m_size; }
+
+    // Writer thread only. A buffer that readers cannot see; it holds an older frame, so the
+    // whole array must be rewritten before publish(). Stable until publish().
+    std::span<T> write_buffer();
+    // Makes the write buffer the latest frame. The next write_buffer() returns another buffer.
+    void publish();
+
+    // Any thread. The latest published frame, pinned until the snapshot is released.
+    snapshot acquire() const;
+
+  private:
+    std::size_t m_size;
+    std::size_t m_slot_count;
+    std::unique_ptr<slot[]> m_slots;
+    std::atomic<std::uint32_t> m_latest{0};
+    // Writer state.
+    std::uint32_t m_writing;
+    std::uint64_t m_frame = 0;
+};
+
+template <typename T>
+typename snapshot_buffer<T>::snapshot &
+snapshot_buffer<T>::snapshot::operator=(snapshot &&other) noexcept {
+    if (this != &other) {
+        release();
+        m_slot = std::exchange(other.m_slot, nullptr);
+    }
+    return *this;
+}
+
+template <typename T> void snapshot_buffer<T>::snapshot::release() {
+    if (m_slot) {
+        m_slot->pins.fetch_sub(1, std::memory_order_release);
+        m_slot = nullptr;
+    }
+}
+
+template <typename T>
+snapshot_buffer<T>::snapshot_buffer(std::size_t element_count, unsigned max_readers)
+    : m_size(element_count), m_slot_count(std::size_t(max_readers) + 2),
+      m_slots(new slot[m_slot_count]), m_writing(static_cast<std::uint32_t>(m_slot_count)) {
+    for (std::size_t s = 0; s < m_slot_count; ++s) {
+        m_slots[s].data.resize(element_count);
+    }
+}
+
+// A slot is free when it is not the latest frame and no reader has it pinned. The pin check
+// and the readers' re-check of m_latest are both sequentially consistent, so a reader that
+// pins a slot the writer is about to take always sees the newer index and backs off.
+template <typename T> std::span<T> snapshot_buffer<T>::write_buffer() {
+    if (m_writing == m_slot_count) {
+        const std::uint32_t latest = m_latest.load(std::memory_order_relaxed);
+        for (std::uint32_t s = 0;; s = (s + 1) % static_cast<std::uint32_t>(m_slot_count)) {
+            if (s != latest && m_slots[s].pins.load(std::memory_order_seq_cst) == 0) {
+                m_writing = s;
+                break;
+            }
+        }
+    }
+    return m_slots[m_writing].data;
+}
+
+template <typename T> void snapshot_buffer<T>::publish() {
+    write_buffer();
+    m_slots[m_writing].frame = ++m_frame;
+    m_latest.store(m_writing, std::memory_order_seq_cst);
+    m_writing = static_cast<std::uint32_t>(m_slot_count);
+}
+
+template <typename T> typename snapshot_buffer<T>::snapshot snapshot_buffer<T>::acquire() const {
+    for (;;) {
+        const std::uint32_t s = m_latest.load(std::memory_order_seq_cst);
+        slot &candidate = m_slots[s];
+        candidate.pins.fetch_add(1, std::memory_order_seq_cst);
+        if (m_latest.load(std::memory_order_seq_cst) == s) [[likely]] {
+            return snapshot(&candidate);
+        }
+        // A newer frame was published meanwhile; the writer may reuse this slot.
+        candidate.pins.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace math
+
+#endif // SNAPSHOT_BUFFER_HPP
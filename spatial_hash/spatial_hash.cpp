@@ -0,0 +1,251 @@
+#include "spatial_hash.hpp"
+
+#include "../parallel/parallel_for.hpp"
+#include "../simd/simd.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+
+static_assert(sizeof(math::vec3) == 3 * sizeof(float), "vec3 arrays are read as packed floats");
+
+namespace {
+
+using math::simd::f32x8;
+
+constexpr std::size_t build_chunk = 16384;
+constexpr std::size_t min_bucket_count = 1024;
+// The sorted position arrays are padded so eight-wide loads never run past the end.
+constexpr std::size_t padding = 8;
+
+inline std::int32_t cell_coordinate(float v, float inv_cell_size) {
+    return static_cast<std::int32_t>(std::floor(v * inv_cell_size));
+}
+
+} // namespace
+
+namespace math {
+
+spatial_hash::spatial_hash(float cell_size)
+    : m_cell_size(cell_size), m_inv_cell_size(1.0f / cell_size),
+      m_bucket_mask(min_bucket_count - 1), m_bucket_start(min_bucket_count + 1, 0) {}
+
+std::uint32_t spatial_hash::row_hash(std::int32_t y, std::int32_t z) {
+    std::uint32_t h = static_cast<std::uint32_t>(y) * 73856093u ^ static_cast<std::uint32_t>(z) * 19349663u;
+    return h ^ (h >> 16);
+}
+
+void spatial_hash::build(std::span<const vec3> points, unsigned thread_count) {
+    const std::size_t count = points.size();
+    const std::size_t bucket_count = std::max(min_bucket_count, std::bit_ceil(2 * count));
+    m_bucket_mask = static_cast<std::uint32_t>(bucket_count - 1);
+    m_bucket_start.assign(bucket_count + 1, 0);
+    m_bucket_of.resize(count);
+    m_index.resize(count);
+    m_x.resize(count + padding);
+    m_y.resize(count + padding);
+    m_z.resize(count + padding);
+
+    const float *p = reinterpret_cast<const float *>(points.data());
+    const float inv = m_inv_cell_size;
+    std::uint32_t *start = m_bucket_start.data();
+
+    // 1. Bucket of every point and bucket sizes.
+    parallel::for_each_chunk(
+        count, build_chunk,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                const std::uint32_t b =
+                    (static_cast<std::uint32_t>(cell_coordinate(p[3 * i], inv)) +
+                     row_hash(cell_coordinate(p[3 * i + 1], inv), cell_coordinate(p[3 * i + 2], inv))) &
+                    m_bucket_mask;
+                m_bucket_of[i] = b;
+                std::atomic_ref<std::uint32_t>(start[b]).fetch_add(1, std::memory_order_relaxed);
+            }
+        },
+        thread_count);
+
+    // 2. Inclusive prefix sum, so start[b] is the end of bucket b: per-chunk totals first,
+    //    then every chunk scans its own range from its offset.
+    const std::size_t scan_chunks = (bucket_count + build_chunk - 1) / build_chunk;
+    std::vector<std::uint32_t> chunk_offset(scan_chunks + 1, 0);
+    parallel::for_each_chunk(
+        bucket_count, build_chunk,
+        [&](std::size_t begin, std::size_t end) {
+            std::uint32_t sum = 0;
+            for (std::size_t b = begin; b < end; ++b) {
+                sum += start[b];
+            }
+            chunk_offset[begin / build_chunk + 1] = sum;
+        },
+        thread_count);
+    for (std::size_t c = 0; c < scan_chunks; ++c) {
+        chunk_offset[c + 1] += chunk_offset[c];
+    }
+    parallel::for_each_chunk(
+        bucket_count, build_chunk,
+        [&](std::size_t begin, std::size_t end) {
+            std::uint32_t sum = chunk_offset[begin / build_chunk];
+            for (std::size_t b = begin; b < end; ++b) {
+                sum += start[b];
+                start[b] = sum;
+            }
+        },
+        thread_count);
+    start[bucket_count] = static_cast<std::uint32_t>(count);
+
+    // 3. Scatter. Decrementing the end pointers leaves start[b] at the beginning of bucket b.
+    //    Slots are written back in input order first; the random stores into m_index happen
+    //    in a separate pass without locked instructions between them.
+    parallel::for_each_chunk(
+        count, build_chunk,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                m_bucket_of[i] = std::atomic_ref<std::uint32_t>(start[m_bucket_of[i]])
+                                     .fetch_sub(1, std::memory_order_relaxed) -
+                                 1;
+            }
+        },
+        thread_count);
+    parallel::for_each_chunk(
+        count, build_chunk,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                m_index[m_bucket_of[i]] = static_cast<std::uint32_t>(i);
+            }
+        },
+        thread_count);
+
+    // 4. Restore input order inside buckets (the scatter order depends on thread timing) and
+    //    copy the positions into their sorted slots.
+    parallel::for_each_chunk(
+        bucket_count, build_chunk,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t b = begin; b < end; ++b) {
+                std::uint32_t *first = m_index.data() + start[b];
+                std::uint32_t *last = m_index.data() + start[b + 1];
+                if (last - first > 1) {
+                    std::sort(first, last);
+                }
+                for (std::uint32_t *it = first; it != last; ++it) {
+                    const std::size_t slot = it - m_index.data();
+                    m_x[slot] = p[3 * *it];
+                    m_y[slot] = p[3 * *it + 1];
+                    m_z[slot] = p[3 * *it + 2];
+                }
+            }
+        },
+        thread_count);
+}
+
+std::size_t spatial_hash::query_radius(const vec3 &center, float radius,
+                                       std::span<std::uint32_t> out) const {
+    const float inv = m_inv_cell_size;
+    const float cx = center.x(), cy = center.y(), cz = center.z();
+    const float r2 = radius * radius;
+    const std::int32_t x0 = cell_coordinate(cx - radius, inv), x1 = cell_coordinate(cx + radius, inv);
+    const std::int32_t y0 = cell_coordinate(cy - radius, inv), y1 = cell_coordinate(cy + radius, inv);
+    const std::int32_t z0 = cell_coordinate(cz - radius, inv), z1 = cell_coordinate(cz + radius, inv);
+
+    std::size_t written = 0;
+    const std::size_t capacity = out.size();
+    const std::uint64_t bucket_count = std::uint64_t(m_bucket_mask) + 1;
+    const std::uint64_t row_length = std::uint64_t(std::int64_t(x1) - x0 + 1);
+    const f32x8 vcx(cx), vcy(cy), vcz(cz);
+    const f32x8 vinv(inv);
+    const f32x8 fx0(static_cast<float>(x0)), fx1(static_cast<float>(x1));
+
+    // Tests the points of buckets [first, last) against the sphere. Points of other cells
+    // hashed into the same buckets are skipped by checking their cell against the row, which
+    // also keeps results free of duplicates.
+    auto scan = [&](std::uint32_t first, std::uint32_t last, std::int32_t y, std::int32_t z) {
+        const std::uint32_t begin = m_bucket_start[first];
+        const std::uint32_t end = m_bucket_start[last];
+        const f32x8 fy(static_cast<float>(y)), fz(static_cast<float>(z));
+        for (std::uint32_t j = begin; j < end; j += 8) {
+            const f32x8 px = f32x8::loadu(&m_x[j]);
+            const f32x8 py = f32x8::loadu(&m_y[j]);
+            const f32x8 pz = f32x8::loadu(&m_z[j]);
+            const f32x8 dx = px - vcx, dy = py - vcy, dz = pz - vcz;
+            const f32x8 d2 = fmadd(dz, dz, fmadd(dy, dy, dx * dx));
+            const f32x8 cell_x = floor(px * vinv);
+            const f32x8::mask hit = (d2 <= r2) & (cell_x >= fx0) & (cell_x <= fx1) &
+                                    (floor(py * vinv) == fy) & (floor(pz * vinv) == fz);
+            unsigned mask = bits(hit);
+            if (end - j < 8) {
+                mask &= (1u << (end - j)) - 1u;
+            }
+            while (mask != 0) {
+                if (written == capacity) [[unlikely]] {
+                    return false;
+                }
+                out[written++] = m_index[j + std::countr_zero(mask)];
+                mask &= mask - 1;
+            }
+        }
+        return true;
+    };
+
+    // Bucket ranges of all rows are collected in batches so the loads of one batch can be
+    // prefetched together instead of waiting for each row in turn.
+    struct row_range {
+        std::uint32_t first, last;
+        std::int32_t y, z;
+    };
+    constexpr int batch_size = 16;
+    row_range batch[batch_size];
+    int batched = 0;
+    auto flush = [&]() {
+        for (int k = 0; k < batched; ++k) {
+            __builtin_prefetch(&m_bucket_start[batch[k].first]);
+            __builtin_prefetch(&m_bucket_start[batch[k].last]);
+        }
+        for (int k = 0; k < batched; ++k) {
+            const std::uint32_t begin = m_bucket_start[batch[k].first];
+            __builtin_prefetch(&m_x[begin]);
+            __builtin_prefetch(&m_y[begin]);
+            __builtin_prefetch(&m_z[begin]);
+            __builtin_prefetch(&m_index[begin]);
+        }
+        for (int k = 0; k < batched; ++k) {
+            if (!scan(batch[k].first, batch[k].last, batch[k].y, batch[k].z)) {
+                return false;
+            }
+        }
+        batched = 0;
+        return true;
+    };
+    auto add = [&](std::uint64_t first, std::uint64_t last, std::int32_t y, std::int32_t z) {
+        batch[batched++] = {static_cast<std::uint32_t>(first), static_cast<std::uint32_t>(last), y, z};
+        return batched < batch_size || flush();
+    };
+
+    for (std::int32_t z = z0; z <= z1; ++z) {
+        for (std::int32_t y = y0; y <= y1; ++y) {
+            bool room = true;
+            if (row_length >= bucket_count) [[unlikely]] {
+                room = add(0, bucket_count, y, z);
+            } else {
+                const std::uint64_t first = (static_cast<std::uint32_t>(x0) + row_hash(y, z)) & m_bucket_mask;
+                const std::uint64_t last = first + row_length;
+                if (last <= bucket_count) {
+                    room = add(first, last, y, z);
+                } else {
+                    room = add(first, bucket_count, y, z) && add(0, last - bucket_count, y, z);
+                }
+            }
+            if (!room) {
+                return written;
+            }
+        }
+    }
+    flush();
+    return written;
+}
+
+std::size_t spatial_hash::point_count() const { return m_index.size(); }
+
+float spatial_hash::cell_size() const { return m_cell_size; }
+
+} // namespace math
@@ -0,0 +1,49 @@
+#ifndef SPATIAL_HASH_HPP
+#define SPATIAL_HASH_HPP
+
+#include "../vec3/vec3.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace math {
+
+// Uniform grid over unbounded space, hashed into a table of buckets. Only the (y, z) row of a
+// cell is hashed and x is added linearly, so cells that are neighbours along x land in
+// neighbouring buckets. build() counting-sorts the points by bucket into a structure-of-arrays
+// copy of the positions, which makes a run of cells along x one contiguous range of points;
+// points within a bucket stay in input order. Rebuilding is meant to happen every frame for
+// moving points.
+class spatial_hash {
+  public:
+    // Queries visit every cell overlapping the query sphere; a cell_size of about twice the
+    // typical radius keeps that at eight cells with enough points each to fill SIMD lanes.
+    explicit spatial_hash(float cell_size);
+
+    // thread_count 0 = hardware concurrency.
+    void build(std::span<const vec3> points, unsigned thread_count = 0);
+
+    // Writes the indices of points with distance <= radius from center into out and returns
+    // how many were written; stops when out is full. Safe to call from several threads.
+    std::size_t query_radius(const vec3 &center, float radius, std::span<std::uint32_t> out) const;
+
+    std::size_t point_count() const;
+    float cell_size() const;
+
+  private:
+    static std::uint32_t row_hash(std::int32_t y, std::int32_t z);
+
+    float m_cell_size;
+    float m_inv_cell_size;
+    std::uint32_t m_bucket_mask;
+    std::vector<std::uint32_t> m_bucket_start; // bucket_count + 1 entries
+    std::vector<std::uint32_t> m_bucket_of;    // per input point: bucket, then sorted slot
+    std::vector<std::uint32_t> m_index;        // sorted position -> input index
+    std::vector<float> m_x, m_y, m_z;          // sorted positions
+};
+
+} // namespace math
+
+#endif // SPATIAL_HASH_HPP
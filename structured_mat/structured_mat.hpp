@@ -0,0 +1,186 @@
+#ifndef STRUCTURED_MAT_HPP
+#define STRUCTURED_MAT_HPP
+
+#include "../mat4x4/mat4x4.hpp"
+
+#include <cmath>
+#include <concepts>
+
+// Sparse stand-ins for the mostly-constant matrices built by mat4x4::translation, scaling,
+// rotation_x/y/z and identity. Each type stores only its free parameters, and its product
+// with a general mat4x4 (on either side) is picked by overload resolution to touch only the
+// rows or columns that change:
+//
+//     mat4x4 model = structured::translation(x, y, z) * rotation * structured::scaling(s, s, s);
+//
+// T * M adds multiples of M's last row to its first three rows (for an affine M only column 3
+// changes); M * T updates column 3 only. Scaling multiplies three rows or columns, an axis
+// rotation mixes two, and identity returns its operand untouched. Use to_mat4x4() where a
+// dense matrix is needed.
+
+namespace math::structured {
+
+struct identity {
+    mat4x4 to_mat4x4() const { return mat4x4::identity(); }
+};
+
+struct translation {
+    float x, y, z;
+
+    translation(float tx, float ty, float tz) : x(tx), y(ty), z(tz) {}
+
+    mat4x4 to_mat4x4() const { return mat4x4::translation(x, y, z); }
+};
+
+struct scaling {
+    float x, y, z;
+
+    scaling(float sx, float sy, float sz) : x(sx), y(sy), z(sz) {}
+
+    mat4x4 to_mat4x4() const { return mat4x4::scaling(x, y, z); }
+};
+
+// Rotation about axis Axis (0 = x, 1 = y, 2 = z), matching mat4x4::rotation_x/y/z.
+template <int Axis> struct axis_rotation {
+    static_assert(Axis >= 0 && Axis < 3, "axis must be 0 (x), 1 (y) or 2 (z)");
+
+    float cos_a, sin_a;
+
+    explicit axis_rotation(float angle_rad) : cos_a(std::cos(angle_rad)), sin_a(std::sin(angle_rad)) {}
+
+    mat4x4 to_mat4x4() const {
+        constexpr int i = (Axis + 1) % 3, j = (Axis + 2) % 3;
+        mat4x4 result = mat4x4::identity();
+        result.at(i, i) = cos_a;
+        result.at(i, j) = -sin_a;
+        result.at(j, i) = sin_a;
+        result.at(j, j) = cos_a;
+        return result;
+    }
+};
+
+using rotation_x = axis_rotation<0>;
+using rotation_y = axis_rotation<1>;
+using rotation_z = axis_rotation<2>;
+
+// identity: a copy of the operand, returned by value like every other product so binding the
+// result of a temporary to a reference cannot dangle.
+inline mat4x4 operator*(identity, const mat4x4 &m) { return m; }
+inline mat4x4 operator*(const mat4x4 &m, identity) { return m; }
+inline identity operator*(identity, identity) { return {}; }
+
+// translation: row i += t_i * row 3 / column 3 += M * t.
+inline mat4x4 operator*(const translation &t, const mat4x4 &m) {
+    mat4x4 result(m);
+    float *r = result.data();
+    const float *last = m.data() + 12;
+    for (int c = 0; c < 4; ++c) {
+        r[c] += t.x * last[c];
+        r[4 + c] += t.y * last[c];
+        r[8 + c] += t.z * last[c];
+    }
+    return result;
+}
+
+inline mat4x4 operator*(const mat4x4 &m, const translation &t) {
+    mat4x4 result(m);
+    float *r = result.data();
+    for (int row = 0; row < 4; ++row) {
+        r[4 * row + 3] += r[4 * row] * t.x + r[4 * row + 1] * t.y + r[4 * row + 2] * t.z;
+    }
+    return result;
+}
+
+inline translation operator*(const translation &a, const translation &b) {
+    return {a.x + b.x, a.y + b.y, a.z + b.z};
+}
+
+// scaling: row i *= s_i / column j *= s_j.
+inline mat4x4 operator*(const scaling &s, const mat4x4 &m) {
+    mat4x4 result(m);
+    float *r = result.data();
+    for (int c = 0; c < 4; ++c) {
+        r[c] *= s.x;
+        r[4 + c] *= s.y;
+        r[8 + c] *= s.z;
+    }
+    return result;
+}
+
+inline mat4x4 operator*(const mat4x4 &m, const scaling &s) {
+    mat4x4 result(m);
+    float *r = result.data();
+    for (int row = 0; row < 4; ++row) {
+        r[4 * row] *= s.x;
+        r[4 * row + 1] *= s.y;
+        r[4 * row + 2] *= s.z;
+    }
+    return result;
+}
+
+inline scaling operator*(const scaling &a, const scaling &b) { return {a.x * b.x, a.y * b.y, a.z * b.z}; }
+
+// Axis rotation: with i, j the two axes it turns, rows i and j (or columns i and j) mix.
+template <int Axis> mat4x4 operator*(const axis_rotation<Axis> &rot, const mat4x4 &m) {
+    constexpr int i = (Axis + 1) % 3, j = (Axis + 2) % 3;
+    mat4x4 result(m);
+    float *r = result.data();
+    const float *src = m.data();
+    for (int c = 0; c < 4; ++c) {
+        r[4 * i + c] = rot.cos_a * src[4 * i + c] - rot.sin_a * src[4 * j + c];
+        r[4 * j + c] = rot.sin_a * src[4 * i + c] + rot.cos_a * src[4 * j + c];
+    }
+    return result;
+}
+
+template <int Axis> mat4x4 operator*(const mat4x4 &m, const axis_rotation<Axis> &rot) {
+    constexpr int i = (Axis + 1) % 3, j = (Axis + 2) % 3;
+    mat4x4 result(m);
+    float *r = result.data();
+    const float *src = m.data();
+    for (int row = 0; row < 4; ++row) {
+        r[4 * row + i] = rot.cos_a * src[4 * row + i] + rot.sin_a * src[4 * row + j];
+        r[4 * row + j] = rot.cos_a * src[4 * row + j] - rot.sin_a * src[4 * row + i];
+    }
+    return result;
+}
+
+template <typename S>
+concept structured_matrix = requires(const S &s) {
+    { s.to_mat4x4() } -> std::same_as<mat4x4>;
+};
+
+// Mixed structured products: the right operand is expanded and the left one applied sparsely.
+template <structured_matrix A, structured_matrix B> mat4x4 operator*(const A &a, const B &b) {
+    return a * b.to_mat4x4();
+}
+
+// Column vectors.
+inline vec4 operator*(const translation &t, const vec4 &v) {
+    return vec4(v.x() + t.x * v.w(), v.y() + t.y * v.w(), v.z() + t.z * v.w(), v.w());
+}
+
+inline vec4 operator*(const scaling &s, const vec4 &v) { return vec4(v.x() * s.x, v.y() * s.y, v.z() * s.z, v.w()); }
+
+template <int Axis> vec4 operator*(const axis_rotation<Axis> &rot, const vec4 &v) {
+    constexpr int i = (Axis + 1) % 3, j = (Axis + 2) % 3;
+    float c[4] = {v.x(), v.y(), v.z(), v.w()};
+    const float ci = c[i], cj = c[j];
+    c[i] = rot.cos_a * ci - rot.sin_a * cj;
+    c[j] = rot.sin_a * ci + rot.cos_a * cj;
+    return vec4(c[0], c[1], c[2], c[3]);
+}
+
+inline vec4 operator*(identity, const vec4 &v) { return v; }
+
+// In-place right multiplication, m = m * s.
+template <typename S>
+    requires structured_matrix<S>
+mat4x4 &operator*=(mat4x4 &m, const S &s) {
+    m = m * s;
+    return m;
+}
+
+} // namespace math::structured
+
+#endif // STRUCTURED_MAT_HPP
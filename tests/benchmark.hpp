@@ -0,0 +1,47 @@
+#ifndef TESTS_BENCHMARK_HPP
+#define TESTS_BENCHMARK_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+
+// Total wall time in milliseconds of repeats calls to fn.
+template <typename Fn>
+double benchmark_ms(int repeats, Fn&& fn)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        fn();
+        // Keeps the compiler from collapsing the identical repetitions into one.
+        asm volatile("" : : : "memory");
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+    return duration.count();
+}
+
+inline void print_rate(const char* name, double shown_ms, double total_ms, size_t count, int repeats, const char* unit)
+{
+    std::cout << name << std::setw(10) << shown_ms << " ms (" << std::setw(8)
+              << (static_cast<double>(count) * repeats / total_ms / 1000.0) << " M " << unit << "/s)" << std::endl;
+}
+
+// Runs fn repeats times, each call processing count items, and prints the total time and the
+// throughput in M units/s.
+template <typename Fn>
+void report(const char* name, size_t count, int repeats, Fn&& fn, const char* unit = "ops")
+{
+    const double total = benchmark_ms(repeats, fn);
+    print_rate(name, total, total, count, repeats, unit);
+}
+
+// As report, but prints the mean time of one call.
+template <typename Fn>
+void report_mean(const char* name, size_t count, int repeats, Fn&& fn, const char* unit = "ops")
+{
+    const double total = benchmark_ms(repeats, fn);
+    print_rate(name, total / repeats, total, count, repeats, unit);
+}
+
+#endif // TESTS_BENCHMARK_HPP
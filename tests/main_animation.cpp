@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "../animation/animation.hpp"
+
+void print_test(const char* name, bool passed)
+{
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << name << std::endl;
+}
+
+bool approx_equal(float a, float b, float epsilon = 0.0001f)
+{
+    return std::abs(a - b) < epsilon;
+}
+
+bool vec_approx_equal(const math::vec3& a, const math::vec3& b, float epsilon = 0.0001f)
+{
+    return approx_equal(a.x(), b.x(), epsilon) && approx_equal(a.y(), b.y(), epsilon) && approx_equal(a.z(), b.z(), epsilon);
+}
+
+void axis_angle(float ax, float ay, float az, float angle, float (&q)[4])
+{
+    float s = std::sin(angle * 0.5f) / std::sqrt(ax * ax + ay * ay + az * az);
+    q[0] = ax * s;
+    q[1] = ay * s;
+    q[2] = az * s;
+    q[3] = std::cos(angle * 0.5f);
+}
+
+void exact_slerp(const float* a, const float* b, float t, float* out)
+{
+    double d = double(a[0]) * b[0] + double(a[1]) * b[1] + double(a[2]) * b[2] + double(a[3]) * b[3];
+    double sign = d < 0.0 ? -1.0 : 1.0;
+    d = std::min(std::abs(d), 1.0);
+    double theta = std::acos(d);
+    double wa = 1.0 - t, wb = t;
+    if (theta > 1e-9) {
+        wa = std::sin((1.0 - t) * theta) / std::sin(theta);
+        wb = std::sin(t * theta) / std::sin(theta);
+    }
+    for (int c = 0; c < 4; ++c) {
+        out[c] = static_cast<float>(wa * a[c] + wb * sign * b[c]);
+    }
+}
+
+float quat_angle(const float* a, const float* b)
+{
+    // Measured through the chord length, acos of a float dot product is too coarse near 1.
+    double sum = 0.0, diff = 0.0;
+    for (int c = 0; c < 4; ++c) {
+        sum += (double(a[c]) + b[c]) * (double(a[c]) + b[c]);
+        diff += (double(a[c]) - b[c]) * (double(a[c]) - b[c]);
+    }
+    double chord = std::sqrt(std::min(sum, diff));
+    return static_cast<float>(4.0 * std::asin(std::min(chord * 0.5, 1.0)));
+}
+
+std::vector<std::vector<math::transform_key>> make_tracks(size_t track_count, int key_count, float key_spacing)
+{
+    std::vector<std::vector<math::transform_key>> tracks(track_count);
+    for (size_t j = 0; j < track_count; ++j) {
+        for (int k = 0; k < key_count; ++k) {
+            math::transform_key key;
+            key.time = k * key_spacing;
+            key.translation = math::vec3(0.1f * k, static_cast<float>(j), -0.05f * k * j);
+            axis_angle(1.0f, 0.3f * j, 0.2f, 0.4f * k + 0.1f * j, key.rotation);
+            if (k % 3 == 2) {
+                for (float& c : key.rotation) {
+                    c = -c;
+                }
+            }
+            key.scale = math::vec3(1.0f + 0.01f * k, 1.0f, 1.0f);
+            tracks[j].push_back(key);
+        }
+    }
+    return tracks;
+}
+
+void run_tests()
+{
+    std::cout << "=== TESTING animation ===" << std::endl
+              << std::endl;
+
+    auto tracks = make_tracks(13, 10, 0.25f);
+    math::animation_clip clip(tracks);
+    math::animation_sampler sampler(clip);
+    std::vector<math::local_transform> out(clip.track_count());
+
+    print_test("duration", approx_equal(clip.duration(), 2.25f));
+
+    sampler.sample(0.5f, out);
+    bool keys_ok = true;
+    for (size_t j = 0; j < tracks.size(); ++j) {
+        keys_ok = keys_ok && vec_approx_equal(out[j].translation, tracks[j][2].translation);
+        keys_ok = keys_ok && quat_angle(out[j].rotation, tracks[j][2].rotation) < 1e-3f;
+    }
+    print_test("sampling on a key returns the key", keys_ok);
+
+    float worst_angle = 0.0f;
+    bool lerp_ok = true;
+    for (float time = 0.0f; time <= 2.25f; time += 0.01f) {
+        sampler.sample(time, out);
+        for (size_t j = 0; j < tracks.size(); ++j) {
+            int k = std::min(static_cast<int>(time / 0.25f), 8);
+            float alpha = std::clamp((time - tracks[j][k].time) / 0.25f, 0.0f, 1.0f);
+            float expected[4];
+            exact_slerp(tracks[j][k].rotation, tracks[j][k + 1].rotation, alpha, expected);
+            worst_angle = std::max(worst_angle, quat_angle(out[j].rotation, expected));
+            lerp_ok = lerp_ok && vec_approx_equal(out[j].translation, math::vec3::lerp(tracks[j][k].translation, tracks[j][k + 1].translation, alpha), 0.001f);
+        }
+    }
+    print_test("translation lerp", lerp_ok);
+    std::cout << "  max slerp error: " << worst_angle << " rad" << std::endl;
+    print_test("rotation within slerp error bound", worst_angle < 1e-3f);
+
+    sampler.sample(0.3f, out);
+    math::animation_sampler fresh(clip);
+    std::vector<math::local_transform> expected(clip.track_count());
+    fresh.sample(0.3f, expected);
+    print_test("jumping backwards", vec_approx_equal(out[12].translation, expected[12].translation));
+
+    sampler.sample(-1.0f, out);
+    print_test("clamps before first key", vec_approx_equal(out[3].translation, tracks[3][0].translation));
+    sampler.sample(100.0f, out);
+    print_test("clamps after last key", vec_approx_equal(out[3].translation, tracks[3][9].translation));
+
+    std::cout << std::endl;
+}
+
+void run_speed_tests(size_t skeletons, size_t joints, int frames)
+{
+    std::cout << "=== SPEED TESTS (" << skeletons << " skeletons x " << joints << " joints x " << frames << " frames) ===" << std::endl
+              << std::endl;
+
+    auto tracks = make_tracks(joints, 60, 1.0f / 30.0f);
+    math::animation_clip clip(tracks);
+    std::vector<math::animation_sampler> samplers(skeletons, math::animation_sampler(clip));
+    std::vector<math::local_transform> out(skeletons * joints);
+    const double total = static_cast<double>(skeletons) * joints * frames;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int f = 0; f < frames; ++f) {
+        for (size_t s = 0; s < skeletons; ++s) {
+            float time = std::fmod(f / 60.0f + 0.001f * s, clip.duration());
+            for (size_t j = 0; j < joints; ++j) {
+                const auto& keys = tracks[j];
+                auto it = std::upper_bound(keys.begin(), keys.end(), time, [](float t, const math::transform_key& k) { return t < k.time; });
+                size_t k = std::min<size_t>(std::max<ptrdiff_t>(it - keys.begin() - 1, 0), keys.size() - 2);
+                float alpha = std::clamp((time - keys[k].time) / (keys[k + 1].time - keys[k].time), 0.0f, 1.0f);
+                math::local_transform& dst = out[s * joints + j];
+                dst.translation = math::vec3::lerp(keys[k].translation, keys[k + 1].translation, alpha);
+                exact_slerp(keys[k].rotation, keys[k + 1].rotation, alpha, dst.rotation);
+                dst.scale = math::vec3::lerp(keys[k].scale, keys[k + 1].scale, alpha);
+            }
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+    std::cout << "Binary search + slerp:" << std::setw(10) << duration.count() << " ms ("
+              << std::setw(8) << (total / duration.count() / 1000.0) << " M samples/s)" << std::endl;
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int f = 0; f < frames; ++f) {
+        for (size_t s = 0; s < skeletons; ++s) {
+            float time = std::fmod(f / 60.0f + 0.001f * s, clip.duration());
+            samplers[s].sample(time, std::span(out).subspan(s * joints, joints));
+        }
+    }
+    end = std::chrono::high_resolution_clock::now();
+    duration = end - start;
+    std::cout << "animation_sampler:    " << std::setw(10) << duration.count() << " ms ("
+              << std::setw(8) << (total / duration.count() / 1000.0) << " M samples/s)" << std::endl;
+    std::cout << "Per 60 Hz frame:      " << std::setw(10) << duration.count() / frames << " ms" << std::endl;
+
+    std::cout << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    size_t skeletons = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000;
+    size_t joints = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100;
+    int frames = argc > 3 ? std::atoi(argv[3]) : 60;
+    run_tests();
+    run_speed_tests(skeletons, joints, frames);
+    return 0;
+}
@@ -0,0 +1,250 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "../aos_soa/aos_soa.hpp"
+#include "../simd/simd.hpp"
+
+void print_test(const char* name, bool passed)
+{
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << name << std::endl;
+}
+
+bool approx_equal(float a, float b, float epsilon = 0.0001f)
+{
+    return std::abs(a - b) < epsilon;
+}
+
+bool same(const math::vec3& a, const math::vec3& b)
+{
+    return approx_equal(a.x(), b.x()) && approx_equal(a.y(), b.y()) && approx_equal(a.z(), b.z());
+}
+
+bool same(const math::vec4& a, const math::vec4& b)
+{
+    return approx_equal(a.x(), b.x()) && approx_equal(a.y(), b.y()) && approx_equal(a.z(), b.z()) && approx_equal(a.w(), b.w());
+}
+
+struct soa3 {
+    std::vector<float> x, y, z;
+    explicit soa3(size_t n) : x(n), y(n), z(n) {}
+    math::vec3_soa view() { return { x, y, z }; }
+    math::vec3 at(size_t i) const { return math::vec3(x[i], y[i], z[i]); }
+};
+
+struct soa4 {
+    std::vector<float> x, y, z, w;
+    explicit soa4(size_t n) : x(n), y(n), z(n), w(n) {}
+    math::vec4_soa view() { return { x, y, z, w }; }
+    math::vec4 at(size_t i) const { return math::vec4(x[i], y[i], z[i], w[i]); }
+};
+
+void fill(std::vector<math::vec3>& v, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    for (auto& p : v) {
+        p = math::vec3(unit(rng), unit(rng), unit(rng));
+    }
+}
+
+void fill(std::vector<math::vec4>& v, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    for (auto& p : v) {
+        p = math::vec4(unit(rng), unit(rng), unit(rng), unit(rng));
+    }
+}
+
+math::mat4x4 test_matrix()
+{
+    return math::mat4x4::translation(1.0f, -2.0f, 0.5f) * math::mat4x4::rotation_y(0.7f) * math::mat4x4::scaling(2.0f, 1.0f, 0.5f);
+}
+
+void run_tests()
+{
+    std::cout << "=== TESTING aos_soa (simd backend: " << math::simd::backend_name << ") ===" << std::endl
+              << std::endl;
+
+    std::mt19937 rng(43);
+    const math::mat4x4 m = test_matrix();
+
+    // Sizes around the block of eight, so full blocks and every tail length are covered.
+    bool dot3_ok = true, cross3_ok = true, norm3_ok = true, dist3_ok = true, xform3_ok = true;
+    bool dot4_ok = true, norm4_ok = true, dist4_ok = true, xform4_ok = true;
+    bool soa_ok = true, round_trip_ok = true, alias_ok = true;
+    for (size_t n : { 0, 1, 7, 8, 9, 19, 24, 37 }) {
+        std::vector<math::vec3> a3(n), b3(n), o3(n);
+        std::vector<math::vec4> a4(n), b4(n), o4(n);
+        std::vector<float> s(n);
+        fill(a3, rng);
+        fill(b3, rng);
+        fill(a4, rng);
+        fill(b4, rng);
+        if (n > 3) {
+            a3[3] = math::vec3(0.0f, 0.0f, 0.0f);
+            a4[3] = math::vec4(0.0f, 0.0f, 0.0f, 0.0f);
+        }
+
+        math::dot_production(a3, b3, s);
+        for (size_t i = 0; i < n; ++i) dot3_ok &= approx_equal(s[i], a3[i].dot_production(b3[i]));
+        math::distance(a3, b3, s);
+        for (size_t i = 0; i < n; ++i) dist3_ok &= approx_equal(s[i], a3[i].distance_to(b3[i]));
+        math::cross_production(a3, b3, o3);
+        for (size_t i = 0; i < n; ++i) cross3_ok &= same(o3[i], a3[i].cross_production(b3[i]));
+        math::normalize(a3, o3);
+        for (size_t i = 0; i < n; ++i) norm3_ok &= same(o3[i], a3[i].normalized());
+        math::transform_points(m, a3, o3);
+        for (size_t i = 0; i < n; ++i) {
+            math::vec4 r = m * math::vec4(a3[i].x(), a3[i].y(), a3[i].z(), 1.0f);
+            xform3_ok &= same(o3[i], math::vec3(r.x(), r.y(), r.z()));
+        }
+
+        math::dot_production(a4, b4, s);
+        for (size_t i = 0; i < n; ++i) dot4_ok &= approx_equal(s[i], a4[i].dot_production(b4[i]));
+        math::distance(a4, b4, s);
+        for (size_t i = 0; i < n; ++i) dist4_ok &= approx_equal(s[i], a4[i].distance_to(b4[i]));
+        math::normalize(a4, o4);
+        for (size_t i = 0; i < n; ++i) norm4_ok &= same(o4[i], a4[i].normalized());
+        math::transform_points(m, a4, o4);
+        for (size_t i = 0; i < n; ++i) xform4_ok &= same(o4[i], m * a4[i]);
+
+        // SoA outputs match the AoS ones.
+        soa3 c3(n);
+        soa4 c4(n);
+        math::cross_production(a3, b3, c3.view());
+        for (size_t i = 0; i < n; ++i) soa_ok &= same(c3.at(i), a3[i].cross_production(b3[i]));
+        math::normalize(a3, c3.view());
+        for (size_t i = 0; i < n; ++i) soa_ok &= same(c3.at(i), a3[i].normalized());
+        math::transform_points(m, a3, c3.view());
+        math::transform_points(m, a3, o3);
+        for (size_t i = 0; i < n; ++i) soa_ok &= same(c3.at(i), o3[i]);
+        math::normalize(a4, c4.view());
+        for (size_t i = 0; i < n; ++i) soa_ok &= same(c4.at(i), a4[i].normalized());
+        math::transform_points(m, a4, c4.view());
+        for (size_t i = 0; i < n; ++i) soa_ok &= same(c4.at(i), m * a4[i]);
+
+        // to_soa / from_soa are exact.
+        math::to_soa(a3, c3.view());
+        math::from_soa(c3.x, c3.y, c3.z, o3);
+        for (size_t i = 0; i < n; ++i) {
+            round_trip_ok &= c3.x[i] == a3[i].x() && c3.y[i] == a3[i].y() && c3.z[i] == a3[i].z();
+            round_trip_ok &= o3[i].x() == a3[i].x() && o3[i].y() == a3[i].y() && o3[i].z() == a3[i].z();
+        }
+        math::to_soa(a4, c4.view());
+        math::from_soa(c4.x, c4.y, c4.z, c4.w, o4);
+        for (size_t i = 0; i < n; ++i) {
+            round_trip_ok &= c4.w[i] == a4[i].w();
+            round_trip_ok &= o4[i].x() == a4[i].x() && o4[i].y() == a4[i].y() && o4[i].z() == a4[i].z() && o4[i].w() == a4[i].w();
+        }
+
+        // In place: the output is the input.
+        std::vector<math::vec3> in_place3 = a3;
+        math::transform_points(m, in_place3, in_place3);
+        math::transform_points(m, a3, o3);
+        for (size_t i = 0; i < n; ++i) alias_ok &= same(in_place3[i], o3[i]);
+        std::vector<math::vec4> in_place4 = a4;
+        math::normalize(in_place4, in_place4);
+        for (size_t i = 0; i < n; ++i) alias_ok &= same(in_place4[i], a4[i].normalized());
+    }
+    print_test("vec3 dot_production", dot3_ok);
+    print_test("vec3 cross_production", cross3_ok);
+    print_test("vec3 normalize (zero vector stays zero)", norm3_ok);
+    print_test("vec3 distance", dist3_ok);
+    print_test("vec3 transform_points (affine, w = 1)", xform3_ok);
+    print_test("vec4 dot_production", dot4_ok);
+    print_test("vec4 normalize (zero vector stays zero)", norm4_ok);
+    print_test("vec4 distance", dist4_ok);
+    print_test("vec4 transform_points", xform4_ok);
+    print_test("SoA outputs match AoS results", soa_ok);
+    print_test("to_soa / from_soa round trip", round_trip_ok);
+    print_test("outputs may alias inputs", alias_ok);
+
+    std::cout << std::endl;
+}
+
+// Reference for data that is already SoA: plain eight-wide loops over component arrays.
+void soa_transform(const math::mat4x4& m, const soa3& in, soa3& out)
+{
+    using math::simd::f32x8;
+    const float* e = m.data();
+    const size_t n = in.x.size();
+    for (size_t i = 0; i + 8 <= n; i += 8) {
+        const f32x8 x = f32x8::loadu(&in.x[i]), y = f32x8::loadu(&in.y[i]), z = f32x8::loadu(&in.z[i]);
+        fmadd(f32x8(e[0]), x, fmadd(f32x8(e[1]), y, fmadd(f32x8(e[2]), z, f32x8(e[3])))).storeu(&out.x[i]);
+        fmadd(f32x8(e[4]), x, fmadd(f32x8(e[5]), y, fmadd(f32x8(e[6]), z, f32x8(e[7])))).storeu(&out.y[i]);
+        fmadd(f32x8(e[8]), x, fmadd(f32x8(e[9]), y, fmadd(f32x8(e[10]), z, f32x8(e[11])))).storeu(&out.z[i]);
+    }
+}
+
+void soa_normalize(const soa3& in, soa3& out)
+{
+    using math::simd::f32x8;
+    const size_t n = in.x.size();
+    for (size_t i = 0; i + 8 <= n; i += 8) {
+        const f32x8 x = f32x8::loadu(&in.x[i]), y = f32x8::loadu(&in.y[i]), z = f32x8::loadu(&in.z[i]);
+        const f32x8 len_sq = fmadd(x, x, fmadd(y, y, z * z));
+        const f32x8 inv = f32x8(1.0f) / sqrt(len_sq);
+        const auto degenerate = len_sq < f32x8(1e-8f);
+        select(degenerate, f32x8(0.0f), x * inv).storeu(&out.x[i]);
+        select(degenerate, f32x8(0.0f), y * inv).storeu(&out.y[i]);
+        select(degenerate, f32x8(0.0f), z * inv).storeu(&out.z[i]);
+    }
+}
+
+void run_speed_tests(size_t count, int repeats)
+{
+    std::cout << "=== SPEED TESTS (" << count << " vectors x " << repeats << ", simd backend: " << math::simd::backend_name << ") ===" << std::endl
+              << std::endl;
+
+    std::mt19937 rng(7);
+    std::vector<math::vec3> a3(count), b3(count), o3(count);
+    std::vector<math::vec4> a4(count), o4(count);
+    std::vector<float> s(count);
+    fill(a3, rng);
+    fill(b3, rng);
+    fill(a4, rng);
+    soa3 sa(count), sb(count), so(count);
+    math::to_soa(a3, sa.view());
+    math::to_soa(b3, sb.view());
+    const math::mat4x4 m = test_matrix();
+
+    report("vec3 dot, per element:        ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) s[i] = a3[i].dot_production(b3[i]); });
+    report("vec3 dot, AoS batch:          ", count, repeats, [&] { math::dot_production(a3, b3, s); });
+    report("vec3 cross, per element:      ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) o3[i] = a3[i].cross_production(b3[i]); });
+    report("vec3 cross, AoS batch:        ", count, repeats, [&] { math::cross_production(a3, b3, o3); });
+    report("vec3 distance, per element:   ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) s[i] = a3[i].distance_to(b3[i]); });
+    report("vec3 distance, AoS batch:     ", count, repeats, [&] { math::distance(a3, b3, s); });
+    report("vec3 normalize, per element:  ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) o3[i] = a3[i].normalized(); });
+    report("vec3 normalize, AoS batch:    ", count, repeats, [&] { math::normalize(a3, o3); });
+    report("vec3 normalize, AoS -> SoA:   ", count, repeats, [&] { math::normalize(a3, so.view()); });
+    report("vec3 normalize, SoA -> SoA:   ", count, repeats, [&] { soa_normalize(sa, so); });
+    report("vec3 transform, per element:  ", count, repeats, [&] {
+        for (size_t i = 0; i < count; ++i) {
+            math::vec4 r = m * math::vec4(a3[i].x(), a3[i].y(), a3[i].z(), 1.0f);
+            o3[i] = math::vec3(r.x(), r.y(), r.z());
+        }
+    });
+    report("vec3 transform, AoS batch:    ", count, repeats, [&] { math::transform_points(m, a3, o3); });
+    report("vec3 transform, AoS -> SoA:   ", count, repeats, [&] { math::transform_points(m, a3, so.view()); });
+    report("vec3 transform, SoA -> SoA:   ", count, repeats, [&] { soa_transform(m, sa, so); });
+    report("vec3 to_soa:                  ", count, repeats, [&] { math::to_soa(a3, sa.view()); });
+    report("vec3 from_soa:                ", count, repeats, [&] { math::from_soa(sa.x, sa.y, sa.z, o3); });
+    report("vec4 transform, per element:  ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) o4[i] = m * a4[i]; });
+    report("vec4 transform, AoS batch:    ", count, repeats, [&] { math::transform_points(m, a4, o4); });
+    report("vec4 normalize, per element:  ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) o4[i] = a4[i].normalized(); });
+    report("vec4 normalize, AoS batch:    ", count, repeats, [&] { math::normalize(a4, o4); });
+
+    std::cout << "(checksum " << s[0] + o3[0].x() + o4[0].x() + so.x[0] << ")" << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 20;
+    int repeats = argc > 2 ? std::atoi(argv[2]) : 20;
+    run_tests();
+    run_speed_tests(count, repeats);
+    return 0;
+}
@@ -0,0 +1,250 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "../bounding_volumes/bounding_volumes.hpp"
+#include "../parallel/parallel_for.hpp"
+#include "../simd/simd.hpp"
+
+void print_test(const char* name, bool passed)
+{
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << name << std::endl;
+}
+
+bool approx_equal(float a, float b, float epsilon = 0.0001f)
+{
+    return std::abs(a - b) < epsilon;
+}
+
+bool same(const math::vec3& a, const math::vec3& b, float epsilon = 0.0001f)
+{
+    return approx_equal(a.x(), b.x(), epsilon) && approx_equal(a.y(), b.y(), epsilon) && approx_equal(a.z(), b.z(), epsilon);
+}
+
+bool same(const math::aabb& a, const math::aabb& b, float epsilon = 0.0001f)
+{
+    return same(a.min, b.min, epsilon) && same(a.max, b.max, epsilon);
+}
+
+bool identical(const math::aabb& a, const math::aabb& b)
+{
+    return std::memcmp(&a, &b, sizeof(math::aabb)) == 0;
+}
+
+bool same(const math::bounding_sphere& a, const math::bounding_sphere& b)
+{
+    return same(a.center, b.center) && approx_equal(a.radius, b.radius);
+}
+
+math::aabb naive_aabb(const math::vec3* p, size_t n)
+{
+    math::aabb box { p[0], p[0] };
+    for (size_t i = 1; i < n; ++i) {
+        box.min = math::vec3(std::min(box.min.x(), p[i].x()), std::min(box.min.y(), p[i].y()), std::min(box.min.z(), p[i].z()));
+        box.max = math::vec3(std::max(box.max.x(), p[i].x()), std::max(box.max.y(), p[i].y()), std::max(box.max.z(), p[i].z()));
+    }
+    return box;
+}
+
+// Box of the eight transformed corners.
+math::aabb naive_transform(const math::mat4x4& m, const math::aabb& box)
+{
+    math::vec4 c = m * math::vec4(box.min.x(), box.min.y(), box.min.z(), 1.0f);
+    math::aabb out { math::vec3(c.x(), c.y(), c.z()), math::vec3(c.x(), c.y(), c.z()) };
+    for (int k = 1; k < 8; ++k) {
+        math::vec4 corner((k & 1 ? box.max : box.min).x(), (k & 2 ? box.max : box.min).y(), (k & 4 ? box.max : box.min).z(), 1.0f);
+        c = m * corner;
+        out.min = math::vec3(std::min(out.min.x(), c.x()), std::min(out.min.y(), c.y()), std::min(out.min.z(), c.z()));
+        out.max = math::vec3(std::max(out.max.x(), c.x()), std::max(out.max.y(), c.y()), std::max(out.max.z(), c.z()));
+    }
+    return out;
+}
+
+bool contains_all(const math::bounding_sphere& s, const math::vec3* p, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        if (p[i].distance_to(s.center) > s.radius * (1.0f + 1e-5f) + 1e-6f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Meshlet-like clusters: points scattered around a random center with a random per-axis spread.
+void make_clusters(std::mt19937& rng, size_t clusters, const std::vector<size_t>& sizes, std::vector<math::vec3>& points, std::vector<std::uint32_t>& offsets)
+{
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f), spread(0.1f, 2.0f);
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+    offsets.assign(1, 0);
+    for (size_t c = 0; c < clusters; ++c) {
+        const math::vec3 center(position(rng), position(rng), position(rng));
+        const float sx = spread(rng), sy = spread(rng), sz = spread(rng);
+        for (size_t i = 0; i < sizes[c % sizes.size()]; ++i) {
+            points.push_back(center + math::vec3(sx * normal(rng), sy * normal(rng), sz * normal(rng)));
+        }
+        offsets.push_back(static_cast<std::uint32_t>(points.size()));
+    }
+}
+
+math::mat4x4 random_affine(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    return math::mat4x4::translation(5 * unit(rng), 5 * unit(rng), 5 * unit(rng)) * math::mat4x4::rotation_x(3 * unit(rng)) * math::mat4x4::rotation_y(3 * unit(rng)) * math::mat4x4::scaling(1.5f + unit(rng), 1.5f + unit(rng), 1.5f + unit(rng));
+}
+
+void run_tests()
+{
+    std::cout << "=== TESTING bounding volumes (simd backend: " << math::simd::backend_name << ") ===" << std::endl
+              << std::endl;
+
+    std::mt19937 rng(48);
+    std::vector<math::vec3> points;
+    std::vector<std::uint32_t> offsets;
+    make_clusters(rng, 64, { 1, 2, 7, 8, 9, 64, 125, 1000 }, points, offsets);
+    const size_t clusters = offsets.size() - 1;
+
+    std::cout << "--- single sets ---" << std::endl;
+    bool aabb_ok = true, ritter_ok = true, epos_ok = true, epos_tighter = true, lower_bound = true;
+    for (size_t c = 0; c < clusters; ++c) {
+        const math::vec3* p = points.data() + offsets[c];
+        const size_t n = offsets[c + 1] - offsets[c];
+        const math::aabb box = math::fit_aabb({ p, n });
+        aabb_ok &= identical(box, naive_aabb(p, n));
+        const math::bounding_sphere ritter = math::ritter_sphere({ p, n });
+        const math::bounding_sphere epos = math::epos_sphere({ p, n });
+        ritter_ok &= contains_all(ritter, p, n);
+        epos_ok &= contains_all(epos, p, n);
+        epos_tighter &= epos.radius <= ritter.radius * 1.05f;
+        // Any enclosing sphere is at least half as wide as the box along its widest axis.
+        const math::vec3 extent = box.max - box.min;
+        lower_bound &= epos.radius >= 0.5f * std::max({ extent.x(), extent.y(), extent.z() }) * (1.0f - 1e-5f);
+    }
+    print_test("fit_aabb matches scalar min/max", aabb_ok);
+    print_test("ritter_sphere contains every point", ritter_ok);
+    print_test("epos_sphere contains every point", epos_ok);
+    print_test("epos_sphere no larger than ritter_sphere (+5%)", epos_tighter);
+    print_test("epos_sphere radius >= half the widest box extent", lower_bound);
+
+    const math::vec3 single[1] = { math::vec3(1.0f, -2.0f, 3.0f) };
+    const math::bounding_sphere point_sphere = math::epos_sphere(single);
+    print_test("single point: zero radius", point_sphere.radius == 0.0f && same(point_sphere.center, single[0]) && math::ritter_sphere(single).radius == 0.0f);
+    // Regular octahedron: the minimal sphere is the unit sphere, and EPOS finds it exactly.
+    const math::vec3 octahedron[6] = { math::vec3(1, 0, 0), math::vec3(-1, 0, 0), math::vec3(0, 1, 0), math::vec3(0, -1, 0), math::vec3(0, 0, 1), math::vec3(0, 0, -1) };
+    const math::bounding_sphere octa = math::epos_sphere(octahedron);
+    print_test("epos_sphere of an octahedron is the unit sphere", same(octa.center, math::vec3::zero()) && approx_equal(octa.radius, 1.0f));
+    std::vector<math::vec3> collinear;
+    for (int i = 0; i < 37; ++i) {
+        collinear.emplace_back(0.5f * i, 0.25f * i, -1.0f * i);
+    }
+    print_test("collinear points", contains_all(math::epos_sphere(collinear), collinear.data(), collinear.size()) && contains_all(math::ritter_sphere(collinear), collinear.data(), collinear.size()));
+
+    std::cout << "--- batches ---" << std::endl;
+    std::vector<math::aabb> boxes(clusters);
+    std::vector<math::bounding_sphere> ritter(clusters), epos(clusters);
+    math::fit_aabbs(points, offsets, boxes, 4);
+    math::ritter_spheres(points, offsets, ritter, 4);
+    math::epos_spheres(points, offsets, epos, 4);
+    bool batch_ok = true;
+    for (size_t c = 0; c < clusters; ++c) {
+        const std::span<const math::vec3> cluster(points.data() + offsets[c], offsets[c + 1] - offsets[c]);
+        batch_ok &= identical(boxes[c], math::fit_aabb(cluster));
+        batch_ok &= same(ritter[c], math::ritter_sphere(cluster)) && same(epos[c], math::epos_sphere(cluster));
+    }
+    print_test("batch forms match the single-set functions", batch_ok);
+
+    std::cout << "--- transformed boxes ---" << std::endl;
+    const math::mat4x4 m = random_affine(rng);
+    bool transform_ok = true;
+    for (const math::aabb& box : boxes) {
+        transform_ok &= same(math::transform_aabb(m, box), naive_transform(m, box), 0.001f);
+    }
+    print_test("transform_aabb equals the box of 8 transformed corners", transform_ok);
+    std::vector<math::aabb> moved(clusters);
+    math::transform_aabbs(m, boxes, moved);
+    bool batch_transform = true;
+    for (size_t c = 0; c < clusters; ++c) {
+        batch_transform &= identical(moved[c], math::transform_aabb(m, boxes[c]));
+    }
+    print_test("transform_aabbs (one matrix)", batch_transform);
+    std::vector<math::mat4x4> matrices;
+    for (size_t c = 0; c < clusters; ++c) {
+        matrices.push_back(random_affine(rng));
+    }
+    std::vector<math::aabb> in_place = boxes;
+    math::transform_aabbs(matrices, in_place, in_place);
+    bool instanced = true;
+    for (size_t c = 0; c < clusters; ++c) {
+        instanced &= same(in_place[c], naive_transform(matrices[c], boxes[c]), 0.001f);
+    }
+    print_test("transform_aabbs (per-instance, in place)", instanced);
+
+    std::cout << "--- errors ---" << std::endl;
+    auto throws = [](auto&& fn) {
+        try {
+            fn();
+        } catch (const std::invalid_argument&) {
+            return true;
+        }
+        return false;
+    };
+    print_test("empty set throws", throws([] { math::fit_aabb({}); }) && throws([] { math::ritter_sphere({}); }) && throws([] { math::epos_sphere({}); }));
+    std::vector<std::uint32_t> empty_cluster = { 0, 4, 4, 8 };
+    std::vector<std::uint32_t> past_end = { 0, 4, static_cast<std::uint32_t>(points.size() + 1) };
+    std::vector<math::aabb> out3(3), out2(2);
+    print_test("empty cluster throws", throws([&] { math::fit_aabbs(points, empty_cluster, out3); }));
+    print_test("offsets past the points throw", throws([&] { math::fit_aabbs(points, past_end, out2); }));
+    print_test("mismatched output size throws", throws([&] { math::fit_aabbs(points, past_end, out3); }));
+
+    std::cout << std::endl;
+}
+
+void run_speed_tests(size_t clusters, size_t cluster_size, int repeats)
+{
+    std::cout << "=== SPEED TESTS (" << clusters << " meshlets x " << cluster_size << " points x " << repeats << ", simd backend: " << math::simd::backend_name << ") ===" << std::endl
+              << std::endl;
+
+    std::mt19937 rng(5);
+    std::vector<math::vec3> points;
+    points.reserve(clusters * cluster_size);
+    std::vector<std::uint32_t> offsets;
+    make_clusters(rng, clusters, { cluster_size }, points, offsets);
+    std::vector<math::aabb> boxes(clusters), moved(clusters);
+    std::vector<math::bounding_sphere> spheres(clusters);
+    const math::mat4x4 m = random_affine(rng);
+    const unsigned threads = math::parallel::default_thread_count();
+
+    report("naive scalar AABB:            ", clusters, repeats, [&] {
+        for (size_t c = 0; c < clusters; ++c) boxes[c] = naive_aabb(points.data() + offsets[c], offsets[c + 1] - offsets[c]);
+    }, "clusters");
+    report("fit_aabbs (1 thread):         ", clusters, repeats, [&] { math::fit_aabbs(points, offsets, boxes, 1); }, "clusters");
+    report("ritter_spheres (1 thread):    ", clusters, repeats, [&] { math::ritter_spheres(points, offsets, spheres, 1); }, "clusters");
+    report("epos_spheres (1 thread):      ", clusters, repeats, [&] { math::epos_spheres(points, offsets, spheres, 1); }, "clusters");
+    if (threads > 1) {
+        report("fit_aabbs (all threads):      ", clusters, repeats, [&] { math::fit_aabbs(points, offsets, boxes); }, "clusters");
+        report("ritter_spheres (all threads): ", clusters, repeats, [&] { math::ritter_spheres(points, offsets, spheres); }, "clusters");
+        report("epos_spheres (all threads):   ", clusters, repeats, [&] { math::epos_spheres(points, offsets, spheres); }, "clusters");
+    }
+    report("naive 8-corner transform:     ", clusters, repeats, [&] {
+        for (size_t c = 0; c < clusters; ++c) moved[c] = naive_transform(m, boxes[c]);
+    }, "clusters");
+    report("transform_aabbs (Arvo):       ", clusters, repeats, [&] { math::transform_aabbs(m, boxes, moved); }, "clusters");
+
+    std::cout << "(checksum " << boxes[0].max.x() + spheres[0].radius + moved[0].min.y() << ")" << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    size_t clusters = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 20;
+    size_t cluster_size = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 64;
+    int repeats = argc > 3 ? std::atoi(argv[3]) : 3;
+    run_tests();
+    run_speed_tests(clusters, cluster_size, repeats);
+    return 0;
+}
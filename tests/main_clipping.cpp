@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../clipping/clipping.hpp"
+
+void print_test(const char* name, bool passed)
+{
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << name << std::endl;
+}
+
+bool inside(const math::vec4& v, float guard_band, float epsilon = 0.0001f)
+{
+    float gw = guard_band * v.w() + epsilon;
+    return std::abs(v.x()) <= gw && std::abs(v.y()) <= gw && std::abs(v.z()) <= v.w() + epsilon;
+}
+
+const math::vec4& vertex(const math::triangle_clipper& clipper, const std::vector<math::vec4>& positions, uint32_t index)
+{
+    return index < positions.size() ? positions[index] : clipper.added_vertices()[index - positions.size()];
+}
+
+void run_tests()
+{
+    std::cout << "=== TESTING clipping ===" << std::endl
+              << std::endl;
+
+    math::triangle_clipper clipper;
+
+    std::vector<math::vec4> positions = {
+        math::vec4(-0.5f, -0.5f, 0.0f, 1.0f), math::vec4(0.5f, -0.5f, 0.0f, 1.0f), math::vec4(0.0f, 0.5f, 0.0f, 1.0f),
+        math::vec4(2.0f, 0.0f, 0.0f, 1.0f), math::vec4(3.0f, 0.0f, 0.0f, 1.0f), math::vec4(2.5f, 1.0f, 0.0f, 1.0f),
+        math::vec4(0.0f, 0.0f, 0.0f, 1.0f), math::vec4(0.5f, 0.0f, 0.0f, 1.0f), math::vec4(0.0f, 0.5f, 0.5f, -1.0f)};
+    std::vector<uint32_t> indices = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+    clipper.clip(positions, indices);
+
+    print_test("inside triangle kept with original indices",
+               clipper.triangle_count() >= 1 && clipper.indices()[0] == 0 && clipper.indices()[1] == 1 && clipper.indices()[2] == 2 && clipper.triangle_ids()[0] == 0);
+    bool rejected = true;
+    for (uint32_t id : clipper.triangle_ids()) {
+        rejected = rejected && id != 1;
+    }
+    print_test("outside triangle rejected", rejected);
+
+    bool straddling = clipper.triangle_count() > 1;
+    bool all_inside = true;
+    for (size_t t = 1; t < clipper.triangle_count(); ++t) {
+        straddling = straddling && clipper.triangle_ids()[t] == 2;
+        for (int k = 0; k < 3; ++k) {
+            all_inside = all_inside && inside(vertex(clipper, positions, clipper.indices()[3 * t + k]), 1.0f);
+        }
+    }
+    print_test("behind-the-eye vertex clipped", straddling && all_inside);
+    print_test("new vertices indexed after the input", !clipper.added_vertices().empty() && clipper.indices().back() >= positions.size());
+
+    // Guard band keeps triangles that only cross the screen edges whole.
+    math::triangle_clipper guard_band_clipper(4.0f);
+    positions = {math::vec4(-2.0f, -2.0f, 0.0f, 1.0f), math::vec4(2.0f, -2.0f, 0.0f, 1.0f), math::vec4(0.0f, 2.0f, 0.0f, 1.0f)};
+    indices = {0, 1, 2};
+    guard_band_clipper.clip(positions, indices);
+    print_test("guard band avoids clipping", guard_band_clipper.triangle_count() == 1 && guard_band_clipper.added_vertices().empty());
+    clipper.clip(positions, indices);
+    bool clipped_inside = clipper.triangle_count() > 1;
+    for (uint32_t i : clipper.indices()) {
+        clipped_inside = clipped_inside && inside(vertex(clipper, positions, i), 1.0f);
+    }
+    print_test("without guard band triangle is clipped to the frustum", clipped_inside);
+
+    // Adjacent triangles crossing the near plane share their new vertex on the common edge.
+    positions = {math::vec4(0.0f, 0.0f, 0.0f, 1.0f), math::vec4(0.0f, 0.0f, -3.0f, 1.0f),
+                 math::vec4(0.5f, 0.0f, 0.0f, 1.0f), math::vec4(-0.5f, 0.0f, 0.0f, 1.0f)};
+    indices = {0, 1, 2, 1, 0, 3};
+    clipper.clip(positions, indices);
+    bool shared = false;
+    for (size_t a = 0; a < clipper.added_vertices().size(); ++a) {
+        for (size_t b = a + 1; b < clipper.added_vertices().size(); ++b) {
+            const math::vec4& va = clipper.added_vertices()[a];
+            const math::vec4& vb = clipper.added_vertices()[b];
+            shared = shared || (va.x() == vb.x() && va.y() == vb.y() && va.z() == vb.z() && va.w() == vb.w());
+        }
+    }
+    print_test("shared edge produces identical vertices", shared);
+
+    std::cout << std::endl;
+}
+
+void run_speed_tests(size_t triangle_count, float straddling_fraction)
+{
+    std::cout << "=== SPEED TESTS (" << triangle_count << " triangles, " << straddling_fraction * 100.0f << "% crossing the near plane) ===" << std::endl
+              << std::endl;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> coord(-0.9f, 0.9f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<math::vec4> positions;
+    std::vector<uint32_t> indices;
+    positions.reserve(triangle_count * 3);
+    for (size_t t = 0; t < triangle_count; ++t) {
+        bool straddle = unit(rng) < straddling_fraction;
+        for (int v = 0; v < 3; ++v) {
+            float z = (straddle && v == 0) ? -2.0f : coord(rng);
+            indices.push_back(static_cast<uint32_t>(positions.size()));
+            positions.push_back(math::vec4(coord(rng), coord(rng), z, 1.0f));
+        }
+    }
+
+    std::vector<uint32_t> copy(indices.size());
+    auto start = std::chrono::high_resolution_clock::now();
+    std::copy(indices.begin(), indices.end(), copy.begin());
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+    std::cout << "Index copy:         " << std::setw(10) << duration.count() << " ms" << std::endl;
+
+    math::triangle_clipper clipper;
+    clipper.clip(positions, indices);
+    start = std::chrono::high_resolution_clock::now();
+    clipper.clip(positions, indices);
+    end = std::chrono::high_resolution_clock::now();
+    duration = end - start;
+    std::cout << "triangle_clipper:   " << std::setw(10) << duration.count() << " ms ("
+              << std::setw(8) << (triangle_count / duration.count() / 1000.0) << " M tris/s), "
+              << clipper.triangle_count() << " triangles out" << std::endl;
+
+    std::cout << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    size_t triangles = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    float straddling = argc > 2 ? static_cast<float>(std::atof(argv[2])) : 0.01f;
+    run_tests();
+    run_speed_tests(triangles, straddling);
+    return 0;
+}
@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "../convex_hull/convex_hull.hpp"
+
+void print_test(const char* name, bool passed)
+{
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << name << std::endl;
+}
+
+std::vector<math::vec3> ball_points(size_t count, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<math::vec3> points;
+    points.reserve(count);
+    while (points.size() < count) {
+        math::vec3 p(unit(rng), unit(rng), unit(rng));
+        if (p.length() <= 1.0f) {
+            points.push_back(p);
+        }
+    }
+    return points;
+}
+
+// Every edge is shared by exactly two faces with opposite directions, and V - E + F = 2.
+bool is_closed_manifold(const math::convex_hull& hull)
+{
+    std::map<std::pair<uint32_t, uint32_t>, int> edges;
+    auto indices = hull.indices();
+    for (size_t f = 0; f < hull.face_count(); ++f) {
+        for (int k = 0; k < 3; ++k) {
+            if (++edges[{ indices[3 * f + k], indices[3 * f + (k + 1) % 3] }] != 1) {
+                return false;
+            }
+        }
+    }
+    for (const auto& [edge, count] : edges) {
+        if (edges.count({ edge.second, edge.first }) != 1) {
+            return false;
+        }
+    }
+    long v = static_cast<long>(hull.vertices().size()), e = static_cast<long>(edges.size() / 2), f = static_cast<long>(hull.face_count());
+    return v - e + f == 2;
+}
+
+// Largest distance of any input point above any face plane.
+double worst_outside(const math::convex_hull& hull, const std::vector<math::vec3>& points)
+{
+    auto indices = hull.indices();
+    double worst = 0.0;
+    for (size_t f = 0; f < hull.face_count(); ++f) {
+        const math::vec3& a = points[indices[3 * f]];
+        const math::vec3& b = points[indices[3 * f + 1]];
+        const math::vec3& c = points[indices[3 * f + 2]];
+        double u[3] = { double(b.x()) - a.x(), double(b.y()) - a.y(), double(b.z()) - a.z() };
+        double v[3] = { double(c.x()) - a.x(), double(c.y()) - a.y(), double(c.z()) - a.z() };
+        double n[3] = { u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0] };
+        double length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (length == 0.0) {
+            continue;
+        }
+        for (const math::vec3& p : points) {
+            double d = (p.x() - double(a.x())) * n[0] + (p.y() - double(a.y())) * n[1] + (p.z() - double(a.z())) * n[2];
+            worst = std::max(worst, d / length);
+        }
+    }
+    return worst;
+}
+
+void run_tests()
+{
+    std::cout << "=== TESTING convex_hull ===" << std::endl
+              << std::endl;
+
+    std::vector<math::vec3> cube;
+    for (int i = 0; i < 8; ++i) {
+        cube.emplace_back((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f);
+    }
+    for (const math::vec3& p : ball_points(500, 1)) {
+        cube.push_back(p * 0.5f);
+    }
+    math::convex_hull cube_hull(cube);
+    bool corners_only = cube_hull.vertices().size() == 8 && cube_hull.vertices().back() == 7;
+    print_test("cube hull has the 8 corners", corners_only);
+    print_test("cube hull has 12 triangles", cube_hull.face_count() == 12);
+    print_test("cube hull is a closed manifold", is_closed_manifold(cube_hull));
+
+    auto ball = ball_points(5000, 2);
+    math::convex_hull ball_hull(ball);
+    print_test("ball hull is a closed manifold", is_closed_manifold(ball_hull));
+    print_test("ball hull contains every point", worst_outside(ball_hull, ball) < 1e-4);
+
+    // Points on a sphere are all hull vertices (up to the tolerance).
+    std::vector<math::vec3> sphere = ball_points(2000, 3);
+    for (math::vec3& p : sphere) {
+        p.normalize();
+    }
+    math::convex_hull sphere_hull(sphere);
+    print_test("sphere hull is a closed manifold", is_closed_manifold(sphere_hull));
+    print_test("sphere hull keeps almost every point", sphere_hull.vertices().size() > 1990);
+    print_test("sphere hull contains every point", worst_outside(sphere_hull, sphere) < 1e-4);
+
+    // Large offset: the tolerance scales with the input.
+    std::vector<math::vec3> far = ball;
+    for (math::vec3& p : far) {
+        p = p * 100.0f + math::vec3(1000.0f, -2000.0f, 500.0f);
+    }
+    math::convex_hull far_hull(far, 1);
+    print_test("offset and scaled hull is a closed manifold", is_closed_manifold(far_hull));
+    print_test("offset and scaled hull contains every point", worst_outside(far_hull, far) < 1e-4 * 2000.0);
+
+    // Small extent far from the origin: the tolerance follows the spread, not the position.
+    bool off_origin_ok = true;
+    for (unsigned seed = 1; seed <= 5; ++seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        std::vector<math::vec3> box;
+        for (int i = 0; i < 100000; ++i) {
+            box.emplace_back(1000.0f + unit(rng), 1000.0f + unit(rng), 1000.0f + unit(rng));
+        }
+        try {
+            math::convex_hull box_hull(box);
+            off_origin_ok = off_origin_ok && is_closed_manifold(box_hull) && worst_outside(box_hull, box) < 1e-3;
+        } catch (const std::exception&) {
+            off_origin_ok = false;
+        }
+    }
+    print_test("off-origin cube hulls are closed and contain every point", off_origin_ok);
+
+    math::convex_hull threaded(ball, 4);
+    print_test("result does not depend on thread count", std::equal(threaded.vertices().begin(), threaded.vertices().end(), ball_hull.vertices().begin(), ball_hull.vertices().end()));
+
+    bool threw = false;
+    try {
+        std::vector<math::vec3> flat = { math::vec3(0, 0, 0), math::vec3(1, 0, 0), math::vec3(0, 1, 0), math::vec3(1, 1, 0), math::vec3(0.5f, 0.5f, 0) };
+        math::convex_hull flat_hull(flat);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    print_test("coplanar input throws", threw);
+
+    std::cout << std::endl;
+}
+
+void run_speed_tests(const std::vector<size_t>& sizes)
+{
+    std::cout << "=== SPEED TESTS ===" << std::endl
+              << std::endl;
+
+    for (size_t count : sizes) {
+        auto points = ball_points(count, 9);
+        auto start = std::chrono::high_resolution_clock::now();
+        math::convex_hull hull(points);
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> duration = end - start;
+        std::cout << std::setw(9) << count << " points:" << std::setw(10) << duration.count() << " ms ("
+                  << std::setw(8) << (count / duration.count() / 1000.0) << " M points/s, "
+                  << hull.vertices().size() << " hull vertices)" << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    std::vector<size_t> sizes;
+    for (int i = 1; i < argc; ++i) {
+        sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+    }
+    if (sizes.empty()) {
+        sizes = { 1000000, 10000000 };
+    }
+    run_tests();
+    run_speed_tests(sizes);
+    return 0;
+}
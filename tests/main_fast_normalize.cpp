@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../fast_normalize/fast_normalize.hpp"
+
+void print_test(const char* name, bool passed)
+{
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << name << std::endl;
+}
+
+// Largest component error relative to the exact (double) unit vector.
+template <int N>
+double relative_error(const float* input, const float* result)
+{
+    double len_sq = 0.0;
+    for (int c = 0; c < N; ++c) {
+        len_sq += double(input[c]) * input[c];
+    }
+    double inv = 1.0 / std::sqrt(len_sq);
+    double worst = 0.0;
+    for (int c = 0; c < N; ++c) {
+        worst = std::max(worst, std::abs(result[c] - input[c] * inv));
+    }
+    return worst;
+}
+
+template <typename T, int N>
+double worst_array_error(const std::vector<T>& in, const std::vector<T>& out)
+{
+    double worst = 0.0;
+    for (size_t i = 0; i < in.size(); ++i) {
+        worst = std::max(worst, relative_error<N>(reinterpret_cast<const float*>(&in[i]), reinterpret_cast<const float*>(&out[i])));
+    }
+    return worst;
+}
+
+void run_tests()
+{
+    std::cout << "=== TESTING fast normalize ===" << std::endl
+              << std::endl;
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> coord(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> exponent(-3.0f, 3.0f);
+
+    // 1003 vectors so the SIMD loops leave a scalar tail; lengths span six orders of magnitude.
+    std::vector<math::vec2> in2;
+    std::vector<math::vec3> in3;
+    std::vector<math::vec4> in4;
+    for (int i = 0; i < 1003; ++i) {
+        float scale = std::pow(10.0f, exponent(rng));
+        in2.push_back(math::vec2(coord(rng), coord(rng)) * scale);
+        in3.push_back(math::vec3(coord(rng), coord(rng), coord(rng)) * scale);
+        in4.push_back(math::vec4(coord(rng), coord(rng), coord(rng), coord(rng)) * scale);
+    }
+
+    std::vector<math::vec2> out2(in2.size());
+    std::vector<math::vec3> out3(in3.size());
+    std::vector<math::vec4> out4(in4.size());
+    math::normalize_fast(in2, out2);
+    math::normalize_fast(in3, out3);
+    math::normalize_fast(in4, out4);
+    double error2 = worst_array_error<math::vec2, 2>(in2, out2);
+    double error3 = worst_array_error<math::vec3, 3>(in3, out3);
+    double error4 = worst_array_error<math::vec4, 4>(in4, out4);
+    std::cout << "  max error vec2/vec3/vec4 arrays: " << error2 << " / " << error3 << " / " << error4 << std::endl;
+    print_test("array forms within 5e-7", error2 < 5e-7 && error3 < 5e-7 && error4 < 5e-7);
+
+    double scale_error = 0.0;
+    for (const math::vec3& v : in3) {
+        const float len_sq = v.x() * v.x() + v.y() * v.y() + v.z() * v.z();
+        scale_error = std::max(scale_error, std::abs(math::fast_inverse_length(len_sq) * std::sqrt(double(len_sq)) - 1.0));
+    }
+    std::cout << "  max error fast_inverse_length: " << scale_error << std::endl;
+    print_test("fast_inverse_length within 5e-7", scale_error < 5e-7);
+
+    std::vector<math::vec3> inplace = in3;
+    math::normalize_fast(std::span<math::vec3>(inplace));
+    print_test("in-place matches out-of-place", std::equal(inplace.begin(), inplace.end(), out3.begin(), [](const math::vec3& a, const math::vec3& b) {
+        return a.x() == b.x() && a.y() == b.y() && a.z() == b.z();
+    }));
+
+    std::vector<math::vec3> degenerate(40, math::vec3(1e-5f, 0.0f, 0.0f));
+    degenerate[3] = math::vec3(0.0f, 0.0f, 0.0f);
+    degenerate[35] = math::vec3(0.0f, 0.0f, 0.0f);
+    math::normalize_fast(std::span<math::vec3>(degenerate));
+    bool zero = true;
+    for (const math::vec3& v : degenerate) {
+        zero = zero && v.x() == 0.0f && v.y() == 0.0f && v.z() == 0.0f;
+    }
+    print_test("degenerate vectors become zero", zero && math::fast_inverse_length(0.0f) == 0.0f && math::fast_inverse_length(1e-9f) == 0.0f);
+
+    std::cout << std::endl;
+}
+
+void run_speed_tests(size_t count, int iterations)
+{
+    std::cout << "=== SPEED TESTS (" << count << " vec3 x " << iterations << " iterations) ===" << std::endl
+              << std::endl;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> coord(-10.0f, 10.0f);
+    std::vector<math::vec3> in(count), out(count);
+    for (math::vec3& v : in) {
+        v = math::vec3(coord(rng), coord(rng), coord(rng));
+    }
+    const double total = static_cast<double>(count) * iterations;
+
+    auto report = [&](const char* name, std::chrono::duration<double, std::milli> duration) {
+        std::cout << name << std::setw(10) << duration.count() << " ms (" << std::setw(8)
+                  << (total / duration.count() / 1000.0) << " M ops/s)" << std::endl;
+    };
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int it = 0; it < iterations; ++it) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = in[i].normalized();
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    report("vec3::normalized():        ", end - start);
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int it = 0; it < iterations; ++it) {
+        math::normalize_fast(in, out);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    report("normalize_fast(span):      ", end - start);
+
+    std::cout << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 20;
+    run_tests();
+    run_speed_tests(count, iterations);
+    return 0;
+}
@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "../gpu_pack/gpu_pack.hpp"
+#include "../simd/simd.hpp"
+
+void print_test(const char* name, bool passed)
+{
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << name << std::endl;
+}
+
+std::vector<math::mat4x4> make_matrices(size_t count, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<math::mat4x4> matrices(count);
+    for (auto& m : matrices) {
+        for (int r = 0; r < 4; ++r) {
+            for (int c = 0; c < 4; ++c) {
+                m.at(r, c) = unit(rng);
+            }
+        }
+    }
+    return matrices;
+}
+
+// Float k of packed matrix i must be element (k % rows, k / rows) of its source.
+bool check_packed(const std::vector<math::mat4x4>& matrices, const std::vector<uint32_t>* remap, const float* out, int rows)
+{
+    size_t count = remap ? remap->size() : matrices.size();
+    for (size_t i = 0; i < count; ++i) {
+        const math::mat4x4& m = matrices[remap ? (*remap)[i] : i];
+        for (int k = 0; k < 4 * rows; ++k) {
+            if (out[i * 4 * rows + k] != m.at(k % rows, k / rows)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// 64-byte aligned scratch with `offset` extra bytes in front of the returned pointer.
+struct host_buffer {
+    std::byte* base;
+    std::byte* ptr;
+    size_t size;
+    host_buffer(size_t bytes, size_t offset)
+        : base(static_cast<std::byte*>(std::aligned_alloc(64, (bytes + offset + 63) / 64 * 64 + 64)))
+        , ptr(base + offset)
+        , size(bytes)
+    {
+    }
+    ~host_buffer() { std::free(base); }
+    std::span<std::byte> span() const { return { ptr, size }; }
+    const float* floats() const { return reinterpret_cast<const float*>(ptr); }
+};
+
+void run_tests()
+{
+    std::cout << "=== TESTING gpu_pack (simd backend: " << math::simd::backend_name << ") ===" << std::endl
+              << std::endl;
+
+    print_test("packed sizes are 64 and 48 bytes", math::packed_matrix_size(math::gpu_matrix_layout::column_major_4x4) == 64 && math::packed_matrix_size(math::gpu_matrix_layout::column_major_4x3) == 48);
+
+    bool ok_4x4 = true, ok_4x3 = true, ok_unaligned = true, ok_remap = true, no_overrun = true;
+    for (size_t count : { 0, 1, 2, 5, 16, 33 }) {
+        std::vector<math::mat4x4> matrices = make_matrices(count, static_cast<unsigned>(count));
+        for (size_t offset : { 0, 4, 16 }) {
+            host_buffer b44(count * 64 + 64, offset), b43(count * 48 + 64, offset);
+            std::memset(b44.ptr, 0x7f, b44.size);
+            std::memset(b43.ptr, 0x7f, b43.size);
+            math::pack_matrices(matrices, math::gpu_matrix_layout::column_major_4x4, b44.span().first(count * 64));
+            math::pack_matrices(matrices, math::gpu_matrix_layout::column_major_4x3, b43.span().first(count * 48));
+            bool good_44 = check_packed(matrices, nullptr, b44.floats(), 4);
+            bool good_43 = check_packed(matrices, nullptr, b43.floats(), 3);
+            if (offset % 16 != 0) {
+                ok_unaligned &= good_44 && good_43;
+            } else {
+                ok_4x4 &= good_44;
+                ok_4x3 &= good_43;
+            }
+            no_overrun &= static_cast<unsigned char>(b44.ptr[count * 64]) == 0x7f && static_cast<unsigned char>(b43.ptr[count * 48]) == 0x7f;
+        }
+
+        std::vector<uint32_t> remap;
+        for (size_t i = 0; i < count + 3 && count > 0; ++i) {
+            remap.push_back(static_cast<uint32_t>((i * 7 + 3) % count));
+        }
+        host_buffer b44(remap.size() * 64, 0), b43(remap.size() * 48, 0);
+        math::pack_matrices(matrices, remap, math::gpu_matrix_layout::column_major_4x4, b44.span());
+        math::pack_matrices(matrices, remap, math::gpu_matrix_layout::column_major_4x3, b43.span());
+        ok_remap &= check_packed(matrices, &remap, b44.floats(), 4) && check_packed(matrices, &remap, b43.floats(), 3);
+    }
+    print_test("column-major 4x4 matches mat4x4::at(row, col)", ok_4x4);
+    print_test("column-major 4x3 matches mat4x4::at(row, col)", ok_4x3);
+    print_test("unaligned destination (plain stores)", ok_unaligned);
+    print_test("remapped instances", ok_remap);
+    print_test("nothing written past the last matrix", no_overrun);
+
+    {
+        // Same bytes as transpose() followed by a copy.
+        std::vector<math::mat4x4> matrices = make_matrices(3, 99);
+        host_buffer b(3 * 64, 0);
+        math::pack_matrices(matrices, math::gpu_matrix_layout::column_major_4x4, b.span());
+        bool same = true;
+        for (size_t i = 0; i < 3; ++i) {
+            same &= std::memcmp(b.ptr + 64 * i, matrices[i].transpose().data(), 64) == 0;
+        }
+        print_test("4x4 equals transpose() bytes", same);
+    }
+
+    {
+        std::vector<math::mat4x4> matrices = make_matrices(4, 1);
+        host_buffer b(4 * 64, 0);
+        bool small_threw = false, index_threw = false;
+        try {
+            math::pack_matrices(matrices, math::gpu_matrix_layout::column_major_4x4, b.span().first(4 * 64 - 1));
+        } catch (const std::invalid_argument&) {
+            small_threw = true;
+        }
+        std::vector<uint32_t> bad = { 0, 4 };
+        try {
+            math::pack_matrices(matrices, bad, math::gpu_matrix_layout::column_major_4x3, b.span());
+        } catch (const std::invalid_argument&) {
+            index_threw = true;
+        }
+        print_test("too small destination throws std::invalid_argument", small_threw);
+        print_test("out-of-range instance index throws std::invalid_argument", index_threw);
+    }
+
+    std::cout << std::endl;
+}
+
+void run_speed_tests(size_t count, int repeats)
+{
+    std::cout << "=== SPEED TESTS (" << count << " matrices x " << repeats << ", simd backend: " << math::simd::backend_name << ") ===" << std::endl
+              << std::endl;
+
+    std::vector<math::mat4x4> matrices = make_matrices(count, 5);
+    std::vector<uint32_t> remap(count);
+    std::mt19937 rng(6);
+    for (size_t i = 0; i < count; ++i) {
+        remap[i] = static_cast<uint32_t>(i);
+    }
+    std::shuffle(remap.begin(), remap.end(), rng);
+    host_buffer aligned(count * 64, 0), unaligned(count * 64, 4);
+
+    report("4x4: transpose() + memcpy:      ", count, repeats, [&] {
+        for (size_t i = 0; i < count; ++i) {
+            math::mat4x4 t = matrices[i].transpose();
+            std::memcpy(aligned.ptr + 64 * i, t.data(), 64);
+        }
+    }, "matrices");
+    report("4x4: pack_matrices (streaming): ", count, repeats, [&] { math::pack_matrices(matrices, math::gpu_matrix_layout::column_major_4x4, aligned.span()); }, "matrices");
+    report("4x4: pack_matrices (unaligned): ", count, repeats, [&] { math::pack_matrices(matrices, math::gpu_matrix_layout::column_major_4x4, unaligned.span()); }, "matrices");
+    report("4x3: transpose() + memcpy:      ", count, repeats, [&] {
+        for (size_t i = 0; i < count; ++i) {
+            math::mat4x4 t = matrices[i].transpose();
+            for (int c = 0; c < 4; ++c) {
+                std::memcpy(aligned.ptr + 48 * i + 12 * c, t.data() + 4 * c, 12);
+            }
+        }
+    }, "matrices");
+    report("4x3: pack_matrices (streaming): ", count, repeats, [&] { math::pack_matrices(matrices, math::gpu_matrix_layout::column_major_4x3, aligned.span()); }, "matrices");
+    report("4x3: pack_matrices (unaligned): ", count, repeats, [&] { math::pack_matrices(matrices, math::gpu_matrix_layout::column_major_4x3, unaligned.span()); }, "matrices");
+    report("4x3: remapped (streaming):      ", count, repeats, [&] { math::pack_matrices(matrices, remap, math::gpu_matrix_layout::column_major_4x3, aligned.span()); }, "matrices");
+
+    std::cout << "(checksum " << aligned.floats()[count] << ")" << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    // Defaults exceed the last-level cache, as an instance buffer upload does.
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 20;
+    int repeats = argc > 2 ? std::atoi(argv[2]) : 10;
+    run_tests();
+    run_speed_tests(count, repeats);
+    return 0;
+}
@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "../kd_tree/kd_tree.hpp"
+#include "../parallel/parallel_for.hpp"
+
+void print_test(const char* name, bool passed)
+{
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << name << std::endl;
+}
+
+bool approx_equal(float a, float b, float epsilon = 0.0001f)
+{
+    return std::abs(a - b) < epsilon;
+}
+
+std::vector<math::vec3> random_points(size_t count, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> coord(-10.0f, 10.0f);
+    std::vector<math::vec3> points;
+    points.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        points.push_back(math::vec3(coord(rng), coord(rng), coord(rng)));
+    }
+    return points;
+}
+
+// k smallest distances (sorted) by brute force with vec3::distance_to.
+std::vector<float> brute_force_knn(const std::vector<math::vec3>& points, const math::vec3& query, size_t k)
+{
+    std::vector<float> distances(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        distances[i] = query.distance_to(points[i]);
+    }
+    k = std::min(k, distances.size());
+    std::partial_sort(distances.begin(), distances.begin() + k, distances.end());
+    distances.resize(k);
+    return distances;
+}
+
+void run_tests()
+{
+    std::cout << "=== TESTING kd_tree ===" << std::endl
+              << std::endl;
+
+    auto points = random_points(50000, 3);
+    math::kd_tree tree(points);
+    print_test("size", tree.size() == points.size());
+
+    auto queries = random_points(200, 4);
+    const size_t k = 10;
+    std::vector<uint32_t> indices(k);
+    std::vector<float> distances(k);
+    bool knn_ok = true;
+    for (const math::vec3& q : queries) {
+        size_t found = tree.nearest(q, k, indices, distances);
+        auto expected = brute_force_knn(points, q, k);
+        knn_ok = knn_ok && found == k;
+        for (size_t j = 0; j < k; ++j) {
+            knn_ok = knn_ok && approx_equal(std::sqrt(distances[j]), expected[j], 1e-4f);
+            knn_ok = knn_ok && approx_equal(q.distance_to(points[indices[j]]), expected[j], 1e-4f);
+        }
+    }
+    print_test("k nearest match brute force", knn_ok);
+
+    size_t found = tree.nearest(points[123], 1, indices, distances);
+    print_test("point is its own nearest neighbour", found == 1 && indices[0] == 123 && distances[0] == 0.0f);
+
+    std::vector<uint32_t> batch_indices(queries.size() * k);
+    std::vector<float> batch_distances(queries.size() * k);
+    tree.nearest(queries, k, batch_indices, batch_distances, 4);
+    tree.nearest(queries[17], k, indices, distances);
+    print_test("batched nearest matches single query",
+               std::equal(indices.begin(), indices.end(), batch_indices.begin() + 17 * k));
+
+    std::vector<uint32_t> out(points.size());
+    bool radius_ok = true;
+    for (size_t q = 0; q < 50; ++q) {
+        size_t count = tree.query_radius(queries[q], 1.5f, out);
+        std::vector<uint32_t> result(out.begin(), out.begin() + count);
+        std::sort(result.begin(), result.end());
+        std::vector<uint32_t> expected;
+        for (size_t i = 0; i < points.size(); ++i) {
+            math::vec3 d = points[i] - queries[q];
+            if (d.x() * d.x() + d.y() * d.y() + d.z() * d.z() <= 1.5f * 1.5f) {
+                expected.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        radius_ok = radius_ok && result == expected;
+    }
+    print_test("radius queries match brute force", radius_ok);
+
+    std::vector<uint32_t> radius_indices(queries.size() * 64);
+    std::vector<uint32_t> counts(queries.size());
+    tree.query_radius(queries, 1.5f, 64, radius_indices, counts);
+    print_test("batched radius query counts", counts[3] == std::min<size_t>(tree.query_radius(queries[3], 1.5f, out), 64));
+
+    int short_threw = 0;
+    try {
+        tree.nearest(queries, k, std::span<uint32_t>(batch_indices.data(), batch_indices.size() - 1), batch_distances);
+    } catch (const std::invalid_argument&) {
+        ++short_threw;
+    }
+    try {
+        tree.query_radius(queries, 1.5f, 64, radius_indices, std::span<uint32_t>(counts.data(), counts.size() - 1));
+    } catch (const std::invalid_argument&) {
+        ++short_threw;
+    }
+    print_test("short batched outputs throw", short_threw == 2);
+
+    // Degenerate inputs: all points equal, fewer points than k, empty tree.
+    std::vector<math::vec3> same(1000, math::vec3(1.0f, 2.0f, 3.0f));
+    math::kd_tree flat(same);
+    found = flat.nearest(math::vec3(0.0f, 0.0f, 0.0f), 5, indices, distances);
+    print_test("identical points", found == 5 && approx_equal(distances[4], 14.0f));
+
+    std::vector<math::vec3> few(points.begin(), points.begin() + 3);
+    math::kd_tree small(few);
+    found = small.nearest(math::vec3(0.0f, 0.0f, 0.0f), k, indices, distances);
+    print_test("k larger than size", found == 3 && distances[0] <= distances[1] && distances[1] <= distances[2]);
+
+    math::kd_tree empty(std::span<const math::vec3>{});
+    print_test("empty tree", empty.nearest(math::vec3(0.0f, 0.0f, 0.0f), k, indices, distances) == 0 && empty.query_radius(math::vec3(0.0f, 0.0f, 0.0f), 1.0f, out) == 0);
+
+    std::cout << std::endl;
+}
+
+void run_speed_tests(size_t count, size_t query_count, size_t k)
+{
+    std::cout << "=== SPEED TESTS (" << count << " points, " << query_count << " queries, k = " << k << ") ===" << std::endl
+              << std::endl;
+
+    auto points = random_points(count, 42);
+    auto queries = random_points(query_count, 43);
+
+    const size_t brute_force_queries = std::min<size_t>(query_count, 20);
+    auto start = std::chrono::high_resolution_clock::now();
+    float sink = 0.0f;
+    for (size_t q = 0; q < brute_force_queries; ++q) {
+        sink += brute_force_knn(points, queries[q], k)[0];
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+    std::cout << "Brute force distance_to (extrapolated): " << std::setw(12)
+              << duration.count() * query_count / brute_force_queries << " ms" << std::endl;
+    (void)sink;
+
+    std::vector<uint32_t> indices(query_count * k);
+    std::vector<float> distances(query_count * k);
+    unsigned max_threads = math::parallel::default_thread_count();
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        start = std::chrono::high_resolution_clock::now();
+        math::kd_tree tree(points, threads);
+        end = std::chrono::high_resolution_clock::now();
+        duration = end - start;
+        double build_ms = duration.count();
+
+        start = std::chrono::high_resolution_clock::now();
+        tree.nearest(queries, k, indices, distances, threads);
+        end = std::chrono::high_resolution_clock::now();
+        duration = end - start;
+        std::cout << std::setw(2) << threads << " threads: build " << std::setw(10) << build_ms << " ms, kNN "
+                  << std::setw(10) << duration.count() << " ms (" << std::setw(8)
+                  << (query_count / duration.count() / 1000.0) << " M queries/s)" << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    size_t queries = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+    size_t k = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 8;
+    run_tests();
+    run_speed_tests(count, queries, k);
+    return 0;
+}
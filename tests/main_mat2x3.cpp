@@ -0,0 +1,187 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "../mat2x3/mat2x3.hpp"
+
+void print_test(const char* name, bool passed)
+{
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << name << std::endl;
+}
+
+bool approx_equal(float a, float b, float epsilon = 0.0001f)
+{
+    return std::abs(a - b) < epsilon;
+}
+
+bool vec_approx_equal(const math::vec2& a, const math::vec2& b, float epsilon = 0.0001f)
+{
+    return approx_equal(a.x(), b.x(), epsilon) && approx_equal(a.y(), b.y(), epsilon);
+}
+
+bool mat_approx_equal(const math::mat2x3& a, const math::mat2x3& b, float epsilon = 0.0001f)
+{
+    for (int r = 0; r < 2; ++r) {
+        for (int c = 0; c < 3; ++c) {
+            if (!approx_equal(a.at(r, c), b.at(r, c), epsilon)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+std::vector<math::sprite> make_sprites(size_t count)
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> pos(-1000.0f, 1000.0f), size(1.0f, 32.0f), angle(-3.14159f, 3.14159f);
+    std::vector<math::sprite> sprites(count);
+    for (math::sprite& s : sprites) {
+        float a = angle(rng);
+        s.position = math::vec2(pos(rng), pos(rng));
+        s.half_size = math::vec2(size(rng), size(rng));
+        s.rotation = math::vec2(std::cos(a), std::sin(a));
+    }
+    return sprites;
+}
+
+// Reference corners through vec2::rotated, evaluating sin/cos per corner.
+void reference_quad(const math::mat2x3& view, const math::sprite& s, float angle, math::vec2* out)
+{
+    const float kx[4] = {-1.0f, 1.0f, 1.0f, -1.0f};
+    const float ky[4] = {-1.0f, -1.0f, 1.0f, 1.0f};
+    for (int k = 0; k < 4; ++k) {
+        math::vec2 local(kx[k] * s.half_size.x(), ky[k] * s.half_size.y());
+        out[k] = view * (s.position + local.rotated(angle));
+    }
+}
+
+void run_tests()
+{
+    std::cout << "=== TESTING mat2x3 ===" << std::endl
+              << std::endl;
+
+    math::mat2x3 t = math::mat2x3::translation(3.0f, -2.0f);
+    math::mat2x3 r = math::mat2x3::rotation(0.5f);
+    math::mat2x3 s = math::mat2x3::scaling(2.0f, 0.5f);
+    math::vec2 p(1.5f, 4.0f);
+
+    print_test("identity", vec_approx_equal(math::mat2x3::identity() * p, p));
+    print_test("compose applies right-hand side first", vec_approx_equal((t * r) * p, t * (r * p)));
+    print_test("rotation matches vec2::rotated", vec_approx_equal(r * p, p.rotated(0.5f)));
+    print_test("transform_vector ignores translation", vec_approx_equal((t * s).transform_vector(p), s * p));
+    print_test("make_transform equals T * R * S", mat_approx_equal(math::mat2x3::make_transform(math::vec2(3.0f, -2.0f), 0.5f, math::vec2(2.0f, 0.5f)), t * r * s));
+
+    math::mat2x3 m = t * r * s;
+    print_test("inverse", mat_approx_equal(m * m.inverse(), math::mat2x3::identity()) && vec_approx_equal(m.inverse() * (m * p), p));
+    print_test("determinant", approx_equal(m.determinant(), 1.0f));
+
+    bool threw = false;
+    try {
+        math::mat2x3::scaling(1.0f, 0.0f).inverse();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    print_test("singular inverse throws", threw);
+
+    std::vector<math::vec2> points;
+    for (int i = 0; i < 37; ++i) {
+        points.emplace_back(0.25f * i, -0.5f * i + 1.0f);
+    }
+    std::vector<math::vec2> out(points.size());
+    math::transform_points(m, points, out);
+    bool batch_ok = true;
+    for (size_t i = 0; i < points.size(); ++i) {
+        batch_ok = batch_ok && vec_approx_equal(out[i], m * points[i]);
+    }
+    print_test("transform_points matches operator*", batch_ok);
+
+    math::transform_points(m, points, points);
+    bool alias_ok = true;
+    for (size_t i = 0; i < points.size(); ++i) {
+        alias_ok = alias_ok && vec_approx_equal(points[i], out[i]);
+    }
+    print_test("transform_points in place", alias_ok);
+
+    auto sprites = make_sprites(29);
+    std::vector<math::vec2> corners(4 * sprites.size());
+    math::build_sprite_quads(m, sprites, corners);
+    bool quads_ok = true;
+    for (size_t i = 0; i < sprites.size(); ++i) {
+        math::vec2 expected[4];
+        reference_quad(m, sprites[i], std::atan2(sprites[i].rotation.y(), sprites[i].rotation.x()), expected);
+        for (int k = 0; k < 4; ++k) {
+            quads_ok = quads_ok && vec_approx_equal(corners[4 * i + k], expected[k], 0.01f);
+        }
+    }
+    print_test("build_sprite_quads matches per-corner rotation", quads_ok);
+
+    threw = false;
+    try {
+        math::transform_points(m, points, std::span<math::vec2>(out.data(), out.size() - 1));
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    print_test("short point output throws", threw);
+    threw = false;
+    try {
+        math::build_sprite_quads(m, sprites, std::span<math::vec2>(corners.data(), corners.size() - 1));
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    print_test("fewer than four corners per sprite throws", threw);
+
+    std::cout << std::endl;
+}
+
+void run_speed_tests(size_t count, int frames)
+{
+    std::cout << "=== SPEED TESTS (" << count << " sprites x " << frames << " frames) ===" << std::endl
+              << std::endl;
+
+    auto sprites = make_sprites(count);
+    std::vector<float> angles(count);
+    for (size_t i = 0; i < count; ++i) {
+        angles[i] = std::atan2(sprites[i].rotation.y(), sprites[i].rotation.x());
+    }
+    std::vector<math::vec2> corners(4 * count);
+    math::mat2x3 view = math::mat2x3::make_transform(math::vec2(640.0f, 360.0f), 0.1f, math::vec2(0.5f, 0.5f));
+    const double total = static_cast<double>(count) * frames;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int f = 0; f < frames; ++f) {
+        for (size_t i = 0; i < count; ++i) {
+            reference_quad(view, sprites[i], angles[i], &corners[4 * i]);
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+    std::cout << "vec2::rotated per corner:" << std::setw(10) << duration.count() << " ms ("
+              << std::setw(8) << (total / duration.count() / 1000.0) << " M sprites/s)" << std::endl;
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int f = 0; f < frames; ++f) {
+        math::build_sprite_quads(view, sprites, corners);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    duration = end - start;
+    std::cout << "build_sprite_quads:      " << std::setw(10) << duration.count() << " ms ("
+              << std::setw(8) << (total / duration.count() / 1000.0) << " M sprites/s)" << std::endl;
+    std::cout << "Per frame:               " << std::setw(10) << duration.count() / frames << " ms" << std::endl;
+
+    std::cout << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    int frames = argc > 2 ? std::atoi(argv[2]) : 10;
+    run_tests();
+    run_speed_tests(count, frames);
+    return 0;
+}
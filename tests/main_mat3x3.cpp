@@ -0,0 +1,177 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "../mat4x4/mat4x4.hpp"
+
+void print_test(const char* name, bool passed)
+{
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << name << std::endl;
+}
+
+bool approx_equal(float a, float b, float epsilon = 0.0001f)
+{
+    return std::abs(a - b) < epsilon;
+}
+
+bool vec_approx_equal(const math::vec3& a, const math::vec3& b, float epsilon = 0.0001f)
+{
+    return approx_equal(a.x(), b.x(), epsilon) && approx_equal(a.y(), b.y(), epsilon) && approx_equal(a.z(), b.z(), epsilon);
+}
+
+bool mat_approx_equal(const math::mat3x3& a, const math::mat3x3& b, float epsilon = 0.0001f)
+{
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 3; ++c) {
+            if (!approx_equal(a.at(r, c), b.at(r, c), epsilon)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+math::vec3 normal_via_mat4x4(const math::mat4x4& model, const math::vec3& n)
+{
+    math::mat4x4 it = model.inverse().transpose();
+    return (it * math::vec4(n, 0.0f)).to_vec3_orthographic().normalized();
+}
+
+void run_tests()
+{
+    std::cout << "=== TESTING mat3x3 CLASS ===" << std::endl
+              << std::endl;
+
+    math::mat3x3 a = { { { 2, 0, 1 }, { 1, 3, 2 }, { 1, 1, 2 } } };
+    math::mat3x3 id = math::mat3x3::identity();
+
+    print_test("multiply by identity", mat_approx_equal(a * id, a) && mat_approx_equal(id * a, a));
+    print_test("determinant", approx_equal(static_cast<float>(a.determinant()), 6.0f));
+    print_test("inverse", mat_approx_equal(a * a.inverse(), id));
+    print_test("transpose", approx_equal(a.transpose().at(0, 1), 1.0f) && approx_equal(a.transpose().at(2, 0), 1.0f));
+    print_test("matrix * vec3", vec_approx_equal(a * math::vec3(1, 2, 3), math::vec3(5, 13, 9)));
+
+    bool threw = false;
+    try {
+        math::mat3x3::zero().inverse();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    print_test("inverse throws on singular matrix", threw);
+
+    math::mat4x4 model = math::mat4x4::make_model_matrix(
+        math::mat4x4::translation(5.0f, -2.0f, 1.0f),
+        math::mat4x4::rotation_axis_angle_extrinsic(0.3f, 1.1f, -0.4f),
+        math::mat4x4::scaling(2.0f, 0.5f, 3.0f));
+    math::mat3x3 nm = model.normal_matrix();
+    math::vec3 n(0.3f, -0.8f, 0.5f);
+    print_test("normal_matrix matches inverse().transpose()", vec_approx_equal((nm * n).normalized(), normal_via_mat4x4(model, n)));
+
+    math::mat4x4 mirrored = math::mat4x4::scaling(-1.0f, 1.0f, 1.0f);
+    math::vec3 mirrored_normal = (mirrored.normal_matrix() * math::vec3(1, 0, 0)).normalized();
+    print_test("normal_matrix keeps orientation under mirroring", vec_approx_equal(mirrored_normal, normal_via_mat4x4(mirrored, math::vec3(1, 0, 0))));
+
+    std::vector<math::vec3> normals;
+    for (int i = 0; i < 11; ++i) {
+        normals.emplace_back(std::sin(i * 0.7f), std::cos(i * 1.3f), 0.25f * i - 1.0f);
+    }
+    normals.emplace_back(0.0f, 0.0f, 0.0f);
+    std::vector<math::vec3> out(normals.size());
+    math::transform_normals(nm, normals, out);
+    bool batch_ok = true;
+    for (size_t i = 0; i < normals.size(); ++i) {
+        batch_ok = batch_ok && vec_approx_equal(out[i], (nm * normals[i]).normalized());
+    }
+    print_test("transform_normals matches scalar path", batch_ok);
+
+    math::transform_normals(nm, normals, normals);
+    print_test("transform_normals in place", vec_approx_equal(normals[5], out[5]));
+
+    threw = false;
+    try {
+        math::transform_normals(nm, normals, std::span<math::vec3>(out.data(), out.size() - 1));
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    print_test("short normal output throws", threw);
+
+    std::cout << std::endl;
+}
+
+void run_speed_tests(size_t count, int repeats)
+{
+    std::cout << "=== SPEED TESTS ===" << std::endl
+              << std::endl;
+
+    math::mat4x4 model = math::mat4x4::make_model_matrix(
+        math::mat4x4::translation(5.0f, -2.0f, 1.0f),
+        math::mat4x4::rotation_axis_angle_extrinsic(0.3f, 1.1f, -0.4f),
+        math::mat4x4::scaling(2.0f, 0.5f, 3.0f));
+
+    const long long iterations = 10000000;
+    volatile float sink = 0.0f;
+    (void)sink;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (long long i = 0; i < iterations; i++) {
+        model.at(0, 3) = static_cast<float>(i & 7);
+        sink = model.inverse().transpose().at(1, 1);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+    std::cout << "inverse().transpose():" << std::setw(10) << duration.count() << " ms ("
+              << std::setw(8) << (iterations / duration.count() / 1000.0) << " M ops/s)" << std::endl;
+
+    start = std::chrono::high_resolution_clock::now();
+    for (long long i = 0; i < iterations; i++) {
+        model.at(0, 3) = static_cast<float>(i & 7);
+        sink = model.normal_matrix().at(1, 1);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    duration = end - start;
+    std::cout << "normal_matrix():      " << std::setw(10) << duration.count() << " ms ("
+              << std::setw(8) << (iterations / duration.count() / 1000.0) << " M ops/s)" << std::endl;
+
+    std::vector<math::vec3> normals(count), out(count);
+    for (size_t i = 0; i < count; ++i) {
+        normals[i] = math::vec3(std::sin(i * 0.1f), std::cos(i * 0.2f), 0.5f);
+    }
+    math::mat3x3 nm = model.normal_matrix();
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = (nm * normals[i]).normalized();
+        }
+    }
+    end = std::chrono::high_resolution_clock::now();
+    duration = end - start;
+    double total = static_cast<double>(count) * repeats;
+    std::cout << "Per-normal transform: " << std::setw(10) << duration.count() << " ms ("
+              << std::setw(8) << (total / duration.count() / 1000.0) << " M normals/s)" << std::endl;
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        math::transform_normals(nm, normals, out);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    duration = end - start;
+    std::cout << "transform_normals:    " << std::setw(10) << duration.count() << " ms ("
+              << std::setw(8) << (total / duration.count() / 1000.0) << " M normals/s)" << std::endl;
+
+    sink = out[count / 2].x();
+    std::cout << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    int repeats = argc > 2 ? std::atoi(argv[2]) : 100;
+    run_tests();
+    run_speed_tests(count, repeats);
+    return 0;
+}
@@ -0,0 +1,231 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "../occlusion/occlusion.hpp"
+#include "../parallel/parallel_for.hpp"
+
+void print_test(const char* name, bool passed)
+{
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << name << std::endl;
+}
+
+// OpenGL-style perspective looking down -z.
+math::mat4x4 perspective(float focal, float aspect, float near, float far)
+{
+    float elements[4][4] = { { focal / aspect, 0.0f, 0.0f, 0.0f }, { 0.0f, focal, 0.0f, 0.0f }, { 0.0f, 0.0f, -(far + near) / (far - near), -2.0f * far * near / (far - near) }, { 0.0f, 0.0f, -1.0f, 0.0f } };
+    return math::mat4x4(elements);
+}
+
+// The 12 triangles of a box.
+void append_box(const math::aabb& box, std::vector<math::vec3>& positions, std::vector<uint32_t>& indices)
+{
+    const uint32_t base = static_cast<uint32_t>(positions.size());
+    for (int k = 0; k < 8; ++k) {
+        positions.emplace_back((k & 1 ? box.max : box.min).x(), (k & 2 ? box.max : box.min).y(), (k & 4 ? box.max : box.min).z());
+    }
+    const uint32_t faces[6][4] = { { 0, 1, 3, 2 }, { 4, 6, 7, 5 }, { 0, 4, 5, 1 }, { 2, 3, 7, 6 }, { 0, 2, 6, 4 }, { 1, 5, 7, 3 } };
+    for (const auto& f : faces) {
+        for (uint32_t i : { f[0], f[1], f[2], f[0], f[2], f[3] }) {
+            indices.push_back(base + i);
+        }
+    }
+}
+
+math::aabb make_box(float x0, float y0, float z0, float x1, float y1, float z1)
+{
+    return { math::vec3(x0, y0, z0), math::vec3(x1, y1, z1) };
+}
+
+// City blocks: a grid of buildings in front of the camera, as occluder triangles.
+void make_city(std::mt19937& rng, std::vector<math::vec3>& positions, std::vector<uint32_t>& indices)
+{
+    std::uniform_real_distribution<float> height(4.0f, 30.0f);
+    for (float z = -12.0f; z > -200.0f; z -= 12.0f) {
+        for (float x = -96.0f; x <= 96.0f; x += 12.0f) {
+            append_box(make_box(x - 4.0f, 0.0f, z - 4.0f, x + 4.0f, height(rng), z + 4.0f), positions, indices);
+        }
+    }
+}
+
+std::vector<math::aabb> make_instances(std::mt19937& rng, size_t count)
+{
+    std::uniform_real_distribution<float> x(-100.0f, 100.0f), y(0.0f, 6.0f), z(-200.0f, 10.0f), size(0.3f, 2.0f);
+    std::vector<math::aabb> boxes;
+    for (size_t i = 0; i < count; ++i) {
+        const float cx = x(rng), cy = y(rng), cz = z(rng), s = size(rng);
+        boxes.push_back(make_box(cx - s, cy, cz - s, cx + s, cy + 2.0f * s, cz + s));
+    }
+    return boxes;
+}
+
+void run_tests()
+{
+    std::cout << "=== TESTING occlusion ===" << std::endl
+              << std::endl;
+
+    const math::mat4x4 projection = perspective(1.5f, 2.0f, 1.0f, 300.0f);
+    math::occlusion_buffer buffer;
+    print_test("default size is 256x128 with a full mip chain", buffer.width() == 256 && buffer.height() == 128 && buffer.level_count() == 9 && buffer.level_width(8) == 1 && buffer.level_height(8) == 1);
+
+    // Without occluders everything inside the view volume is visible.
+    std::vector<math::vec3> positions;
+    std::vector<uint32_t> indices;
+    buffer.render_occluders(projection, positions, indices);
+    print_test("no occluders: box in view is visible", buffer.is_visible(projection, make_box(-1, -1, -20, 1, 1, -18)));
+
+    // A wall at z = -10 covering x, y in [-5, 5].
+    append_box(make_box(-5, -5, -10.5f, 5, 5, -10), positions, indices);
+    buffer.render_occluders(projection, positions, indices);
+    std::cout << "--- single boxes ---" << std::endl;
+    print_test("box behind the wall is occluded", !buffer.is_visible(projection, make_box(-1, -1, -30, 1, 1, -20)));
+    print_test("box in front of the wall is visible", buffer.is_visible(projection, make_box(-1, -1, -8, 1, 1, -6)));
+    print_test("box behind the wall but wider than it is visible", buffer.is_visible(projection, make_box(-20, -1, -30, 20, 1, -28)));
+    print_test("box beside the view volume is culled", !buffer.is_visible(projection, make_box(-200, -1, -30, -150, 1, -28)));
+    print_test("box beyond the far plane is culled", !buffer.is_visible(projection, make_box(-1, -1, -400, 1, 1, -350)));
+    print_test("box behind the camera is culled", !buffer.is_visible(projection, make_box(-1, -1, 5, 1, 1, 8)));
+    print_test("box crossing the near plane is visible", buffer.is_visible(projection, make_box(-1, -1, -3, 1, 1, 3)));
+
+    std::cout << "--- mip chain ---" << std::endl;
+    std::mt19937 rng(49);
+    positions.clear();
+    indices.clear();
+    make_city(rng, positions, indices);
+    math::occlusion_buffer odd(203, 77);
+    const math::mat4x4 view_projection = projection * math::mat4x4::translation(0.0f, -2.0f, 0.0f);
+    odd.render_occluders(view_projection, positions, indices);
+    bool chain = true;
+    float overall = 0.0f;
+    for (int y = 0; y < odd.height(); ++y) {
+        for (int x = 0; x < odd.width(); ++x) {
+            overall = std::max(overall, odd.depth(0, x, y));
+        }
+    }
+    for (int level = 1; level < odd.level_count(); ++level) {
+        chain &= odd.level_width(level) == (odd.level_width(level - 1) + 1) / 2 && odd.level_height(level) == (odd.level_height(level - 1) + 1) / 2;
+        for (int y = 0; y < odd.level_height(level); ++y) {
+            for (int x = 0; x < odd.level_width(level); ++x) {
+                float expected = 0.0f;
+                for (int dy = 0; dy < 2; ++dy) {
+                    for (int dx = 0; dx < 2; ++dx) {
+                        const int sx = std::min(2 * x + dx, odd.level_width(level - 1) - 1);
+                        const int sy = std::min(2 * y + dy, odd.level_height(level - 1) - 1);
+                        expected = std::max(expected, odd.depth(level - 1, sx, sy));
+                    }
+                }
+                chain &= odd.depth(level, x, y) == expected;
+            }
+        }
+    }
+    print_test("every texel is the farthest of its 2x2 children (odd size)", chain);
+    print_test("top level is the farthest depth", odd.depth(odd.level_count() - 1, 0, 0) == overall);
+
+    std::cout << "--- batches ---" << std::endl;
+    math::occlusion_buffer city;
+    city.render_occluders(view_projection, positions, indices);
+    const std::vector<math::aabb> boxes = make_instances(rng, 400);
+    std::vector<uint8_t> single(boxes.size()), multi(boxes.size());
+    city.test_aabbs(view_projection, boxes, single, 1);
+    city.test_aabbs(view_projection, boxes, multi, 4);
+    bool same = single == multi;
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        same &= (single[i] != 0) == city.is_visible(view_projection, boxes[i]);
+    }
+    print_test("test_aabbs matches is_visible, any thread count", same);
+
+    // Ground truth: render the occluders and each box with triangle IDs at the same resolution.
+    // A culled box must not win a single pixel.
+    size_t culled = 0, wrongly_culled = 0;
+    const uint32_t occluder_triangles = static_cast<uint32_t>(indices.size() / 3);
+    math::raster_target target(city.width(), city.height());
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        if (single[i]) {
+            continue;
+        }
+        ++culled;
+        std::vector<math::vec3> scene = positions;
+        std::vector<uint32_t> scene_indices = indices;
+        append_box(boxes[i], scene, scene_indices);
+        target.clear();
+        math::rasterize(view_projection, scene, scene_indices, target);
+        for (uint32_t id : target.id_buffer()) {
+            if (id != math::raster_target::no_triangle && id >= occluder_triangles) {
+                ++wrongly_culled;
+                break;
+            }
+        }
+    }
+    print_test("culled boxes are hidden in a full render", culled > 100 && wrongly_culled == 0);
+
+    std::cout << "--- errors ---" << std::endl;
+    bool threw = false;
+    try {
+        math::occlusion_buffer bad(0, 128);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    print_test("non-positive size throws", threw);
+    threw = false;
+    try {
+        std::vector<uint8_t> small(boxes.size() - 1);
+        city.test_aabbs(view_projection, boxes, small);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    print_test("short output throws", threw);
+
+    std::cout << std::endl;
+}
+
+template <typename Fn>
+double time_ms(int repeats, Fn&& fn)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        fn();
+        asm volatile("" : : : "memory");
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / repeats;
+}
+
+void run_speed_tests(size_t instance_count, int repeats)
+{
+    std::mt19937 rng(5);
+    std::vector<math::vec3> positions;
+    std::vector<uint32_t> indices;
+    make_city(rng, positions, indices);
+    const std::vector<math::aabb> boxes = make_instances(rng, instance_count);
+    std::vector<uint8_t> visible(boxes.size());
+    const math::mat4x4 view_projection = perspective(1.5f, 2.0f, 1.0f, 300.0f) * math::mat4x4::translation(0.0f, -2.0f, 0.0f);
+
+    std::cout << "=== SPEED TESTS (" << indices.size() / 3 << " occluder triangles, " << instance_count << " instances, mean of " << repeats << ") ===" << std::endl
+              << std::endl;
+
+    math::occlusion_buffer buffer;
+    const unsigned max_threads = math::parallel::default_thread_count();
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        const double render = time_ms(repeats, [&] { buffer.render_occluders(view_projection, positions, indices, threads); });
+        const double test = time_ms(repeats, [&] { buffer.test_aabbs(view_projection, boxes, visible, threads); });
+        std::cout << std::setw(2) << threads << " threads: render_occluders" << std::setw(9) << render << " ms, test_aabbs" << std::setw(9) << test << " ms ("
+                  << std::setw(8) << (instance_count / test / 1000.0) << " M boxes/s)" << std::endl;
+    }
+    size_t culled = std::count(visible.begin(), visible.end(), 0);
+    std::cout << "culled " << culled << " of " << instance_count << " instances" << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    size_t instances = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    int repeats = argc > 2 ? std::atoi(argv[2]) : 20;
+    run_tests();
+    run_speed_tests(instances, repeats);
+    return 0;
+}
@@ -0,0 +1,163 @@
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "../ordered_mat4x4/ordered_mat4x4.hpp"
+
+void print_test(const char* name, bool passed)
+{
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << name << std::endl;
+}
+
+bool approx_equal(float a, float b, float epsilon = 0.0001f)
+{
+    return std::abs(a - b) < epsilon;
+}
+
+template <typename M>
+bool same(const M& a, const math::mat4x4& b, float epsilon = 0.0001f)
+{
+    for (int r = 0; r < 4; ++r) {
+        for (int c = 0; c < 4; ++c) {
+            if (!approx_equal(a.at(r, c), b.at(r, c), epsilon)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool same(const math::vec4& a, const math::vec4& b)
+{
+    return approx_equal(a.x(), b.x()) && approx_equal(a.y(), b.y()) && approx_equal(a.z(), b.z()) && approx_equal(a.w(), b.w());
+}
+
+math::mat4x4 random_matrix(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    math::mat4x4 m;
+    for (int r = 0; r < 4; ++r) {
+        for (int c = 0; c < 4; ++c) {
+            m.at(r, c) = unit(rng);
+        }
+    }
+    return m;
+}
+
+template <math::storage_order Order>
+void test_order(const char* label)
+{
+    using M = math::basic_mat4x4<Order>;
+    std::cout << "--- " << label << " ---" << std::endl;
+    std::mt19937 rng(47);
+
+    math::mat4x4 a = random_matrix(rng), b = random_matrix(rng);
+    M ma(a), mb(b);
+    print_test("construct from mat4x4 keeps elements", same(ma, a));
+    print_test("to_mat4x4 round trip is exact", std::memcmp(ma.to_mat4x4().data(), a.data(), 64) == 0);
+    print_test("operator* (matrix)", same(ma * mb, a * b));
+    M product = ma;
+    product *= mb;
+    print_test("operator*=", same(product, a * b));
+    print_test("operator+ / operator-", same(ma + mb, a + b) && same(ma - mb, a - b));
+    print_test("operator* (scalar)", same(ma * 2.5f, a * 2.5f));
+    math::vec4 v(0.3f, -1.2f, 2.0f, 1.0f);
+    print_test("operator* (vec4)", same(ma * v, a * v));
+    print_test("transpose", same(ma.transpose(), a.transpose()));
+
+    print_test("identity / zero", same(M::identity(), math::mat4x4::identity()) && same(M::zero(), math::mat4x4::zero()));
+    print_test("translation", same(M::translation(1.0f, -2.0f, 3.0f), math::mat4x4::translation(1.0f, -2.0f, 3.0f)));
+    print_test("scaling", same(M::scaling(2.0f, 3.0f, 4.0f), math::mat4x4::scaling(2.0f, 3.0f, 4.0f)));
+    print_test("rotation_x / y / z", same(M::rotation_x(0.4f), math::mat4x4::rotation_x(0.4f)) && same(M::rotation_y(0.4f), math::mat4x4::rotation_y(0.4f)) && same(M::rotation_z(0.4f), math::mat4x4::rotation_z(0.4f)));
+    M model = M::translation(1.0f, 2.0f, 3.0f) * M::rotation_y(0.7f) * M::scaling(2.0f, 2.0f, 2.0f);
+    math::mat4x4 reference = math::mat4x4::translation(1.0f, 2.0f, 3.0f) * math::mat4x4::rotation_y(0.7f) * math::mat4x4::scaling(2.0f, 2.0f, 2.0f);
+    print_test("composed model matrix", same(model, reference) && same(model * v, reference * v));
+
+    float elements[4][4] = { { 1, 2, 3, 4 }, { 5, 6, 7, 8 }, { 9, 10, 11, 12 }, { 13, 14, 15, 16 } };
+    M e(elements);
+    bool layout = e.at(1, 2) == 7.0f;
+    // data() is in storage order: element (0, 1) is the second float for row-major only.
+    layout &= e.data()[1] == (Order == math::storage_order::row_major ? 2.0f : 5.0f);
+    print_test("at(row, col) and data() storage order", layout);
+    print_test("32-byte aligned", reinterpret_cast<std::uintptr_t>(e.data()) % 32 == 0);
+
+    // Like mat4x4, only the const overload checks its indices.
+    const M& checked = e;
+    auto out_of_range = [&](int row, int col) {
+        try {
+            static_cast<void>(checked.at(row, col));
+        } catch (const std::out_of_range&) {
+            return true;
+        }
+        return false;
+    };
+    print_test("const at() throws std::out_of_range", out_of_range(4, 0) && out_of_range(-1, 2) && out_of_range(0, 4) && out_of_range(3, -1) && !out_of_range(3, 3));
+}
+
+void run_tests()
+{
+    std::cout << "=== TESTING ordered mat4x4 (simd backend: " << math::simd::backend_name << ") ===" << std::endl
+              << std::endl;
+
+    test_order<math::storage_order::row_major>("row-major");
+    test_order<math::storage_order::column_major>("column-major");
+
+    std::cout << "--- conversions ---" << std::endl;
+    std::mt19937 rng(1);
+    math::mat4x4 a = random_matrix(rng);
+    math::row_major_mat4x4 rm(a);
+    math::column_major_mat4x4 cm(rm);
+    print_test("row-major data() equals mat4x4 bytes", std::memcmp(rm.data(), a.data(), 64) == 0);
+    print_test("column-major data() equals transpose() bytes", std::memcmp(cm.data(), a.transpose().data(), 64) == 0);
+    print_test("row-major -> column-major keeps elements", same(cm, a));
+    print_test("column-major -> row-major round trip", std::memcmp(math::row_major_mat4x4(cm).data(), a.data(), 64) == 0);
+
+    std::cout << std::endl;
+}
+
+void run_speed_tests(size_t count, int repeats)
+{
+    std::cout << "=== SPEED TESTS (" << count << " matrices x " << repeats << ", simd backend: " << math::simd::backend_name << ") ===" << std::endl
+              << std::endl;
+
+    std::mt19937 rng(3);
+    std::vector<math::mat4x4> a(count), b(count), out(count);
+    std::vector<math::row_major_mat4x4> ra, rb, r_out(count);
+    std::vector<math::column_major_mat4x4> ca, cb, c_out(count);
+    std::vector<math::vec4> v(count), vout(count);
+    for (size_t i = 0; i < count; ++i) {
+        a[i] = random_matrix(rng);
+        b[i] = random_matrix(rng);
+        ra.emplace_back(a[i]);
+        rb.emplace_back(b[i]);
+        ca.emplace_back(a[i]);
+        cb.emplace_back(b[i]);
+        v[i] = math::vec4(a[i].at(0, 0), a[i].at(1, 1), a[i].at(2, 2), 1.0f);
+    }
+
+    report("mat4x4 product:                    ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) out[i] = a[i] * b[i]; });
+    report("row_major_mat4x4 product:          ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) r_out[i] = ra[i] * rb[i]; });
+    report("column_major_mat4x4 product:       ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) c_out[i] = ca[i] * cb[i]; });
+    report("mat4x4 * vec4:                     ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) vout[i] = a[i] * v[i]; });
+    report("row_major_mat4x4 * vec4:           ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) vout[i] = ra[i] * v[i]; });
+    report("column_major_mat4x4 * vec4:        ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) vout[i] = ca[i] * v[i]; });
+    // Handing a product to a column-major consumer.
+    report("mat4x4 product + transpose():      ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) out[i] = (a[i] * b[i]).transpose(); });
+    report("column_major_mat4x4 product:       ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) c_out[i] = ca[i] * cb[i]; });
+
+    std::cout << "(checksum " << out[0].at(0, 0) + r_out[0].at(1, 1) + c_out[0].at(2, 2) + vout[0].x() << ")" << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 16384;
+    int repeats = argc > 2 ? std::atoi(argv[2]) : 500;
+    run_tests();
+    run_speed_tests(count, repeats);
+    return 0;
+}
@@ -0,0 +1,284 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "../orthonormalize/orthonormalize.hpp"
+
+void print_test(const char* name, bool passed)
+{
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << name << std::endl;
+}
+
+bool approx_equal(float a, float b, float epsilon = 0.0001f)
+{
+    return std::abs(a - b) < epsilon;
+}
+
+bool linear_approx_equal(const math::mat3x3& a, const math::mat4x4& b, float epsilon = 0.0001f)
+{
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 3; ++c) {
+            if (!approx_equal(a.at(r, c), b.at(r, c), epsilon)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool mat3_approx_equal(const math::mat3x3& a, const math::mat3x3& b, float epsilon = 0.0001f)
+{
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 3; ++c) {
+            if (!approx_equal(a.at(r, c), b.at(r, c), epsilon)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+math::mat4x4 random_rotation(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> angle(-3.0f, 3.0f);
+    return math::mat4x4::rotation_z(angle(rng)) * math::mat4x4::rotation_y(angle(rng)) * math::mat4x4::rotation_x(angle(rng));
+}
+
+// A rotation accumulated from many small incremental steps, as a simulation would produce.
+math::mat4x4 drifted_rotation(std::mt19937& rng, int steps)
+{
+    std::uniform_real_distribution<float> angle(-0.05f, 0.05f);
+    math::mat4x4 m = math::mat4x4::translation(1.0f, 2.0f, 3.0f);
+    for (int i = 0; i < steps; ++i) {
+        m *= math::mat4x4::rotation_x(angle(rng)) * math::mat4x4::rotation_y(angle(rng));
+    }
+    return m;
+}
+
+void run_tests()
+{
+    std::cout << "=== TESTING orthonormalize ===" << std::endl
+              << std::endl;
+
+    std::mt19937 rng(11);
+    // 19 matrices: two SIMD batches plus a scalar tail.
+    std::vector<math::mat4x4> drifted;
+    for (int i = 0; i < 19; ++i) {
+        drifted.push_back(drifted_rotation(rng, 2000));
+    }
+    std::vector<float> errors(drifted.size());
+    math::orthonormality_error(drifted, errors);
+    bool drift_detected = true;
+    for (float e : errors) {
+        drift_detected = drift_detected && e > 1e-6f && e < 1e-2f;
+    }
+    print_test("accumulated drift is measured", drift_detected);
+
+    std::vector<math::mat4x4> exact = { math::mat4x4::identity(), random_rotation(rng) };
+    std::vector<float> exact_errors(exact.size());
+    math::orthonormality_error(exact, exact_errors);
+    print_test("rotation has no error", exact_errors[0] == 0.0f && exact_errors[1] < 1e-6f);
+
+    std::vector<math::mat4x4> fixed = drifted;
+    math::orthonormalize(fixed);
+    math::orthonormality_error(fixed, errors);
+    bool repaired = true;
+    bool close = true;
+    bool translation_kept = true;
+    for (size_t i = 0; i < fixed.size(); ++i) {
+        repaired = repaired && errors[i] < 1e-6f && fixed[i].determinant() > 0.0f;
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) {
+                close = close && approx_equal(fixed[i].at(r, c), drifted[i].at(r, c), 1e-2f);
+            }
+            translation_kept = translation_kept && fixed[i].at(r, 3) == drifted[i].at(r, 3);
+        }
+    }
+    print_test("orthonormalize removes drift", repaired);
+    print_test("orthonormalize stays close", close);
+    print_test("translation untouched", translation_kept);
+
+    std::vector<math::mat4x4> scaled = { math::mat4x4::scaling(2.0f, 0.5f, 3.0f) };
+    math::orthonormalize(scaled);
+    print_test("scale is removed", linear_approx_equal(math::mat3x3::identity(), scaled[0]));
+
+    std::vector<math::mat4x4> gated = drifted;
+    gated[3] = random_rotation(rng);
+    gated[12] = random_rotation(rng);
+    const math::mat4x4 untouched = gated[3];
+    std::vector<float> gated_errors(gated.size());
+    math::orthonormality_error(gated, gated_errors);
+    float threshold = 1e-6f;
+    size_t expected_changed = 0;
+    for (float e : gated_errors) {
+        expected_changed += e > threshold;
+    }
+    size_t changed = math::orthonormalize_drifted(gated, threshold);
+    bool gated_ok = changed == expected_changed;
+    for (int r = 0; r < 4; ++r) {
+        for (int c = 0; c < 4; ++c) {
+            gated_ok = gated_ok && gated[3].at(r, c) == untouched.at(r, c);
+        }
+    }
+    math::orthonormality_error(gated, gated_errors);
+    for (float e : gated_errors) {
+        gated_ok = gated_ok && e <= threshold;
+    }
+    print_test("orthonormalize_drifted fixes only drifted", gated_ok && changed >= 17);
+
+    // Polar decomposition of R * S with a known symmetric positive definite S.
+    std::vector<math::mat4x4> composed;
+    std::vector<math::mat3x3> expected_r, expected_s;
+    for (int i = 0; i < 11; ++i) {
+        math::mat4x4 r = random_rotation(rng);
+        math::mat4x4 q = random_rotation(rng);
+        float d[3] = { 0.5f + i * 0.1f, 2.0f, 1.0f + i * 0.05f };
+        // S = Q * D * Q^T
+        math::mat4x4 s = q * math::mat4x4::scaling(d[0], d[1], d[2]) * q.transpose();
+        composed.push_back(math::mat4x4::translation(5.0f, 0.0f, -1.0f) * r * s);
+        float rr[3][3], ss[3][3];
+        for (int a = 0; a < 3; ++a) {
+            for (int b = 0; b < 3; ++b) {
+                rr[a][b] = r.at(a, b);
+                ss[a][b] = s.at(a, b);
+            }
+        }
+        expected_r.emplace_back(rr);
+        expected_s.emplace_back(ss);
+    }
+    std::vector<math::mat3x3> rotations(composed.size()), stretches(composed.size());
+    math::polar_decompose(composed, rotations, stretches);
+    bool polar_r = true, polar_s = true;
+    for (size_t i = 0; i < composed.size(); ++i) {
+        polar_r = polar_r && mat3_approx_equal(rotations[i], expected_r[i], 1e-4f);
+        polar_s = polar_s && mat3_approx_equal(stretches[i], expected_s[i], 1e-4f);
+    }
+    print_test("polar rotation of R * S", polar_r);
+    print_test("polar stretch of R * S", polar_s);
+
+    // A sheared matrix: R must be orthonormal and R * S must reproduce the input.
+    std::vector<math::mat4x4> sheared = { math::mat4x4({ { { 1.0f, 0.8f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.3f, 0.0f }, { 0.2f, 0.0f, 1.5f, 0.0f }, { 0.0f, 0.0f, 0.0f, 1.0f } } }) };
+    std::vector<math::mat3x3> sheared_r(1), sheared_s(1);
+    math::polar_decompose(sheared, sheared_r, sheared_s);
+    math::mat3x3 rt = sheared_r[0].transpose();
+    bool orthonormal = true, reproduced = true;
+    for (int a = 0; a < 3; ++a) {
+        for (int b = 0; b < 3; ++b) {
+            float dot = 0.0f, product = 0.0f;
+            for (int k = 0; k < 3; ++k) {
+                dot += rt.at(a, k) * sheared_r[0].at(k, b);
+                product += sheared_r[0].at(a, k) * sheared_s[0].at(k, b);
+            }
+            orthonormal = orthonormal && approx_equal(dot, a == b ? 1.0f : 0.0f);
+            reproduced = reproduced && approx_equal(product, sheared[0].at(a, b));
+        }
+    }
+    print_test("sheared polar rotation is orthonormal", orthonormal && sheared_r[0].determinant() > 0.0);
+    print_test("sheared polar reproduces input", reproduced);
+
+    std::vector<math::mat3x3> rotations_only(drifted.size());
+    math::polar_decompose(drifted, rotations_only, {});
+    bool matches_drifted = true;
+    for (size_t i = 0; i < drifted.size(); ++i) {
+        matches_drifted = matches_drifted && linear_approx_equal(rotations_only[i], fixed[i], 1e-3f);
+    }
+    print_test("polar and Gram-Schmidt agree on drift", matches_drifted);
+
+    bool threw = false;
+    std::vector<math::mat4x4> singular = { math::mat4x4::scaling(1.0f, 0.0f, 1.0f) };
+    std::vector<math::mat3x3> singular_r(1);
+    try {
+        math::polar_decompose(singular, singular_r, {});
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    print_test("singular matrix throws", threw);
+
+    // Well conditioned but small: det 8e-9, below any absolute threshold. Nine copies cover
+    // the batched and the single-matrix path.
+    std::vector<math::mat4x4> small(9, math::mat4x4::rotation_z(0.3f) * math::mat4x4::scaling(0.002f, 0.002f, 0.002f));
+    std::vector<math::mat3x3> small_r(small.size()), small_s(small.size());
+    bool small_ok = true;
+    try {
+        math::polar_decompose(small, small_r, small_s);
+        math::mat4x4 expected = math::mat4x4::rotation_z(0.3f);
+        for (size_t i = 0; i < small.size(); ++i) {
+            for (int a = 0; a < 3; ++a) {
+                for (int b = 0; b < 3; ++b) {
+                    small_ok = small_ok && approx_equal(small_r[i].at(a, b), expected.at(a, b));
+                    small_ok = small_ok && std::abs(small_s[i].at(a, b) - (a == b ? 0.002f : 0.0f)) < 1e-6f;
+                }
+            }
+        }
+    } catch (const std::runtime_error&) {
+        small_ok = false;
+    }
+    print_test("small uniform scale is not singular", small_ok);
+
+    std::cout << std::endl;
+}
+
+void run_speed_tests(size_t count, float drifted_fraction)
+{
+    std::cout << "=== SPEED TESTS (" << count << " matrices, " << drifted_fraction * 100.0f << "% drifted) ===" << std::endl
+              << std::endl;
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<math::mat4x4> base(count);
+    for (size_t i = 0; i < count; ++i) {
+        base[i] = random_rotation(rng);
+        if (unit(rng) < drifted_fraction) {
+            base[i] *= math::mat4x4::scaling(1.001f, 1.0f, 0.999f);
+        }
+    }
+    std::vector<math::mat4x4> matrices = base;
+    std::vector<float> errors(count);
+    std::vector<math::mat3x3> rotations(count), stretches(count);
+    const double total = static_cast<double>(count);
+    const float threshold = 1e-4f;
+
+    auto report = [&](const char* name, auto&& fn) {
+        matrices = base;
+        auto start = std::chrono::high_resolution_clock::now();
+        fn();
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> duration = end - start;
+        std::cout << name << std::setw(10) << duration.count() << " ms (" << std::setw(8)
+                  << (total / duration.count() / 1000.0) << " M matrices/s)" << std::endl;
+    };
+
+    report("orthonormality_error:       ", [&] { math::orthonormality_error(matrices, errors); });
+    report("scalar Gram-Schmidt:        ", [&] {
+        for (math::mat4x4& m : matrices) {
+            math::vec3 x(m.at(0, 0), m.at(1, 0), m.at(2, 0));
+            math::vec3 y(m.at(0, 1), m.at(1, 1), m.at(2, 1));
+            x.normalize();
+            y = (y - x * x.dot_production(y)).normalized();
+            math::vec3 z = x.cross_production(y);
+            m.at(0, 0) = x.x(), m.at(1, 0) = x.y(), m.at(2, 0) = x.z();
+            m.at(0, 1) = y.x(), m.at(1, 1) = y.y(), m.at(2, 1) = y.z();
+            m.at(0, 2) = z.x(), m.at(1, 2) = z.y(), m.at(2, 2) = z.z();
+        }
+    });
+    report("orthonormalize (always):    ", [&] { math::orthonormalize(matrices); });
+    size_t changed = 0;
+    report("orthonormalize_drifted:     ", [&] { changed = math::orthonormalize_drifted(matrices, threshold); });
+    report("polar_decompose (R only):   ", [&] { math::polar_decompose(matrices, rotations, {}); });
+    report("polar_decompose (R and S):  ", [&] { math::polar_decompose(matrices, rotations, stretches); });
+    std::cout << "drifted matrices fixed: " << changed << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    float drifted = argc > 2 ? std::strtof(argv[2], nullptr) : 0.05f;
+    run_tests();
+    run_speed_tests(count, drifted);
+    return 0;
+}
@@ -0,0 +1,258 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../predicates/predicates.hpp"
+
+void print_test(const char* name, bool passed)
+{
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << name << std::endl;
+}
+
+// Exact references in 128-bit integers for coordinates that are multiples of 2^-shift.
+using wide = __int128;
+
+wide fixed(float v, int shift)
+{
+    return static_cast<wide>(std::ldexp(static_cast<double>(v), shift));
+}
+
+int sign(wide v)
+{
+    return v > 0 ? 1 : (v < 0 ? -1 : 0);
+}
+
+int orient2d_reference(const math::vec2& a, const math::vec2& b, const math::vec2& c, int shift)
+{
+    wide acx = fixed(a.x(), shift) - fixed(c.x(), shift), acy = fixed(a.y(), shift) - fixed(c.y(), shift);
+    wide bcx = fixed(b.x(), shift) - fixed(c.x(), shift), bcy = fixed(b.y(), shift) - fixed(c.y(), shift);
+    return sign(acx * bcy - acy * bcx);
+}
+
+int orient3d_reference(const math::vec3& a, const math::vec3& b, const math::vec3& c, const math::vec3& d, int shift)
+{
+    wide ad[3] = { fixed(a.x(), shift) - fixed(d.x(), shift), fixed(a.y(), shift) - fixed(d.y(), shift), fixed(a.z(), shift) - fixed(d.z(), shift) };
+    wide bd[3] = { fixed(b.x(), shift) - fixed(d.x(), shift), fixed(b.y(), shift) - fixed(d.y(), shift), fixed(b.z(), shift) - fixed(d.z(), shift) };
+    wide cd[3] = { fixed(c.x(), shift) - fixed(d.x(), shift), fixed(c.y(), shift) - fixed(d.y(), shift), fixed(c.z(), shift) - fixed(d.z(), shift) };
+    return sign(ad[2] * (bd[0] * cd[1] - cd[0] * bd[1]) + bd[2] * (cd[0] * ad[1] - ad[0] * cd[1]) + cd[2] * (ad[0] * bd[1] - bd[0] * ad[1]));
+}
+
+int incircle_reference(const math::vec2& a, const math::vec2& b, const math::vec2& c, const math::vec2& d, int shift)
+{
+    wide adx = fixed(a.x(), shift) - fixed(d.x(), shift), ady = fixed(a.y(), shift) - fixed(d.y(), shift);
+    wide bdx = fixed(b.x(), shift) - fixed(d.x(), shift), bdy = fixed(b.y(), shift) - fixed(d.y(), shift);
+    wide cdx = fixed(c.x(), shift) - fixed(d.x(), shift), cdy = fixed(c.y(), shift) - fixed(d.y(), shift);
+    wide alift = adx * adx + ady * ady, blift = bdx * bdx + bdy * bdy, clift = cdx * cdx + cdy * cdy;
+    return sign(alift * (bdx * cdy - cdx * bdy) + blift * (cdx * ady - adx * cdy) + clift * (adx * bdy - bdx * ady));
+}
+
+int insphere_reference(const math::vec3* p, const math::vec3& e, int shift)
+{
+    wide d[4][4];
+    for (int r = 0; r < 4; ++r) {
+        d[r][0] = fixed(p[r].x(), shift) - fixed(e.x(), shift);
+        d[r][1] = fixed(p[r].y(), shift) - fixed(e.y(), shift);
+        d[r][2] = fixed(p[r].z(), shift) - fixed(e.z(), shift);
+        d[r][3] = d[r][0] * d[r][0] + d[r][1] * d[r][1] + d[r][2] * d[r][2];
+    }
+    // Laplace expansion along the lift column.
+    wide det = 0;
+    for (int r = 0; r < 4; ++r) {
+        int rows[3], n = 0;
+        for (int k = 0; k < 4; ++k) {
+            if (k != r) {
+                rows[n++] = k;
+            }
+        }
+        const wide* x = d[rows[0]];
+        const wide* y = d[rows[1]];
+        const wide* z = d[rows[2]];
+        wide minor = x[0] * (y[1] * z[2] - y[2] * z[1]) - x[1] * (y[0] * z[2] - y[2] * z[0]) + x[2] * (y[0] * z[1] - y[1] * z[0]);
+        det += ((r + 3) % 2 == 0 ? 1 : -1) * d[r][3] * minor;
+    }
+    return sign(det);
+}
+
+void run_tests()
+{
+    std::cout << "=== TESTING predicates ===" << std::endl
+              << std::endl;
+
+    print_test("orient2d basic", math::orient2d(math::vec2(0, 0), math::vec2(1, 0), math::vec2(0, 1)) == 1 && math::orient2d(math::vec2(0, 0), math::vec2(0, 1), math::vec2(1, 0)) == -1 && math::orient2d(math::vec2(0, 0), math::vec2(1, 1), math::vec2(3, 3)) == 0);
+    print_test("orient3d basic", math::orient3d(math::vec3(0, 0, 0), math::vec3(1, 0, 0), math::vec3(0, 1, 0), math::vec3(0, 0, -1)) == 1 && math::orient3d(math::vec3(0, 0, 0), math::vec3(1, 0, 0), math::vec3(0, 1, 0), math::vec3(0, 0, 1)) == -1 && math::orient3d(math::vec3(0, 0, 0), math::vec3(1, 0, 0), math::vec3(0, 1, 0), math::vec3(5, 7, 0)) == 0);
+    print_test("incircle basic", math::incircle(math::vec2(0, 0), math::vec2(1, 0), math::vec2(0, 1), math::vec2(0.5f, 0.5f)) == 1 && math::incircle(math::vec2(0, 0), math::vec2(1, 0), math::vec2(0, 1), math::vec2(2, 2)) == -1 && math::incircle(math::vec2(0, 0), math::vec2(1, 0), math::vec2(0, 1), math::vec2(1, 1)) == 0);
+    math::vec3 tet[4] = { math::vec3(0, 0, 0), math::vec3(1, 0, 0), math::vec3(0, 1, 0), math::vec3(0, 0, -1) };
+    print_test("insphere basic", math::insphere(tet[0], tet[1], tet[2], tet[3], math::vec3(0.2f, 0.2f, -0.2f)) == 1 && math::insphere(tet[0], tet[1], tet[2], tet[3], math::vec3(3, 3, 3)) == -1 && math::insphere(tet[0], tet[1], tet[2], tet[3], math::vec3(1, 1, -1)) == 0);
+
+    // Shewchuk's near-degenerate orient2d grid: a sweeps 64x64 ulps around (0.5, 0.5)
+    // against the line through (12, 12) and (24, 24).
+    const float ulp = std::ldexp(1.0f, -24);
+    math::vec2 b(12.0f, 12.0f), c(24.0f, 24.0f);
+    std::vector<math::vec2> grid;
+    for (int i = 0; i < 64; ++i) {
+        for (int j = 0; j < 64; ++j) {
+            grid.emplace_back(0.5f + i * ulp, 0.5f + j * ulp);
+        }
+    }
+    int wrong = 0, naive_wrong = 0;
+    for (const math::vec2& a : grid) {
+        int expected = orient2d_reference(a, b, c, 24);
+        wrong += math::orient2d(a, b, c) != expected;
+        float naive = (a.x() - c.x()) * (b.y() - c.y()) - (a.y() - c.y()) * (b.x() - c.x());
+        naive_wrong += (naive > 0 ? 1 : (naive < 0 ? -1 : 0)) != expected;
+    }
+    std::cout << "  naive float orient2d wrong on " << naive_wrong << " / " << grid.size() << " grid points" << std::endl;
+    print_test("orient2d exact on near-degenerate grid", wrong == 0);
+
+    std::vector<int> batch(grid.size());
+    math::orient2d(b, c, grid, batch);
+    bool batch_ok = true;
+    for (size_t i = 0; i < grid.size(); ++i) {
+        batch_ok = batch_ok && batch[i] == orient2d_reference(b, c, grid[i], 24);
+    }
+    print_test("orient2d batch on near-degenerate grid", batch_ok);
+
+    // Nearly coplanar / cocircular / cospherical points, perturbed by a few ulps.
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> coord(-1 << 12, 1 << 12), nudge(-2, 2);
+    auto on_grid = [&](int shift) { return std::ldexp(static_cast<float>(coord(rng)), -shift); };
+    bool o3_ok = true, o3_batch_ok = true;
+    for (int t = 0; t < 200; ++t) {
+        math::vec3 a(on_grid(8), on_grid(8), 0), bb(on_grid(8), on_grid(8), 0), cc(on_grid(8), on_grid(8), 0);
+        auto plane = [](math::vec3 v) { v.z(v.x() * 0.375f + v.y() * 1.25f); return v; };
+        a = plane(a);
+        bb = plane(bb);
+        cc = plane(cc);
+        std::vector<math::vec3> points;
+        for (int k = 0; k < 19; ++k) {
+            math::vec3 d = plane(math::vec3(on_grid(8), on_grid(8), 0));
+            d.z(d.z() + nudge(rng) * std::ldexp(1.0f, -24));
+            points.push_back(d);
+            o3_ok = o3_ok && math::orient3d(a, bb, cc, d) == orient3d_reference(a, bb, cc, d, 24);
+        }
+        std::vector<int> signs(points.size());
+        math::orient3d(a, bb, cc, points, signs);
+        for (size_t k = 0; k < points.size(); ++k) {
+            o3_batch_ok = o3_batch_ok && signs[k] == orient3d_reference(a, bb, cc, points[k], 24);
+        }
+    }
+    print_test("orient3d exact on near-coplanar points", o3_ok);
+    print_test("orient3d batch on near-coplanar points", o3_batch_ok);
+
+    bool ic_ok = true, ic_batch_ok = true;
+    math::vec2 ca(-3.0f, 4.0f), cb(5.0f, 0.0f), ccc(3.0f, 4.0f); // on the circle of radius 5
+    std::vector<math::vec2> circle_points;
+    for (int k = 0; k < 203; ++k) {
+        float n = nudge(rng) * std::ldexp(1.0f, -20);
+        math::vec2 d = (k % 2) ? math::vec2(-5.0f + n, 0.0f) : math::vec2(0.0f, 5.0f + n);
+        circle_points.push_back(d);
+        ic_ok = ic_ok && math::incircle(ca, cb, ccc, d) == incircle_reference(ca, cb, ccc, d, 24);
+    }
+    std::vector<int> ic_signs(circle_points.size());
+    math::incircle(ca, cb, ccc, circle_points, ic_signs);
+    for (size_t k = 0; k < circle_points.size(); ++k) {
+        ic_batch_ok = ic_batch_ok && ic_signs[k] == incircle_reference(ca, cb, ccc, circle_points[k], 24);
+    }
+    print_test("incircle exact on near-cocircular points", ic_ok);
+    print_test("incircle batch on near-cocircular points", ic_batch_ok);
+
+    math::vec3 sphere[4] = { math::vec3(1, 0, 0), math::vec3(0, 1, 0), math::vec3(0, 0, 1), math::vec3(-1, 0, 0) };
+    if (math::orient3d(sphere[0], sphere[1], sphere[2], sphere[3]) < 0) {
+        std::swap(sphere[0], sphere[1]);
+    }
+    bool is_ok = true, is_batch_ok = true;
+    std::vector<math::vec3> sphere_points;
+    for (int k = 0; k < 203; ++k) {
+        float n = nudge(rng) * std::ldexp(1.0f, -20);
+        math::vec3 e = (k % 3 == 0) ? math::vec3(0, -1 + n, 0) : (k % 3 == 1 ? math::vec3(0, 0, -1 - n) : math::vec3(0.0f, 0.0f, 1.0f + n));
+        sphere_points.push_back(e);
+        is_ok = is_ok && math::insphere(sphere[0], sphere[1], sphere[2], sphere[3], e) == insphere_reference(sphere, e, 20);
+    }
+    std::vector<int> is_signs(sphere_points.size());
+    math::insphere(sphere[0], sphere[1], sphere[2], sphere[3], sphere_points, is_signs);
+    for (size_t k = 0; k < sphere_points.size(); ++k) {
+        is_batch_ok = is_batch_ok && is_signs[k] == insphere_reference(sphere, sphere_points[k], 20);
+    }
+    print_test("insphere exact on near-cospherical points", is_ok);
+    print_test("insphere batch on near-cospherical points", is_batch_ok);
+
+    std::cout << std::endl;
+}
+
+void run_speed_tests(size_t count)
+{
+    std::cout << "=== SPEED TESTS (" << count << " points) ===" << std::endl
+              << std::endl;
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<math::vec3> points(count);
+    for (math::vec3& p : points) {
+        p = math::vec3(unit(rng), unit(rng), unit(rng));
+    }
+    math::vec3 a(0.1f, -0.2f, 0.05f), b(0.9f, 0.1f, -0.1f), c(-0.3f, 0.8f, 0.2f), d(0.2f, 0.3f, -0.9f);
+    std::vector<int> out(count);
+    long long checksum = 0;
+
+    auto report = [&](const char* name, auto&& body) {
+        auto start = std::chrono::high_resolution_clock::now();
+        body();
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> duration = end - start;
+        std::cout << name << std::setw(10) << duration.count() << " ms ("
+                  << std::setw(8) << (count / duration.count() / 1000.0) << " M ops/s)" << std::endl;
+        for (int s : out) {
+            checksum += s;
+        }
+    };
+
+    report("orient3d naive double:  ", [&] {
+        for (size_t i = 0; i < count; ++i) {
+            double adx = a.x() - points[i].x(), ady = a.y() - points[i].y(), adz = a.z() - points[i].z();
+            double bdx = b.x() - points[i].x(), bdy = b.y() - points[i].y(), bdz = b.z() - points[i].z();
+            double cdx = c.x() - points[i].x(), cdy = c.y() - points[i].y(), cdz = c.z() - points[i].z();
+            double det = adz * (bdx * cdy - cdx * bdy) + bdz * (cdx * ady - adx * cdy) + cdz * (adx * bdy - bdx * ady);
+            out[i] = det > 0 ? 1 : (det < 0 ? -1 : 0);
+        }
+    });
+    report("orient3d scalar:        ", [&] {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = math::orient3d(a, b, c, points[i]);
+        }
+    });
+    report("orient3d batch:         ", [&] { math::orient3d(a, b, c, points, out); });
+    report("insphere scalar:        ", [&] {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = math::insphere(a, b, c, d, points[i]);
+        }
+    });
+    report("insphere batch:         ", [&] { math::insphere(a, b, c, d, points, out); });
+
+    // Every point exactly on the plane: all queries reach the exact stage.
+    std::vector<math::vec3> coplanar(count / 100);
+    for (size_t i = 0; i < coplanar.size(); ++i) {
+        coplanar[i] = math::vec3(static_cast<float>(i % 97), static_cast<float>(i % 89), 0.0f);
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    math::orient3d(math::vec3(0, 0, 0), math::vec3(1, 0, 0), math::vec3(0, 1, 0), coplanar, out);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+    std::cout << "orient3d degenerate:    " << std::setw(10) << duration.count() << " ms ("
+              << std::setw(8) << (coplanar.size() / duration.count() / 1000.0) << " M ops/s)" << std::endl;
+    std::cout << "(checksum " << checksum << ")" << std::endl;
+
+    std::cout << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    run_tests();
+    run_speed_tests(count);
+    return 0;
+}
@@ -0,0 +1,176 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../parallel/parallel_for.hpp"
+#include "../rasterizer/rasterizer.hpp"
+
+void print_test(const char* name, bool passed)
+{
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << name << std::endl;
+}
+
+bool approx_equal(float a, float b, float epsilon = 0.0001f)
+{
+    return std::abs(a - b) < epsilon;
+}
+
+size_t covered_pixels(const math::raster_target& target, uint32_t id)
+{
+    size_t count = 0;
+    for (int y = 0; y < target.height(); ++y) {
+        for (int x = 0; x < target.width(); ++x) {
+            count += target.triangle_id(x, y) == id;
+        }
+    }
+    return count;
+}
+
+void run_tests()
+{
+    std::cout << "=== TESTING rasterizer ===" << std::endl
+              << std::endl;
+
+    // Identity view-projection: positions are NDC directly.
+    math::mat4x4 identity = math::mat4x4::identity();
+    math::raster_target target(64, 64);
+
+    // Counter-clockwise triangle covering the lower-left half of the screen at z = 0.
+    std::vector<math::vec3> positions = {
+        math::vec3(-1.0f, -1.0f, 0.0f), math::vec3(1.0f, -1.0f, 0.0f), math::vec3(-1.0f, 1.0f, 0.0f),
+        math::vec3(1.0f, 1.0f, 0.0f)};
+    std::vector<uint32_t> indices = {0, 1, 2};
+    math::rasterize(identity, positions, indices, target);
+    // The hypotenuse is a right edge, so the top-left rule leaves out the 64 pixel centers on it.
+    print_test("half-screen triangle coverage", covered_pixels(target, 0) == 64 * 63 / 2);
+    print_test("depth is window-space z", approx_equal(target.depth(2, 60), 0.5f));
+    print_test("uncovered pixel keeps clear values",
+               target.triangle_id(60, 2) == math::raster_target::no_triangle && target.depth(60, 2) == 1.0f);
+
+    // Two triangles sharing the diagonal must cover every pixel exactly once.
+    target.clear();
+    indices = {0, 1, 2, 2, 1, 3};
+    math::rasterize(identity, positions, indices, target);
+    size_t first = covered_pixels(target, 0);
+    size_t second = covered_pixels(target, 1);
+    print_test("shared edge is watertight", first + second == 64 * 64);
+
+    // Closer triangle wins regardless of submission order.
+    target.clear();
+    positions = {math::vec3(-1.0f, -1.0f, 0.5f), math::vec3(1.0f, -1.0f, 0.5f), math::vec3(-1.0f, 1.0f, 0.5f),
+                 math::vec3(-1.0f, -1.0f, -0.5f), math::vec3(1.0f, -1.0f, -0.5f), math::vec3(-1.0f, 1.0f, -0.5f)};
+    indices = {3, 4, 5, 0, 1, 2};
+    math::rasterize(identity, positions, indices, target);
+    print_test("depth test keeps nearer triangle", covered_pixels(target, 0) > 0 && covered_pixels(target, 1) == 0);
+    print_test("nearer depth stored", approx_equal(target.depth(2, 60), 0.25f));
+
+    // Clockwise triangle is culled only when requested.
+    target.clear();
+    indices = {0, 2, 1};
+    math::raster_options options;
+    options.cull_back_faces = true;
+    math::rasterize(identity, positions, indices, target, options);
+    print_test("back face culled", covered_pixels(target, 0) == 0);
+    options.cull_back_faces = false;
+    math::rasterize(identity, positions, indices, target, options);
+    print_test("back face drawn without culling", covered_pixels(target, 0) > 0);
+
+    // Triangle crossing the near plane: only the part in front of the eye is drawn.
+    target.clear();
+    // OpenGL-style perspective with near = 1 and far = 10.
+    math::mat4x4 projection({{1.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -11.0f / 9.0f, -20.0f / 9.0f}, {0.0f, 0.0f, -1.0f, 0.0f}});
+    positions = {math::vec3(-1.0f, -1.0f, -2.0f), math::vec3(1.0f, -1.0f, -2.0f), math::vec3(0.0f, 1.0f, 1.0f)};
+    indices = {0, 1, 2};
+    math::rasterize(projection, positions, indices, target);
+    size_t visible = covered_pixels(target, 0);
+    bool in_front = true;
+    for (int y = 0; y < 64; ++y) {
+        for (int x = 0; x < 64; ++x) {
+            in_front = in_front && target.depth(x, y) >= 0.0f && target.depth(x, y) <= 1.0f;
+        }
+    }
+    print_test("near-plane crossing triangle is clipped, not dropped", visible > 0 && visible < 64 * 64 && in_front);
+
+    // Huge triangle far beyond the guard band still fills the screen exactly once.
+    target.clear();
+    positions = {math::vec3(-1000.0f, -1000.0f, 0.0f), math::vec3(1000.0f, -1000.0f, 0.0f), math::vec3(0.0f, 1000.0f, 0.0f)};
+    math::rasterize(identity, positions, indices, target);
+    print_test("guard-band clipped triangle covers the screen", covered_pixels(target, 0) == 64 * 64);
+
+    // Many overlapping triangles: results do not depend on the thread count.
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> coord(-1.0f, 1.0f);
+    positions.clear();
+    indices.clear();
+    for (uint32_t i = 0; i < 3000; ++i) {
+        positions.push_back(math::vec3(coord(rng), coord(rng), coord(rng)));
+        indices.push_back(i);
+    }
+    math::raster_target single(333, 211), multi(333, 211);
+    options = {};
+    options.thread_count = 1;
+    math::rasterize(identity, positions, indices, single, options);
+    options.thread_count = 4;
+    math::rasterize(identity, positions, indices, multi, options);
+    bool same = true;
+    for (size_t i = 0; i < single.id_buffer().size(); ++i) {
+        same = same && single.id_buffer()[i] == multi.id_buffer()[i] && single.depth_buffer()[i] == multi.depth_buffer()[i];
+    }
+    print_test("deterministic across thread counts", same);
+
+    std::cout << std::endl;
+}
+
+void run_speed_tests(size_t triangle_count, int width, int height)
+{
+    std::cout << "=== SPEED TESTS (" << triangle_count << " triangles, " << width << "x" << height << ") ===" << std::endl
+              << std::endl;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> center(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> offset(-0.01f, 0.01f);
+    std::uniform_real_distribution<float> depth(-1.0f, 1.0f);
+    std::vector<math::vec3> positions;
+    std::vector<uint32_t> indices;
+    positions.reserve(triangle_count * 3);
+    indices.reserve(triangle_count * 3);
+    for (size_t t = 0; t < triangle_count; ++t) {
+        float cx = center(rng), cy = center(rng), z = depth(rng);
+        for (int v = 0; v < 3; ++v) {
+            indices.push_back(static_cast<uint32_t>(positions.size()));
+            positions.push_back(math::vec3(cx + offset(rng), cy + offset(rng), z));
+        }
+    }
+
+    math::mat4x4 identity = math::mat4x4::identity();
+    math::raster_target target(width, height);
+    unsigned max_threads = math::parallel::default_thread_count();
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        math::raster_options options;
+        options.thread_count = threads;
+        target.clear();
+        auto start = std::chrono::high_resolution_clock::now();
+        math::rasterize(identity, positions, indices, target, options);
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> duration = end - start;
+        std::cout << "rasterize, " << std::setw(2) << threads << " threads:" << std::setw(10) << duration.count() << " ms ("
+                  << std::setw(8) << (triangle_count / duration.count() / 1000.0) << " M tris/s)" << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    size_t triangles = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    int width = argc > 2 ? std::atoi(argv[2]) : 1920;
+    int height = argc > 3 ? std::atoi(argv[3]) : 1080;
+    run_tests();
+    run_speed_tests(triangles, width, height);
+    return 0;
+}
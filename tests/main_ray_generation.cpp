@@ -0,0 +1,192 @@
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "../parallel/parallel_for.hpp"
+#include "../ray_generation/ray_generation.hpp"
+#include "../simd/simd.hpp"
+
+void print_test(const char* name, bool passed)
+{
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << name << std::endl;
+}
+
+bool approx_equal(float a, float b, float epsilon = 0.0001f)
+{
+    return std::abs(a - b) < epsilon;
+}
+
+bool same(const math::vec3& a, const math::vec3& b, float epsilon = 0.0001f)
+{
+    return approx_equal(a.x(), b.x(), epsilon) && approx_equal(a.y(), b.y(), epsilon) && approx_equal(a.z(), b.z(), epsilon);
+}
+
+// OpenGL-style perspective looking down -z.
+math::mat4x4 perspective(float focal, float aspect, float near, float far)
+{
+    float elements[4][4] = { { focal / aspect, 0.0f, 0.0f, 0.0f }, { 0.0f, focal, 0.0f, 0.0f }, { 0.0f, 0.0f, -(far + near) / (far - near), -2.0f * far * near / (far - near) }, { 0.0f, 0.0f, -1.0f, 0.0f } };
+    return math::mat4x4(elements);
+}
+
+// Camera at eye, turned by yaw and pitch.
+math::mat4x4 camera(const math::vec3& eye, float aspect)
+{
+    const math::mat4x4 view = math::mat4x4::rotation_x(0.2f) * math::mat4x4::rotation_y(-0.6f) * math::mat4x4::translation(-eye.x(), -eye.y(), -eye.z());
+    return perspective(1.2f, aspect, 0.5f, 500.0f) * view;
+}
+
+math::vec3 xyz(const math::vec4& v)
+{
+    return math::vec3(v.x(), v.y(), v.z());
+}
+
+// The per-pixel path: two vec4 points through the inverse, divide by w, subtract, normalize.
+void reference_ray(const math::mat4x4& inverse, int width, int height, int x, int y, math::vec3& origin, math::vec3& direction)
+{
+    const float nx = (x + 0.5f) * 2.0f / width - 1.0f;
+    const float ny = 1.0f - (y + 0.5f) * 2.0f / height;
+    origin = xyz((inverse * math::vec4(nx, ny, -1.0f, 1.0f)).to_normalized_device_coordinates());
+    const math::vec3 far = xyz((inverse * math::vec4(nx, ny, 1.0f, 1.0f)).to_normalized_device_coordinates());
+    direction = (far - origin).normalized();
+}
+
+struct ray_image {
+    std::vector<float> ox, oy, oz, dx, dy, dz;
+
+    explicit ray_image(size_t pixels)
+        : ox(pixels), oy(pixels), oz(pixels), dx(pixels), dy(pixels), dz(pixels)
+    {
+    }
+
+    math::vec3_soa origins() { return { ox, oy, oz }; }
+    math::vec3_soa directions() { return { dx, dy, dz }; }
+    math::vec3 origin(size_t i) const { return math::vec3(ox[i], oy[i], oz[i]); }
+    math::vec3 direction(size_t i) const { return math::vec3(dx[i], dy[i], dz[i]); }
+};
+
+void run_tests()
+{
+    std::cout << "=== TESTING ray generation (simd backend: " << math::simd::backend_name << ") ===" << std::endl
+              << std::endl;
+
+    const int width = 37, height = 23;
+    const math::vec3 eye(3.0f, 1.5f, 8.0f);
+    const math::mat4x4 view_projection = camera(eye, float(width) / height);
+    const math::mat4x4 inverse = view_projection.inverse();
+
+    std::cout << "--- primary rays ---" << std::endl;
+    ray_image rays(width * height);
+    math::generate_primary_rays(view_projection, width, height, rays.origins(), rays.directions(), 1);
+    bool matches = true, unit = true, from_eye = true;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const size_t i = size_t(y) * width + x;
+            math::vec3 origin, direction;
+            reference_ray(inverse, width, height, x, y, origin, direction);
+            matches &= same(rays.origin(i), origin, 0.0005f) && same(rays.direction(i), direction);
+            unit &= approx_equal(rays.direction(i).length(), 1.0f);
+            from_eye &= same(rays.direction(i), (rays.origin(i) - eye).normalized(), 0.001f);
+        }
+    }
+    print_test("matches the per-pixel vec4 path (37x23, partial blocks)", matches);
+    print_test("directions are unit length", unit);
+    print_test("perspective rays start on the line from the eye", from_eye);
+
+    ray_image threaded(width * height);
+    math::generate_primary_rays(view_projection, width, height, threaded.origins(), threaded.directions(), 4);
+    print_test("same bits with 4 threads", rays.ox == threaded.ox && rays.oy == threaded.oy && rays.oz == threaded.oz && rays.dx == threaded.dx && rays.dy == threaded.dy && rays.dz == threaded.dz);
+
+    std::cout << "--- unproject ---" << std::endl;
+    std::mt19937 rng(50);
+    std::uniform_real_distribution<float> coord(-1.0f, 1.0f), depth(-40.0f, -2.0f);
+    const math::mat4x4 view = math::mat4x4::rotation_x(0.2f) * math::mat4x4::rotation_y(-0.6f) * math::mat4x4::translation(-eye.x(), -eye.y(), -eye.z());
+    const math::mat4x4 camera_to_world = view.inverse();
+    std::vector<math::vec3> world, window;
+    for (int i = 0; i < 45; ++i) {
+        // Points in front of the camera, projected with the vec4 NDC path.
+        const float z = depth(rng);
+        const math::vec4 p = camera_to_world * math::vec4(coord(rng) * -z * 0.5f, coord(rng) * -z * 0.5f, z, 1.0f);
+        world.push_back(xyz(p));
+        const math::vec4 ndc = (view_projection * p).to_normalized_device_coordinates();
+        window.emplace_back((ndc.x() + 1.0f) * 0.5f * width, (1.0f - ndc.y()) * 0.5f * height, ndc.z() * 0.5f + 0.5f);
+    }
+    std::vector<math::vec3> back(window.size());
+    math::unproject(view_projection, width, height, window, back);
+    bool round_trip = true;
+    for (size_t i = 0; i < world.size(); ++i) {
+        round_trip &= same(back[i], world[i], 0.002f * (1.0f + world[i].distance_to(eye)));
+    }
+    print_test("unproject inverts the projection (45 points)", round_trip);
+    std::vector<math::vec3> in_place = window;
+    math::unproject(view_projection, width, height, in_place, in_place);
+    print_test("unproject in place", std::memcmp(in_place.data(), back.data(), back.size() * sizeof(math::vec3)) == 0);
+    const math::vec3 corner[1] = { math::vec3(0.5f, 0.5f, 0.0f) };
+    math::vec3 corner_world[1];
+    math::unproject(view_projection, width, height, corner, corner_world);
+    print_test("near-plane pixel center is the ray origin", same(corner_world[0], rays.origin(0), 0.0005f));
+
+    std::cout << "--- errors ---" << std::endl;
+    auto throws_invalid = [](auto&& fn) {
+        try {
+            fn();
+        } catch (const std::invalid_argument&) {
+            return true;
+        }
+        return false;
+    };
+    bool singular = false;
+    try {
+        math::generate_primary_rays(math::mat4x4::zero(), width, height, rays.origins(), rays.directions());
+    } catch (const std::runtime_error&) {
+        singular = true;
+    }
+    print_test("singular view-projection throws", singular);
+    print_test("non-positive size throws", throws_invalid([&] { math::generate_primary_rays(view_projection, 0, height, rays.origins(), rays.directions()); }));
+    print_test("short ray output throws", throws_invalid([&] { math::generate_primary_rays(view_projection, width + 1, height, rays.origins(), rays.directions()); }));
+    print_test("short unproject output throws", throws_invalid([&] { math::unproject(view_projection, width, height, window, std::span<math::vec3>(back.data(), back.size() - 1)); }));
+
+    std::cout << std::endl;
+}
+
+void run_speed_tests(int width, int height, int repeats)
+{
+    std::cout << "=== SPEED TESTS (" << width << "x" << height << ", mean of " << repeats << ", simd backend: " << math::simd::backend_name << ") ===" << std::endl
+              << std::endl;
+
+    const size_t pixels = size_t(width) * height;
+    const math::mat4x4 view_projection = camera(math::vec3(3.0f, 1.5f, 8.0f), float(width) / height);
+    ray_image rays(pixels);
+    std::vector<math::vec3> origins(pixels), directions(pixels);
+
+    report_mean("per-pixel vec4 path:          ", pixels, repeats, [&] {
+        const math::mat4x4 inverse = view_projection.inverse();
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                const size_t i = size_t(y) * width + x;
+                reference_ray(inverse, width, height, x, y, origins[i], directions[i]);
+            }
+        }
+    }, "rays");
+    report_mean("generate_primary_rays (1):    ", pixels, repeats, [&] { math::generate_primary_rays(view_projection, width, height, rays.origins(), rays.directions(), 1); }, "rays");
+    const unsigned threads = math::parallel::default_thread_count();
+    if (threads > 1) {
+        report_mean("generate_primary_rays (all):  ", pixels, repeats, [&] { math::generate_primary_rays(view_projection, width, height, rays.origins(), rays.directions()); }, "rays");
+    }
+
+    std::cout << "(checksum " << origins[7].x() + directions[9].y() + rays.dx[11] << ")" << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    int width = argc > 1 ? std::atoi(argv[1]) : 3840;
+    int height = argc > 2 ? std::atoi(argv[2]) : 2160;
+    int repeats = argc > 3 ? std::atoi(argv[3]) : 5;
+    run_tests();
+    run_speed_tests(width, height, repeats);
+    return 0;
+}
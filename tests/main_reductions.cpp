@@ -0,0 +1,251 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "../parallel/parallel_for.hpp"
+#include "../reductions/reductions.hpp"
+#include "../simd/simd.hpp"
+
+void print_test(const char* name, bool passed)
+{
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << name << std::endl;
+}
+
+bool approx_equal(float a, float b, float epsilon = 0.0001f)
+{
+    return std::abs(a - b) < epsilon;
+}
+
+bool bit_equal(const math::point_statistics& a, const math::point_statistics& b)
+{
+    float fa[21], fb[21];
+    auto flatten = [](const math::point_statistics& s, float* f) {
+        const math::vec3 v[3] = { s.bounds.min, s.bounds.max, s.mean };
+        for (int i = 0; i < 3; ++i) {
+            f[3 * i] = v[i].x();
+            f[3 * i + 1] = v[i].y();
+            f[3 * i + 2] = v[i].z();
+        }
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) {
+                f[9 + 3 * r + c] = s.covariance.at(r, c);
+            }
+        }
+        f[18] = f[19] = f[20] = 0.0f;
+    };
+    flatten(a, fa);
+    flatten(b, fb);
+    return std::memcmp(fa, fb, sizeof(fa)) == 0;
+}
+
+// Mean and covariance in long double, two passes.
+void reference(const std::vector<math::vec3>& points, long double (&mean)[3], long double (&cov)[3][3])
+{
+    long double sum[3] = {};
+    for (const math::vec3& p : points) {
+        sum[0] += p.x();
+        sum[1] += p.y();
+        sum[2] += p.z();
+    }
+    for (int c = 0; c < 3; ++c) {
+        mean[c] = sum[c] / points.size();
+    }
+    long double s[3][3] = {};
+    for (const math::vec3& p : points) {
+        const long double d[3] = { p.x() - mean[0], p.y() - mean[1], p.z() - mean[2] };
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) {
+                s[r][c] += d[r] * d[c];
+            }
+        }
+    }
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 3; ++c) {
+            cov[r][c] = s[r][c] / points.size();
+        }
+    }
+}
+
+// Points around `center` with per-axis spread, x and y correlated.
+std::vector<math::vec3> make_points(size_t count, float center, float spread, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> normal(0.0f, spread);
+    std::vector<math::vec3> points(count);
+    for (auto& p : points) {
+        const float a = normal(rng), b = normal(rng), c = normal(rng);
+        p = math::vec3(center + a, center - 0.5f * center + a * 0.6f + b * 0.8f, center * 0.25f + c * 0.5f);
+    }
+    return points;
+}
+
+void run_tests()
+{
+    std::cout << "=== TESTING reductions (simd backend: " << math::simd::backend_name << ") ===" << std::endl
+              << std::endl;
+
+    // Small sets, including partial blocks.
+    {
+        std::vector<math::vec3> points = { math::vec3(1.0f, -2.0f, 3.0f), math::vec3(-1.0f, 4.0f, 0.5f), math::vec3(2.0f, 0.0f, -3.0f) };
+        math::point_statistics s = math::compute_statistics(points);
+        print_test("bounds of 3 points", s.bounds.min.x() == -1.0f && s.bounds.min.y() == -2.0f && s.bounds.min.z() == -3.0f && s.bounds.max.x() == 2.0f && s.bounds.max.y() == 4.0f && s.bounds.max.z() == 3.0f);
+        print_test("mean of 3 points", approx_equal(s.mean.x(), 2.0f / 3.0f) && approx_equal(s.mean.y(), 2.0f / 3.0f) && approx_equal(s.mean.z(), 0.5f / 3.0f));
+        // var(x) of {1, -1, 2} = 14/9; cov(x, y) = E[xy] - E[x]E[y] = -2 - 4/9.
+        print_test("covariance of 3 points", approx_equal(s.covariance.at(0, 0), 14.0f / 9.0f) && approx_equal(s.covariance.at(0, 1), -22.0f / 9.0f) && approx_equal(s.covariance.at(1, 0), s.covariance.at(0, 1)));
+
+        math::vec3 single = math::compute_centroid(std::vector<math::vec3> { math::vec3(5.0f, 6.0f, 7.0f) });
+        print_test("centroid of one point", single.x() == 5.0f && single.y() == 6.0f && single.z() == 7.0f);
+
+        bool threw = false;
+        try {
+            math::compute_bounds(std::span<const math::vec3>());
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        print_test("empty input throws std::invalid_argument", threw);
+    }
+
+    // Against a long double reference, far from the origin where naive float sums drift.
+    {
+        std::vector<math::vec3> points = make_points(1000003, 1000.0f, 1.0f, 1);
+        long double mean[3], cov[3][3];
+        reference(points, mean, cov);
+        math::point_statistics s = math::compute_statistics(points);
+        bool mean_ok = approx_equal(s.mean.x(), static_cast<float>(mean[0]), 1e-3f) && approx_equal(s.mean.y(), static_cast<float>(mean[1]), 1e-3f) && approx_equal(s.mean.z(), static_cast<float>(mean[2]), 1e-3f);
+        bool cov_ok = true;
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) {
+                cov_ok &= approx_equal(s.covariance.at(r, c), static_cast<float>(cov[r][c]), 1e-3f);
+            }
+        }
+        print_test("mean matches long double reference", mean_ok);
+        print_test("covariance matches long double reference (offset 1000)", cov_ok);
+
+        float naive = 0.0f;
+        for (const math::vec3& p : points) {
+            naive += p.x();
+        }
+        naive /= points.size();
+        print_test("mean more accurate than naive float summation", std::abs(s.mean.x() - mean[0]) < std::abs(naive - mean[0]));
+
+        math::vec3 centroid = math::compute_centroid(points);
+        math::mat3x3 covariance = math::compute_covariance(points);
+        math::aabb box = math::compute_bounds(points);
+        bool same = centroid.x() == s.mean.x() && centroid.y() == s.mean.y() && centroid.z() == s.mean.z()
+            && box.min.x() == s.bounds.min.x() && box.max.z() == s.bounds.max.z();
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) {
+                same &= covariance.at(r, c) == s.covariance.at(r, c);
+            }
+        }
+        print_test("single-purpose functions match compute_statistics", same);
+
+        math::bounding_sphere sphere = math::compute_bounding_sphere(points);
+        bool contains = true;
+        for (const math::vec3& p : points) {
+            contains &= p.distance_to(sphere.center) <= sphere.radius * (1.0f + 1e-6f);
+        }
+        math::vec3 half = (box.max - box.min) * 0.5f;
+        print_test("bounding sphere contains every point", contains);
+        print_test("bounding sphere within the box's circumscribed sphere", sphere.radius <= half.length() * (1.0f + 1e-6f));
+    }
+
+    // Bit-identical at any thread count.
+    {
+        std::vector<math::vec3> points = make_points(700001, 50.0f, 10.0f, 2);
+        math::point_statistics base = math::compute_statistics(points, 1);
+        math::bounding_sphere base_sphere = math::compute_bounding_sphere(points, 1);
+        bool identical = true;
+        for (unsigned threads : { 2u, 3u, 4u, 7u, 16u, 0u }) {
+            identical &= bit_equal(base, math::compute_statistics(points, threads));
+            math::bounding_sphere sphere = math::compute_bounding_sphere(points, threads);
+            identical &= sphere.radius == base_sphere.radius && sphere.center.x() == base_sphere.center.x();
+        }
+        print_test("results bit-identical for 1, 2, 3, 4, 7, 16 and default threads", identical);
+    }
+
+    std::cout << std::endl;
+}
+
+template <typename Fn>
+void report(const char* name, size_t bytes, int repeats, Fn&& fn)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        fn();
+        asm volatile("" : : : "memory");
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+    std::cout << name << std::setw(10) << duration.count() << " ms (" << std::setw(8)
+              << (static_cast<double>(bytes) * repeats / duration.count() / 1e6) << " GB/s)" << std::endl;
+}
+
+void run_speed_tests(size_t count, int repeats)
+{
+    std::cout << "=== SPEED TESTS (" << count << " points x " << repeats << ", simd backend: " << math::simd::backend_name << ") ===" << std::endl
+              << std::endl;
+
+    std::vector<math::vec3> points = make_points(count, 100.0f, 5.0f, 3);
+    const size_t bytes = count * sizeof(math::vec3);
+    const float* data = reinterpret_cast<const float*>(points.data());
+    float sink = 0.0f;
+
+    // Streaming read of the same bytes: the memory bandwidth the reductions are measured against.
+    report("bandwidth (f32x8 sum):        ", bytes, repeats, [&] {
+        math::simd::f32x8 acc(0.0f);
+        size_t i = 0;
+        for (; i + 8 <= 3 * count; i += 8) {
+            acc += math::simd::f32x8::loadu(data + i);
+        }
+        sink += reduce_add(acc);
+    });
+    report("naive float centroid:         ", bytes, repeats, [&] {
+        float sum[3] = {};
+        for (const math::vec3& p : points) {
+            sum[0] += p.x();
+            sum[1] += p.y();
+            sum[2] += p.z();
+        }
+        sink += sum[0] / count;
+    });
+    report("naive float covariance:       ", bytes, repeats, [&] {
+        float sum[3] = {}, product[6] = {};
+        for (const math::vec3& p : points) {
+            sum[0] += p.x();
+            sum[1] += p.y();
+            sum[2] += p.z();
+            product[0] += p.x() * p.x();
+            product[1] += p.y() * p.y();
+            product[2] += p.z() * p.z();
+            product[3] += p.x() * p.y();
+            product[4] += p.y() * p.z();
+            product[5] += p.z() * p.x();
+        }
+        sink += product[0] / count - (sum[0] / count) * (sum[0] / count);
+    });
+    for (unsigned threads : { 1u, 0u }) {
+        std::cout << "threads: " << (threads ? threads : math::parallel::default_thread_count()) << std::endl;
+        report("  compute_bounds:             ", bytes, repeats, [&] { sink += math::compute_bounds(points, threads).max.x(); });
+        report("  compute_centroid:           ", bytes, repeats, [&] { sink += math::compute_centroid(points, threads).x(); });
+        report("  compute_statistics:         ", bytes, repeats, [&] { sink += math::compute_statistics(points, threads).covariance.at(0, 1); });
+        report("  compute_bounding_sphere:    ", bytes, repeats, [&] { sink += math::compute_bounding_sphere(points, threads).radius; });
+    }
+
+    std::cout << "(checksum " << sink << ")" << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 23;
+    int repeats = argc > 2 ? std::atoi(argv[2]) : 10;
+    run_tests();
+    run_speed_tests(count, repeats);
+    return 0;
+}
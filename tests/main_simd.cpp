@@ -0,0 +1,233 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../mat4x4/mat4x4.hpp"
+#include "../simd/simd.hpp"
+
+void print_test(const char* name, bool passed)
+{
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << name << std::endl;
+}
+
+bool approx_equal(float a, float b, float epsilon = 0.0001f)
+{
+    return std::abs(a - b) < epsilon;
+}
+
+// Checks every operation of V lane by lane against plain float arithmetic.
+template <typename V>
+void test_type(const char* name)
+{
+    constexpr int n = static_cast<int>(V::size);
+    alignas(64) float a[n], b[n], c[n], out[n];
+    for (int i = 0; i < n; ++i) {
+        a[i] = static_cast<float>(i) - 3.5f;
+        b[i] = static_cast<float>((i * 5) % n) * 0.5f + 0.25f;
+        c[i] = static_cast<float>(n - i);
+    }
+    const V va = V::load(a), vb = V::loadu(b), vc = V::load(c);
+
+    std::int32_t index[n];
+    for (int i = 0; i < n; ++i) {
+        index[i] = (i * 3 + 1) % n;
+    }
+
+    auto check = [&](V v, auto expected) {
+        v.store(out);
+        bool ok = true;
+        for (int i = 0; i < n; ++i) {
+            ok = ok && approx_equal(out[i], expected(i));
+        }
+        return ok;
+    };
+
+    bool arithmetic = check(va + vb, [&](int i) { return a[i] + b[i]; })
+        && check(va - vb, [&](int i) { return a[i] - b[i]; })
+        && check(va * vb, [&](int i) { return a[i] * b[i]; })
+        && check(va / vb, [&](int i) { return a[i] / b[i]; })
+        && check(-va, [&](int i) { return -a[i]; })
+        && check(va * 2.0f, [&](int i) { return a[i] * 2.0f; });
+    V acc = va;
+    acc += vb;
+    acc *= vc;
+    arithmetic = arithmetic && check(acc, [&](int i) { return (a[i] + b[i]) * c[i]; });
+
+    bool functions = check(fmadd(va, vb, vc), [&](int i) { return a[i] * b[i] + c[i]; })
+        && check(fnmadd(va, vb, vc), [&](int i) { return c[i] - a[i] * b[i]; })
+        && check(min(va, vb), [&](int i) { return std::min(a[i], b[i]); })
+        && check(max(va, vb), [&](int i) { return std::max(a[i], b[i]); })
+        && check(abs(va), [&](int i) { return std::abs(a[i]); })
+        && check(sqrt(vc), [&](int i) { return std::sqrt(c[i]); })
+        && check(floor(va * 0.75f), [&](int i) { return std::floor(a[i] * 0.75f); });
+
+    // The estimate is good to 12 bits on every backend.
+    V estimate = rsqrt(vc);
+    bool reciprocal_sqrt = true;
+    for (int i = 0; i < n; ++i) {
+        reciprocal_sqrt = reciprocal_sqrt && std::abs(estimate[i] * std::sqrt(c[i]) - 1.0f) < 1.0f / 2048.0f;
+    }
+
+    float sum = 0.0f, lowest = a[0], highest = a[0];
+    for (int i = 0; i < n; ++i) {
+        sum += a[i];
+        lowest = std::min(lowest, a[i]);
+        highest = std::max(highest, a[i]);
+    }
+    bool reductions = approx_equal(reduce_add(va), sum) && reduce_min(va) == lowest && reduce_max(va) == highest;
+
+    unsigned less = 0;
+    for (int i = 0; i < n; ++i) {
+        less |= static_cast<unsigned>(a[i] < b[i]) << i;
+    }
+    const unsigned all_lanes = (n == 32) ? ~0u : (1u << n) - 1u;
+    typename V::mask m = va < vb;
+    bool masks = bits(m) == less && bits(~m) == (~less & all_lanes) && bits(va >= vb) == (~less & all_lanes)
+        && bits(m & (va == va)) == less && bits(m | ~m) == all_lanes && all(va == va) && none(va != va)
+        && any(m) == (less != 0) && bits(va <= va) == all_lanes && bits(vb > va) == less;
+    masks = masks && check(select(m, va, vb), [&](int i) { return a[i] < b[i] ? a[i] : b[i]; });
+
+    bool shuffles = check(shuffle<3, 2, 1, 0>(va), [&](int i) { return a[(i & ~3) + 3 - (i & 3)]; })
+        && check(shuffle<1, 0, 3, 2>(va, vb), [&](int i) {
+               int g = i & ~3, l = i & 3;
+               return l < 2 ? a[g + (l == 0 ? 1 : 0)] : b[g + (l == 2 ? 3 : 2)];
+           })
+        && check(math::simd::broadcast_lane<2>(va), [&](int i) { return a[(i & ~3) + 2]; });
+
+    bool lanes = va[0] == a[0] && va[n - 1] == a[n - 1];
+    bool gathered = check(V::gather(c, index), [&](int i) { return c[index[i]]; });
+
+    std::cout << name << ":" << std::endl;
+    print_test("  arithmetic", arithmetic);
+    print_test("  fmadd / min / max / abs / sqrt / floor", functions);
+    print_test("  rsqrt estimate", reciprocal_sqrt);
+    print_test("  reductions", reductions);
+    print_test("  compare / masks / select", masks);
+    print_test("  shuffles", shuffles);
+    print_test("  lane access", lanes);
+    print_test("  gather", gathered);
+}
+
+void run_tests()
+{
+    std::cout << "=== TESTING simd (backend: " << math::simd::backend_name << ") ===" << std::endl
+              << std::endl;
+
+    test_type<math::simd::f32x4>("f32x4");
+    test_type<math::simd::f32x8>("f32x8");
+    test_type<math::simd::f32x16>("f32x16");
+
+    alignas(64) float rows[16];
+    for (int i = 0; i < 16; ++i) {
+        rows[i] = static_cast<float>(i);
+    }
+    math::simd::f32x4 r0 = math::simd::f32x4::load(rows), r1 = math::simd::f32x4::load(rows + 4);
+    math::simd::f32x4 r2 = math::simd::f32x4::load(rows + 8), r3 = math::simd::f32x4::load(rows + 12);
+    math::simd::transpose4(r0, r1, r2, r3);
+    print_test("transpose4", r0[1] == 4.0f && r1[0] == 1.0f && r2[3] == 14.0f && r3[2] == 11.0f);
+
+    math::simd::f32x16 whole = math::simd::f32x16::load(rows);
+    math::simd::f32x8 low = whole.low(), high = whole.high();
+    math::simd::f32x16 joined(low, high);
+    print_test("halves", low[7] == 7.0f && high[0] == 8.0f && joined[15] == 15.0f && high.low()[3] == 11.0f);
+
+    // Integer lanes wrap on overflow, compare signed and select with the float masks.
+    const int32_t edges[8] = { -3, 0, 5, INT32_MAX, -1, 7, INT32_MIN, 2 };
+    math::simd::i32x8 e = math::simd::i32x8::loadu(edges);
+    e += math::simd::i32x8(1);
+    int32_t sum[8];
+    (e | math::simd::i32x8(0)).storeu(sum);
+    bool wrapped = sum[0] == -2 && sum[3] == INT32_MIN && sum[6] == INT32_MIN + 1;
+    const math::simd::f32x8::mask negative = e < math::simd::i32x8(0);
+    int32_t picked[8];
+    select(negative, math::simd::i32x8(-9), e).storeu(picked);
+    print_test("i32x8 add / or", wrapped);
+    print_test("i32x8 compare / select", bits(negative) == 0x49 && picked[0] == -9 && picked[1] == 1 && picked[2] == 6);
+
+    math::mat4x4 a({ { { 1, 2, 3, 4 }, { 5, 6, 7, 8 }, { 9, 10, 11, 12 }, { 13, 14, 15, 16 } } });
+    math::mat4x4 b({ { { 2, 0, 1, 0 }, { 0, 1, 0, 3 }, { 1, 0, 2, 0 }, { 0, 4, 0, 1 } } });
+    math::mat4x4 p = a * b;
+    bool product = true;
+    for (int r = 0; r < 4; ++r) {
+        for (int c = 0; c < 4; ++c) {
+            float expected = 0.0f;
+            for (int k = 0; k < 4; ++k) {
+                expected += a.at(r, k) * b.at(k, c);
+            }
+            product = product && p.at(r, c) == expected;
+        }
+    }
+    print_test("mat4x4 product on the layer", product);
+    print_test("mat4x4 transpose on the layer", a.transpose().at(0, 3) == 13.0f && a.transpose().at(2, 1) == 7.0f);
+
+    std::cout << std::endl;
+}
+
+template <typename V>
+double axpy_rate(std::vector<float>& y, const std::vector<float>& x, int repeats)
+{
+    const size_t count = y.size() / V::size * V::size;
+    const V a(1.0001f);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        for (size_t i = 0; i < count; i += V::size) {
+            fmadd(a, V::loadu(&x[i]), V::loadu(&y[i])).storeu(&y[i]);
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+    return duration.count();
+}
+
+void run_speed_tests(size_t count, int repeats)
+{
+    std::cout << "=== SPEED TESTS (backend: " << math::simd::backend_name << ", " << count << " floats x " << repeats << ") ===" << std::endl
+              << std::endl;
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<float> x(count), y(count);
+    for (size_t i = 0; i < count; ++i) {
+        x[i] = unit(rng);
+        y[i] = unit(rng);
+    }
+    const double total = static_cast<double>(count) * repeats;
+    auto report = [&](const char* name, double ms) {
+        std::cout << name << std::setw(10) << ms << " ms (" << std::setw(8) << (total / ms / 1000.0) << " M ops/s)" << std::endl;
+    };
+    report("axpy f32x4:          ", axpy_rate<math::simd::f32x4>(y, x, repeats));
+    report("axpy f32x8:          ", axpy_rate<math::simd::f32x8>(y, x, repeats));
+    report("axpy f32x16:         ", axpy_rate<math::simd::f32x16>(y, x, repeats));
+
+    const size_t matrices = count / 16;
+    std::vector<math::mat4x4> ms(matrices);
+    for (size_t i = 0; i < matrices; ++i) {
+        ms[i] = math::mat4x4::rotation_z(unit(rng)) * math::mat4x4::translation(unit(rng), unit(rng), unit(rng));
+    }
+    math::mat4x4 acc = math::mat4x4::identity();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        for (const math::mat4x4& m : ms) {
+            acc = m * acc;
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+    std::cout << "mat4x4 product:       " << std::setw(10) << duration.count() << " ms (" << std::setw(8)
+              << (static_cast<double>(matrices) * repeats / duration.count() / 1000.0) << " M ops/s)" << std::endl;
+    std::cout << "(checksum " << y[0] + acc.at(0, 0) << ")" << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 20;
+    int repeats = argc > 2 ? std::atoi(argv[2]) : 100;
+    run_tests();
+    run_speed_tests(count, repeats);
+    return 0;
+}
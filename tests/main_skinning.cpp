@@ -0,0 +1,223 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "../skinning/skinning.hpp"
+
+void print_test(const char* name, bool passed)
+{
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << name << std::endl;
+}
+
+bool approx_equal(float a, float b, float epsilon = 0.0001f)
+{
+    return std::abs(a - b) < epsilon;
+}
+
+bool vec_approx_equal(const math::vec3& a, const math::vec3& b, float epsilon = 0.0001f)
+{
+    return approx_equal(a.x(), b.x(), epsilon) && approx_equal(a.y(), b.y(), epsilon) && approx_equal(a.z(), b.z(), epsilon);
+}
+
+math::vec3 reference_linear(const std::vector<math::mat4x4>& palette, const math::vec3& p, const math::vertex_influence4& inf)
+{
+    math::mat4x4 blended = math::mat4x4::zero();
+    for (int k = 0; k < 4; ++k) {
+        blended += palette[inf.bones[k]] * inf.weights[k];
+    }
+    return (blended * math::vec4(p, 1.0f)).to_vec3_orthographic();
+}
+
+void make_mesh(size_t count, size_t bone_count, std::vector<math::vec3>& positions, std::vector<math::vec3>& normals,
+    std::vector<math::vertex_influence4>& influences)
+{
+    positions.resize(count);
+    normals.resize(count);
+    influences.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        float f = static_cast<float>(i);
+        positions[i] = math::vec3(std::sin(f * 0.01f), f * 0.001f, std::cos(f * 0.01f));
+        normals[i] = math::vec3(std::sin(f * 0.01f), 0.0f, std::cos(f * 0.01f));
+        for (int k = 0; k < 4; ++k) {
+            influences[i].bones[k] = static_cast<std::uint16_t>((i / 64 + k) % bone_count);
+        }
+        influences[i].weights[0] = 0.4f;
+        influences[i].weights[1] = 0.3f;
+        influences[i].weights[2] = 0.2f;
+        influences[i].weights[3] = 0.1f;
+    }
+}
+
+std::vector<math::mat4x4> make_palette(size_t bone_count, float phase)
+{
+    std::vector<math::mat4x4> palette;
+    for (size_t b = 0; b < bone_count; ++b) {
+        float a = phase + 0.05f * static_cast<float>(b);
+        palette.push_back(math::mat4x4::translation(0.1f * b, 0.0f, -0.2f * b) * math::mat4x4::rotation_axis_angle_extrinsic(a, 0.5f * a, 0.0f));
+    }
+    return palette;
+}
+
+void run_tests()
+{
+    std::cout << "=== TESTING skinning ===" << std::endl
+              << std::endl;
+
+    std::vector<math::vec3> positions, normals;
+    std::vector<math::vertex_influence4> influences;
+    make_mesh(1000, 16, positions, normals, influences);
+    std::vector<math::mat4x4> palette = make_palette(16, 0.3f);
+
+    std::vector<math::vec3> out_p(positions.size()), out_n(positions.size());
+    math::skin_linear(palette, positions, normals, influences, out_p, out_n);
+    bool lbs_ok = true;
+    for (size_t i = 0; i < positions.size(); ++i) {
+        lbs_ok = lbs_ok && vec_approx_equal(out_p[i], reference_linear(palette, positions[i], influences[i]), 0.001f);
+        lbs_ok = lbs_ok && approx_equal(out_n[i].length(), 1.0f, 0.001f);
+    }
+    print_test("skin_linear matches blended mat4x4", lbs_ok);
+
+    std::vector<math::vec3> threaded_p(positions.size());
+    math::skinning_options options;
+    options.thread_count = 4;
+    options.chunk_size = 100;
+    math::skin_linear(palette, positions, {}, influences, threaded_p, {}, options);
+    bool same = true;
+    for (size_t i = 0; i < positions.size(); ++i) {
+        same = same && out_p[i].x() == threaded_p[i].x() && out_p[i].z() == threaded_p[i].z();
+    }
+    print_test("skin_linear independent of thread count", same);
+
+    std::vector<math::vertex_influence8> influences8(positions.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+        for (int k = 0; k < 8; ++k) {
+            influences8[i].bones[k] = influences[i].bones[k % 4];
+            influences8[i].weights[k] = influences[i].weights[k % 4] * 0.5f;
+        }
+    }
+    std::vector<math::vec3> out8(positions.size());
+    math::skin_linear(palette, positions, {}, influences8, out8, {});
+    print_test("skin_linear with 8 influences", vec_approx_equal(out8[123], out_p[123], 0.001f));
+
+    std::vector<math::dual_quat> dq_palette;
+    for (const math::mat4x4& m : palette) {
+        dq_palette.push_back(math::dual_quat::from_matrix(m));
+    }
+    std::vector<math::vertex_influence4> single(positions.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+        single[i] = { { influences[i].bones[0], 0, 0, 0 }, { 1.0f, 0.0f, 0.0f, 0.0f } };
+    }
+    std::vector<math::vec3> dq_p(positions.size()), dq_n(positions.size()), lbs_p(positions.size()), lbs_n(positions.size());
+    math::skin_dual_quaternion(dq_palette, positions, normals, single, dq_p, dq_n);
+    math::skin_linear(palette, positions, normals, single, lbs_p, lbs_n);
+    bool rigid_ok = true;
+    for (size_t i = 0; i < positions.size(); ++i) {
+        rigid_ok = rigid_ok && vec_approx_equal(dq_p[i], lbs_p[i], 0.001f) && vec_approx_equal(dq_n[i], lbs_n[i], 0.001f);
+    }
+    print_test("dual quaternion matches rigid single-bone transform", rigid_ok);
+
+    std::vector<math::mat4x4> twist = { math::mat4x4::identity(), math::mat4x4::rotation_x(3.0f) };
+    std::vector<math::dual_quat> dq_twist = { math::dual_quat::from_matrix(twist[0]), math::dual_quat::from_matrix(twist[1]) };
+    std::vector<math::vec3> arm = { math::vec3(2.0f, 1.0f, 0.0f) };
+    std::vector<math::vertex_influence4> half = { { { 0, 1, 0, 0 }, { 0.5f, 0.5f, 0.0f, 0.0f } } };
+    std::vector<math::vec3> lbs_arm(1), dq_arm(1);
+    math::skin_linear(twist, arm, {}, half, lbs_arm, {});
+    math::skin_dual_quaternion(dq_twist, arm, {}, half, dq_arm, {});
+    float lbs_radius = std::sqrt(lbs_arm[0].y() * lbs_arm[0].y() + lbs_arm[0].z() * lbs_arm[0].z());
+    float dq_radius = std::sqrt(dq_arm[0].y() * dq_arm[0].y() + dq_arm[0].z() * dq_arm[0].z());
+    print_test("dual quaternion avoids candy-wrapper collapse", lbs_radius < 0.1f && approx_equal(dq_radius, 1.0f, 0.001f));
+
+    std::vector<math::vec3> big_p, big_n;
+    std::vector<math::vertex_influence4> big_influences;
+    make_mesh(1000, 300, big_p, big_n, big_influences);
+    const std::vector<math::mat4x4> big_palette = make_palette(300, 0.2f);
+    std::vector<math::vec3> big_out(big_p.size());
+    math::skin_linear(big_palette, big_p, {}, big_influences, big_out, {});
+    bool big_ok = true;
+    for (size_t i = 0; i < big_p.size(); ++i) {
+        big_ok = big_ok && vec_approx_equal(big_out[i], reference_linear(big_palette, big_p[i], big_influences[i]), 0.001f);
+    }
+    print_test("skin_linear with a 300-bone palette", big_ok);
+
+    auto throws_invalid = [](auto&& fn) {
+        try {
+            fn();
+        } catch (const std::invalid_argument&) {
+            return true;
+        }
+        return false;
+    };
+    const std::span<const math::vertex_influence4> few(influences.data(), influences.size() - 1);
+    const std::span<math::vec3> short_out(out_p.data(), out_p.size() - 1);
+    print_test("short influences throw", throws_invalid([&] { math::skin_linear(palette, positions, {}, few, out_p, {}); }) && throws_invalid([&] { math::skin_dual_quaternion(dq_palette, positions, {}, few, dq_p, {}); }));
+    print_test("short position output throws", throws_invalid([&] { math::skin_linear(palette, positions, {}, influences, short_out, {}); }) && throws_invalid([&] { math::skin_dual_quaternion(dq_palette, positions, {}, influences, short_out, {}); }));
+    print_test("short normal output throws", throws_invalid([&] { math::skin_linear(palette, positions, normals, influences, out_p, std::span<math::vec3>(out_n.data(), 10)); }) && throws_invalid([&] { math::skin_dual_quaternion(dq_palette, positions, normals, influences, dq_p, std::span<math::vec3>(dq_n.data(), 10)); }));
+
+    std::cout << std::endl;
+}
+
+void run_speed_tests(size_t vertex_count, int characters)
+{
+    std::cout << "=== SPEED TESTS (" << vertex_count << " vertices x " << characters << " characters) ===" << std::endl
+              << std::endl;
+
+    std::vector<math::vec3> positions, normals;
+    std::vector<math::vertex_influence4> influences;
+    make_mesh(vertex_count, 64, positions, normals, influences);
+    std::vector<math::vec3> out_p(vertex_count), out_n(vertex_count);
+
+    std::vector<std::vector<math::mat4x4>> palettes;
+    std::vector<std::vector<math::dual_quat>> dq_palettes;
+    for (int c = 0; c < characters; ++c) {
+        palettes.push_back(make_palette(64, 0.01f * c));
+        dq_palettes.emplace_back();
+        for (const math::mat4x4& m : palettes.back()) {
+            dq_palettes.back().push_back(math::dual_quat::from_matrix(m));
+        }
+    }
+
+    const double total = static_cast<double>(vertex_count) * characters;
+    auto report = [&](const char* name, std::chrono::duration<double, std::milli> duration) {
+        std::cout << name << std::setw(10) << duration.count() << " ms (" << std::setw(8)
+                  << (total / duration.count() / 1000.0) << " M vertices/s)" << std::endl;
+    };
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int c = 0; c < characters; ++c) {
+        const std::vector<math::mat4x4>& palette = palettes[c];
+        for (size_t i = 0; i < vertex_count; ++i) {
+            out_p[i] = reference_linear(palette, positions[i], influences[i]);
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    report("mat4x4 operators:     ", end - start);
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int c = 0; c < characters; ++c) {
+        math::skin_linear(palettes[c], positions, normals, influences, out_p, out_n);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    report("skin_linear:          ", end - start);
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int c = 0; c < characters; ++c) {
+        math::skin_dual_quaternion(dq_palettes[c], positions, normals, influences, out_p, out_n);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    report("skin_dual_quaternion: ", end - start);
+
+    std::cout << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    size_t vertex_count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    int characters = argc > 2 ? std::atoi(argv[2]) : 200;
+    run_tests();
+    run_speed_tests(vertex_count, characters);
+    return 0;
+}
@@ -0,0 +1,237 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../mat4x4/mat4x4.hpp"
+#include "../snapshot_buffer/snapshot_buffer.hpp"
+
+void print_test(const char* name, bool passed)
+{
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << name << std::endl;
+}
+
+// Every element of frame f is tagged with f, so a torn read shows up as mixed tags.
+void write_frame(std::span<math::mat4x4> matrices, std::uint64_t frame)
+{
+    const float tag = static_cast<float>(frame);
+    for (math::mat4x4& m : matrices) {
+        for (int r = 0; r < 4; ++r) {
+            for (int c = 0; c < 4; ++c) {
+                m.at(r, c) = tag;
+            }
+        }
+    }
+}
+
+// Sum of the first element of every matrix, or -1 when the tags do not all match `frame`.
+double consume(std::span<const math::mat4x4> matrices, std::uint64_t frame)
+{
+    const float tag = static_cast<float>(frame);
+    double sum = 0.0;
+    bool consistent = true;
+    for (const math::mat4x4& m : matrices) {
+        consistent &= m.at(0, 0) == tag && m.at(3, 3) == tag;
+        sum += m.at(1, 2);
+    }
+    return consistent ? sum : -1.0;
+}
+
+void run_tests()
+{
+    std::cout << "=== TESTING snapshot_buffer ===" << std::endl
+              << std::endl;
+
+    {
+        math::snapshot_buffer<math::mat4x4> buffer(64);
+        auto first = buffer.acquire();
+        print_test("initial snapshot is frame 0", first && first.frame() == 0 && first.data().size() == 64 && first.data()[5].at(2, 1) == 0.0f);
+        first.release();
+
+        write_frame(buffer.write_buffer(), 1);
+        buffer.publish();
+        auto s = buffer.acquire();
+        print_test("published frame is visible", s.frame() == 1 && consume(s.data(), 1) >= 0.0);
+
+        // The writer keeps going while the reader holds frame 1.
+        bool never_aliased = true;
+        for (std::uint64_t f = 2; f < 20; ++f) {
+            std::span<math::mat4x4> target = buffer.write_buffer();
+            never_aliased &= target.data() != s.data().data();
+            write_frame(target, f);
+            buffer.publish();
+        }
+        print_test("writer never hands out a pinned buffer", never_aliased);
+        print_test("held snapshot does not change", s.frame() == 1 && consume(s.data(), 1) >= 0.0);
+        s.release();
+        auto latest = buffer.acquire();
+        print_test("acquire after release sees the newest frame", latest.frame() == 19 && consume(latest.data(), 19) >= 0.0);
+
+        auto moved = std::move(latest);
+        print_test("snapshot moves", !latest && moved && moved.frame() == 19);
+    }
+
+    {
+        // Four readers each hold a different frame; the writer still has a free buffer.
+        math::snapshot_buffer<math::mat4x4> buffer(16, 4);
+        std::vector<math::snapshot_buffer<math::mat4x4>::snapshot> held;
+        for (std::uint64_t f = 1; f <= 4; ++f) {
+            write_frame(buffer.write_buffer(), f);
+            buffer.publish();
+            held.push_back(buffer.acquire());
+        }
+        for (std::uint64_t f = 5; f < 12; ++f) {
+            write_frame(buffer.write_buffer(), f);
+            buffer.publish();
+        }
+        bool intact = true;
+        for (std::uint64_t f = 1; f <= 4; ++f) {
+            intact &= held[f - 1].frame() == f && consume(held[f - 1].data(), f) >= 0.0;
+        }
+        print_test("max_readers held snapshots stay intact", intact);
+    }
+
+    {
+        // One writer, four readers, real threads.
+        math::snapshot_buffer<math::mat4x4> buffer(256, 4);
+        std::atomic<bool> done { false };
+        std::atomic<int> torn { 0 }, out_of_order { 0 };
+        std::vector<std::thread> readers;
+        for (int r = 0; r < 4; ++r) {
+            readers.emplace_back([&] {
+                std::uint64_t last = 0;
+                while (!done.load(std::memory_order_relaxed)) {
+                    auto s = buffer.acquire();
+                    torn += consume(s.data(), s.frame()) < 0.0;
+                    out_of_order += s.frame() < last;
+                    last = s.frame();
+                }
+            });
+        }
+        for (std::uint64_t f = 1; f <= 20000; ++f) {
+            write_frame(buffer.write_buffer(), f);
+            buffer.publish();
+        }
+        done = true;
+        for (std::thread& t : readers) {
+            t.join();
+        }
+        print_test("1 writer / 4 readers: no torn frames", torn == 0);
+        print_test("1 writer / 4 readers: frames never go backwards", out_of_order == 0);
+    }
+
+    std::cout << std::endl;
+}
+
+// Today's approach: the writer copies each frame into a shared array under a mutex and the
+// readers copy it out again.
+struct mutex_exchange {
+    std::mutex mutex;
+    std::vector<math::mat4x4> shared;
+    std::uint64_t frame = 0;
+};
+
+struct contention_result {
+    std::uint64_t frames = 0;
+    std::uint64_t reads = 0;
+    int torn = 0;
+};
+
+template <typename Write, typename Read>
+contention_result contend(int reader_count, double seconds, Write&& write, Read&& read)
+{
+    std::atomic<bool> done { false };
+    std::atomic<std::uint64_t> reads { 0 };
+    std::atomic<int> torn { 0 };
+    std::vector<std::thread> readers;
+    for (int r = 0; r < reader_count; ++r) {
+        readers.emplace_back([&] {
+            std::uint64_t local = 0;
+            int local_torn = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                local_torn += read() < 0.0;
+                ++local;
+            }
+            reads += local;
+            torn += local_torn;
+        });
+    }
+    contention_result result;
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < seconds) {
+        write(++result.frames);
+    }
+    done = true;
+    for (std::thread& t : readers) {
+        t.join();
+    }
+    result.reads = reads;
+    result.torn = torn;
+    return result;
+}
+
+void print_result(const char* name, const contention_result& r, double seconds)
+{
+    std::cout << name << std::setw(10) << (r.frames / seconds) << " frames/s written, " << std::setw(10)
+              << (r.reads / seconds) << " frames/s read, " << r.torn << " torn" << std::endl;
+}
+
+void run_speed_tests(size_t count, double seconds)
+{
+    const int reader_count = 4;
+    std::cout << "=== CONTENTION (" << count << " matrices per frame, 1 writer / " << reader_count << " readers, "
+              << std::thread::hardware_concurrency() << " hardware threads) ===" << std::endl
+              << std::endl;
+
+    {
+        mutex_exchange exchange;
+        exchange.shared.resize(count);
+        std::vector<math::mat4x4> local(count);
+        contention_result r = contend(
+            reader_count, seconds,
+            [&](std::uint64_t f) {
+                write_frame(local, f);
+                std::lock_guard lock(exchange.mutex);
+                exchange.shared = local;
+                exchange.frame = f;
+            },
+            [&] {
+                thread_local std::vector<math::mat4x4> copy;
+                std::uint64_t frame;
+                {
+                    std::lock_guard lock(exchange.mutex);
+                    copy = exchange.shared;
+                    frame = exchange.frame;
+                }
+                return consume(copy, frame);
+            });
+        print_result("mutex + copy:    ", r, seconds);
+    }
+    {
+        math::snapshot_buffer<math::mat4x4> buffer(count, reader_count);
+        contention_result r = contend(
+            reader_count, seconds,
+            [&](std::uint64_t f) {
+                write_frame(buffer.write_buffer(), f);
+                buffer.publish();
+            },
+            [&] {
+                auto s = buffer.acquire();
+                return consume(s.data(), s.frame());
+            });
+        print_result("snapshot_buffer: ", r, seconds);
+    }
+}
+
+int main(int argc, const char** argv)
+{
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000;
+    double seconds = argc > 2 ? std::atof(argv[2]) : 2.0;
+    run_tests();
+    run_speed_tests(count, seconds);
+    return 0;
+}
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../parallel/parallel_for.hpp"
+#include "../spatial_hash/spatial_hash.hpp"
+
+void print_test(const char* name, bool passed)
+{
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << name << std::endl;
+}
+
+std::vector<math::vec3> random_points(size_t count, float extent, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> coord(-extent, extent);
+    std::vector<math::vec3> points;
+    points.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        points.push_back(math::vec3(coord(rng), coord(rng), coord(rng)));
+    }
+    return points;
+}
+
+std::vector<uint32_t> brute_force(const std::vector<math::vec3>& points, const math::vec3& center, float radius)
+{
+    std::vector<uint32_t> result;
+    for (size_t i = 0; i < points.size(); ++i) {
+        math::vec3 d = points[i] - center;
+        if (d.x() * d.x() + d.y() * d.y() + d.z() * d.z() <= radius * radius) {
+            result.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    return result;
+}
+
+void run_tests()
+{
+    std::cout << "=== TESTING spatial_hash ===" << std::endl
+              << std::endl;
+
+    auto points = random_points(20000, 10.0f, 1);
+    math::spatial_hash hash(1.0f);
+    hash.build(points);
+    print_test("point count", hash.point_count() == points.size());
+
+    std::vector<uint32_t> out(points.size());
+    bool matches = true;
+    for (float radius : {0.3f, 1.0f, 2.5f}) {
+        for (size_t q = 0; q < 200; ++q) {
+            size_t found = hash.query_radius(points[q * 37], radius, out);
+            std::vector<uint32_t> result(out.begin(), out.begin() + found);
+            std::sort(result.begin(), result.end());
+            matches = matches && result == brute_force(points, points[q * 37], radius);
+        }
+    }
+    print_test("radius queries match brute force", matches);
+
+    math::vec3 outside(1000.0f, 1000.0f, 1000.0f);
+    print_test("query far from all points is empty", hash.query_radius(outside, 1.0f, out) == 0);
+
+    std::vector<uint32_t> small(3);
+    print_test("output is truncated to capacity", hash.query_radius(points[0], 5.0f, small) == 3);
+
+    // Rebuilding with another thread count gives the same results in the same order.
+    math::spatial_hash other(1.0f);
+    other.build(points, 1);
+    hash.build(points, 4);
+    std::vector<uint32_t> out_other(points.size());
+    bool same = true;
+    for (size_t q = 0; q < 100; ++q) {
+        size_t a = hash.query_radius(points[q], 1.5f, out);
+        size_t b = other.query_radius(points[q], 1.5f, out_other);
+        same = same && a == b && std::equal(out.begin(), out.begin() + a, out_other.begin());
+    }
+    print_test("deterministic across thread counts", same);
+
+    // Moving points: rebuild reflects new positions.
+    for (math::vec3& p : points) {
+        p = p + math::vec3(50.0f, 0.0f, 0.0f);
+    }
+    hash.build(points);
+    size_t found = hash.query_radius(points[5], 0.5f, out);
+    bool moved = found > 0 && std::find(out.begin(), out.begin() + found, 5u) != out.begin() + found;
+    print_test("rebuild after moving points", moved && hash.query_radius(math::vec3(0.0f, 0.0f, 0.0f), 0.5f, out) == 0);
+
+    hash.build(std::span<const math::vec3>());
+    print_test("empty build", hash.point_count() == 0 && hash.query_radius(outside, 1.0f, out) == 0);
+
+    std::cout << std::endl;
+}
+
+void run_speed_tests(size_t count, size_t brute_force_queries)
+{
+    std::cout << "=== SPEED TESTS (" << count << " points, radius queries around every point) ===" << std::endl
+              << std::endl;
+
+    // Density of one point per unit cube and cells twice the radius: about four neighbours per
+    // query, eight cells visited.
+    float extent = 0.5f * std::cbrt(static_cast<float>(count));
+    auto points = random_points(count, extent, 42);
+    const float radius = 1.0f;
+
+    std::vector<uint32_t> out(1024);
+    auto start = std::chrono::high_resolution_clock::now();
+    size_t brute_hits = 0;
+    for (size_t q = 0; q < brute_force_queries; ++q) {
+        for (size_t i = 0; i < points.size(); ++i) {
+            brute_hits += points[q].distance_to(points[i]) <= radius;
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+    double brute_ms = duration.count() * (static_cast<double>(count) / brute_force_queries);
+    std::cout << "Brute force distance_to (extrapolated): " << std::setw(12) << brute_ms << " ms" << std::endl;
+
+    math::spatial_hash hash(2.0f * radius);
+    // Steady state of a per-frame rebuild: buffers are already allocated.
+    hash.build(points);
+    unsigned max_threads = math::parallel::default_thread_count();
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        start = std::chrono::high_resolution_clock::now();
+        hash.build(points, threads);
+        end = std::chrono::high_resolution_clock::now();
+        duration = end - start;
+        double build_ms = duration.count();
+
+        std::vector<size_t> hits(points.size());
+        start = std::chrono::high_resolution_clock::now();
+        math::parallel::for_each_chunk(
+            points.size(), 4096,
+            [&](size_t begin, size_t stop) {
+                std::vector<uint32_t> local(1024);
+                for (size_t q = begin; q < stop; ++q) {
+                    hits[q] = hash.query_radius(points[q], radius, local);
+                }
+            },
+            threads);
+        end = std::chrono::high_resolution_clock::now();
+        duration = end - start;
+        size_t total = 0;
+        for (size_t h : hits) {
+            total += h;
+        }
+        std::cout << std::setw(2) << threads << " threads: build " << std::setw(10) << build_ms << " ms, queries "
+                  << std::setw(10) << duration.count() << " ms (" << std::setw(8) << (count / duration.count() / 1000.0)
+                  << " M queries/s, " << static_cast<double>(total) / count << " neighbours avg)" << std::endl;
+    }
+    (void)brute_hits;
+
+    std::cout << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    size_t brute_force_queries = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100;
+    run_tests();
+    run_speed_tests(count, brute_force_queries);
+    return 0;
+}
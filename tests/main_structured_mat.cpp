@@ -0,0 +1,146 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "../structured_mat/structured_mat.hpp"
+
+void print_test(const char* name, bool passed)
+{
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << name << std::endl;
+}
+
+bool approx_equal(float a, float b, float epsilon = 0.0001f)
+{
+    return std::abs(a - b) < epsilon;
+}
+
+bool mat_approx_equal(const math::mat4x4& a, const math::mat4x4& b, float epsilon = 0.0001f)
+{
+    for (int r = 0; r < 4; ++r) {
+        for (int c = 0; c < 4; ++c) {
+            if (!approx_equal(a.at(r, c), b.at(r, c), epsilon)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool vec_approx_equal(const math::vec4& a, const math::vec4& b, float epsilon = 0.0001f)
+{
+    return approx_equal(a.x(), b.x(), epsilon) && approx_equal(a.y(), b.y(), epsilon) && approx_equal(a.z(), b.z(), epsilon) && approx_equal(a.w(), b.w(), epsilon);
+}
+
+// A general (non-affine) matrix so every row and column takes part.
+math::mat4x4 dense_matrix(float seed)
+{
+    math::mat4x4 m;
+    for (int r = 0; r < 4; ++r) {
+        for (int c = 0; c < 4; ++c) {
+            m.at(r, c) = std::sin(seed + 1.7f * r + 0.3f * c) * 2.0f;
+        }
+    }
+    return m;
+}
+
+template <typename S>
+bool check_both_sides(const S& s, const math::mat4x4& m)
+{
+    math::mat4x4 dense = s.to_mat4x4();
+    math::mat4x4 left = s * m;
+    math::mat4x4 right = m * s;
+    return mat_approx_equal(left, dense * m) && mat_approx_equal(right, m * dense);
+}
+
+void run_tests()
+{
+    std::cout << "=== TESTING structured_mat ===" << std::endl
+              << std::endl;
+
+    namespace st = math::structured;
+    math::mat4x4 m = dense_matrix(0.4f);
+    math::vec4 v(1.0f, -2.0f, 0.5f, 1.0f);
+
+    print_test("to_mat4x4 matches mat4x4 factories",
+        mat_approx_equal(st::translation(1, 2, 3).to_mat4x4(), math::mat4x4::translation(1, 2, 3))
+            && mat_approx_equal(st::rotation_x(0.7f).to_mat4x4(), math::mat4x4::rotation_x(0.7f))
+            && mat_approx_equal(st::rotation_y(0.7f).to_mat4x4(), math::mat4x4::rotation_y(0.7f))
+            && mat_approx_equal(st::rotation_z(0.7f).to_mat4x4(), math::mat4x4::rotation_z(0.7f)));
+    print_test("translation * M and M * translation", check_both_sides(st::translation(1.5f, -2.0f, 3.0f), m));
+    print_test("scaling * M and M * scaling", check_both_sides(st::scaling(2.0f, 0.5f, -3.0f), m));
+    print_test("rotation_x both sides", check_both_sides(st::rotation_x(0.9f), m));
+    print_test("rotation_y both sides", check_both_sides(st::rotation_y(-1.3f), m));
+    print_test("rotation_z both sides", check_both_sides(st::rotation_z(2.1f), m));
+    const math::mat4x4& bound = st::identity() * (m * m);
+    print_test("identity returns a copy of the operand", mat_approx_equal(st::identity() * m, m) && mat_approx_equal(m * st::identity(), m) && mat_approx_equal(bound, m * m));
+
+    math::mat4x4 chained = st::translation(1, 2, 3) * st::rotation_y(0.5f) * m * st::scaling(2, 2, 2);
+    math::mat4x4 dense_chain = math::mat4x4::translation(1, 2, 3) * math::mat4x4::rotation_y(0.5f) * m * math::mat4x4::scaling(2, 2, 2);
+    print_test("chained product", mat_approx_equal(chained, dense_chain));
+
+    math::mat4x4 in_place = m;
+    in_place *= st::rotation_z(0.3f);
+    print_test("operator*=", mat_approx_equal(in_place, m * math::mat4x4::rotation_z(0.3f)));
+
+    print_test("same-type composition",
+        mat_approx_equal((st::translation(1, 2, 3) * st::translation(4, 5, 6)).to_mat4x4(), math::mat4x4::translation(5, 7, 9))
+            && mat_approx_equal((st::scaling(1, 2, 3) * st::scaling(4, 5, 6)).to_mat4x4(), math::mat4x4::scaling(4, 10, 18)));
+
+    print_test("vector products",
+        vec_approx_equal(st::translation(1, 2, 3) * v, math::mat4x4::translation(1, 2, 3) * v)
+            && vec_approx_equal(st::scaling(1, 2, 3) * v, math::mat4x4::scaling(1, 2, 3) * v)
+            && vec_approx_equal(st::rotation_x(0.4f) * v, math::mat4x4::rotation_x(0.4f) * v)
+            && vec_approx_equal(st::rotation_y(0.4f) * v, math::mat4x4::rotation_y(0.4f) * v)
+            && vec_approx_equal(st::rotation_z(0.4f) * v, math::mat4x4::rotation_z(0.4f) * v));
+
+    std::cout << std::endl;
+}
+
+void run_speed_tests(size_t count)
+{
+    std::cout << "=== SPEED TESTS (" << count << " model matrices) ===" << std::endl
+              << std::endl;
+
+    namespace st = math::structured;
+    std::vector<math::mat4x4> parents(count);
+    std::vector<math::mat4x4> out(count);
+    for (size_t i = 0; i < count; ++i) {
+        parents[i] = math::mat4x4::rotation_x(0.001f * i);
+    }
+
+    // parent * T * Rz * S for every object, the usual scene-graph composition.
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        float f = static_cast<float>(i);
+        out[i] = parents[i] * math::mat4x4::translation(f, 1.0f, 2.0f) * math::mat4x4::rotation_z(0.01f * f) * math::mat4x4::scaling(2.0f, 2.0f, 2.0f);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+    std::cout << "Dense products:     " << std::setw(10) << duration.count() << " ms ("
+              << std::setw(8) << (count / duration.count() / 1000.0) << " M ops/s)" << std::endl;
+    float check = out[count / 2].at(0, 3);
+
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        float f = static_cast<float>(i);
+        out[i] = parents[i] * st::translation(f, 1.0f, 2.0f) * st::rotation_z(0.01f * f) * st::scaling(2.0f, 2.0f, 2.0f);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    duration = end - start;
+    std::cout << "Structured products:" << std::setw(10) << duration.count() << " ms ("
+              << std::setw(8) << (count / duration.count() / 1000.0) << " M ops/s)" << std::endl;
+    std::cout << "(results agree: " << (approx_equal(check, out[count / 2].at(0, 3), 0.01f) ? "yes" : "no") << ")" << std::endl;
+
+    std::cout << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    run_tests();
+    run_speed_tests(count);
+    return 0;
+}
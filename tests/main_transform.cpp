@@ -0,0 +1,194 @@
+#include <chrono>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "../transform/transform.hpp"
+
+void print_test(const char* name, bool passed)
+{
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << name << std::endl;
+}
+
+bool approx_equal(float a, float b, float epsilon = 0.0001f)
+{
+    return std::abs(a - b) < epsilon;
+}
+
+bool mat_approx_equal(const math::mat4x4& a, const math::mat4x4& b, float epsilon = 0.0001f)
+{
+    for (int r = 0; r < 4; ++r) {
+        for (int c = 0; c < 4; ++c) {
+            if (!approx_equal(a.at(r, c), b.at(r, c), epsilon)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void axis_angle(float ax, float ay, float az, float angle, float (&q)[4])
+{
+    float s = std::sin(angle * 0.5f) / std::sqrt(ax * ax + ay * ay + az * az);
+    q[0] = ax * s;
+    q[1] = ay * s;
+    q[2] = az * s;
+    q[3] = std::cos(angle * 0.5f);
+}
+
+// The uncached path: T * R * S through make_model_matrix, then a general inverse.
+math::mat4x4 reference_model(const math::vec3& t, const float (&q)[4], const math::vec3& s)
+{
+    float x = q[0], y = q[1], z = q[2], w = q[3];
+    math::mat4x4 rotation({ { { 1 - 2 * (y * y + z * z), 2 * (x * y - w * z), 2 * (x * z + w * y), 0 },
+        { 2 * (x * y + w * z), 1 - 2 * (x * x + z * z), 2 * (y * z - w * x), 0 },
+        { 2 * (x * z - w * y), 2 * (y * z + w * x), 1 - 2 * (x * x + y * y), 0 },
+        { 0, 0, 0, 1 } } });
+    return math::mat4x4::make_model_matrix(math::mat4x4::translation(t.x(), t.y(), t.z()), rotation,
+        math::mat4x4::scaling(s.x(), s.y(), s.z()));
+}
+
+void run_tests()
+{
+    std::cout << "=== TESTING transform ===" << std::endl
+              << std::endl;
+
+    math::transform identity;
+    print_test("default is identity", mat_approx_equal(identity.model_matrix(), math::mat4x4::identity()) && mat_approx_equal(identity.inverse_matrix(), math::mat4x4::identity()));
+
+    float q[4];
+    axis_angle(0.3f, 1.0f, -0.5f, 1.2f, q);
+    math::vec3 t(3.0f, -1.0f, 2.5f), s(2.0f, 0.5f, 1.5f);
+    math::transform tr(t, q, s);
+    math::mat4x4 expected = reference_model(t, q, s);
+    print_test("model matrix equals T * R * S", mat_approx_equal(tr.model_matrix(), expected));
+    print_test("inverse (non-uniform scale)", mat_approx_equal(tr.inverse_matrix(), expected.inverse()));
+
+    tr.set_scale(2.0f);
+    print_test("uniform scale detected", tr.has_uniform_scale());
+    print_test("inverse (uniform scale)", mat_approx_equal(tr.inverse_matrix(), reference_model(t, q, math::vec3(2.0f, 2.0f, 2.0f)).inverse()));
+    print_test("model * inverse is identity", mat_approx_equal(tr.model_matrix() * tr.inverse_matrix(), math::mat4x4::identity()));
+
+    tr.reset_cache_stats();
+    tr.model_matrix();
+    tr.model_matrix();
+    tr.inverse_matrix();
+    tr.set_translation(t);
+    tr.set_rotation(q);
+    tr.set_scale(2.0f);
+    tr.model_matrix();
+    math::transform_cache_stats stats = tr.cache_stats();
+    print_test("no-op setters keep the cache", stats.matrix_builds == 0 && stats.matrix_hits == 3 && stats.inverse_hits == 1);
+
+    tr.set_translation(math::vec3(0.0f, 0.0f, 0.0f));
+    tr.model_matrix();
+    tr.model_matrix();
+    stats = tr.cache_stats();
+    print_test("change rebuilds once", stats.matrix_builds == 1 && stats.matrix_hits == 4 && stats.inverse_builds == 0);
+    print_test("rebuilt matrix is current", approx_equal(tr.model_matrix().at(0, 3), 0.0f));
+
+    bool threw = false;
+    tr.set_scale(math::vec3(1.0f, 0.0f, 1.0f));
+    try {
+        tr.inverse_matrix();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    print_test("zero scale inverse throws", threw);
+
+    std::cout << std::endl;
+}
+
+void run_speed_tests(size_t count, int frames, float moving)
+{
+    std::cout << "=== SPEED TESTS (" << count << " objects x " << frames << " frames, " << moving * 100.0f << "% moving) ===" << std::endl
+              << std::endl;
+
+    // Each frame a fraction of the objects moves; every object is then read three times
+    // (culling, rendering, physics) and its inverse once (picking / local-space queries).
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<math::transform> objects;
+    std::vector<math::vec3> translations, scales;
+    std::vector<std::array<float, 4>> rotations;
+    for (size_t i = 0; i < count; ++i) {
+        float q[4];
+        axis_angle(unit(rng) + 0.1f, unit(rng), unit(rng), 6.0f * unit(rng), q);
+        translations.emplace_back(100.0f * unit(rng), 100.0f * unit(rng), 100.0f * unit(rng));
+        scales.emplace_back(1.0f, 1.0f, 1.0f);
+        rotations.push_back({ q[0], q[1], q[2], q[3] });
+        objects.emplace_back(translations.back(), q, scales.back());
+    }
+    std::vector<int> moves(static_cast<size_t>(frames) * count);
+    for (int& m : moves) {
+        m = unit(rng) < moving;
+    }
+    const double total = static_cast<double>(count) * frames;
+    float sink = 0.0f;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int f = 0; f < frames; ++f) {
+        for (size_t i = 0; i < count; ++i) {
+            if (moves[f * count + i]) {
+                translations[i].x(translations[i].x() + 0.01f);
+            }
+            float q[4] = { rotations[i][0], rotations[i][1], rotations[i][2], rotations[i][3] };
+            for (int r = 0; r < 3; ++r) {
+                sink += reference_model(translations[i], q, scales[i]).at(0, 3);
+            }
+            sink += reference_model(translations[i], q, scales[i]).inverse().at(0, 3);
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+    std::cout << "make_model_matrix + inverse:" << std::setw(10) << duration.count() << " ms ("
+              << std::setw(8) << (total / duration.count() / 1000.0) << " M objects/s)" << std::endl;
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int f = 0; f < frames; ++f) {
+        for (size_t i = 0; i < count; ++i) {
+            if (moves[f * count + i]) {
+                math::vec3 p = objects[i].translation();
+                p.x(p.x() + 0.01f);
+                objects[i].set_translation(p);
+            }
+            for (int r = 0; r < 3; ++r) {
+                sink += objects[i].model_matrix().at(0, 3);
+            }
+            sink += objects[i].inverse_matrix().at(0, 3);
+        }
+    }
+    end = std::chrono::high_resolution_clock::now();
+    duration = end - start;
+    std::cout << "cached transform:           " << std::setw(10) << duration.count() << " ms ("
+              << std::setw(8) << (total / duration.count() / 1000.0) << " M objects/s)" << std::endl;
+
+    math::transform_cache_stats stats;
+    for (const math::transform& object : objects) {
+        const math::transform_cache_stats& s = object.cache_stats();
+        stats.matrix_hits += s.matrix_hits;
+        stats.matrix_builds += s.matrix_builds;
+        stats.inverse_hits += s.inverse_hits;
+        stats.inverse_builds += s.inverse_builds;
+    }
+    std::cout << "Matrix hit rate:            " << std::setw(10) << 100.0 * stats.matrix_hits / (stats.matrix_hits + stats.matrix_builds) << " %" << std::endl;
+    std::cout << "Inverse hit rate:           " << std::setw(10) << 100.0 * stats.inverse_hits / (stats.inverse_hits + stats.inverse_builds) << " %" << std::endl;
+    std::cout << "(checksum " << sink << ")" << std::endl;
+
+    std::cout << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000;
+    int frames = argc > 2 ? std::atoi(argv[2]) : 100;
+    float moving = argc > 3 ? std::strtof(argv[3], nullptr) : 0.1f;
+    run_tests();
+    run_speed_tests(count, frames, moving);
+    return 0;
+}
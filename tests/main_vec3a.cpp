@@ -0,0 +1,158 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "../vec3a/vec3a.hpp"
+
+void print_test(const char* name, bool passed)
+{
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << name << std::endl;
+}
+
+bool approx_equal(float a, float b, float epsilon = 0.0001f)
+{
+    return std::abs(a - b) < epsilon;
+}
+
+bool same(const math::vec3a& a, const math::vec3& b, float epsilon = 0.0001f)
+{
+    return approx_equal(a.x(), b.x(), epsilon) && approx_equal(a.y(), b.y(), epsilon) && approx_equal(a.z(), b.z(), epsilon)
+        && a.to_simd()[3] == 0.0f;
+}
+
+bool same(const math::vec4& a, float x, float y, float z, float w)
+{
+    return approx_equal(a.x(), x) && approx_equal(a.y(), y) && approx_equal(a.z(), z) && approx_equal(a.w(), w);
+}
+
+// Four loose floats with the previous vec4 code: the scalar baseline for the benchmarks.
+struct scalar_vec4 {
+    float x, y, z, w;
+    scalar_vec4 operator+(const scalar_vec4& o) const { return { x + o.x, y + o.y, z + o.z, w + o.w }; }
+    scalar_vec4 operator*(float s) const { return { x * s, y * s, z * s, w * s }; }
+    float dot(const scalar_vec4& o) const { return x * o.x + y * o.y + z * o.z + w * o.w; }
+    scalar_vec4 normalized() const
+    {
+        float len_sq = dot(*this);
+        if (len_sq == 0.0f) {
+            return { 0.0f, 0.0f, 0.0f, 0.0f };
+        }
+        return *this * (1.0f / std::sqrt(len_sq));
+    }
+    scalar_vec4 lerp(const scalar_vec4& o, float t) const
+    {
+        return { x + (o.x - x) * t, y + (o.y - y) * t, z + (o.z - z) * t, w + (o.w - w) * t };
+    }
+};
+
+void run_tests()
+{
+    std::cout << "=== TESTING vec4 / vec3a (simd backend: " << math::simd::backend_name << ") ===" << std::endl
+              << std::endl;
+
+    print_test("vec3a is 16 bytes, 16-aligned", sizeof(math::vec3a) == 16 && alignof(math::vec3a) == 16);
+    print_test("vec4 is 16 bytes, 16-aligned", sizeof(math::vec4) == 16 && alignof(math::vec4) == 16);
+
+    math::vec4 a(1.0f, 2.0f, 3.0f, 4.0f), b(-2.0f, 0.5f, 1.0f, 2.0f);
+    print_test("vec4 add / sub", same(a + b, -1.0f, 2.5f, 4.0f, 6.0f) && same(a - b, 3.0f, 1.5f, 2.0f, 2.0f));
+    print_test("vec4 scale", same(a * 2.0f, 2.0f, 4.0f, 6.0f, 8.0f) && same(a / 2.0f, 0.5f, 1.0f, 1.5f, 2.0f));
+    math::vec4 c = a;
+    c += b;
+    c *= 2.0f;
+    c -= a;
+    c /= 2.0f;
+    print_test("vec4 compound", same(c, -1.5f, 1.5f, 2.5f, 4.0f));
+    print_test("vec4 dot / length", approx_equal(a.dot_production(b), 10.0f) && approx_equal(a.length(), std::sqrt(30.0f)) && approx_equal(math::vec4::dot_production(a, b), 10.0f));
+    print_test("vec4 distance", approx_equal(a.distance_to(b), std::sqrt(9.0f + 2.25f + 4.0f + 4.0f)));
+    float inv = 1.0f / std::sqrt(30.0f);
+    print_test("vec4 normalize", same(a.normalized(), inv, 2 * inv, 3 * inv, 4 * inv) && same(math::vec4::zero().normalized(), 0, 0, 0, 0));
+    print_test("vec4 lerp", same(a.lerp(b, 0.25f), 0.25f, 1.625f, 2.5f, 3.5f));
+    print_test("vec4 reflect", same(math::vec4(1, -1, 0, 0).reflect(math::vec4(0, 2, 0, 0)), 1, 1, 0, 0) && same(a.reflect(math::vec4::zero()), 1, 2, 3, 4));
+
+    math::vec3 p(1.0f, 2.0f, 3.0f), q(-4.0f, 0.5f, 2.0f);
+    math::vec3a pa(p), qa(q);
+    print_test("vec3a add / sub / scale", same(pa + qa, p + q) && same(pa - qa, p - q) && same(pa * 3.0f, p * 3.0f) && same(pa / 4.0f, p / 4.0f));
+    math::vec3a ca = pa;
+    ca += qa;
+    ca *= 0.5f;
+    ca -= pa;
+    print_test("vec3a compound", same(ca, (p + q) * 0.5f - p));
+    print_test("vec3a dot / length", approx_equal(pa.dot_production(qa), p.dot_production(q)) && approx_equal(pa.length(), p.length()));
+    print_test("vec3a cross", same(pa.cross_production(qa), p.cross_production(q)) && same(math::vec3a::cross_production(qa, pa), q.cross_production(p)));
+    print_test("vec3a normalize", same(pa.normalized(), p.normalized()) && same(math::vec3a::zero().normalized(), math::vec3::zero()));
+    math::vec3a na = qa;
+    na.normalize();
+    print_test("vec3a normalize in place", same(na, q.normalized()));
+    print_test("vec3a lerp", same(math::vec3a::lerp(pa, qa, 0.3f), math::vec3::lerp(p, q, 0.3f)));
+    print_test("vec3a reflect", same(pa.reflect(qa), p.reflect(q)));
+    print_test("vec3a distance", approx_equal(pa.distance_to(qa), p.distance_to(q)));
+
+    math::vec3a from4(math::vec4(1.0f, 2.0f, 3.0f, 9.0f));
+    print_test("vec3a from vec4 drops w", same(from4, p));
+    print_test("vec3a to vec4 / vec3", same(pa.to_vec4(), 1, 2, 3, 1) && same(pa.to_vec4(0.0f), 1, 2, 3, 0) && same(math::vec3a(pa.to_vec3()), p));
+    print_test("vec3a from register clears w", math::vec3a(math::simd::f32x4(7.0f)).to_simd()[3] == 0.0f);
+
+    std::cout << std::endl;
+}
+
+void run_speed_tests(size_t count, int repeats)
+{
+    std::cout << "=== SPEED TESTS (" << count << " vectors x " << repeats << ", simd backend: " << math::simd::backend_name << ") ===" << std::endl
+              << std::endl;
+
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<math::vec3> u3(count), v3(count), o3(count);
+    std::vector<math::vec3a> u3a(count), v3a(count), o3a(count);
+    std::vector<scalar_vec4> u4s(count), v4s(count), o4s(count);
+    std::vector<math::vec4> u4(count), v4(count), o4(count);
+    for (size_t i = 0; i < count; ++i) {
+        float a[8];
+        for (float& x : a) {
+            x = unit(rng);
+        }
+        u3[i] = math::vec3(a[0], a[1], a[2]);
+        v3[i] = math::vec3(a[4], a[5], a[6]);
+        u3a[i] = math::vec3a(u3[i]);
+        v3a[i] = math::vec3a(v3[i]);
+        u4s[i] = { a[0], a[1], a[2], a[3] };
+        v4s[i] = { a[4], a[5], a[6], a[7] };
+        u4[i] = math::vec4(a[0], a[1], a[2], a[3]);
+        v4[i] = math::vec4(a[4], a[5], a[6], a[7]);
+    }
+    float sink = 0.0f;
+
+    report("vec3  add + scale:     ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) o3[i] = (u3[i] + v3[i]) * 0.5f; });
+    report("vec3a add + scale:     ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) o3a[i] = (u3a[i] + v3a[i]) * 0.5f; });
+    report("vec3  dot:             ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) sink += u3[i].dot_production(v3[i]); });
+    report("vec3a dot:             ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) sink += u3a[i].dot_production(v3a[i]); });
+    report("vec3  cross:           ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) o3[i] = u3[i].cross_production(v3[i]); });
+    report("vec3a cross:           ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) o3a[i] = u3a[i].cross_production(v3a[i]); });
+    report("vec3  normalize:       ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) o3[i] = u3[i].normalized(); });
+    report("vec3a normalize:       ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) o3a[i] = u3a[i].normalized(); });
+    report("vec3  lerp:            ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) o3[i] = math::vec3::lerp(u3[i], v3[i], 0.3f); });
+    report("vec3a lerp:            ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) o3a[i] = math::vec3a::lerp(u3a[i], v3a[i], 0.3f); });
+    report("vec3  reflect:         ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) o3[i] = u3[i].reflect(v3[i]); });
+    report("vec3a reflect:         ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) o3a[i] = u3a[i].reflect(v3a[i]); });
+    report("scalar vec4 add+scale: ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) o4s[i] = (u4s[i] + v4s[i]) * 0.5f; });
+    report("vec4  add + scale:     ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) o4[i] = (u4[i] + v4[i]) * 0.5f; });
+    report("scalar vec4 normalize: ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) o4s[i] = u4s[i].normalized(); });
+    report("vec4  normalize:       ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) o4[i] = u4[i].normalized(); });
+    report("scalar vec4 lerp:      ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) o4s[i] = u4s[i].lerp(v4s[i], 0.3f); });
+    report("vec4  lerp:            ", count, repeats, [&] { for (size_t i = 0; i < count; ++i) o4[i] = u4[i].lerp(v4[i], 0.3f); });
+
+    std::cout << "(checksum " << sink + o3[0].x() + o3a[0].x() + o4s[0].x + o4[0].x() << ")" << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    // Defaults keep the arrays in cache so the per-operation cost is measured, not bandwidth.
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 16384;
+    int repeats = argc > 2 ? std::atoi(argv[2]) : 1000;
+    run_tests();
+    run_speed_tests(count, repeats);
+    return 0;
+}
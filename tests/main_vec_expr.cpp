@@ -0,0 +1,150 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "../vec_expr/vec_expr.hpp"
+
+void print_test(const char* name, bool passed)
+{
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << name << std::endl;
+}
+
+bool approx_equal(float a, float b, float epsilon = 0.0001f)
+{
+    return std::abs(a - b) < epsilon;
+}
+
+bool vec_approx_equal(const math::vec3& a, const math::vec3& b, float epsilon = 0.0001f)
+{
+    return approx_equal(a.x(), b.x(), epsilon) && approx_equal(a.y(), b.y(), epsilon) && approx_equal(a.z(), b.z(), epsilon);
+}
+
+void run_tests()
+{
+    namespace expr = math::expr;
+
+    std::cout << "=== TESTING vec_expr ===" << std::endl
+              << std::endl;
+
+    math::vec3 a(1.0f, 2.0f, 3.0f);
+    math::vec3 b(4.0f, 5.0f, 6.0f);
+    math::vec3 c(0.0f, 1.0f, 0.0f);
+    math::vec3 d(0.0f, 0.0f, 1.0f);
+    float s = 0.5f;
+
+    math::vec3 expected = a + b * s - c.cross_production(d);
+    math::vec3 fused = expr::evaluate<math::vec3>(expr::ref(a) + expr::ref(b) * s - expr::cross(expr::ref(c), expr::ref(d)));
+    print_test("a + b * s - cross(c, d)", vec_approx_equal(fused, expected));
+
+    math::vec3 negated;
+    expr::evaluate(negated, -expr::ref(a) / 2.0f);
+    print_test("unary minus and division", vec_approx_equal(negated, math::vec3(-0.5f, -1.0f, -1.5f)));
+
+    math::vec3 lerped = expr::evaluate<math::vec3>(expr::lerp(expr::ref(a), expr::ref(b), 0.25f));
+    print_test("lerp", vec_approx_equal(lerped, math::vec3::lerp(a, b, 0.25f)));
+
+    math::vec3 projected = expr::evaluate<math::vec3>(expr::ref(c) * expr::dot(expr::ref(a), expr::ref(c)));
+    print_test("scale by dot", vec_approx_equal(projected, a.project_on_vector(c)));
+
+    math::vec4 p(1.0f, 2.0f, 3.0f, 4.0f);
+    math::vec4 q(4.0f, 3.0f, 2.0f, 1.0f);
+    math::vec4 r = expr::evaluate<math::vec4>(expr::ref(p) - expr::ref(q) * 2.0f);
+    print_test("vec4 expression", approx_equal(r.x(), -7.0f) && approx_equal(r.y(), -4.0f) && approx_equal(r.z(), -1.0f) && approx_equal(r.w(), 2.0f));
+
+    std::vector<math::vec3> va = { a, b, c };
+    std::vector<math::vec3> vb = { d, a, b };
+    std::vector<float> weights = { 1.0f, 2.0f, 3.0f };
+    std::vector<math::vec3> out(va.size());
+    expr::evaluate(std::span { out }, expr::each(va) + expr::each(vb) * expr::each(weights));
+    bool arrays_ok = true;
+    for (size_t i = 0; i < out.size(); ++i) {
+        arrays_ok = arrays_ok && vec_approx_equal(out[i], va[i] + vb[i] * weights[i]);
+    }
+    print_test("array evaluation", arrays_ok);
+
+    std::vector<float> dots(va.size());
+    expr::evaluate(std::span { dots }, expr::dot(expr::each(va), expr::each(vb)));
+    print_test("array dot", approx_equal(dots[1], b.dot_production(a)));
+
+    bool threw = false;
+    try {
+        expr::evaluate(std::span { out }, expr::each(va) + expr::each(std::span<const math::vec3>(vb.data(), 2)));
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    print_test("short each() operand throws", threw);
+
+    int single_threw = 0;
+    try {
+        expr::evaluate<math::vec3>(expr::each(va) + expr::ref(a));
+    } catch (const std::invalid_argument&) {
+        ++single_threw;
+    }
+    try {
+        math::vec3 single;
+        expr::evaluate(single, expr::each(std::span<const math::vec3>()));
+    } catch (const std::invalid_argument&) {
+        ++single_threw;
+    }
+    math::vec3 first = expr::evaluate<math::vec3>(expr::each(std::span<const math::vec3>(va.data(), 1)) * 2.0f);
+    print_test("single-value evaluate needs one-element each() operands", single_threw == 2 && vec_approx_equal(first, va[0] * 2.0f));
+
+    std::cout << std::endl;
+}
+
+void run_speed_tests(size_t count, int repeats)
+{
+    namespace expr = math::expr;
+
+    std::cout << "=== SPEED TESTS (" << count << " vectors x " << repeats << ") ===" << std::endl
+              << std::endl;
+
+    std::vector<math::vec3> a(count), b(count), c(count), d(count), out(count);
+    for (size_t i = 0; i < count; ++i) {
+        float f = static_cast<float>(i % 1024);
+        a[i] = math::vec3(f, f + 1.0f, f + 2.0f);
+        b[i] = math::vec3(f * 0.5f, 1.0f, -f);
+        c[i] = math::vec3(1.0f, f, 0.25f);
+        d[i] = math::vec3(-f, 2.0f, 3.0f);
+    }
+    const float s = 0.75f;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = a[i] + b[i] * s - c[i].cross_production(d[i]);
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> operators = end - start;
+    float check_operators = out[count / 2].x();
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        expr::evaluate(std::span { out }, expr::each(a) + expr::each(b) * s - expr::cross(expr::each(c), expr::each(d)));
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> fused = end - start;
+
+    const double total = static_cast<double>(count) * repeats;
+    std::cout << "Operator chain:       " << std::setw(10) << operators.count() << " ms ("
+              << std::setw(8) << (total / operators.count() / 1000.0) << " M ops/s)" << std::endl;
+    std::cout << "Fused expression:     " << std::setw(10) << fused.count() << " ms ("
+              << std::setw(8) << (total / fused.count() / 1000.0) << " M ops/s)" << std::endl;
+    std::cout << "Speedup:              " << std::setw(10) << (operators.count() / fused.count()) << "x" << std::endl;
+    print_test("results match", approx_equal(check_operators, out[count / 2].x(), 0.01f));
+    std::cout << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    int repeats = argc > 2 ? std::atoi(argv[2]) : 100;
+    run_tests();
+    run_speed_tests(count, repeats);
+    return 0;
+}
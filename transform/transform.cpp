@@ -0,0 +1,108 @@
+#include "transform.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+inline bool same(const math::vec3 &a, const math::vec3 &b) {
+    return a.x() == b.x() && a.y() == b.y() && a.z() == b.z();
+}
+
+} // namespace
+
+namespace math {
+
+transform::transform()
+    : m_translation(0.0f, 0.0f, 0.0f), m_rotation{0.0f, 0.0f, 0.0f, 1.0f}, m_scale(1.0f, 1.0f, 1.0f),
+      m_model_valid(true), m_inverse_valid(true), m_model(mat4x4::identity()),
+      m_inverse(mat4x4::identity()) {}
+
+transform::transform(const vec3 &translation, const float (&rotation)[4], const vec3 &scale)
+    : m_translation(translation), m_rotation{rotation[0], rotation[1], rotation[2], rotation[3]},
+      m_scale(scale), m_model_valid(false), m_inverse_valid(false) {}
+
+void transform::set_translation(const vec3 &translation) {
+    if (same(translation, m_translation)) {
+        return;
+    }
+    m_translation = translation;
+    invalidate();
+}
+
+void transform::set_rotation(const float (&rotation)[4]) {
+    if (rotation[0] == m_rotation[0] && rotation[1] == m_rotation[1] &&
+        rotation[2] == m_rotation[2] && rotation[3] == m_rotation[3]) {
+        return;
+    }
+    for (int c = 0; c < 4; ++c) {
+        m_rotation[c] = rotation[c];
+    }
+    invalidate();
+}
+
+void transform::set_scale(const vec3 &scale) {
+    if (same(scale, m_scale)) {
+        return;
+    }
+    m_scale = scale;
+    invalidate();
+}
+
+void transform::set_scale(float uniform_scale) { set_scale(vec3(uniform_scale, uniform_scale, uniform_scale)); }
+
+bool transform::has_uniform_scale() const {
+    return m_scale.x() == m_scale.y() && m_scale.y() == m_scale.z();
+}
+
+void transform::reset_cache_stats() { m_stats = {}; }
+
+void transform::invalidate() {
+    m_model_valid = false;
+    m_inverse_valid = false;
+}
+
+void transform::build_model_matrix() const {
+    const float x = m_rotation[0], y = m_rotation[1], z = m_rotation[2], w = m_rotation[3];
+    const float sx = m_scale.x(), sy = m_scale.y(), sz = m_scale.z();
+    m_model = mat4x4({{{(1.0f - 2.0f * (y * y + z * z)) * sx, 2.0f * (x * y - w * z) * sy,
+                        2.0f * (x * z + w * y) * sz, m_translation.x()},
+                       {2.0f * (x * y + w * z) * sx, (1.0f - 2.0f * (x * x + z * z)) * sy,
+                        2.0f * (y * z - w * x) * sz, m_translation.y()},
+                       {2.0f * (x * z - w * y) * sx, 2.0f * (y * z + w * x) * sy,
+                        (1.0f - 2.0f * (x * x + y * y)) * sz, m_translation.z()},
+                       {0.0f, 0.0f, 0.0f, 1.0f}}});
+    m_model_valid = true;
+    ++m_stats.matrix_builds;
+}
+
+void transform::build_inverse_matrix() const {
+    const float sx = m_scale.x(), sy = m_scale.y(), sz = m_scale.z();
+    if (std::abs(sx) < 1e-8f || std::abs(sy) < 1e-8f || std::abs(sz) < 1e-8f) {
+        throw std::runtime_error("Matrix is not invertible");
+    }
+    const float x = m_rotation[0], y = m_rotation[1], z = m_rotation[2], w = m_rotation[3];
+    // Rows of R^T are the columns of R, each divided by its axis scale.
+    float rows[3][3] = {{1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + w * z), 2.0f * (x * z - w * y)},
+                        {2.0f * (x * y - w * z), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + w * x)},
+                        {2.0f * (x * z + w * y), 2.0f * (y * z - w * x), 1.0f - 2.0f * (x * x + y * y)}};
+    const float inv[3] = {1.0f / sx, 1.0f / sy, 1.0f / sz};
+    for (int r = 0; r < 3; ++r) {
+        rows[r][0] *= inv[r];
+        rows[r][1] *= inv[r];
+        rows[r][2] *= inv[r];
+    }
+    const float tx = m_translation.x(), ty = m_translation.y(), tz = m_translation.z();
+    float offset[3];
+    for (int r = 0; r < 3; ++r) {
+        offset[r] = -(rows[r][0] * tx + rows[r][1] * ty + rows[r][2] * tz);
+    }
+    m_inverse = mat4x4({{{rows[0][0], rows[0][1], rows[0][2], offset[0]},
+                         {rows[1][0], rows[1][1], rows[1][2], offset[1]},
+                         {rows[2][0], rows[2][1], rows[2][2], offset[2]},
+                         {0.0f, 0.0f, 0.0f, 1.0f}}});
+    m_inverse_valid = true;
+    ++m_stats.inverse_builds;
+}
+
+} // namespace math
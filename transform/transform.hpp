@@ -0,0 +1,87 @@
+#ifndef TRANSFORM_HPP
+#define TRANSFORM_HPP
+
+#include "../mat4x4/mat4x4.hpp"
+
+#include <cstdint>
+
+namespace math {
+
+struct transform_cache_stats {
+    std::uint64_t matrix_hits = 0;
+    std::uint64_t matrix_builds = 0;
+    std::uint64_t inverse_hits = 0;
+    std::uint64_t inverse_builds = 0;
+};
+
+// Translation, rotation (unit quaternion, x, y, z, w) and per-axis scale of an object. The
+// model matrix T * R * S and its inverse are cached and rebuilt on the first access after a
+// change; setters that store the current value do not invalidate the cache.
+class transform {
+  public:
+    transform();
+    transform(const vec3 &translation, const float (&rotation)[4], const vec3 &scale);
+
+    const vec3 &translation() const;
+    const float (&rotation() const)[4];
+    const vec3 &scale() const;
+
+    void set_translation(const vec3 &translation);
+    void set_rotation(const float (&rotation)[4]);
+    void set_scale(const vec3 &scale);
+    void set_scale(float uniform_scale);
+
+    bool has_uniform_scale() const;
+
+    const mat4x4 &model_matrix() const;
+    // Built in closed form as S^-1 * R^T * T^-1 rather than a general 4x4 inverse, so it
+    // costs no more than the model matrix; throws std::runtime_error when a scale is zero.
+    const mat4x4 &inverse_matrix() const;
+
+    const transform_cache_stats &cache_stats() const;
+    void reset_cache_stats();
+
+  private:
+    void invalidate();
+    void build_model_matrix() const;
+    void build_inverse_matrix() const;
+
+    vec3 m_translation;
+    float m_rotation[4];
+    vec3 m_scale;
+    mutable bool m_model_valid;
+    mutable bool m_inverse_valid;
+    mutable mat4x4 m_model;
+    mutable mat4x4 m_inverse;
+    mutable transform_cache_stats m_stats;
+};
+
+inline const vec3 &transform::translation() const { return m_translation; }
+
+inline const float (&transform::rotation() const)[4] { return m_rotation; }
+
+inline const vec3 &transform::scale() const { return m_scale; }
+
+inline const mat4x4 &transform::model_matrix() const {
+    if (m_model_valid) [[likely]] {
+        ++m_stats.matrix_hits;
+    } else {
+        build_model_matrix();
+    }
+    return m_model;
+}
+
+inline const mat4x4 &transform::inverse_matrix() const {
+    if (m_inverse_valid) [[likely]] {
+        ++m_stats.inverse_hits;
+    } else {
+        build_inverse_matrix();
+    }
+    return m_inverse;
+}
+
+inline const transform_cache_stats &transform::cache_stats() const { return m_stats; }
+
+} // namespace math
+
+#endif // TRANSFORM_HPP
@@ -16,6 +16,8 @@ class vec2 {
     vec2(const point2 &start, const point2 &end);
     vec2(const vec2 &other);
 
+    vec2 &operator=(const vec2 &other) = default;
+
     float x() const;
     float y() const;
 
@@ -5,10 +5,7 @@ namespace math {
 
 vec3::vec3() : m_x(0.0f), m_y(0.0f), m_z(0.0f) {}
 
-vec3::vec3(float x, float y, float z, bool normalize) {
-    this->m_x = x;
-    this->m_y = y;
-    this->m_z = z;
+vec3::vec3(float x, float y, float z, bool normalize) : m_x(x), m_y(y), m_z(z) {
     if (normalize) [[unlikely]] {
         this->normalize();
     }
@@ -54,27 +51,6 @@ vec3::vec3(const vec3& other)
     m_z = other.m_z;
 }
 
-float vec3::x() const { return m_x; }
-
-float vec3::y() const { return m_y; }
-
-float vec3::z() const { return m_z; }
-
-float vec3::x(float x) {
-    m_x = x;
-    return m_x;
-}
-
-float vec3::y(float y) {
-    m_y = y;
-    return m_y;
-}
-
-float vec3::z(float z) {
-    m_z = z;
-    return m_z;
-}
-
 vec3 &math::vec3::operator=(const vec3 &other) {
     if (this != &other) [[likely]] {
         this->m_x = other.m_x;
@@ -99,19 +75,11 @@ vec3 &vec3::operator-=(const vec3 &other) {
 }
 
 vec3 vec3::operator+(const vec3 &other) const {
-    vec3 result;
-    result.m_x = m_x + other.m_x;
-    result.m_y = m_y + other.m_y;
-    result.m_z = m_z + other.m_z;
-    return result;
+    return vec3(m_x + other.m_x, m_y + other.m_y, m_z + other.m_z);
 }
 
 vec3 vec3::operator-(const vec3 &other) const {
-    vec3 result;
-    result.m_x = m_x - other.m_x;
-    result.m_y = m_y - other.m_y;
-    result.m_z = m_z - other.m_z;
-    return result;
+    return vec3(m_x - other.m_x, m_y - other.m_y, m_z - other.m_z);
 }
 
 vec3 &vec3::operator*=(float scalar) {
@@ -128,13 +96,7 @@ vec3 &vec3::operator/=(float scalar) {
     return *this;
 }
 
-vec3 vec3::operator*(float scalar) const {
-    vec3 result;
-    result.m_x = m_x * scalar;
-    result.m_y = m_y * scalar;
-    result.m_z = m_z * scalar;
-    return result;
-}
+vec3 vec3::operator*(float scalar) const { return vec3(m_x * scalar, m_y * scalar, m_z * scalar); }
 
 vec3 vec3::operator/(float scalar) const { return vec3(m_x / scalar, m_y / scalar, m_z / scalar); }
 
@@ -143,11 +105,8 @@ float vec3::dot_production(const vec3 &other) const {
 }
 
 vec3 vec3::cross_production(const vec3 &other) const {
-    vec3 result;
-    result.m_x = m_y * other.m_z - m_z * other.m_y;
-    result.m_y = m_z * other.m_x - m_x * other.m_z;
-    result.m_z = m_x * other.m_y - m_y * other.m_x;
-    return result;
+    return vec3(m_y * other.m_z - m_z * other.m_y, m_z * other.m_x - m_x * other.m_z,
+                m_x * other.m_y - m_y * other.m_x);
 }
 
 float vec3::distance_to(const vec3 &other) const {
@@ -333,11 +292,8 @@ float vec3::angle_between(const vec3 &a, const vec3 &b) {
 }
 
 vec3 vec3::cross_production(const vec3 &a, const vec3 &b) {
-    vec3 result;
-    result.m_x = a.m_y * b.m_z - a.m_z * b.m_y;
-    result.m_y = a.m_z * b.m_x - a.m_x * b.m_z;
-    result.m_z = a.m_x * b.m_y - a.m_y * b.m_x;
-    return result;
+    return vec3(a.m_y * b.m_z - a.m_z * b.m_y, a.m_z * b.m_x - a.m_x * b.m_z,
+                a.m_x * b.m_y - a.m_y * b.m_x);
 }
 
 float vec3::dot_production(const vec3 &a, const vec3 &b) {
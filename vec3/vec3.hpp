@@ -91,6 +91,27 @@ class vec3 {
     float m_x, m_y, m_z;
 };
 
+inline float vec3::x() const { return m_x; }
+
+inline float vec3::y() const { return m_y; }
+
+inline float vec3::z() const { return m_z; }
+
+inline float vec3::x(float x) {
+    m_x = x;
+    return m_x;
+}
+
+inline float vec3::y(float y) {
+    m_y = y;
+    return m_y;
+}
+
+inline float vec3::z(float z) {
+    m_z = z;
+    return m_z;
+}
+
 vec3 l_inf_normalize(const vec3 &v);
 vec3 l_one_normalize(const vec3 &v);
 vec3 static_normalize(const vec3 &v);
@@ -0,0 +1,195 @@
+#ifndef VEC3A_HPP
+#define VEC3A_HPP
+
+#include "../simd/simd.hpp"
+#include "../vec4/vec4.hpp"
+
+#include <cmath>
+
+namespace math {
+
+// vec3 padded to 16 bytes and 16-byte aligned, so every operation works on one register.
+// The fourth lane is padding and kept at zero. Use it for hot arithmetic; vec3 stays the
+// packed 12-byte type for storage and interchange.
+class vec3a {
+  public:
+    vec3a();
+    vec3a(float x, float y, float z);
+    explicit vec3a(const vec3 &v);
+    // Drops w.
+    explicit vec3a(const vec4 &v);
+    // Lanes x, y, z of a register; lane 3 is cleared.
+    explicit vec3a(simd::f32x4 lanes);
+
+    vec3 to_vec3() const;
+    vec4 to_vec4(float w = 1.0f) const;
+    // x, y, z, 0.
+    simd::f32x4 to_simd() const;
+
+    float x() const;
+    float y() const;
+    float z() const;
+
+    float x(float x);
+    float y(float y);
+    float z(float z);
+
+    vec3a &operator+=(const vec3a &other);
+    vec3a &operator-=(const vec3a &other);
+    vec3a operator+(const vec3a &other) const;
+    vec3a operator-(const vec3a &other) const;
+
+    vec3a &operator*=(float scalar);
+    vec3a &operator/=(float scalar);
+    vec3a operator*(float scalar) const;
+    vec3a operator/(float scalar) const;
+
+    float dot_production(const vec3a &other) const;
+    vec3a cross_production(const vec3a &other) const;
+
+    float distance_to(const vec3a &other) const;
+
+    float length() const;
+    vec3a normalized() const;
+    void normalize();
+    vec3a reflect(const vec3a &normal) const;
+
+    static vec3a zero();
+
+    static vec3a lerp(const vec3a &a, const vec3a &b, float t);
+
+    static vec3a cross_production(const vec3a &a, const vec3a &b);
+    static float dot_production(const vec3a &a, const vec3a &b);
+
+  private:
+    // Wraps a register whose lane 3 is already zero.
+    static vec3a from_lanes(simd::f32x4 lanes);
+
+    alignas(16) float m_v[4];
+};
+
+static_assert(sizeof(vec3a) == 16 && alignof(vec3a) == 16, "vec3a is one 16-byte register");
+
+inline vec3a::vec3a() : m_v{0.0f, 0.0f, 0.0f, 0.0f} {}
+
+inline vec3a::vec3a(float x, float y, float z) : m_v{x, y, z, 0.0f} {}
+
+inline vec3a::vec3a(const vec3 &v) : m_v{v.x(), v.y(), v.z(), 0.0f} {}
+
+inline vec3a::vec3a(const vec4 &v) : vec3a(v.to_simd()) {}
+
+inline vec3a::vec3a(simd::f32x4 lanes) {
+    lanes.store(m_v);
+    m_v[3] = 0.0f;
+}
+
+inline vec3a vec3a::from_lanes(simd::f32x4 lanes) {
+    vec3a result;
+    lanes.store(result.m_v);
+    return result;
+}
+
+inline vec3 vec3a::to_vec3() const { return vec3(m_v[0], m_v[1], m_v[2]); }
+
+inline vec4 vec3a::to_vec4(float w) const {
+    vec4 result(to_simd());
+    result.w(w);
+    return result;
+}
+
+inline simd::f32x4 vec3a::to_simd() const { return simd::f32x4::load(m_v); }
+
+inline float vec3a::x() const { return m_v[0]; }
+
+inline float vec3a::y() const { return m_v[1]; }
+
+inline float vec3a::z() const { return m_v[2]; }
+
+inline float vec3a::x(float x) {
+    m_v[0] = x;
+    return m_v[0];
+}
+
+inline float vec3a::y(float y) {
+    m_v[1] = y;
+    return m_v[1];
+}
+
+inline float vec3a::z(float z) {
+    m_v[2] = z;
+    return m_v[2];
+}
+
+inline vec3a &vec3a::operator+=(const vec3a &other) { return *this = *this + other; }
+
+inline vec3a &vec3a::operator-=(const vec3a &other) { return *this = *this - other; }
+
+inline vec3a vec3a::operator+(const vec3a &other) const {
+    return from_lanes(to_simd() + other.to_simd());
+}
+
+inline vec3a vec3a::operator-(const vec3a &other) const {
+    return from_lanes(to_simd() - other.to_simd());
+}
+
+inline vec3a &vec3a::operator*=(float scalar) { return *this = *this * scalar; }
+
+inline vec3a &vec3a::operator/=(float scalar) { return *this = *this / scalar; }
+
+inline vec3a vec3a::operator*(float scalar) const { return from_lanes(to_simd() * scalar); }
+
+inline vec3a vec3a::operator/(float scalar) const { return from_lanes(to_simd() / scalar); }
+
+inline float vec3a::dot_production(const vec3a &other) const {
+    return reduce_add(to_simd() * other.to_simd());
+}
+
+// a x b = yzx(a * yzx(b) - yzx(a) * b); lane 3 stays zero.
+inline vec3a vec3a::cross_production(const vec3a &other) const {
+    const simd::f32x4 a = to_simd(), b = other.to_simd();
+    const simd::f32x4 c = fnmadd(shuffle<1, 2, 0, 3>(a), b, a * shuffle<1, 2, 0, 3>(b));
+    return from_lanes(shuffle<1, 2, 0, 3>(c));
+}
+
+inline float vec3a::distance_to(const vec3a &other) const { return (*this - other).length(); }
+
+inline float vec3a::length() const { return std::sqrt(dot_production(*this)); }
+
+inline vec3a vec3a::normalized() const {
+    const float len_sq = dot_production(*this);
+    if (len_sq < 1e-8f) [[unlikely]] {
+        return vec3a();
+    }
+    return from_lanes(to_simd() * (1.0f / std::sqrt(len_sq)));
+}
+
+inline void vec3a::normalize() { *this = normalized(); }
+
+inline vec3a vec3a::reflect(const vec3a &normal) const {
+    const float len_sq = normal.dot_production(normal);
+    if (len_sq < 1e-8f) [[unlikely]] {
+        return *this;
+    }
+    // v - 2 (v . n) n / |n|^2
+    const float factor = 2.0f * dot_production(normal) / len_sq;
+    return from_lanes(fnmadd(simd::f32x4(factor), normal.to_simd(), to_simd()));
+}
+
+inline vec3a vec3a::zero() { return vec3a(); }
+
+inline vec3a vec3a::lerp(const vec3a &a, const vec3a &b, float t) {
+    const simd::f32x4 va = a.to_simd();
+    return from_lanes(fmadd(b.to_simd() - va, t, va));
+}
+
+inline vec3a vec3a::cross_production(const vec3a &a, const vec3a &b) {
+    return a.cross_production(b);
+}
+
+inline float vec3a::dot_production(const vec3a &a, const vec3a &b) {
+    return a.dot_production(b);
+}
+
+} // namespace math
+
+#endif // VEC3A_HPP
@@ -1,152 +1,40 @@
 #include "vec4.hpp"
 #include <cmath>
 
-math::vec4::vec4() : m_x(0.0f), m_y(0.0f), m_z(0.0f), m_w(0.0f) {}
-math::vec4::vec4(float x, float y, float z, float w) : m_x(x), m_y(y), m_z(z), m_w(w) {}
+math::vec4::vec4() : m_v{0.0f, 0.0f, 0.0f, 0.0f} {}
+math::vec4::vec4(float x, float y, float z, float w) : m_v{x, y, z, w} {}
 
 math::vec4::vec4(const point4& point)
 {
-    m_x = point.x;
-    m_y = point.y;
-    m_z = point.z;
-    m_w = point.w;
+    m_v[0] = point.x;
+    m_v[1] = point.y;
+    m_v[2] = point.z;
+    m_v[3] = point.w;
 }
 
 math::vec4::vec4(const point4& start, const point4& end)
 {
-    m_x = end.x - start.x;
-    m_y = end.y - start.y;
-    m_z = end.z - start.z;
-    m_w = end.w - start.w;
+    m_v[0] = end.x - start.x;
+    m_v[1] = end.y - start.y;
+    m_v[2] = end.z - start.z;
+    m_v[3] = end.w - start.w;
 }
 
-math::vec4::vec4(const vec3 &v, float w) : m_x(v.x()), m_y(v.y()), m_z(v.z()), m_w(w) {}
+math::vec4::vec4(const vec3 &v, float w) : m_v{v.x(), v.y(), v.z(), w} {}
 
 math::vec4::vec4(const point3& point, float w)
 {
-    m_x = point.x;
-    m_y = point.y;
-    m_z = point.z;
-    m_w = w;
-}
-
-math::vec4::vec4(const vec4& other)
-{
-    m_x = other.m_x;
-    m_y = other.m_y;
-    m_z = other.m_z;
-    m_w = other.m_w;
-}
-
-float math::vec4::x() const { return m_x; }
-
-float math::vec4::y() const { return m_y; }
-
-float math::vec4::z() const { return m_z; }
-
-float math::vec4::w() const { return m_w; }
-
-float math::vec4::x(float x) {
-    m_x = x;
-    return m_x;
-}
-
-float math::vec4::y(float y) {
-    m_y = y;
-    return m_y;
-}
-float math::vec4::z(float z) {
-    m_z = z;
-    return m_z;
-}
-
-float math::vec4::w(float w) {
-    m_w = w;
-    return m_w;
-}
-
-math::vec4 math::vec4::operator+(const vec4 &other) const {
-    return vec4(m_x + other.m_x, m_y + other.m_y, m_z + other.m_z, m_w + other.m_w);
-}
-
-math::vec4 math::vec4::operator-(const vec4 &other) const {
-    return vec4(m_x - other.m_x, m_y - other.m_y, m_z - other.m_z, m_w - other.m_w);
-}
-
-math::vec4 math::vec4::operator*(float scalar) const {
-    return vec4(m_x * scalar, m_y * scalar, m_z * scalar, m_w * scalar);
-}
-
-math::vec4 math::vec4::operator/(float scalar) const {
-    return vec4(m_x / scalar, m_y / scalar, m_z / scalar, m_w / scalar);
-}
-
-math::vec4 &math::vec4::operator+=(const vec4 &other) {
-    m_x += other.m_x;
-    m_y += other.m_y;
-    m_z += other.m_z;
-    m_w += other.m_w;
-    return *this;
-}
-
-math::vec4 &math::vec4::operator-=(const vec4 &other) {
-    m_x -= other.m_x;
-    m_y -= other.m_y;
-    m_z -= other.m_z;
-    m_w -= other.m_w;
-    return *this;
-}
-
-math::vec4 &math::vec4::operator*=(float scalar) {
-    m_x *= scalar;
-    m_y *= scalar;
-    m_z *= scalar;
-    m_w *= scalar;
-    return *this;
-}
-
-math::vec4 &math::vec4::operator/=(float scalar) {
-    m_x /= scalar;
-    m_y /= scalar;
-    m_z /= scalar;
-    m_w /= scalar;
-    return *this;
-}
-
-float math::vec4::length() const {
-    return std::sqrt(m_x * m_x + m_y * m_y + m_z * m_z + m_w * m_w);
-}
-
-math::vec4 math::vec4::normalized() const {
-    float len_sq = m_x * m_x + m_y * m_y + m_z * m_z + m_w * m_w;
-    if (len_sq == 0.0f) [[unlikely]] {
-        return vec4(0.0f, 0.0f, 0.0f, 0.0f);
-    }
-    float invlen = 1.0f / std::sqrt(len_sq);
-    return vec4(m_x * invlen, m_y * invlen, m_z * invlen, m_w * invlen);
-}
-
-void math::vec4::normalize() {
-    float len_sq = m_x * m_x + m_y * m_y + m_z * m_z + m_w * m_w;
-    if (len_sq == 0.0f) [[unlikely]] {
-        m_x = 0.0f;
-        m_y = 0.0f;
-        m_z = 0.0f;
-        m_w = 0.0f;
-        return;
-    }
-    float invlen = 1.0f / std::sqrt(len_sq);
-    m_x *= invlen;
-    m_y *= invlen;
-    m_z *= invlen;
-    m_w *= invlen;
+    m_v[0] = point.x;
+    m_v[1] = point.y;
+    m_v[2] = point.z;
+    m_v[3] = w;
 }
 
 float math::vec4::angle_between(const vec4 &other) const {
     float dot = this->dot_production(other);
-    float len_sq = m_x * m_x + m_y * m_y + m_z * m_z + m_w * m_w;
-    float other_len_sq = other.m_x * other.m_x + other.m_y * other.m_y + other.m_z * other.m_z +
-                         other.m_w * other.m_w;
+    float len_sq = m_v[0] * m_v[0] + m_v[1] * m_v[1] + m_v[2] * m_v[2] + m_v[3] * m_v[3];
+    float other_len_sq = other.m_v[0] * other.m_v[0] + other.m_v[1] * other.m_v[1] + other.m_v[2] * other.m_v[2] +
+                         other.m_v[3] * other.m_v[3];
     float len_product = std::sqrt(len_sq * other_len_sq);
     if (len_product == 0.0f) [[unlikely]] {
         return 0.0f;
@@ -155,17 +43,17 @@ float math::vec4::angle_between(const vec4 &other) const {
     return std::acos(cos_angle);
 }
 
-float math::vec4::x_axis_angle() const { return std::acos(m_x / this->length()); }
+float math::vec4::x_axis_angle() const { return std::acos(m_v[0] / this->length()); }
 
-float math::vec4::y_axis_angle() const { return std::acos(m_y / this->length()); }
+float math::vec4::y_axis_angle() const { return std::acos(m_v[1] / this->length()); }
 
-float math::vec4::z_axis_angle() const { return std::acos(m_z / this->length()); }
+float math::vec4::z_axis_angle() const { return std::acos(m_v[2] / this->length()); }
 
-float math::vec4::w_axis_angle() const { return std::acos(m_w / this->length()); }
+float math::vec4::w_axis_angle() const { return std::acos(m_v[3] / this->length()); }
 
 math::vec4 math::vec4::project_on_vector(const vec4 &other) const {
-    float other_len_sq = other.m_x * other.m_x + other.m_y * other.m_y + other.m_z * other.m_z +
-                         other.m_w * other.m_w;
+    float other_len_sq = other.m_v[0] * other.m_v[0] + other.m_v[1] * other.m_v[1] + other.m_v[2] * other.m_v[2] +
+                         other.m_v[3] * other.m_v[3];
     if (other_len_sq == 0.0f) [[unlikely]] {
         return vec4(0.0f, 0.0f, 0.0f, 0.0f);
     }
@@ -174,116 +62,81 @@ math::vec4 math::vec4::project_on_vector(const vec4 &other) const {
     return other * scalar;
 }
 
-math::vec3 math::vec4::to_vec3_orthographic() const { return vec3(m_x, m_y, m_z); }
+math::vec3 math::vec4::to_vec3_orthographic() const { return vec3(m_v[0], m_v[1], m_v[2]); }
 
 math::vec3 math::vec4::to_vec3_perspective(float focal_length) const {
-    if (m_w == 0.0f) [[unlikely]] {
+    if (m_v[3] == 0.0f) [[unlikely]] {
         return vec3(0.0f, 0.0f, 0.0f);
     }
-    float inv_w = focal_length / m_w;
-    return vec3(m_x * inv_w, m_y * inv_w, m_z * inv_w);
-}
-
-float math::vec4::dot_production(const vec4 &other) const {
-    return m_x * other.m_x + m_y * other.m_y + m_z * other.m_z + m_w * other.m_w;
-}
-
-float math::vec4::distance_to(const vec4 &other) const {
-    float dx = m_x - other.m_x;
-    float dy = m_y - other.m_y;
-    float dz = m_z - other.m_z;
-    float dw = m_w - other.m_w;
-    return std::sqrt(dx * dx + dy * dy + dz * dz + dw * dw);
-}
-
-math::vec4 math::vec4::lerp(const vec4 &other, float t) const {
-    return vec4(m_x + (other.m_x - m_x) * t, m_y + (other.m_y - m_y) * t,
-                m_z + (other.m_z - m_z) * t, m_w + (other.m_w - m_w) * t);
-}
-
-math::vec4 math::vec4::reflect(const vec4 &normal) const {
-    float len_sq = normal.m_x * normal.m_x + normal.m_y * normal.m_y + normal.m_z * normal.m_z +
-                   normal.m_w * normal.m_w;
-    if (len_sq == 0.0f) [[unlikely]] {
-        return *this;
-    }
-    float inv_len = 1.0f / std::sqrt(len_sq);
-    float nx = normal.m_x * inv_len;
-    float ny = normal.m_y * inv_len;
-    float nz = normal.m_z * inv_len;
-    float nw = normal.m_w * inv_len;
-
-    float dot = m_x * nx + m_y * ny + m_z * nz + m_w * nw;
-    float factor = 2.0f * dot;
-
-    return vec4(m_x - factor * nx, m_y - factor * ny, m_z - factor * nz, m_w - factor * nw);
+    float inv_w = focal_length / m_v[3];
+    return vec3(m_v[0] * inv_w, m_v[1] * inv_w, m_v[2] * inv_w);
 }
 
 math::vec4 math::vec4::scale_by_vector(const vec3& scale) const
 {
-    return vec4(m_x * scale.x(), m_y * scale.y(), m_z * scale.z(), m_w);
+    return vec4(m_v[0] * scale.x(), m_v[1] * scale.y(), m_v[2] * scale.z(), m_v[3]);
 }
 
 math::vec4 math::vec4::scale_by_scalar(float scale) const
 {
-    return vec4(m_x * scale, m_y * scale, m_z * scale, m_w);
+    return vec4(m_v[0] * scale, m_v[1] * scale, m_v[2] * scale, m_v[3]);
 }
 
 math::vec4 math::vec4::transfer_by_vector(const vec3& translation) const
 {
-    return vec4(m_x + translation.x(), m_y + translation.y(), m_z + translation.z(), m_w);
+    return vec4(m_v[0] + translation.x(), m_v[1] + translation.y(), m_v[2] + translation.z(), m_v[3]);
 }
 
 math::vec4 math::vec4::rotate_around_x_axis(float angle) const
 {
     return vec4(
-        m_x,
-        m_y * std::cos(angle) - m_z * std::sin(angle),
-        m_y * std::sin(angle) + m_z * std::cos(angle),
-        m_w);
+        m_v[0],
+        m_v[1] * std::cos(angle) - m_v[2] * std::sin(angle),
+        m_v[1] * std::sin(angle) + m_v[2] * std::cos(angle),
+        m_v[3]);
 }
 
 math::vec4 math::vec4::rotate_around_y_axis(float angle) const
 {
     return vec4(
-        m_x * std::cos(angle) + m_z * std::sin(angle),
-        m_y,
-        -m_x * std::sin(angle) + m_z * std::cos(angle),
-        m_w);
+        m_v[0] * std::cos(angle) + m_v[2] * std::sin(angle),
+        m_v[1],
+        -m_v[0] * std::sin(angle) + m_v[2] * std::cos(angle),
+        m_v[3]);
 }
 
 math::vec4 math::vec4::rotate_around_z_axis(float angle) const
 {
     return vec4(
-        m_x * std::cos(angle) - m_y * std::sin(angle),
-        m_x * std::sin(angle) + m_y * std::cos(angle),
-        m_z,
-        m_w);
+        m_v[0] * std::cos(angle) - m_v[1] * std::sin(angle),
+        m_v[0] * std::sin(angle) + m_v[1] * std::cos(angle),
+        m_v[2],
+        m_v[3]);
 }
 
 math::vec4 math::vec4::to_normalized_device_coordinates() const
 {
-    if (m_w == 0.0f) [[unlikely]] {
+    if (m_v[3] == 0.0f) [[unlikely]] {
         return vec4(0.0f, 0.0f, 0.0f, 0.0f);
     }
-    float inv_w = 1.0f / m_w;
-    return vec4(m_x * inv_w, m_y * inv_w, m_z * inv_w, 1.0f);
+    float inv_w = 1.0f / m_v[3];
+    return vec4(m_v[0] * inv_w, m_v[1] * inv_w, m_v[2] * inv_w, 1.0f);
 }
 
 void math::vec4::normalize_to_device_coordinates()
 {
-    if (m_w == 0.0f) [[unlikely]] {
-        m_x = 0.0f;
-        m_y = 0.0f;
-        m_z = 0.0f;
-        m_w = 0.0f;
+    if (m_v[3] == 0.0f) [[unlikely]] {
+        m_v[0] = 0.0f;
+        m_v[1] = 0.0f;
+        m_v[2] = 0.0f;
+        m_v[3] = 0.0f;
         return;
     }
-    float inv_w = 1.0f / m_w;
-    m_x *= inv_w;
-    m_y *= inv_w;
-    m_z *= inv_w;
-    m_w = 1.0f;
+    float inv_w = 1.0f / m_v[3];
+    m_v[0] *= inv_w;
+    m_v[1] *= inv_w;
+    m_v[2] *= inv_w;
+    m_v[3] = 1.0f;
 }
 
 math::vec4 math::vec4::zero() { return vec4(0.0f, 0.0f, 0.0f, 0.0f); }
@@ -298,18 +151,14 @@ math::vec4 math::vec4::basis_k() { return vec4(0.0f, 0.0f, 1.0f, 0.0f); }
 
 math::vec4 math::vec4::basis_l() { return vec4(0.0f, 0.0f, 0.0f, 1.0f); }
 
-float math::vec4::dot_production(const vec4 &a, const vec4 &b) {
-    return a.m_x * b.m_x + a.m_y * b.m_y + a.m_z * b.m_z + a.m_w * b.m_w;
-}
-
 math::vec4 math::vec4::cross_production_exp(const vec4 &a, const vec4 &b, const vec4 &c) {
-    float x = a.m_y * (b.m_z * c.m_w - c.m_z * b.m_w) - a.m_z * (b.m_y * c.m_w - c.m_y * b.m_w) +
-              a.m_w * (b.m_y * c.m_z - c.m_y * b.m_z);
-    float y = a.m_x * (c.m_z * b.m_w - b.m_z * c.m_w) - a.m_z * (c.m_x * b.m_w - b.m_x * c.m_w) +
-              a.m_w * (c.m_x * b.m_z - b.m_x * c.m_z);
-    float z = a.m_x * (b.m_y * c.m_w - c.m_y * b.m_w) - a.m_y * (b.m_x * c.m_w - c.m_x * b.m_w) +
-              a.m_w * (b.m_x * c.m_y - c.m_x * b.m_y);
-    float w = a.m_x * (c.m_y * b.m_z - b.m_y * c.m_z) - a.m_y * (c.m_x * b.m_z - b.m_x * c.m_z) +
-              a.m_z * (c.m_x * b.m_y - b.m_x * c.m_y);
+    float x = a.m_v[1] * (b.m_v[2] * c.m_v[3] - c.m_v[2] * b.m_v[3]) - a.m_v[2] * (b.m_v[1] * c.m_v[3] - c.m_v[1] * b.m_v[3]) +
+              a.m_v[3] * (b.m_v[1] * c.m_v[2] - c.m_v[1] * b.m_v[2]);
+    float y = a.m_v[0] * (c.m_v[2] * b.m_v[3] - b.m_v[2] * c.m_v[3]) - a.m_v[2] * (c.m_v[0] * b.m_v[3] - b.m_v[0] * c.m_v[3]) +
+              a.m_v[3] * (c.m_v[0] * b.m_v[2] - b.m_v[0] * c.m_v[2]);
+    float z = a.m_v[0] * (b.m_v[1] * c.m_v[3] - c.m_v[1] * b.m_v[3]) - a.m_v[1] * (b.m_v[0] * c.m_v[3] - c.m_v[0] * b.m_v[3]) +
+              a.m_v[3] * (b.m_v[0] * c.m_v[1] - c.m_v[0] * b.m_v[1]);
+    float w = a.m_v[0] * (c.m_v[1] * b.m_v[2] - b.m_v[1] * c.m_v[2]) - a.m_v[1] * (c.m_v[0] * b.m_v[2] - b.m_v[0] * c.m_v[2]) +
+              a.m_v[2] * (c.m_v[0] * b.m_v[1] - b.m_v[0] * c.m_v[1]);
     return vec4(x, y, z, w);
 }
\ No newline at end of file
@@ -1,8 +1,11 @@
 #ifndef VEC4_HPP
 #define VEC4_HPP
 
+#include "../simd/simd.hpp"
 #include "../vec3/vec3.hpp"
 
+#include <cmath>
+
 namespace math {
 
 struct point4 {
@@ -19,7 +22,13 @@ class vec4 {
     vec4(const point4& start, const point4& end);
     vec4(const vec3& v, float w = 1.0f);
     vec4(const point3& point, float w = 1.0f);
-    vec4(const vec4& other);
+    vec4(const vec4& other) = default;
+    // Lanes x, y, z, w of a register; both directions are a single aligned load or store.
+    explicit vec4(simd::f32x4 lanes);
+    simd::f32x4 to_simd() const;
+
+    vec4 &operator=(const vec4 &other) = default;
+
     float x() const;
     float y() const;
     float z() const;
@@ -84,9 +93,95 @@ class vec4 {
     static vec4 cross_production_exp(const vec4 &a, const vec4 &b, const vec4 &c);
 
   private:
-    float m_x, m_y, m_z, m_w;
+    // x, y, z, w; 16-byte aligned so the whole vector is one register load.
+    alignas(16) float m_v[4];
 };
 
+inline vec4::vec4(simd::f32x4 lanes) { lanes.store(m_v); }
+
+inline simd::f32x4 vec4::to_simd() const { return simd::f32x4::load(m_v); }
+
+inline float vec4::x() const { return m_v[0]; }
+
+inline float vec4::y() const { return m_v[1]; }
+
+inline float vec4::z() const { return m_v[2]; }
+
+inline float vec4::w() const { return m_v[3]; }
+
+inline float vec4::x(float x) {
+    m_v[0] = x;
+    return m_v[0];
+}
+
+inline float vec4::y(float y) {
+    m_v[1] = y;
+    return m_v[1];
+}
+
+inline float vec4::z(float z) {
+    m_v[2] = z;
+    return m_v[2];
+}
+
+inline float vec4::w(float w) {
+    m_v[3] = w;
+    return m_v[3];
+}
+
+// The arithmetic below is inline so that chains of operations stay in registers.
+
+inline vec4 vec4::operator+(const vec4 &other) const { return vec4(to_simd() + other.to_simd()); }
+
+inline vec4 vec4::operator-(const vec4 &other) const { return vec4(to_simd() - other.to_simd()); }
+
+inline vec4 vec4::operator*(float scalar) const { return vec4(to_simd() * scalar); }
+
+inline vec4 vec4::operator/(float scalar) const { return vec4(to_simd() / scalar); }
+
+inline vec4 &vec4::operator+=(const vec4 &other) { return *this = *this + other; }
+
+inline vec4 &vec4::operator-=(const vec4 &other) { return *this = *this - other; }
+
+inline vec4 &vec4::operator*=(float scalar) { return *this = *this * scalar; }
+
+inline vec4 &vec4::operator/=(float scalar) { return *this = *this / scalar; }
+
+inline float vec4::dot_production(const vec4 &other) const {
+    return reduce_add(to_simd() * other.to_simd());
+}
+
+inline float vec4::dot_production(const vec4 &a, const vec4 &b) { return a.dot_production(b); }
+
+inline float vec4::length() const { return std::sqrt(dot_production(*this)); }
+
+inline float vec4::distance_to(const vec4 &other) const { return (*this - other).length(); }
+
+inline vec4 vec4::normalized() const {
+    const float len_sq = dot_production(*this);
+    if (len_sq == 0.0f) [[unlikely]] {
+        return vec4(0.0f, 0.0f, 0.0f, 0.0f);
+    }
+    return vec4(to_simd() * (1.0f / std::sqrt(len_sq)));
+}
+
+inline void vec4::normalize() { *this = normalized(); }
+
+inline vec4 vec4::lerp(const vec4 &other, float t) const {
+    const simd::f32x4 a = to_simd();
+    return vec4(fmadd(other.to_simd() - a, t, a));
+}
+
+inline vec4 vec4::reflect(const vec4 &normal) const {
+    const float len_sq = normal.dot_production(normal);
+    if (len_sq == 0.0f) [[unlikely]] {
+        return *this;
+    }
+    // v - 2 (v . n) n / |n|^2
+    const float factor = 2.0f * dot_production(normal) / len_sq;
+    return vec4(fnmadd(simd::f32x4(factor), normal.to_simd(), to_simd()));
+}
+
 } // namespace math
 
 #endif // VEC4_HPP
@@ -0,0 +1,323 @@
+#ifndef VEC_EXPR_HPP
+#define VEC_EXPR_HPP
+
+#include "../vec4/vec4.hpp"
+
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+// Opt-in expression templates for vec3/vec4 arithmetic.
+//
+// Wrapping operands with expr::ref (single vector) or expr::each (array of vectors) builds a
+// lightweight expression tree instead of a vec3 per operator. The tree is evaluated once per
+// element by expr::evaluate, so a chain like
+//
+//     expr::evaluate(out, expr::each(a) + expr::each(b) * s - expr::cross(expr::each(c), expr::each(d)));
+//
+// compiles to a single loop with no intermediate vectors. Expression nodes hold references to
+// their operands: evaluate them in the same full-expression that builds them.
+
+namespace math::expr {
+
+template <std::size_t N> struct lanes {
+    float v[N];
+};
+
+template <typename T> struct vec_traits;
+
+template <> struct vec_traits<vec3> {
+    static constexpr std::size_t dimension = 3;
+    static lanes<3> load(const vec3 &v) { return {{v.x(), v.y(), v.z()}}; }
+    static void store(vec3 &v, const lanes<3> &l) {
+        v.x(l.v[0]);
+        v.y(l.v[1]);
+        v.z(l.v[2]);
+    }
+};
+
+template <> struct vec_traits<vec4> {
+    static constexpr std::size_t dimension = 4;
+    static lanes<4> load(const vec4 &v) { return {{v.x(), v.y(), v.z(), v.w()}}; }
+    static void store(vec4 &v, const lanes<4> &l) {
+        v.x(l.v[0]);
+        v.y(l.v[1]);
+        v.z(l.v[2]);
+        v.w(l.v[3]);
+    }
+};
+
+// Every vector node exposes `dimension` and `lanes<dimension> at(std::size_t i)`,
+// every scalar node exposes `is_scalar` and `float at(std::size_t i)`. Single-value
+// terminals ignore the index. `covers(n)` is true when every expr::each operand in the tree
+// has exactly n elements.
+template <typename E>
+concept vector_expression = requires(const E &e, std::size_t i) {
+    { E::dimension } -> std::convertible_to<std::size_t>;
+    { e.at(i) } -> std::same_as<lanes<E::dimension>>;
+};
+
+template <typename E>
+concept scalar_expression = E::is_scalar && requires(const E &e, std::size_t i) {
+    { e.at(i) } -> std::same_as<float>;
+};
+
+// ---- terminals ----
+
+template <typename T> struct ref_node {
+    static constexpr std::size_t dimension = vec_traits<T>::dimension;
+    const T &value;
+    lanes<dimension> at(std::size_t) const { return vec_traits<T>::load(value); }
+    bool covers(std::size_t) const { return true; }
+};
+
+template <typename T> struct each_node {
+    static constexpr std::size_t dimension = vec_traits<T>::dimension;
+    const T *data;
+    std::size_t count;
+    lanes<dimension> at(std::size_t i) const { return vec_traits<T>::load(data[i]); }
+    bool covers(std::size_t n) const { return count == n; }
+};
+
+struct constant_node {
+    static constexpr bool is_scalar = true;
+    float value;
+    float at(std::size_t) const { return value; }
+    bool covers(std::size_t) const { return true; }
+};
+
+struct each_scalar_node {
+    static constexpr bool is_scalar = true;
+    const float *data;
+    std::size_t count;
+    float at(std::size_t i) const { return data[i]; }
+    bool covers(std::size_t n) const { return count == n; }
+};
+
+inline ref_node<vec3> ref(const vec3 &v) { return {v}; }
+inline ref_node<vec4> ref(const vec4 &v) { return {v}; }
+inline each_node<vec3> each(std::span<const vec3> v) { return {v.data(), v.size()}; }
+inline each_node<vec4> each(std::span<const vec4> v) { return {v.data(), v.size()}; }
+inline each_scalar_node each(std::span<const float> s) { return {s.data(), s.size()}; }
+
+// ---- vector nodes ----
+
+template <vector_expression L, vector_expression R>
+    requires(L::dimension == R::dimension)
+struct add_node {
+    static constexpr std::size_t dimension = L::dimension;
+    L lhs;
+    R rhs;
+    bool covers(std::size_t n) const { return lhs.covers(n) && rhs.covers(n); }
+    lanes<dimension> at(std::size_t i) const {
+        lanes<dimension> a = lhs.at(i);
+        const lanes<dimension> b = rhs.at(i);
+        for (std::size_t k = 0; k < dimension; ++k) {
+            a.v[k] += b.v[k];
+        }
+        return a;
+    }
+};
+
+template <vector_expression L, vector_expression R>
+    requires(L::dimension == R::dimension)
+struct sub_node {
+    static constexpr std::size_t dimension = L::dimension;
+    L lhs;
+    R rhs;
+    bool covers(std::size_t n) const { return lhs.covers(n) && rhs.covers(n); }
+    lanes<dimension> at(std::size_t i) const {
+        lanes<dimension> a = lhs.at(i);
+        const lanes<dimension> b = rhs.at(i);
+        for (std::size_t k = 0; k < dimension; ++k) {
+            a.v[k] -= b.v[k];
+        }
+        return a;
+    }
+};
+
+template <vector_expression E> struct neg_node {
+    static constexpr std::size_t dimension = E::dimension;
+    E operand;
+    bool covers(std::size_t n) const { return operand.covers(n); }
+    lanes<dimension> at(std::size_t i) const {
+        lanes<dimension> a = operand.at(i);
+        for (std::size_t k = 0; k < dimension; ++k) {
+            a.v[k] = -a.v[k];
+        }
+        return a;
+    }
+};
+
+template <vector_expression E, scalar_expression S> struct scale_node {
+    static constexpr std::size_t dimension = E::dimension;
+    E operand;
+    S scalar;
+    bool covers(std::size_t n) const { return operand.covers(n) && scalar.covers(n); }
+    lanes<dimension> at(std::size_t i) const {
+        lanes<dimension> a = operand.at(i);
+        const float s = scalar.at(i);
+        for (std::size_t k = 0; k < dimension; ++k) {
+            a.v[k] *= s;
+        }
+        return a;
+    }
+};
+
+template <vector_expression L, vector_expression R>
+    requires(L::dimension == 3 && R::dimension == 3)
+struct cross_node {
+    static constexpr std::size_t dimension = 3;
+    L lhs;
+    R rhs;
+    bool covers(std::size_t n) const { return lhs.covers(n) && rhs.covers(n); }
+    lanes<3> at(std::size_t i) const {
+        const lanes<3> a = lhs.at(i);
+        const lanes<3> b = rhs.at(i);
+        return {{a.v[1] * b.v[2] - a.v[2] * b.v[1], a.v[2] * b.v[0] - a.v[0] * b.v[2],
+                 a.v[0] * b.v[1] - a.v[1] * b.v[0]}};
+    }
+};
+
+template <vector_expression L, vector_expression R, scalar_expression S>
+    requires(L::dimension == R::dimension)
+struct lerp_node {
+    static constexpr std::size_t dimension = L::dimension;
+    L lhs;
+    R rhs;
+    S t;
+    bool covers(std::size_t n) const { return lhs.covers(n) && rhs.covers(n) && t.covers(n); }
+    lanes<dimension> at(std::size_t i) const {
+        lanes<dimension> a = lhs.at(i);
+        const lanes<dimension> b = rhs.at(i);
+        const float s = t.at(i);
+        for (std::size_t k = 0; k < dimension; ++k) {
+            a.v[k] += (b.v[k] - a.v[k]) * s;
+        }
+        return a;
+    }
+};
+
+// ---- scalar nodes ----
+
+template <vector_expression L, vector_expression R>
+    requires(L::dimension == R::dimension)
+struct dot_node {
+    static constexpr bool is_scalar = true;
+    L lhs;
+    R rhs;
+    bool covers(std::size_t n) const { return lhs.covers(n) && rhs.covers(n); }
+    float at(std::size_t i) const {
+        const lanes<L::dimension> a = lhs.at(i);
+        const lanes<L::dimension> b = rhs.at(i);
+        float sum = a.v[0] * b.v[0];
+        for (std::size_t k = 1; k < L::dimension; ++k) {
+            sum += a.v[k] * b.v[k];
+        }
+        return sum;
+    }
+};
+
+// ---- operators (only participate for expression nodes, never for plain vec3/vec4) ----
+
+template <vector_expression L, vector_expression R> auto operator+(const L &lhs, const R &rhs) {
+    return add_node<L, R>{lhs, rhs};
+}
+
+template <vector_expression L, vector_expression R> auto operator-(const L &lhs, const R &rhs) {
+    return sub_node<L, R>{lhs, rhs};
+}
+
+template <vector_expression E> auto operator-(const E &operand) { return neg_node<E>{operand}; }
+
+template <vector_expression E> auto operator*(const E &operand, float scalar) {
+    return scale_node<E, constant_node>{operand, {scalar}};
+}
+
+template <vector_expression E> auto operator*(float scalar, const E &operand) {
+    return scale_node<E, constant_node>{operand, {scalar}};
+}
+
+template <vector_expression E, scalar_expression S> auto operator*(const E &operand, const S &scalar) {
+    return scale_node<E, S>{operand, scalar};
+}
+
+template <vector_expression E, scalar_expression S> auto operator*(const S &scalar, const E &operand) {
+    return scale_node<E, S>{operand, scalar};
+}
+
+// Division by a constant is folded into one reciprocal, matching vec3::normalized.
+template <vector_expression E> auto operator/(const E &operand, float scalar) {
+    return scale_node<E, constant_node>{operand, {1.0f / scalar}};
+}
+
+template <vector_expression L, vector_expression R> auto cross(const L &lhs, const R &rhs) {
+    return cross_node<L, R>{lhs, rhs};
+}
+
+template <vector_expression L, vector_expression R> auto dot(const L &lhs, const R &rhs) {
+    return dot_node<L, R>{lhs, rhs};
+}
+
+template <vector_expression L, vector_expression R> auto lerp(const L &a, const R &b, float t) {
+    return lerp_node<L, R, constant_node>{a, b, {t}};
+}
+
+template <vector_expression L, vector_expression R, scalar_expression S>
+auto lerp(const L &a, const R &b, const S &t) {
+    return lerp_node<L, R, S>{a, b, t};
+}
+
+// ---- evaluation ----
+
+template <typename E> void check_sizes(const E &e, std::size_t count) {
+    if (!e.covers(count)) [[unlikely]] {
+        throw std::invalid_argument("expr::each operand size does not match the output");
+    }
+}
+
+// Single-value evaluation: one element, so any expr::each operand must have exactly one
+// element, otherwise std::invalid_argument is thrown.
+template <typename T, vector_expression E>
+    requires(vec_traits<T>::dimension == E::dimension)
+void evaluate(T &out, const E &e) {
+    check_sizes(e, 1);
+    vec_traits<T>::store(out, e.at(0));
+}
+
+template <typename T, vector_expression E>
+    requires(vec_traits<T>::dimension == E::dimension)
+T evaluate(const E &e) {
+    check_sizes(e, 1);
+    T out;
+    vec_traits<T>::store(out, e.at(0));
+    return out;
+}
+
+// Element-wise evaluation over out.size() elements. Every expr::each operand must have
+// exactly that many elements, otherwise std::invalid_argument is thrown before anything is
+// written; the loop body is branch-free so the compiler can vectorize it.
+template <typename T, vector_expression E>
+    requires(vec_traits<T>::dimension == E::dimension)
+void evaluate(std::span<T> out, const E &e) {
+    check_sizes(e, out.size());
+    T *dst = out.data();
+    const std::size_t count = out.size();
+    for (std::size_t i = 0; i < count; ++i) {
+        vec_traits<T>::store(dst[i], e.at(i));
+    }
+}
+
+template <scalar_expression S> void evaluate(std::span<float> out, const S &s) {
+    check_sizes(s, out.size());
+    float *dst = out.data();
+    const std::size_t count = out.size();
+    for (std::size_t i = 0; i < count; ++i) {
+        dst[i] = s.at(i);
+    }
+}
+
+} // namespace math::expr
+
+#endif // VEC_EXPR_HPP